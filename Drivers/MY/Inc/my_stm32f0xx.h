@@ -81,6 +81,11 @@
 					#define	MAX_DELAY      						0xFFFFFFFFU
 				#endif
 
+				/*!< Функции MY_RAMFUNC выполняются из ОЗУ. При 0 они остаются во Flash */
+				#if !defined(RAMFUNC_ENABLE)
+					#define	RAMFUNC_ENABLE      				1U
+				#endif
+
 			/**
 			 * @} MY_Settings
 			 */
@@ -103,24 +108,21 @@
 			 * @brief    Библиотечные макросы
 			 * @{
 			 */
-				/* Блокировка структуры. Применяется при использовании RTOS */
-				#define MY_LOCK(__HANDLE__)                 	\
-					  do{                                       \
-						  if((__HANDLE__)->Lock == MY_Lock_On)  \
-						  {                                     \
-							 return MY_Result_Busy;             \
-						  }                                     \
-						  else                                  \
-						  {                                     \
-							 (__HANDLE__)->Lock = MY_Lock_On;   \
-						  }                                     \
-					  } while (0)
-
-				/* Разблокировка структуры. Применяется при использовании RTOS */
-				 #define MY_UNLOCK(__HANDLE__)             			 	\
-					  do{                                       		\
-						  (__HANDLE__)->Lock = MY_Lock_Off;    			\
-					  } while (0)
+				/**
+				 * Размещение функции в секции .ramfunc: Reset_Handler копирует её из Flash в ОЗУ, где она выполняется
+				 * без тактов ожидания Flash (FLASH_LATENCY) и промахов буфера предвыборки на ветвлениях.
+				 * ОЗУ и Flash дальше досягаемости BL (±16 МБ). long_call указывается и в прототипе: вызывающий код
+				 * загружает адрес в регистр и переходит по BLX. Вызовы из ОЗУ в функции во Flash (и обратно без
+				 * long_call) компоновщик проводит через заглушку __<имя>_veneer рядом с вызывающим кодом: для ARMv6-M
+				 * это загрузка адреса и переход через стек, несколько тактов на вызов. Список заглушек выводит make.
+				 * Размер секции ограничен _Ramfunc_Size в скрипте компоновщика
+				 */
+				#if (RAMFUNC_ENABLE == 1U)
+					#define MY_RAMFUNC							__attribute__((section(".ramfunc"), noinline, long_call))
+				#else
+					#define MY_RAMFUNC
+				#endif
+
 			/**
 			 * @}  MY_Macros
 			 */
@@ -143,17 +145,6 @@
 				}
 				MY_Result_t;
 
-
-				/**
-				 * @brief 	Блокировка доступа
-				 */
-				typedef enum
-				{
-					MY_Lock_On     = 0x00U, 	/*!< Разблокировано  */
-					MY_Lock_Off    = 0x01U		/*!< Заблокировано  */
-				}
-				MY_Lock_t;
-
 			/**
 			 * @} MY_Typedefs
 			 */
@@ -171,6 +162,18 @@
 				 */
 				MY_Result_t MY_System_Init(void);
 
+
+				/**
+				 * @brief  Сравнение выполнения одного и того же цикла из Flash и из ОЗУ
+				 * @note   Цикл опроса флага с ветвлением, как в ожидании флагов I2C. Лучший из 8 замеров
+				 * 		   по SysTick при запрещённых прерываниях. Замеряется только этот цикл: время
+				 * 		   обработчиков прерываний и функций драйверов с MY_RAMFUNC он не показывает
+				 * @param  *FlashCycles: такты HCLK при выполнении из Flash
+				 * @param  *RamCycles: такты HCLK при выполнении из ОЗУ (равны FlashCycles при RAMFUNC_ENABLE = 0)
+				 * @retval Нет
+				 */
+				void MY_RAMFUNC_Benchmark(uint32_t *FlashCycles, uint32_t *RamCycles);
+
 			/**
 			 * @} MY_Functions
 			 */
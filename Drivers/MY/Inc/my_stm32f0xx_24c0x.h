@@ -80,6 +80,17 @@
 			 * @brief    Typedefs используемые в библиотеке
 			 * @{
 			 */
+				/**
+				 * @brief  Контекст операции с EEPROM в сопрограмме
+				 */
+				typedef struct
+				{
+					MY_PT_t			PT;				/*!< Состояние сопрограммы */
+					MY_I2C_PT_t		I2C;			/*!< Вложенная передача I2C */
+					uint8_t			Buffer[2];		/*!< Адрес ячейки и данные */
+					MY_Result_t		Result;			/*!< Результат после завершения */
+				}
+				MY_24C0X_PT_t;
 
 			/**
 			 * @} MY_24С0X_Typedefs
@@ -120,6 +131,30 @@
 				uint8_t MY_24C0X_ReadByte(I2C_TypeDef* I2Cx, uint8_t address_byte);
 
 
+				/**
+				 * @brief  Записывает один байт без блокировки суперцикла, включая ожидание цикла записи
+				 * @note   Вызывается повторно, пока не вернёт MY_PT_State_Ended. Перед запуском MY_PT_INIT(&Ctx->PT)
+				 * @param  *Ctx - контекст операции, результат в Ctx->Result
+				 * @param  I2Cx - указатель на структуру I2C
+				 * @param  address_byte - адрес ячейки
+				 * @param  data - байт для записи
+				 * @retval Состояние сопрограммы @ref MY_PT_State_t
+				 */
+				MY_PT_State_t MY_24C0X_PT_WriteByte(MY_24C0X_PT_t *Ctx, I2C_TypeDef* I2Cx, uint8_t address_byte, uint8_t data);
+
+
+				/**
+				 * @brief  Читает один байт без блокировки суперцикла
+				 * @note   Вызывается повторно, пока не вернёт MY_PT_State_Ended. Перед запуском MY_PT_INIT(&Ctx->PT)
+				 * @param  *Ctx - контекст операции, результат в Ctx->Result
+				 * @param  I2Cx - указатель на структуру I2C
+				 * @param  address_byte - адрес ячейки
+				 * @param  *data - значение ячейки памяти
+				 * @retval Состояние сопрограммы @ref MY_PT_State_t
+				 */
+				MY_PT_State_t MY_24C0X_PT_ReadByte(MY_24C0X_PT_t *Ctx, I2C_TypeDef* I2Cx, uint8_t address_byte, uint8_t *data);
+
+
 			/**
 			 * @} MY_24С0X_Functions
 			 */
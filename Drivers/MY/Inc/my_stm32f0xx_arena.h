@@ -0,0 +1,283 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/arena
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Арена для временных буферов: выделение сдвигом указателя, освобождение областями
+ */
+
+#ifndef MY_STM32F0xx_ARENA_H
+	#define MY_STM32F0xx_ARENA_H 100
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		extern "C"
+		{
+	#endif
+
+	/**
+	 * @addtogroup MY_STM32F0xx_Libraries
+	 * @{
+	 */
+
+		/**
+		 * @defgroup MY_ARENA
+		 * @brief    Арена временных буферов
+		 *
+		 * 	Память арены - секция .arena размером _Arena_Size, зарезервированная в скрипте компоновщика
+		 * 	(символы _sarena/_earena). Выделение - выравнивание и сдвиг вершины, освобождения отдельных
+		 * 	буферов нет: MY_ARENA_Mark() запоминает вершину, MY_ARENA_Release() возвращает её обратно
+		 * 	и освобождает всё, выделенное после отметки.
+		 *
+		 * 	Области с отчётом об использовании:
+		 * 		MY_ARENA_SCOPE_BEGIN(Format);
+		 * 		char *line = MY_ARENA_Alloc(64);
+		 * 		...
+		 * 		MY_ARENA_SCOPE_END(Format);
+		 * 		...
+		 * 		MY_ARENA_Dump();
+		 *
+		 * 	Для каждой области (регистрируется по имени при первом проходе) считаются вызовы,
+		 * 	максимум и последнее значение занятой памяти с учётом вложенных областей, отказы.
+		 * 	При нехватке места вызывается MY_ARENA_FailureCallback() и возвращается NULL.
+		 *
+		 * 	Арена не защищена от параллельного использования: выделения должны освобождаться в обратном
+		 * 	порядке, поэтому её использует один поток (суперцикл или одна задача ОС), не обработчики прерываний.
+		 *	@{
+		 */
+
+			/* Подключаем основные файлы библиотек и настройки проекта */
+			#include "main.h"
+			#include "my_stm32f0xx.h"
+
+			/**
+			 * @defgroup MY_ARENA_Settings
+			 * @brief    Библиотечные настройки
+			 * @{
+			 */
+				/*!< Выравнивание MY_ARENA_Alloc() по умолчанию, степень двойки */
+				#ifndef ARENA_ALIGN
+					#define ARENA_ALIGN							4U
+				#endif
+
+				/*!< Количество областей в отчёте */
+				#ifndef ARENA_SCOPES_MAX
+					#define ARENA_SCOPES_MAX					8U
+				#endif
+
+			/**
+			 * @} MY_ARENA_Settings
+			 */
+
+
+			/**
+			 * @defgroup MY_ARENA_Defines
+			 * @brief    Библиотечные константы
+			 * @{
+			 */
+
+			/**
+			 * @} MY_ARENA_Defines
+			 */
+
+
+			/**
+			 * @defgroup MY_ARENA_Macros
+			 * @brief    Библиотечные макросы
+			 * @{
+			 */
+				/* Начало области: запоминает вершину арены */
+				#define MY_ARENA_SCOPE_BEGIN(__NAME__)															\
+					static MY_ARENA_Scope_t *MY_ARENA_Scope_##__NAME__;										\
+					MY_ARENA_Frame_t MY_ARENA_Frame_##__NAME__;												\
+					MY_ARENA_Scope_Begin(&MY_ARENA_Scope_##__NAME__, #__NAME__, &MY_ARENA_Frame_##__NAME__)
+
+				/* Конец области: освобождает выделенное в ней и обновляет отчёт */
+				#define MY_ARENA_SCOPE_END(__NAME__)															\
+					MY_ARENA_Scope_End(MY_ARENA_Scope_##__NAME__, &MY_ARENA_Frame_##__NAME__)
+
+			/**
+			 * @}  MY_ARENA_Macros
+			 */
+
+
+			/**
+			 * @defgroup MY_ARENA_Typedefs
+			 * @brief    Typedefs для библиотеки
+			 * @{
+			 */
+				/**
+				 * @brief  Отметка вершины арены (смещение от начала)
+				 */
+				typedef uint32_t MY_ARENA_Mark_t;
+
+
+				/**
+				 * @brief  Отчёт об использовании области
+				 */
+				typedef struct
+				{
+					const char	*Name;			/*!< Имя из MY_ARENA_SCOPE_BEGIN */
+					uint32_t	Count;			/*!< Количество проходов */
+					uint32_t	Last;			/*!< Занято в последнем проходе, байт */
+					uint32_t	Peak;			/*!< Максимум занятого за проход, байт */
+					uint32_t	Failed;			/*!< Отказы в выделении внутри области */
+				}
+				MY_ARENA_Scope_t;
+
+
+				/**
+				 * @brief  Состояние прохода области, хранится в стеке вызывающей функции
+				 */
+				typedef struct
+				{
+					MY_ARENA_Mark_t	Mark;		/*!< Вершина при входе */
+					uint32_t		HighWater;	/*!< Максимум вершины внешней области */
+					uint32_t		Failed;		/*!< Счётчик отказов при входе */
+				}
+				MY_ARENA_Frame_t;
+
+
+				/**
+				 * @brief  Статистика арены
+				 */
+				typedef struct
+				{
+					uint32_t	Size;			/*!< Размер арены, байт */
+					uint32_t	Used;			/*!< Занято сейчас */
+					uint32_t	Peak;			/*!< Максимум занятого */
+					uint32_t	Failed;			/*!< Отказы в выделении */
+				}
+				MY_ARENA_Stats_t;
+
+			/**
+			 * @} MY_ARENA_Typedefs
+			 */
+
+
+			/**
+			 * @defgroup MY_ARENA_Functions
+			 * @brief    Функции используемые в библиотеке
+			 * @{
+			 */
+				/**
+				 * @brief  Освобождает всю арену и сбрасывает статистику
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_ARENA_Init(void);
+
+
+				/**
+				 * @brief  Выделение с выравниванием ARENA_ALIGN
+				 * @param  Size: размер в байтах
+				 * @retval Указатель или NULL при нехватке места
+				 */
+				void* MY_ARENA_Alloc(uint32_t Size);
+
+
+				/**
+				 * @brief  Выделение с заданным выравниванием
+				 * @param  Size: размер в байтах
+				 * @param  Align: выравнивание, степень двойки
+				 * @retval Указатель или NULL при нехватке места или неверном Align
+				 */
+				void* MY_ARENA_AllocAligned(uint32_t Size, uint32_t Align);
+
+
+				/**
+				 * @brief  Текущая вершина арены
+				 * @param  Нет
+				 * @retval Отметка для MY_ARENA_Release()
+				 */
+				MY_ARENA_Mark_t MY_ARENA_Mark(void);
+
+
+				/**
+				 * @brief  Освобождает всё, выделенное после отметки
+				 * @param  Mark: отметка от MY_ARENA_Mark()
+				 * @retval MY_Result_Error - отметка выше вершины (область уже освобождена)
+				 */
+				MY_Result_t MY_ARENA_Release(MY_ARENA_Mark_t Mark);
+
+
+				/**
+				 * @brief  Свободное место над вершиной
+				 * @param  Нет
+				 * @retval Байт
+				 */
+				uint32_t MY_ARENA_GetFree(void);
+
+
+				/**
+				 * @brief  Начало области. Вызывается из MY_ARENA_SCOPE_BEGIN
+				 * @param  **Scope: запись отчёта, регистрируется при первом вызове
+				 * @param  *Name: имя области
+				 * @param  *Frame: состояние прохода
+				 * @retval Нет
+				 */
+				void MY_ARENA_Scope_Begin(MY_ARENA_Scope_t **Scope, const char *Name, MY_ARENA_Frame_t *Frame);
+
+
+				/**
+				 * @brief  Конец области. Вызывается из MY_ARENA_SCOPE_END
+				 * @param  *Scope: запись отчёта или NULL, если таблица заполнена
+				 * @param  *Frame: состояние прохода
+				 * @retval Нет
+				 */
+				void MY_ARENA_Scope_End(MY_ARENA_Scope_t *Scope, MY_ARENA_Frame_t *Frame);
+
+
+				/**
+				 * @brief  Статистика арены
+				 * @param  *Stats: копия статистики
+				 * @retval Нет
+				 */
+				void MY_ARENA_GetStats(MY_ARENA_Stats_t *Stats);
+
+
+				/**
+				 * @brief  Запись отчёта области
+				 * @param  Index: номер записи
+				 * @retval Указатель на запись или NULL
+				 */
+				const MY_ARENA_Scope_t* MY_ARENA_GetScope(uint32_t Index);
+
+
+				/**
+				 * @brief  Выводит статистику арены и отчёт по областям через printf()
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_ARENA_Dump(void);
+
+
+				/**
+				 * @brief  Вызывается при нехватке места в арене
+				 * @note   Реализация по умолчанию ничего не делает, MY_ARENA_Alloc() возвращает NULL.
+				 * 		   Приложение может переопределить её, например для остановки в отладке
+				 * @param  Size: запрошенный размер с учётом выравнивания
+				 * @param  Free: свободное место
+				 * @retval Нет
+				 */
+				void MY_ARENA_FailureCallback(uint32_t Size, uint32_t Free);
+
+			/**
+			 * @} MY_ARENA_Functions
+			 */
+
+		/**
+		 * @} MY_ARENA
+		 */
+
+	/**
+	 * @} MY_STM32F0xx_Libraries
+	 */
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		}
+	#endif
+
+#endif
@@ -0,0 +1,163 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/boot
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Последовательность запуска и замер времени загрузки
+ */
+
+#ifndef MY_STM32F0xx_BOOT_H
+	#define MY_STM32F0xx_BOOT_H 100
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		extern "C"
+		{
+	#endif
+
+	/**
+	 * @addtogroup MY_STM32F0xx_Libraries
+	 * @{
+	 */
+
+		/**
+		 * @defgroup MY_BOOT
+		 * @brief    Последовательность запуска
+		 *
+		 * 	Порядок запуска (Reset_Handler):
+		 * 		- MY_BOOT_EarlyInit(): сразу после установки стека, до инициализации .data/.bss.
+		 * 		  Включает HSE (если он используется по настройкам main.h) и запускает таймер замера.
+		 * 		  Пока кварц выходит на режим, выполняется копирование .data и обнуление .bss.
+		 * 		- MY_System_Init(): регистры RCC сбрасываются только если они не в состоянии после сброса.
+		 * 		- MY_RCC_System_Init(): дожидается уже запущенного HSE, затем PLL и переключение SYSCLK.
+		 *
+		 * 	При BOOT_TIMESTAMP_ENABLE = 1 на каждом этапе фиксируется время от сброса в мкс (MY_BOOT_GetTimestamp()).
+		 * 	Для замера используется TIM2, после входа в main() он останавливается и возвращается в исходное состояние.
+		 *
+		 * 	@note MY_BOOT_EarlyInit() вызывается до инициализации RAM и не должна обращаться к глобальным переменным.
+		 *	@{
+		 */
+
+			/* Подключаем основные файлы библиотек и настройки проекта */
+			#include "main.h"
+			#include "my_stm32f0xx.h"
+
+			/**
+			 * @defgroup MY_BOOT_Settings
+			 * @brief    Библиотечные настройки
+			 * @{
+			 */
+				/*!< Запись временных меток этапов загрузки. Выключена по умолчанию: на время загрузки занимает TIM2 */
+				#ifndef BOOT_TIMESTAMP_ENABLE
+					#define BOOT_TIMESTAMP_ENABLE				0U
+				#endif
+
+			/**
+			 * @} MY_BOOT_Settings
+			 */
+
+
+			/**
+			 * @defgroup MY_BOOT_Defines
+			 * @brief    Библиотечные константы
+			 * @{
+			 */
+
+			/**
+			 * @} MY_BOOT_Defines
+			 */
+
+
+			/**
+			 * @defgroup MY_BOOT_Macros
+			 * @brief    Библиотечные макросы
+			 * @{
+			 */
+				/* Отметка этапа загрузки. Компилируется в пустоту при BOOT_TIMESTAMP_ENABLE = 0 */
+				#if (BOOT_TIMESTAMP_ENABLE == 1U)
+					#define MY_BOOT_TIMESTAMP(__PHASE__)		MY_BOOT_Timestamp(__PHASE__)
+				#else
+					#define MY_BOOT_TIMESTAMP(__PHASE__)		do { } while(0)
+				#endif
+
+			/**
+			 * @}  MY_BOOT_Macros
+			 */
+
+
+			/**
+			 * @defgroup MY_BOOT_Typedefs
+			 * @brief    Typedefs для библиотеки
+			 * @{
+			 */
+				/**
+				 * @brief  Этапы загрузки
+				 * @note   Значения MemInit и Main используются в startup_stm32f051r8tx.s
+				 */
+				typedef enum
+				{
+					MY_BOOT_Phase_Reset         = 0x00U,	/*!< Старт Reset_Handler, всегда 0 */
+					MY_BOOT_Phase_MemInit       = 0x01U,	/*!< .data и .bss проинициализированы */
+					MY_BOOT_Phase_SystemInit    = 0x02U,	/*!< MY_System_Init() сбросил RCC и настроил SysTick */
+					MY_BOOT_Phase_HSEReady      = 0x03U,	/*!< HSE готов */
+					MY_BOOT_Phase_PLLReady      = 0x04U,	/*!< PLL захвачен */
+					MY_BOOT_Phase_ClockSwitched = 0x05U,	/*!< SYSCLK переключен на целевой источник */
+					MY_BOOT_Phase_Main          = 0x06U,	/*!< Вход в main() */
+					MY_BOOT_Phase_Count         = 0x07U
+				}
+				MY_BOOT_Phase_t;
+
+			/**
+			 * @} MY_BOOT_Typedefs
+			 */
+
+
+			/**
+			 * @defgroup MY_BOOT_Functions
+			 * @brief    Функции используемые в библиотеке
+			 * @{
+			 */
+				/**
+				 * @brief  Ранний этап запуска: включение HSE и таймера замера
+				 * @note   Вызывается из Reset_Handler до инициализации .data/.bss
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_BOOT_EarlyInit(void);
+
+
+				/**
+				 * @brief  Фиксирует время этапа загрузки
+				 * @note   После MY_BOOT_Phase_Main таймер замера останавливается
+				 * @param  Phase: этап загрузки
+				 * @retval Нет
+				 */
+				void MY_BOOT_Timestamp(MY_BOOT_Phase_t Phase);
+
+
+				/**
+				 * @brief  Возвращает время этапа загрузки от сброса
+				 * @param  Phase: этап загрузки
+				 * @retval Время в мкс, 0 если этап не был пройден
+				 */
+				uint32_t MY_BOOT_GetTimestamp(MY_BOOT_Phase_t Phase);
+
+			/**
+			 * @} MY_BOOT_Functions
+			 */
+
+		/**
+		 * @} MY_BOOT
+		 */
+
+	/**
+	 * @} MY_STM32F0xx_Libraries
+	 */
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		}
+	#endif
+
+#endif
@@ -0,0 +1,279 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/button
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Обработка кнопок с подавлением дребезга контактов
+ */
+
+#ifndef MY_STM32F0xx_BUTTON_H
+	#define MY_STM32F0xx_BUTTON_H 100
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		extern "C"
+		{
+	#endif
+
+	/**
+	 * @addtogroup MY_STM32F0xx_Libraries
+	 * @{
+	 */
+
+		/**
+		 * @defgroup MY_BUTTON
+		 * @brief    Подавление дребезга кнопок методом "вертикального счётчика"
+		 *
+		 * 	Опрос ведётся не по одной кнопке, а целым портом GPIO: за один отсчёт читается IDR
+		 * 	и для всех 16 входов порта параллельно считается 2-битный счётчик устойчивости.
+		 * 	Бит счётчика N для всех пинов хранится в одном 16-битном слове (Cnt0, Cnt1), поэтому
+		 * 	обработка порта занимает несколько побитовых операций независимо от числа кнопок.
+		 *
+		 * 	Состояние пина меняется, только если новое значение продержалось 4 отсчёта подряд,
+		 * 	т.е. при BUTTON_SAMPLE_PERIOD = 5 мс дребезг короче 20 мс отфильтровывается.
+		 *
+		 * 	Использование:
+		 * 		- Настроить пин как вход (MY_GPIO_Init)
+		 * 		- Зарегистрировать кнопку через MY_BUTTON_Init(), получить её номер
+		 * 		- Вызывать MY_BUTTON_Tick() из SysTick_Handler (каждую 1 мс)
+		 * 		- Забирать события из очереди MY_BUTTON_GetEvent() или
+		 * 		  опрашивать фронты MY_BUTTON_OnPressed()/MY_BUTTON_OnReleased()
+		 *	@{
+		 */
+
+			/* Подключаем основные файлы библиотек и настройки проекта */
+			#include "main.h"
+			#include "my_stm32f0xx.h"
+			#include "my_stm32f0xx_gpio.h"
+
+			/**
+			 * @defgroup MY_BUTTON_Settings
+			 * @brief    Библиотечные настройки
+			 * @{
+			 */
+				/*!< Период опроса портов в тиках SysTick (мс) */
+				#ifndef BUTTON_SAMPLE_PERIOD
+					#define BUTTON_SAMPLE_PERIOD				5U
+				#endif
+
+				/*!< Максимальное количество опрашиваемых портов GPIO */
+				#ifndef BUTTON_PORTS_MAX
+					#define BUTTON_PORTS_MAX					2U
+				#endif
+
+				/*!< Максимальное количество кнопок */
+				#ifndef BUTTON_MAX
+					#define BUTTON_MAX							8U
+				#endif
+
+				/*!< Размер очереди событий, должен быть степенью двойки */
+				#ifndef BUTTON_EVENT_QUEUE_SIZE
+					#define BUTTON_EVENT_QUEUE_SIZE				16U
+				#endif
+
+				/*!< Время удержания до события долгого нажатия, мс */
+				#ifndef BUTTON_LONGPRESS_TIME
+					#define BUTTON_LONGPRESS_TIME				1000U
+				#endif
+
+				/*!< Период автоповтора после долгого нажатия, мс. 0 - автоповтор выключен */
+				#ifndef BUTTON_REPEAT_PERIOD
+					#define BUTTON_REPEAT_PERIOD				200U
+				#endif
+
+				#if ((BUTTON_EVENT_QUEUE_SIZE & (BUTTON_EVENT_QUEUE_SIZE - 1U)) != 0U)
+					#error "my_stm32f0xx_button.h: BUTTON_EVENT_QUEUE_SIZE must be a power of two"
+				#endif
+
+			/**
+			 * @} MY_BUTTON_Settings
+			 */
+
+
+			/**
+			 * @defgroup MY_BUTTON_Defines
+			 * @brief    Библиотечные константы
+			 * @{
+			 */
+				/*!< Пороги удержания в отсчётах опроса */
+				#define BUTTON_LONGPRESS_SAMPLES				(BUTTON_LONGPRESS_TIME / BUTTON_SAMPLE_PERIOD)
+				#define BUTTON_REPEAT_SAMPLES					(BUTTON_REPEAT_PERIOD / BUTTON_SAMPLE_PERIOD)
+
+			/**
+			 * @} MY_BUTTON_Defines
+			 */
+
+
+			/**
+			 * @defgroup MY_BUTTON_Macros
+			 * @brief    Библиотечные макросы
+			 * @{
+			 */
+
+			/**
+			 * @}  MY_BUTTON_Macros
+			 */
+
+
+			/**
+			 * @defgroup MY_BUTTON_Typedefs
+			 * @brief    Typedefs для библиотеки
+			 * @{
+			 */
+				/**
+				 * @brief  Тип события кнопки
+				 */
+				typedef enum
+				{
+					MY_BUTTON_Event_None      = 0x00U,	/*!< Нет события */
+					MY_BUTTON_Event_Press     = 0x01U,	/*!< Кнопка нажата */
+					MY_BUTTON_Event_Release   = 0x02U,	/*!< Кнопка отпущена */
+					MY_BUTTON_Event_LongPress = 0x03U,	/*!< Кнопка удерживается дольше BUTTON_LONGPRESS_TIME */
+					MY_BUTTON_Event_Repeat    = 0x04U	/*!< Автоповтор при продолжении удержания */
+				}
+				MY_BUTTON_EventType_t;
+
+
+				/**
+				 * @brief  Событие в очереди
+				 */
+				typedef struct
+				{
+					uint8_t 				Button;		/*!< Номер кнопки, выданный MY_BUTTON_Init() */
+					MY_BUTTON_EventType_t 	Event;		/*!< Тип события */
+				}
+				MY_BUTTON_Event_t;
+
+
+				/**
+				 * @brief  Состояние вертикального счётчика одного порта
+				 */
+				typedef struct
+				{
+					GPIO_TypeDef* 	GPIOx;		/*!< Опрашиваемый порт */
+					uint16_t 		Mask;		/*!< Пины порта, занятые кнопками */
+					uint16_t 		Invert;		/*!< Пины, у которых нажатие - низкий уровень */
+					uint16_t 		State;		/*!< Устойчивое состояние, 1 - нажата */
+					uint16_t 		Cnt0;		/*!< Младший бит счётчика для всех пинов */
+					uint16_t 		Cnt1;		/*!< Старший бит счётчика для всех пинов */
+				}
+				MY_BUTTON_Port_t;
+
+			/**
+			 * @} MY_BUTTON_Typedefs
+			 */
+
+
+			/**
+			 * @defgroup MY_BUTTON_Functions
+			 * @brief    Функции используемые в библиотеке
+			 * @{
+			 */
+				/**
+				 * @brief  Регистрирует кнопку в обработчике. Пин должен быть заранее настроен как вход
+				 * @param  *GPIOx: порт GPIO
+				 * @param  GPIO_Pin: пин кнопки (GPIO_PIN_x)
+				 * @param  PressedState: уровень на пине при нажатии (0 или 1)
+				 * @param  *ButtonId: указатель для записи номера кнопки
+				 * @retval @arg MY_Result_Ok    - кнопка зарегистрирована
+				 * 		   @arg MY_Result_Error - нет свободного места для порта или кнопки
+				 */
+				MY_Result_t MY_BUTTON_Init(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, uint8_t PressedState, uint8_t *ButtonId);
+
+
+				/**
+				 * @brief  Отсчёт времени для опроса. Вызывается из SysTick_Handler
+				 * @note   Период опроса отсчитывается по MY_SysTick_GetTick(), поэтому работает и при простое без тиков
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_BUTTON_Tick(void);
+
+
+				/**
+				 * @brief  Время до следующего опроса для простоя без тиков (MY_SysTick_Tickless_Idle())
+				 * @note   Регистрируется в MY_BUTTON_Init() как источник срока MY_PWR_Deadline_Register()
+				 * @param  Нет
+				 * @retval Количество тиков до опроса, 0xFFFFFFFF - кнопки не зарегистрированы
+				 */
+				uint32_t MY_BUTTON_GetIdleTicks(void);
+
+
+				/**
+				 * @brief  Опрашивает все зарегистрированные порты и формирует события
+				 * @note   Вызывается из MY_BUTTON_Tick() раз в BUTTON_SAMPLE_PERIOD
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_BUTTON_Sample(void);
+
+
+				/**
+				 * @brief  Один шаг вертикального счётчика для порта
+				 * @param  *Port: состояние порта
+				 * @param  Sample: считанное значение IDR
+				 * @retval Маска пинов, сменивших устойчивое состояние на этом шаге
+				 */
+				uint16_t MY_BUTTON_Debounce(MY_BUTTON_Port_t *Port, uint16_t Sample);
+
+
+				/**
+				 * @brief  Забирает событие из очереди
+				 * @param  *Event: указатель для записи события
+				 * @retval @arg MY_Result_Ok    - событие получено
+				 * 		   @arg MY_Result_Error - очередь пуста
+				 */
+				MY_Result_t MY_BUTTON_GetEvent(MY_BUTTON_Event_t *Event);
+
+
+				/**
+				 * @brief  Возвращает устойчивое (после подавления дребезга) состояние кнопки
+				 * @param  ButtonId: номер кнопки
+				 * @retval 1 - нажата, 0 - отпущена
+				 */
+				uint8_t MY_BUTTON_IsPressed(uint8_t ButtonId);
+
+
+				/**
+				 * @brief  Проверяет произошло ли нажатие кнопки с момента прошлого вызова
+				 * @note   Счётчики нажатий и отпусканий независимы, функции можно вызывать вместе
+				 * @param  ButtonId: номер кнопки
+				 * @retval 1 - было нажатие, 0 - не было
+				 */
+				uint8_t MY_BUTTON_OnPressed(uint8_t ButtonId);
+
+
+				/**
+				 * @brief  Проверяет произошло ли отпускание кнопки с момента прошлого вызова
+				 * @param  ButtonId: номер кнопки
+				 * @retval 1 - было отпускание, 0 - не было
+				 */
+				uint8_t MY_BUTTON_OnReleased(uint8_t ButtonId);
+
+
+				/**
+				 * @brief  Количество событий, потерянных из-за переполнения очереди
+				 * @param  Нет
+				 * @retval Число потерянных событий
+				 */
+				uint32_t MY_BUTTON_GetDroppedEvents(void);
+
+			/**
+			 * @} MY_BUTTON_Functions
+			 */
+
+		/**
+		 * @} MY_BUTTON
+		 */
+
+	/**
+	 * @} MY_STM32F0xx_Libraries
+	 */
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		}
+	#endif
+
+#endif
@@ -0,0 +1,204 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/console
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Буферизованный неблокирующий вывод printf() через USART1
+ */
+
+#ifndef MY_STM32F0xx_CONSOLE_H
+	#define MY_STM32F0xx_CONSOLE_H 100
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		extern "C"
+		{
+	#endif
+
+	/**
+	 * @addtogroup MY_STM32F0xx_Libraries
+	 * @{
+	 */
+
+		/**
+		 * @defgroup MY_CONSOLE
+		 * @brief    Отладочный вывод
+		 *
+		 * 	_write (syscalls.c) передаёт вывод printf() в MY_CONSOLE_Write(), которая только копирует байты
+		 * 	в кольцевой буфер и разрешает прерывание TXE. USART1_IRQHandler передаёт по байту из буфера,
+		 * 	пока он не опустеет, после чего запрещает прерывание.
+		 *
+		 * 	Писателей может быть несколько, в том числе обработчики прерываний: MY_CONSOLE_Write() занимает
+		 * 	место в короткой критической секции и копирует данные при разрешённых прерываниях. Запись,
+		 * 	прервавшая другую, попадает в буфер после неё целиком, а передача начинается, когда вложенные
+		 * 	записи скопированы. Tail меняет только обработчик прерывания USART1.
+		 *
+		 * 	Вывод никогда не ждёт: если места не хватает, записывается то, что помещается, остальные байты
+		 * 	отбрасываются и учитываются в MY_CONSOLE_GetStats(). Вывод до MY_CONSOLE_Init() накапливается
+		 * 	в буфере и передаётся после инициализации.
+		 *
+		 * 	Пропускная способность: 115200 бод 8N1 - 11520 байт/с, одно прерывание на байт (87 мкс).
+		 * 	Буфер 256 байт принимает около 22 мс вывода без потерь, копирование строки в буфер занимает
+		 * 	единицы микросекунд вместо миллисекунд при передаче с ожиданием.
+		 *	@{
+		 */
+
+			/* Подключаем основные файлы библиотек и настройки проекта */
+			#include "main.h"
+			#include "my_stm32f0xx.h"
+
+			/**
+			 * @defgroup MY_CONSOLE_Settings
+			 * @brief    Библиотечные настройки
+			 * @{
+			 */
+				/*!< Размер кольцевого буфера, степень двойки */
+				#ifndef CONSOLE_BUFFER_SIZE
+					#define CONSOLE_BUFFER_SIZE					256U
+				#endif
+
+				/*!< Скорость USART1, бод */
+				#ifndef CONSOLE_BAUDRATE
+					#define CONSOLE_BAUDRATE					115200U
+				#endif
+
+				/*!< Приоритет прерывания USART1 */
+				#ifndef CONSOLE_IRQ_PRIORITY
+					#define CONSOLE_IRQ_PRIORITY				3U
+				#endif
+
+				/*!< Вывод TX: PA9 (AF1) на STM32F0-Discovery */
+				#ifndef CONSOLE_TX_PORT
+					#define CONSOLE_TX_PORT						GPIOA
+				#endif
+
+				#ifndef CONSOLE_TX_PIN
+					#define CONSOLE_TX_PIN						GPIO_Pin_9
+				#endif
+
+				#ifndef CONSOLE_TX_AF
+					#define CONSOLE_TX_AF						GPIO_AF1_USART1
+				#endif
+
+			/**
+			 * @} MY_CONSOLE_Settings
+			 */
+
+
+			/**
+			 * @defgroup MY_CONSOLE_Defines
+			 * @brief    Библиотечные константы
+			 * @{
+			 */
+
+			/**
+			 * @} MY_CONSOLE_Defines
+			 */
+
+
+			/**
+			 * @defgroup MY_CONSOLE_Macros
+			 * @brief    Библиотечные макросы
+			 * @{
+			 */
+
+			/**
+			 * @}  MY_CONSOLE_Macros
+			 */
+
+
+			/**
+			 * @defgroup MY_CONSOLE_Typedefs
+			 * @brief    Typedefs для библиотеки
+			 * @{
+			 */
+				/**
+				 * @brief  Статистика вывода
+				 */
+				typedef struct
+				{
+					uint32_t	Written;		/*!< Байт принято в буфер */
+					uint32_t	Dropped;		/*!< Байт отброшено из-за переполнения */
+					uint32_t	Overflows;		/*!< Вызовов MY_CONSOLE_Write() с потерями */
+					uint32_t	Peak;			/*!< Максимальное заполнение буфера, байт */
+				}
+				MY_CONSOLE_Stats_t;
+
+			/**
+			 * @} MY_CONSOLE_Typedefs
+			 */
+
+
+			/**
+			 * @defgroup MY_CONSOLE_Functions
+			 * @brief    Функции используемые в библиотеке
+			 * @{
+			 */
+				/**
+				 * @brief  Инициализация USART1 (только передача), вывода TX и прерывания
+				 * @note   Скорость пересчитывается автоматически при смене частот RCC
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_CONSOLE_Init(void);
+
+
+				/**
+				 * @brief  Копирует данные в буфер передачи без ожидания
+				 * @param  *Data: данные
+				 * @param  Size: количество байт
+				 * @retval Количество байт, принятых в буфер
+				 */
+				uint32_t MY_CONSOLE_Write(const char *Data, uint32_t Size);
+
+
+				/**
+				 * @brief  Свободное место в буфере передачи
+				 * @param  Нет
+				 * @retval Байт, которые MY_CONSOLE_Write() примет без потерь
+				 */
+				uint32_t MY_CONSOLE_GetFree(void);
+
+
+				/**
+				 * @brief  Ожидает передачи всего буфера, например перед сбросом
+				 * @param  Timeout: таймаут в мс
+				 * @retval MY_Result_Timeout - буфер не опустел за Timeout
+				 */
+				MY_Result_t MY_CONSOLE_Flush(uint32_t Timeout);
+
+
+				/**
+				 * @brief  Статистика вывода
+				 * @param  *Stats: копия статистики
+				 * @retval Нет
+				 */
+				void MY_CONSOLE_GetStats(MY_CONSOLE_Stats_t *Stats);
+
+
+				/**
+				 * @brief  Обработчик прерывания USART1. Вызывается из USART1_IRQHandler
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_CONSOLE_IRQHandler(void);
+
+			/**
+			 * @} MY_CONSOLE_Functions
+			 */
+
+		/**
+		 * @} MY_CONSOLE
+		 */
+
+	/**
+	 * @} MY_STM32F0xx_Libraries
+	 */
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		}
+	#endif
+
+#endif
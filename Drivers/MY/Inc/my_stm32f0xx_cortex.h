@@ -42,6 +42,22 @@
 					#define	TICK_INT_PRIORITY           ((uint32_t)(1U<<__NVIC_PRIO_BITS) - 1U)
 				#endif
 
+				/*!< Минимальный интервал простоя в тиках, при котором SysTick перепрограммируется на длинный сон.
+				 *   При меньшем интервале MY_SysTick_Tickless_Idle() выполняет обычный WFI до следующего тика */
+				#ifndef		SYSTICK_TICKLESS_MIN_IDLE
+					#define	SYSTICK_TICKLESS_MIN_IDLE	2U
+				#endif
+
+				#if (SYSTICK_TICKLESS_MIN_IDLE < 2U)
+					#error "my_stm32f0xx_cortex.h: SYSTICK_TICKLESS_MIN_IDLE must be at least 2"
+				#endif
+
+				/*!< Таблица векторов в начале SRAM (переназначение памяти SYSCFG, в Cortex-M0 нет VTOR).
+				 *   Позволяет устанавливать обработчики прерываний во время работы через MY_NVIC_SetVector() */
+				#ifndef		NVIC_VECTORS_IN_RAM
+					#define	NVIC_VECTORS_IN_RAM			0U
+				#endif
+
 			/**
 			 * @} MY_CORTEX_Settings
 			 */
@@ -66,6 +82,9 @@
 				/* Маска ID */
 				#define IDCODE_DEVID_MASK    (0x00000FFFU)
 
+				/* Количество векторов: 16 исключений ядра и 32 прерывания периферии */
+				#define MY_NVIC_VECTORS_COUNT			(16U + 32U)
+
 			/**
 			 * @} MY_CORTEX_Defines
 			 */
@@ -77,6 +96,13 @@
 			 * @{
 			 */
 
+				/**
+				 * @brief  Сравнение 32-битных отметок времени с учётом переполнения (разность меньше 2^31)
+				 * @retval 1 - отметка __A__ позже __B__
+				 */
+				#define MY_TIME_AFTER(__A__, __B__)				((int32_t)((uint32_t)(__A__) - (uint32_t)(__B__)) > 0)
+				#define MY_TIME_AFTER_EQ(__A__, __B__)			((int32_t)((uint32_t)(__A__) - (uint32_t)(__B__)) >= 0)
+
 			/**
 			 * @}  MY_CORTEX_Macros
 			 */
@@ -87,6 +113,10 @@
 			 * @brief    Typedefs для библиотеки
 			 * @{
 			 */
+				/**
+				 * @brief  Обработчик прерывания в таблице векторов
+				 */
+				typedef void (*MY_NVIC_Handler_t)(void);
 
 			/**
 			 * @} MY_CORTEX_Typedefs
@@ -132,14 +162,65 @@
 				 * @note 	Каждый раз когда срабатывает прерывания в Systick - функция прибавляет значение на единицу
 				 * @retval Нет
 				 */
-				void MY_SysTick_IncTick(void);
+				MY_RAMFUNC void MY_SysTick_IncTick(void);
 
 
 				/**
 				 * @brief  Возвращает значение тиков из глобальной переменной
 				 * @retval Значение "uwTick"
 				 */
-				uint32_t MY_SysTick_GetTick(void);
+				MY_RAMFUNC uint32_t MY_SysTick_GetTick(void);
+
+
+				/**
+				 * @brief  Возвращает 64-битный монотонный счётчик тиков (мс), не переполняется за время работы
+				 * @note   На Cortex-M0 нет LDREXD, поэтому чтение выполняется по счётчику последовательности:
+				 * 		   при обновлении счётчика в прерывании во время чтения чтение повторяется.
+				 * 		   Можно вызывать из прерываний и при запрещённых прерываниях.
+				 * @retval Количество тиков с момента запуска
+				 */
+				uint64_t MY_SysTick_GetTick64(void);
+
+
+				/**
+				 * @brief  Возвращает время с момента запуска в мкс
+				 * @note   Дробная часть тика вычисляется по текущему значению счётчика SysTick
+				 * @retval Время в мкс
+				 */
+				uint64_t MY_SysTick_GetMicros(void);
+
+
+				/**
+				 * @brief  Возвращает число тактов счётчика SysTick с момента запуска
+				 * @note   Тики и значение счётчика берутся из того же снимка, что и в MY_SysTick_GetMicros():
+				 * 		   перезагрузка счётчика с необработанным прерыванием учитывается по PENDSTSET
+				 * @retval Такты HCLK (при тактировании SysTick от HCLK)
+				 */
+				uint64_t MY_SysTick_GetCycles(void);
+
+
+				/**
+				 * @brief  Вычисляет срок, наступающий через TimeoutUs мкс
+				 * @param  TimeoutUs: интервал в мкс
+				 * @retval Срок в мкс по шкале MY_SysTick_GetMicros()
+				 */
+				uint64_t MY_SysTick_Deadline(uint32_t TimeoutUs);
+
+
+				/**
+				 * @brief  Проверяет, наступил ли срок
+				 * @param  Deadline: срок, полученный от MY_SysTick_Deadline()
+				 * @retval 1 - срок наступил, 0 - нет
+				 */
+				uint8_t MY_SysTick_Deadline_Expired(uint64_t Deadline);
+
+
+				/**
+				 * @brief  Время, оставшееся до срока
+				 * @param  Deadline: срок, полученный от MY_SysTick_Deadline()
+				 * @retval Оставшееся время в мкс, 0 - срок наступил
+				 */
+				uint32_t MY_SysTick_Deadline_Remaining(uint64_t Deadline);
 
 
 				/**
@@ -158,6 +239,21 @@
 				void MY_SysTick_ResumeTick(void);
 
 
+				/**
+				 * @brief 	Простой без периодических прерываний SysTick (tickless idle)
+				 * @note 	SysTick перепрограммируется так, чтобы следующее прерывание пришло через IdleTicks тиков,
+				 * 			затем ядро уходит в WFI. После пробуждения (по SysTick или любому другому прерыванию)
+				 * 			uwTick увеличивается на число полностью прошедших тиков по остатку счётчика,
+				 * 			а SysTick возвращается к периоду 1 мс с сохранением фазы. MY_SysTick_GetTick() остаётся монотонным.
+				 * @note 	Интервал ограничен 24-битным счётчиком SysTick: около 349 мс при HCLK = 48 МГц.
+				 * 			Срок обычно передаёт MY_PWR_Enter(): минимум из срока приложения и источников
+				 * 			MY_PWR_Deadline_Register() (опрос кнопок, таймауты задач ОС)
+				 * @param 	IdleTicks: время до ближайшего срока в тиках (мс)
+				 * @retval 	Количество тиков, добавленных к uwTick при компенсации
+				 */
+				uint32_t MY_SysTick_Tickless_Idle(uint32_t IdleTicks);
+
+
 				/* ###################################################### Функции работы с прерываниями ###################################################### */
 
 				/**
@@ -235,6 +331,35 @@
 				void MY_NVIC_SystemReset(void);
 
 
+				/**
+				 * @brief  Копирует таблицу векторов из Flash в начало SRAM и переназначает на неё адрес 0x00000000
+				 * @note   Вызывается из MY_System_Init() при NVIC_VECTORS_IN_RAM = 1. Таблица размещается
+				 * 		   в секции .ram_vector, которая в линкер-скрипте стоит первой в RAM
+				 * @retval @arg MY_Result_Ok    - таблица перенесена
+				 * 		   @arg MY_Result_Error - NVIC_VECTORS_IN_RAM = 0
+				 */
+				MY_Result_t MY_NVIC_Vectors_Relocate(void);
+
+
+				/**
+				 * @brief  Устанавливает обработчик прерывания в таблицу векторов в SRAM
+				 * @note   Ядро берёт адрес прямо из таблицы - промежуточного диспетчера нет
+				 * @param  IRQn - номер прерывания или исключения (SysTick_IRQn, PendSV_IRQn и т.д.)
+				 * @param  Handler - обработчик
+				 * @retval @arg MY_Result_Ok    - обработчик установлен
+				 * 		   @arg MY_Result_Error - таблица не перенесена в SRAM или неверный номер
+				 */
+				MY_Result_t MY_NVIC_SetVector(IRQn_Type IRQn, MY_NVIC_Handler_t Handler);
+
+
+				/**
+				 * @brief  Возвращает текущий обработчик прерывания из действующей таблицы векторов
+				 * @param  IRQn - номер прерывания или исключения
+				 * @retval Обработчик или NULL для неверного номера
+				 */
+				MY_NVIC_Handler_t MY_NVIC_GetVector(IRQn_Type IRQn);
+
+
 				/* ###################################################### Функции работы с ID микроконтроллера ###################################################### */
 
 				/**
@@ -81,7 +81,8 @@
 
 
 				/**
-				 * @brief  Конфигурирует пины кнопки как input
+				 * @brief  Конфигурирует пины кнопки как input и регистрирует её в MY_BUTTON
+				 * @note   События формируются в MY_BUTTON_Tick(), который вызывается из SysTick_Handler
 				 * @param  Нет
 				 * @retval Нет
 				 */
@@ -149,6 +150,7 @@
 				 * @retval Значение срабатывающее при нажатии
 				 *           - 0: Если эта кнопка уже нажата при последнем вызове или еще не нажата
 				 *           - 1: Произошло событие: кнопка была нажата
+				 * @note   Нажатие фиксируется после подавления дребезга, независимо от MY_DISCO_ButtonOnReleased()
 				 */
 				uint8_t MY_DISCO_ButtonOnPressed(void);
 
@@ -70,24 +70,94 @@
    	     (+) Используя функцию MY_DMA_Start_IT() запускается передача DMA после настройки
           	 Source address и Destination address  и длину передаваемых данных.
 
-   	     (+) Используем обработчик прерывания через вызов MY_DMA_Channel_IRQHandler() в DMA_IRQHandler()
+   	     (+) Используем обработчик прерывания через вызов MY_DMA_IRQ_Dispatch() в DMA1_CHx_IRQHandler().
+   	     	 Каналы 2-3 и 4-5 делят один вектор, MY_DMA_IRQ_Dispatch() обслуживает все каналы вектора
 
    	     (+) At the end of data transfer MY_DMA_IRQHandler() function is executed and user can
           	 add his own function by customization of function pointer XferCpltCallback and
           	 XferErrorCallback (i.e a member of DMA handle structure).
 
+   	     ==============================================================================
+                        		##### Circular mode #####
+   	     ==============================================================================
+
+   	     (+) В режиме DMA_MODE_CIRCULAR передача не завершается: после заполнения первой половины
+   	     	 буфера вызывается XferHalfCpltCallback, после второй - XferCpltCallback, и DMA продолжает
+   	     	 с начала. Пока DMA заполняет одну половину, приложение обрабатывает другую (двойная буферизация).
+   	     	 Остановка - MY_DMA_Abort().
+
+   	     (+) Пока передача идёт, менеджер питания не переводит ядро в Stop (ограничение регистрируется
+   	     	 в MY_DMA_Init())
+
+   	     ==============================================================================
+                        		##### Копирование и заполнение памяти #####
+   	     ==============================================================================
+
+   	     (+) MY_DMA_Memcpy()/MY_DMA_Memset() - синхронные, MY_DMA_Memcpy_IT()/MY_DMA_Memset_IT() -
+   	     	 с вызовом Callback по завершении. Используется канал DMA_MEM_CHANNEL в режиме memory-to-memory,
+   	     	 источником может быть и Flash (копирование ресурсов в RAM).
+
+   	     (+) Невыровненные начало и конец обрабатывает процессор, середину - DMA словами. Если адреса
+   	     	 источника и приёмника по-разному выровнены, DMA передаёт полуслова или байты.
+
+   	     (+) Выбор между процессором и DMA по размеру:
+   	     	 - newlib-nano memcpy/memset на Cortex-M0 - побайтовый цикл, около 7 тактов на байт;
+   	     	 - DMA memory-to-memory: чтение и запись по AHB, около 5 тактов на передачу (слово, полуслово
+   	     	   или байт), то есть ~1.25 такта на байт при передаче словами;
+   	     	 - настройка канала и ожидание TCIF - около 150 тактов.
+   	     	 Расчётная точка равновесия для слов - около 30 байт (DMA_MEM_THRESHOLD = 32), для байтовых передач
+   	     	 выигрыш 2 такта на байт окупается после ~75 байт, с запасом на нестабильность -
+   	     	 DMA_MEM_THRESHOLD_UNALIGNED = 256. Асинхронный вариант освобождает процессор полностью,
+   	     	 но добавляет вход в прерывание. Фактическое значение для своей сборки (оптимизация,
+   	     	 задержка Flash, конкуренция на шине) измеряет MY_DMA_Mem_Crossover().
+
+   	     (+) Если канал занят асинхронной операцией, синхронные функции копируют процессором,
+   	     	 асинхронные возвращают MY_Result_Busy. Копии меньше порога асинхронные функции выполняют
+   	     	 процессором и вызывают Callback до возврата.
+
 		 * @{
 		 */
 
 			/* Подключаем основные файлы библиотек и настройки проекта */
 			#include "main.h"
 			#include "my_stm32f0xx.h"
+			#include "my_stm32f0xx_lock.h"
 
 			/**
 			 * @defgroup MY_DMA_Settings
 			 * @brief    Библиотечные настройки
 			 * @{
 			 */
+				/*!< Таймаут блокировки структуры канала, мс */
+				#ifndef DMA_TIMEOUT_BUSY
+					#define DMA_TIMEOUT_BUSY					25U
+				#endif
+
+				/*!< Канал для MY_DMA_Memcpy()/MY_DMA_Memset(). Канал 5 на F051 не занят ADC, SPI1, USART1 и I2C1 */
+				#ifndef DMA_MEM_CHANNEL
+					#define DMA_MEM_CHANNEL						DMA1_Channel5
+				#endif
+
+				/*!< Приоритет канала копирования */
+				#ifndef DMA_MEM_PRIORITY
+					#define DMA_MEM_PRIORITY					DMA_PRIORITY_LOW
+				#endif
+
+				/*!< Минимальный размер в байтах для копирования DMA при одинаковом выравнивании по слову.
+				 *   Оценка по тактам, а не замер: значение для своей сборки возвращает MY_DMA_Mem_Crossover() */
+				#ifndef DMA_MEM_THRESHOLD
+					#define DMA_MEM_THRESHOLD					32U
+				#endif
+
+				/*!< Минимальный размер в байтах для копирования DMA полусловами или байтами (оценка с запасом) */
+				#ifndef DMA_MEM_THRESHOLD_UNALIGNED
+					#define DMA_MEM_THRESHOLD_UNALIGNED			256U
+				#endif
+
+				/*!< Таймаут синхронного копирования, мс */
+				#ifndef DMA_MEM_TIMEOUT
+					#define DMA_MEM_TIMEOUT						10U
+				#endif
 
 			/**
 			 * @} MY_DMA_Settings
@@ -151,6 +221,26 @@
 				#define DMA_PRIORITY_MEDIUM          ((uint32_t)DMA_CCR_PL_0)  				/*!< Priority level : Medium    */
 				#define DMA_PRIORITY_HIGH            ((uint32_t)DMA_CCR_PL_1)  				/*!< Priority level : High      */
 				#define DMA_PRIORITY_VERY_HIGH       ((uint32_t)DMA_CCR_PL)    				/*!< Priority level : Very_High */
+
+
+				/**
+				 * @brief DMA Error Code
+				 */
+				#define DMA_ERROR_NONE               (0x00000000U)    						/*!< No error             */
+				#define DMA_ERROR_TE                 (0x00000001U)    						/*!< Transfer error       */
+				#define DMA_ERROR_NO_XFER            (0x00000004U)    						/*!< No transfer ongoing  */
+				#define DMA_ERROR_TIMEOUT            (0x00000020U)    						/*!< Timeout error        */
+				#define DMA_ERROR_NOT_SUPPORTED      (0x00000100U)    						/*!< Not supported mode   */
+
+
+				/**
+				 * @brief Количество каналов DMA1 и флаги одного канала в DMA_ISR/DMA_IFCR
+				 */
+				#define DMA_CHANNELS                 5U
+				#define DMA_FLAG_GL                  (0x00000001U)    						/*!< Global interrupt flag  */
+				#define DMA_FLAG_TC                  (0x00000002U)    						/*!< Transfer complete flag */
+				#define DMA_FLAG_HT                  (0x00000004U)    						/*!< Half transfer flag     */
+				#define DMA_FLAG_TE                  (0x00000008U)    						/*!< Transfer error flag    */
 			/**
 			 * @} MY_DMA_Defines
 			 */
@@ -225,6 +315,46 @@
 															Этот параметр определяется в константах @ref DMA Priority level */
 				}
 				MY_DMA_Init_t;
+
+
+				/**
+				  * @brief  Структура канала DMA
+				  */
+				typedef struct MY_DMA_Handle_s
+				{
+					DMA_Channel_TypeDef		*Instance;					/*!< Регистры канала */
+
+					MY_DMA_Init_t			Init;						/*!< Параметры канала */
+
+					MY_Lock_t				Lock;						/*!< Блокировка структуры */
+
+					volatile MY_DMA_State_t	State;						/*!< Состояние канала */
+
+					volatile uint32_t		ErrorCode;					/*!< Код ошибки, @ref DMA Error Code */
+
+					uint32_t				ChannelIndex;				/*!< Сдвиг флагов канала в DMA_ISR/DMA_IFCR */
+
+					IRQn_Type				IRQn;						/*!< Вектор прерывания канала */
+
+					void					*Parent;					/*!< Драйвер периферии, использующий канал */
+
+					void (*XferCpltCallback)(struct MY_DMA_Handle_s *DMA_Handler);		/*!< Передача завершена */
+
+					void (*XferHalfCpltCallback)(struct MY_DMA_Handle_s *DMA_Handler);	/*!< Передана половина данных */
+
+					void (*XferErrorCallback)(struct MY_DMA_Handle_s *DMA_Handler);		/*!< Ошибка передачи */
+
+					void (*XferAbortCallback)(struct MY_DMA_Handle_s *DMA_Handler);		/*!< Передача прервана MY_DMA_Abort() */
+				}
+				MY_DMA_Handle_t;
+
+
+				/**
+				  * @brief  Завершение асинхронного копирования или заполнения
+				  * @param  Result: MY_Result_Ok или MY_Result_Error при ошибке передачи
+				  * @param  Context: значение, переданное при запуске
+				  */
+				typedef void (*MY_DMA_Mem_Callback_t)(MY_Result_t Result, void *Context);
 			/**
 			 * @} MY_DMA_Typedefs
 			 */
@@ -235,8 +365,181 @@
 			 * @brief    Функции используемые в библиотеке
 			 * @{
 			 */
+				/**
+				 * @brief  Возвращает структуру канала DMA
+				 * @param  Channel: DMA1_Channel1 ... DMA1_Channel5
+				 * @retval Указатель на структуру или 0 для неизвестного канала
+				 */
+				MY_DMA_Handle_t* MY_DMA_GetHandler(DMA_Channel_TypeDef *Channel);
+
+
+				/**
+				 * @brief  Инициализация канала DMA
+				 * @note   Включает тактирование DMA1, сбрасывает флаги и callback-функции канала
+				 * @param  Channel: DMA1_Channel1 ... DMA1_Channel5
+				 * @param  *Init: параметры канала
+				 * @retval @arg MY_Result_Ok    - канал настроен
+				 * 		   @arg MY_Result_Busy  - идёт передача
+				 * 		   @arg MY_Result_Error - неизвестный канал или circular в режиме memory-to-memory
+				 */
+				MY_Result_t MY_DMA_Init(DMA_Channel_TypeDef *Channel, MY_DMA_Init_t *Init);
+
+
+				/**
+				 * @brief  Сброс канала DMA в исходное состояние
+				 * @param  *DMA_Handler: структура канала
+				 * @retval MY_Result_t
+				 */
+				MY_Result_t MY_DMA_DeInit(MY_DMA_Handle_t *DMA_Handler);
+
+
+				/**
+				 * @brief  Запуск передачи без прерываний
+				 * @param  *DMA_Handler: структура канала
+				 * @param  SrcAddress: адрес источника
+				 * @param  DstAddress: адрес приёмника
+				 * @param  DataLength: количество элементов данных (1..65535)
+				 * @retval MY_Result_t
+				 */
+				MY_Result_t MY_DMA_Start(MY_DMA_Handle_t *DMA_Handler, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength);
 
 
+				/**
+				 * @brief  Запуск передачи с прерываниями TC и TE, HT - если задан XferHalfCpltCallback
+				 * @param  *DMA_Handler: структура канала
+				 * @param  SrcAddress: адрес источника
+				 * @param  DstAddress: адрес приёмника
+				 * @param  DataLength: количество элементов данных (1..65535)
+				 * @retval MY_Result_t
+				 */
+				MY_Result_t MY_DMA_Start_IT(MY_DMA_Handle_t *DMA_Handler, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength);
+
+
+				/**
+				 * @brief  Ожидание завершения передачи или её половины
+				 * @note   В режиме circular ожидание полной передачи не поддерживается
+				 * @param  *DMA_Handler: структура канала
+				 * @param  CompleteLevel: @ref MY_DMA_LevelComplete_t
+				 * @param  Timeout: таймаут в мс
+				 * @retval MY_Result_t
+				 */
+				MY_Result_t MY_DMA_PollForTransfer(MY_DMA_Handle_t *DMA_Handler, MY_DMA_LevelComplete_t CompleteLevel, uint32_t Timeout);
+
+
+				/**
+				 * @brief  Остановка передачи. Вызывает XferAbortCallback, если он задан
+				 * @param  *DMA_Handler: структура канала
+				 * @retval @arg MY_Result_Ok    - передача остановлена
+				 * 		   @arg MY_Result_Error - передача не выполнялась (DMA_ERROR_NO_XFER)
+				 */
+				MY_Result_t MY_DMA_Abort(MY_DMA_Handle_t *DMA_Handler);
+
+
+				/**
+				 * @brief  Обработка прерывания одного канала
+				 * @param  *DMA_Handler: структура канала
+				 * @retval Нет
+				 */
+				void MY_DMA_IRQHandler(MY_DMA_Handle_t *DMA_Handler);
+
+
+				/**
+				 * @brief  Обработка прерывания всех каналов, подключённых к вектору
+				 * @param  IRQn: DMA1_Channel1_IRQn, DMA1_Channel2_3_IRQn или DMA1_Channel4_5_IRQn
+				 * @retval Нет
+				 */
+				void MY_DMA_IRQ_Dispatch(IRQn_Type IRQn);
+
+
+				/**
+				 * @brief  Оставшееся количество элементов передачи (регистр CNDTR)
+				 * @param  *DMA_Handler: структура канала
+				 * @retval Количество элементов
+				 */
+				uint32_t MY_DMA_GetCounter(MY_DMA_Handle_t *DMA_Handler);
+
+
+				/**
+				 * @brief  Текущее состояние канала
+				 * @param  *DMA_Handler: структура канала
+				 * @retval @ref MY_DMA_State_t
+				 */
+				MY_DMA_State_t MY_DMA_GetState(MY_DMA_Handle_t *DMA_Handler);
+
+
+				/**
+				 * @brief  Код последней ошибки
+				 * @param  *DMA_Handler: структура канала
+				 * @retval @ref DMA Error Code
+				 */
+				uint32_t MY_DMA_GetError(MY_DMA_Handle_t *DMA_Handler);
+
+
+				/**
+				 * @brief  Копирование памяти с ожиданием завершения
+				 * @param  *Dst: приёмник (RAM)
+				 * @param  *Src: источник (RAM или Flash)
+				 * @param  Size: размер в байтах
+				 * @retval MY_Result_t
+				 */
+				MY_Result_t MY_DMA_Memcpy(void *Dst, const void *Src, uint32_t Size);
+
+
+				/**
+				 * @brief  Заполнение памяти значением с ожиданием завершения
+				 * @param  *Dst: приёмник (RAM)
+				 * @param  Value: значение байта
+				 * @param  Size: размер в байтах
+				 * @retval MY_Result_t
+				 */
+				MY_Result_t MY_DMA_Memset(void *Dst, uint8_t Value, uint32_t Size);
+
+
+				/**
+				 * @brief  Копирование памяти без ожидания
+				 * @note   Буферы должны оставаться действительными до вызова Callback. Callback вызывается из прерывания DMA
+				 * @param  *Dst: приёмник (RAM)
+				 * @param  *Src: источник (RAM или Flash)
+				 * @param  Size: размер в байтах
+				 * @param  Callback: функция завершения или NULL
+				 * @param  *Context: параметр для Callback
+				 * @retval @arg MY_Result_Ok   - копирование запущено или выполнено
+				 * 		   @arg MY_Result_Busy - канал занят
+				 */
+				MY_Result_t MY_DMA_Memcpy_IT(void *Dst, const void *Src, uint32_t Size, MY_DMA_Mem_Callback_t Callback, void *Context);
+
+
+				/**
+				 * @brief  Заполнение памяти без ожидания
+				 * @param  *Dst: приёмник (RAM)
+				 * @param  Value: значение байта
+				 * @param  Size: размер в байтах
+				 * @param  Callback: функция завершения или NULL
+				 * @param  *Context: параметр для Callback
+				 * @retval @arg MY_Result_Ok   - заполнение запущено или выполнено
+				 * 		   @arg MY_Result_Busy - канал занят
+				 */
+				MY_Result_t MY_DMA_Memset_IT(void *Dst, uint8_t Value, uint32_t Size, MY_DMA_Mem_Callback_t Callback, void *Context);
+
+
+				/**
+				 * @brief  Асинхронная операция копирования ещё выполняется
+				 * @param  Нет
+				 * @retval 1 - канал DMA_MEM_CHANNEL занят
+				 */
+				uint8_t MY_DMA_Mem_IsBusy(void);
+
+
+				/**
+				 * @brief  Измерение точки равновесия между memcpy() и DMA на целевой системе
+				 * @note   Копирует первую половину буфера во вторую размерами 4, 8, 16 ... байт процессором
+				 * 		   и DMA словами, такты считает SysTick. Выполняется при запрещённых прерываниях
+				 * @param  *Buffer: буфер, выровненный по слову
+				 * @param  Size: размер буфера в байтах
+				 * @retval Наименьший размер в байтах, при котором DMA быстрее, 0 - не быстрее ни на одном размере
+				 */
+				uint32_t MY_DMA_Mem_Crossover(uint8_t *Buffer, uint32_t Size);
+
 
 			/**
 			 * @} MY_DMA_Functions
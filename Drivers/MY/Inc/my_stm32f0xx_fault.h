@@ -0,0 +1,170 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/fault
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Сохранение состояния ядра при HardFault
+ */
+
+#ifndef MY_STM32F0xx_FAULT_H
+	#define MY_STM32F0xx_FAULT_H 100
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		extern "C"
+		{
+	#endif
+
+	/**
+	 * @addtogroup MY_STM32F0xx_Libraries
+	 * @{
+	 */
+
+		/**
+		 * @defgroup MY_FAULT
+		 * @brief    Запись аварийного состояния
+		 *
+		 * 	HardFault_Handler (interrupt_handlers.c) определяет, какой стек использовался в момент сбоя
+		 * 	(бит 2 EXC_RETURN: MSP или PSP), и передаёт указатель на сохранённый ядром кадр в MY_FAULT_HardFault().
+		 * 	Кадр (R0-R3, R12, LR, PC, xPSR), EXC_RETURN, SP, время работы и часть стека над кадром
+		 * 	записываются в секцию .noinit, которую startup не обнуляет, после чего выполняется сброс.
+		 *
+		 * 	После перезапуска запись доступна через MY_FAULT_GetLast(), MY_FAULT_Dump() выводит её
+		 * 	в формате, который разбирает Tools/fault_decode.py (адреса сопоставляются с символами ELF).
+		 *	@{
+		 */
+
+			/* Подключаем основные файлы библиотек и настройки проекта */
+			#include "main.h"
+			#include "my_stm32f0xx.h"
+
+			/**
+			 * @defgroup MY_FAULT_Settings
+			 * @brief    Библиотечные настройки
+			 * @{
+			 */
+				/*!< Количество слов стека над кадром исключения, сохраняемых в запись */
+				#ifndef FAULT_STACK_WORDS
+					#define FAULT_STACK_WORDS					16U
+				#endif
+
+			/**
+			 * @} MY_FAULT_Settings
+			 */
+
+
+			/**
+			 * @defgroup MY_FAULT_Defines
+			 * @brief    Библиотечные константы
+			 * @{
+			 */
+				/*!< Признак действительной записи */
+				#define FAULT_RECORD_MAGIC						0xFA017EC0U
+
+			/**
+			 * @} MY_FAULT_Defines
+			 */
+
+
+			/**
+			 * @defgroup MY_FAULT_Macros
+			 * @brief    Библиотечные макросы
+			 * @{
+			 */
+
+			/**
+			 * @}  MY_FAULT_Macros
+			 */
+
+
+			/**
+			 * @defgroup MY_FAULT_Typedefs
+			 * @brief    Typedefs для библиотеки
+			 * @{
+			 */
+				/**
+				 * @brief  Запись о сбое в памяти .noinit
+				 */
+				typedef struct
+				{
+					uint32_t Magic;							/*!< FAULT_RECORD_MAGIC - запись действительна */
+					uint32_t Count;							/*!< Количество сбоев с момента включения питания */
+					uint32_t R0;							/*!< Регистры из кадра исключения */
+					uint32_t R1;
+					uint32_t R2;
+					uint32_t R3;
+					uint32_t R12;
+					uint32_t LR;
+					uint32_t PC;							/*!< Адрес инструкции, вызвавшей сбой */
+					uint32_t xPSR;
+					uint32_t ExcReturn;						/*!< EXC_RETURN: режим и используемый стек */
+					uint32_t SP;							/*!< Указатель на кадр исключения */
+					uint32_t Uptime;						/*!< Время работы до сбоя, мс */
+					uint32_t StackWords;					/*!< Количество сохранённых слов стека */
+					uint32_t Stack[FAULT_STACK_WORDS];		/*!< Стек над кадром исключения */
+					uint32_t Checksum;						/*!< Контрольная сумма предыдущих полей */
+				}
+				MY_FAULT_Record_t;
+
+			/**
+			 * @} MY_FAULT_Typedefs
+			 */
+
+
+			/**
+			 * @defgroup MY_FAULT_Functions
+			 * @brief    Функции используемые в библиотеке
+			 * @{
+			 */
+				/**
+				 * @brief  Сохраняет запись о сбое и перезапускает МК
+				 * @note   Вызывается только из ассемблерной вставки HardFault_Handler: used сохраняет функцию при LTO
+				 * @param  *Frame: кадр исключения на стеке (MSP или PSP)
+				 * @param  ExcReturn: значение LR при входе в обработчик
+				 * @retval Нет
+				 */
+				void MY_FAULT_HardFault(uint32_t *Frame, uint32_t ExcReturn) __attribute__((noreturn, used));
+
+
+				/**
+				 * @brief  Возвращает запись о последнем сбое
+				 * @param  Нет
+				 * @retval Указатель на запись или NULL, если сбоев не было или запись повреждена
+				 */
+				const MY_FAULT_Record_t* MY_FAULT_GetLast(void);
+
+
+				/**
+				 * @brief  Помечает запись как прочитанную, счётчик сбоев сохраняется
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_FAULT_Clear(void);
+
+
+				/**
+				 * @brief  Выводит запись о последнем сбое через printf() для Tools/fault_decode.py
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_FAULT_Dump(void);
+
+			/**
+			 * @} MY_FAULT_Functions
+			 */
+
+		/**
+		 * @} MY_FAULT
+		 */
+
+	/**
+	 * @} MY_STM32F0xx_Libraries
+	 */
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		}
+	#endif
+
+#endif
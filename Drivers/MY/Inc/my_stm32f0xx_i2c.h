@@ -291,6 +291,8 @@
 			#include "main.h"
 			#include "my_stm32f0xx.h"
 			#include "my_stm32f0xx_gpio.h"
+			#include "my_stm32f0xx_lock.h"
+			#include "my_stm32f0xx_pt.h"
 
 			/**
 			 * @defgroup MY_I2C_Settings
@@ -488,6 +490,9 @@
 				#define MY_I2C_RESET_CR2(I2CX)                 			((I2CX)->CR2 &= (uint32_t)~((uint32_t)(I2C_CR2_SADD | I2C_CR2_HEAD10R | I2C_CR2_NBYTES | I2C_CR2_RELOAD | I2C_CR2_RD_WRN)))
 
 
+				/* Запуск передачи-сопрограммы из сопрограммы __PT__ и ожидание её завершения, результат в (__CTX__)->Result */
+				#define MY_I2C_PT_AWAIT(__PT__, __CTX__, __CALL__)		MY_PT_SPAWN((__PT__), &(__CTX__)->PT, (__CALL__))
+
 			/**
 			 * @}  MY_I2C_Macros
 			 */
@@ -650,6 +655,8 @@
 
 			   __IO MY_I2C_State_t 		State;          	/*!< Статус передачи данных по I2C */
 
+			   __IO uint8_t				TimingPending;		/*!< Частота сменилась при занятом I2C: TIMINGR пересчитывается при разблокировке */
+
 			   __IO uint32_t       		ErrorCode;      	/*!< I2C Error code */
 
 			   __IO uint32_t       		PreviousState;  	/*!< I2C communication Previous state */
@@ -657,6 +664,20 @@
 				}
 				MY_I2C_Init_t;
 
+
+				/**
+				 * @brief  Контекст передачи I2C в сопрограмме
+				 */
+				typedef struct
+				{
+					MY_PT_t				PT;					/*!< Состояние сопрограммы */
+					uint8_t*			Data;				/*!< Текущая позиция в буфере */
+					uint16_t			Count;				/*!< Осталось передать байт */
+					uint8_t				Chunk;				/*!< Осталось байт в текущем NBYTES */
+					MY_Result_t			Result;				/*!< Результат после завершения */
+				}
+				MY_I2C_PT_t;
+
 			/**
 			 * @} MY_I2C_Typedefs
 			 */
@@ -683,6 +704,19 @@
 				MY_Result_t MY_I2C_Init(I2C_TypeDef* I2Cx);
 
 
+				/**
+				 * @brief  Вычисляет значение регистра TIMINGR
+				 * @note   Для 8 и 48 МГц используются проверенные табличные значения,
+				 * 		   для остальных частот - расчёт по минимальным временам из спецификации I2C.
+				 * 		   MY_I2C_Init() подписывает I2C на изменение частот RCC, и TIMINGR
+				 * 		   пересчитывается автоматически при смене тактирования.
+				 * @param  I2C_Clock - частота тактирования I2Cx, Гц
+				 * @param  ClockSpeed - требуемая частота шины I2C, Гц
+				 * @retval Значение для I2Cx->TIMINGR
+				 */
+				uint32_t MY_I2C_Timing_Calc(uint32_t I2C_Clock, uint32_t ClockSpeed);
+
+
 				/**
 				 * @brief  Функция проверят наличие устройства на шине I2C
 				 * @param  I2Cx - указатель на структуру I2Cx
@@ -749,7 +783,7 @@
 				MY_Result_t MY_I2C_Master_Receive(MY_I2C_Init_t *I2C_Handler, uint16_t DevAddress, uint8_t *pData, uint16_t Size, uint32_t Timeout);
 
 
-				MY_Result_t MY_I2C_WaitOnFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32_t Flag, FlagStatus Status, uint32_t Timeout, uint32_t Tickstart);
+				MY_RAMFUNC MY_Result_t MY_I2C_WaitOnFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32_t Flag, FlagStatus Status, uint32_t Timeout, uint32_t Tickstart);
 
 				/**
 				  * @brief  This function handles I2C Communication Timeout for specific usage of TXIS flag.
@@ -759,7 +793,7 @@
 				  * @param  Tickstart Tick start value
 				  * @retval HAL status
 				  */
-				MY_Result_t MY_I2C_WaitOnTXISFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32_t Timeout, uint32_t Tickstart);
+				MY_RAMFUNC MY_Result_t MY_I2C_WaitOnTXISFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32_t Timeout, uint32_t Tickstart);
 
 
 				/**
@@ -770,7 +804,7 @@
 				  * @param  Tickstart Tick start value
 				  * @retval HAL status
 				  */
-				MY_Result_t MY_I2C_IsAcknowledgeFailed(MY_I2C_Init_t *I2C_Handler, uint32_t Timeout, uint32_t Tickstart);
+				MY_RAMFUNC MY_Result_t MY_I2C_IsAcknowledgeFailed(MY_I2C_Init_t *I2C_Handler, uint32_t Timeout, uint32_t Tickstart);
 
 
 				/**
@@ -781,7 +815,7 @@
 				  * @param  Tickstart Tick start value
 				  * @retval HAL status
 				  */
-				MY_Result_t MY_I2C_WaitOnSTOPFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32_t Timeout, uint32_t Tickstart);
+				MY_RAMFUNC MY_Result_t MY_I2C_WaitOnSTOPFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32_t Timeout, uint32_t Tickstart);
 
 
 				void MY_I2C_Flush_TXDR(MY_I2C_Init_t *I2C_Handler);
@@ -794,7 +828,7 @@
 				  * @param  Tickstart Tick start value
 				  * @retval HAL status
 				  */
-				MY_Result_t MY_I2C_WaitOnRXNEFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32_t Timeout, uint32_t Tickstart);
+				MY_RAMFUNC MY_Result_t MY_I2C_WaitOnRXNEFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32_t Timeout, uint32_t Tickstart);
 
 				/**
 				  * @brief  Configure Noise Filters (Analog and Digital).
@@ -822,6 +856,36 @@
 				* @retval I2C Error Code
 				*/
 				uint32_t MY_I2C_GetError(MY_I2C_Init_t *I2C_Handler);
+
+
+				/**
+				 * @brief  Передача в режиме Master без блокировки суперцикла
+				 * @note   Вызывается повторно с теми же параметрами, пока не вернёт MY_PT_State_Ended.
+				 * 		   Параметры используются при первом вызове после MY_PT_INIT(&Ctx->PT).
+				 * 		   Ожидание занятого другим процессом I2C входит в таймаут
+				 * @param  *Ctx: контекст передачи, результат в Ctx->Result
+				 * @param  *I2C_Handler: структура I2C
+				 * @param  device_address: адрес устройства
+				 * @param  *pData: данные, буфер должен существовать до завершения
+				 * @param  size: количество байт
+				 * @param  timeout: таймаут в тиках
+				 * @retval Состояние сопрограммы @ref MY_PT_State_t
+				 */
+				MY_PT_State_t MY_I2C_PT_Master_Transmit(MY_I2C_PT_t *Ctx, MY_I2C_Init_t *I2C_Handler, uint16_t device_address, uint8_t *pData, uint16_t size, uint32_t timeout);
+
+
+				/**
+				 * @brief  Приём в режиме Master без блокировки суперцикла
+				 * @note   Правила вызова те же, что у MY_I2C_PT_Master_Transmit()
+				 * @param  *Ctx: контекст передачи, результат в Ctx->Result
+				 * @param  *I2C_Handler: структура I2C
+				 * @param  device_address: адрес устройства
+				 * @param  *pData: буфер приёма
+				 * @param  size: количество байт
+				 * @param  timeout: таймаут в тиках
+				 * @retval Состояние сопрограммы @ref MY_PT_State_t
+				 */
+				MY_PT_State_t MY_I2C_PT_Master_Receive(MY_I2C_PT_t *Ctx, MY_I2C_Init_t *I2C_Handler, uint16_t device_address, uint8_t *pData, uint16_t size, uint32_t timeout);
 			/**
 			 * @} MY_I2C_Functions
 			 */
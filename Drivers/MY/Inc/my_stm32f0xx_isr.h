@@ -0,0 +1,227 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/isr
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Статистика обработчиков прерываний: длительность, вложенность, задержка, загрузка
+ */
+
+#ifndef MY_STM32F0xx_ISR_H
+	#define MY_STM32F0xx_ISR_H 100
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		extern "C"
+		{
+	#endif
+
+	/**
+	 * @addtogroup MY_STM32F0xx_Libraries
+	 * @{
+	 */
+
+		/**
+		 * @defgroup MY_ISR
+		 * @brief    Инструментирование обработчиков прерываний
+		 *
+		 * 	Обработчик оборачивается макросами:
+		 * 		void SysTick_Handler(void)
+		 * 		{
+		 * 			MY_ISR_ENTER(SysTick_IRQn);
+		 * 			...
+		 * 			MY_ISR_EXIT(SysTick_IRQn);
+		 * 		}
+		 *
+		 * 	Для каждого IRQn при первом входе выделяется запись в компактной таблице (ISR_STATS_SLOTS записей):
+		 * 	количество вызовов, время последнего входа, собственная длительность (без вложенных
+		 * 	обработчиков) - максимум и сумма, максимальная глубина вложения.
+		 * 	Такты считаются по SysTick->VAL (такты HCLK, в Cortex-M0 нет DWT), поэтому отдельный
+		 * 	таймер не нужен. Обработчик должен выполняться меньше периода SysTick.
+		 *
+		 * 	Задержка входа измеряется для SysTick_IRQn: прерывание возникает при перезагрузке счётчика,
+		 * 	поэтому LOAD - VAL на входе - время от запроса до начала обработки. Её максимум показывает,
+		 * 	насколько долго прерывания бывают запрещены или заняты обработчиками с более высоким приоритетом.
+		 *
+		 * 	Загрузка процессора по каждому IRQn - доля суммы длительностей в окне с последнего MY_ISR_Reset().
+		 * 	MY_ISR_Dump() выводит таблицу через printf() в отладочную консоль.
+		 * 	NMI_Handler() не оборачивается: NMI не маскируется PRIMASK и может прервать MY_ISR_Enter()/
+		 * 	MY_ISR_Exit() посреди обновления записи или глубины вложения.
+		 * 	При ISR_STATS_ENABLE = 0 макросы пустые, функции не компилируются.
+		 *	@{
+		 */
+
+			/* Подключаем основные файлы библиотек и настройки проекта */
+			#include "main.h"
+			#include "my_stm32f0xx.h"
+
+			/**
+			 * @defgroup MY_ISR_Settings
+			 * @brief    Библиотечные настройки
+			 * @{
+			 */
+				/*!< Включение статистики прерываний */
+				#ifndef ISR_STATS_ENABLE
+					#define ISR_STATS_ENABLE					0U
+				#endif
+
+				/*!< Количество отслеживаемых IRQn */
+				#ifndef ISR_STATS_SLOTS
+					#define ISR_STATS_SLOTS						8U
+				#endif
+
+				/*!< Максимальная учитываемая глубина вложения */
+				#ifndef ISR_STATS_NEST_MAX
+					#define ISR_STATS_NEST_MAX					4U
+				#endif
+
+			/**
+			 * @} MY_ISR_Settings
+			 */
+
+
+			/**
+			 * @defgroup MY_ISR_Defines
+			 * @brief    Библиотечные константы
+			 * @{
+			 */
+				/*!< Количество исключений и прерываний (от NonMaskableInt_IRQn = -14 до последнего IRQn = 31) */
+				#define ISR_STATS_VECTORS						48U
+
+			/**
+			 * @} MY_ISR_Defines
+			 */
+
+
+			/**
+			 * @defgroup MY_ISR_Macros
+			 * @brief    Библиотечные макросы
+			 * @{
+			 */
+				#if (ISR_STATS_ENABLE == 1U)
+
+					/* Вход в обработчик: первая строка обработчика */
+					#define MY_ISR_ENTER(__IRQN__)						uint32_t MY_ISR_Start = MY_ISR_Enter(__IRQN__)
+
+					/* Выход из обработчика: последняя строка обработчика */
+					#define MY_ISR_EXIT(__IRQN__)						MY_ISR_Exit((__IRQN__), MY_ISR_Start)
+
+				#else
+
+					#define MY_ISR_ENTER(__IRQN__)						do { } while(0)
+					#define MY_ISR_EXIT(__IRQN__)						do { } while(0)
+
+				#endif
+
+			/**
+			 * @}  MY_ISR_Macros
+			 */
+
+
+			/**
+			 * @defgroup MY_ISR_Typedefs
+			 * @brief    Typedefs для библиотеки
+			 * @{
+			 */
+				/**
+				 * @brief  Статистика одного IRQn
+				 */
+				typedef struct
+				{
+					int8_t		IRQn;			/*!< Номер прерывания */
+					uint8_t		MaxDepth;		/*!< Максимальная глубина вложения при входе, 1 - без вложения */
+					uint32_t	Count;			/*!< Количество вызовов */
+					uint32_t	LastEntry;		/*!< Тик последнего входа */
+					uint32_t	Max;			/*!< Максимальная собственная длительность, такты */
+					uint64_t	Total;			/*!< Сумма собственных длительностей, такты */
+				}
+				MY_ISR_Stats_t;
+
+			/**
+			 * @} MY_ISR_Typedefs
+			 */
+
+
+			/**
+			 * @defgroup MY_ISR_Functions
+			 * @brief    Функции используемые в библиотеке
+			 * @{
+			 */
+				#if (ISR_STATS_ENABLE == 1U)
+
+					/**
+					 * @brief  Вход в обработчик. Вызывается из MY_ISR_ENTER
+					 * @param  IRQn: номер прерывания
+					 * @retval Отметка начала (SysTick->VAL)
+					 */
+					uint32_t MY_ISR_Enter(IRQn_Type IRQn);
+
+
+					/**
+					 * @brief  Выход из обработчика. Вызывается из MY_ISR_EXIT
+					 * @param  IRQn: номер прерывания
+					 * @param  Start: отметка начала
+					 * @retval Нет
+					 */
+					void MY_ISR_Exit(IRQn_Type IRQn, uint32_t Start);
+
+
+					/**
+					 * @brief  Статистика IRQn
+					 * @param  IRQn: номер прерывания
+					 * @retval Указатель на запись или NULL, если прерывание не вызывалось
+					 */
+					const MY_ISR_Stats_t* MY_ISR_GetStats(IRQn_Type IRQn);
+
+
+					/**
+					 * @brief  Максимальная задержка входа в SysTick_Handler
+					 * @param  Нет
+					 * @retval Такты HCLK
+					 */
+					uint32_t MY_ISR_GetMaxLatency(void);
+
+
+					/**
+					 * @brief  Загрузка процессора прерыванием в окне с последнего сброса
+					 * @param  IRQn: номер прерывания
+					 * @retval Сотые доли процента (10000 = 100 %)
+					 */
+					uint32_t MY_ISR_GetLoad(IRQn_Type IRQn);
+
+
+					/**
+					 * @brief  Сбрасывает статистику и начинает новое окно
+					 * @param  Нет
+					 * @retval Нет
+					 */
+					void MY_ISR_Reset(void);
+
+
+					/**
+					 * @brief  Выводит таблицу статистики через printf()
+					 * @param  Нет
+					 * @retval Нет
+					 */
+					void MY_ISR_Dump(void);
+
+				#endif
+
+			/**
+			 * @} MY_ISR_Functions
+			 */
+
+		/**
+		 * @} MY_ISR
+		 */
+
+	/**
+	 * @} MY_STM32F0xx_Libraries
+	 */
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		}
+	#endif
+
+#endif
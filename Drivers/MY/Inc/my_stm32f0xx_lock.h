@@ -0,0 +1,219 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/lock
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Блокировки и критические секции
+ */
+
+#ifndef MY_STM32F0xx_LOCK_H
+	#define MY_STM32F0xx_LOCK_H 100
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		extern "C"
+		{
+	#endif
+
+	/**
+	 * @addtogroup MY_STM32F0xx_Libraries
+	 * @{
+	 */
+
+		/**
+		 * @defgroup MY_LOCK
+		 * @brief    Блокировка доступа к структурам драйверов
+		 *
+		 * 	- Проверка и захват выполняются атомарно внутри критической секции (PRIMASK),
+		 * 	  поэтому обработчик прерывания не может захватить ту же блокировку между ними.
+		 * 	- Нулевое значение MY_Lock_t - свободная блокировка: статические структуры
+		 * 	  драйверов не требуют явной инициализации.
+		 * 	- MY_Lock_Acquire() ждёт освобождения не дольше Timeout. При USE_RTOS = 1 задача
+		 * 	  блокируется в MY_OS_Wait(), без ОС - ожидание в цикле. В обработчиках прерываний
+		 * 	  ожидание не выполняется: владелец не может продолжить работу, пока обработчик активен.
+		 * 	- При LOCK_OWNERSHIP = 1 запоминается владелец (задача ОС, номер исключения или main()):
+		 * 	  повторный захват владельцем и освобождение чужой блокировки возвращают MY_Result_Error.
+		 * 	- При LOCK_STATISTICS = 1 считаются захваты и конфликты.
+		 *
+		 * 	MY_Critical_Enter()/MY_Critical_Exit() допускают вложение: прерывания разрешаются
+		 * 	только при выходе из внешней секции и только если были разрешены при входе в неё.
+		 * 	Внутри критической секции нельзя вызывать функции, которые могут ожидать.
+		 *	@{
+		 */
+
+			/* Подключаем основные файлы библиотек и настройки проекта */
+			#include "main.h"
+			#include "my_stm32f0xx.h"
+
+			/**
+			 * @defgroup MY_LOCK_Settings
+			 * @brief    Библиотечные настройки
+			 * @{
+			 */
+				/*!< Контроль владельца блокировки */
+				#ifndef LOCK_OWNERSHIP
+					#define LOCK_OWNERSHIP						0U
+				#endif
+
+				/*!< Счётчики захватов и конфликтов */
+				#ifndef LOCK_STATISTICS
+					#define LOCK_STATISTICS						0U
+				#endif
+
+			/**
+			 * @} MY_LOCK_Settings
+			 */
+
+
+			/**
+			 * @defgroup MY_LOCK_Defines
+			 * @brief    Библиотечные константы
+			 * @{
+			 */
+				/*!< Владелец: блокировка свободна */
+				#define MY_LOCK_OWNER_NONE						0x00000000U
+
+				/*!< Владелец: основной поток без ОС */
+				#define MY_LOCK_OWNER_MAIN						0x00000100U
+
+			/**
+			 * @} MY_LOCK_Defines
+			 */
+
+
+			/**
+			 * @defgroup MY_LOCK_Macros
+			 * @brief    Библиотечные макросы
+			 * @{
+			 */
+
+			/**
+			 * @}  MY_LOCK_Macros
+			 */
+
+
+			/**
+			 * @defgroup MY_LOCK_Typedefs
+			 * @brief    Typedefs для библиотеки
+			 * @{
+			 */
+				/**
+				 * @brief 	Состояние блокировки
+				 */
+				typedef enum
+				{
+					MY_Lock_Off    = 0x00U, 	/*!< Разблокировано  */
+					MY_Lock_On     = 0x01U		/*!< Заблокировано  */
+				}
+				MY_Lock_State_t;
+
+
+				/**
+				 * @brief 	Блокировка доступа
+				 */
+				typedef struct
+				{
+					volatile uint8_t	State;			/*!< @ref MY_Lock_State_t */
+
+					#if (LOCK_OWNERSHIP == 1U)
+						volatile uint32_t	Owner;		/*!< Владелец или MY_LOCK_OWNER_NONE */
+					#endif
+
+					#if (LOCK_STATISTICS == 1U)
+						volatile uint32_t	Acquired;	/*!< Количество успешных захватов */
+						volatile uint32_t	Contended;	/*!< Количество захватов, заставших блокировку занятой */
+					#endif
+				}
+				MY_Lock_t;
+
+			/**
+			 * @} MY_LOCK_Typedefs
+			 */
+
+
+			/**
+			 * @defgroup MY_LOCK_Functions
+			 * @brief    Функции используемые в библиотеке
+			 * @{
+			 */
+				/**
+				 * @brief  Вход в критическую секцию с запретом прерываний, допускается вложение
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_Critical_Enter(void);
+
+
+				/**
+				 * @brief  Выход из критической секции
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_Critical_Exit(void);
+
+
+				/**
+				 * @brief  Инициализация блокировки в свободном состоянии
+				 * @param  *Lock: блокировка
+				 * @retval Нет
+				 */
+				void MY_Lock_Init(MY_Lock_t *Lock);
+
+
+				/**
+				 * @brief  Попытка захвата без ожидания
+				 * @param  *Lock: блокировка
+				 * @retval @arg MY_Result_Ok    - блокировка захвачена
+				 * 		   @arg MY_Result_Busy  - занята
+				 * 		   @arg MY_Result_Error - повторный захват владельцем (LOCK_OWNERSHIP = 1)
+				 */
+				MY_Result_t MY_Lock_TryAcquire(MY_Lock_t *Lock);
+
+
+				/**
+				 * @brief  Захват с ожиданием
+				 * @param  *Lock: блокировка
+				 * @param  Timeout: таймаут в тиках, 0 - без ожидания, MAX_DELAY - без ограничения
+				 * @retval @arg MY_Result_Ok      - блокировка захвачена
+				 * 		   @arg MY_Result_Busy    - занята, ожидание невозможно (Timeout = 0 или обработчик прерывания)
+				 * 		   @arg MY_Result_Timeout - не освободилась за Timeout
+				 * 		   @arg MY_Result_Error   - повторный захват владельцем (LOCK_OWNERSHIP = 1)
+				 */
+				MY_Result_t MY_Lock_Acquire(MY_Lock_t *Lock, uint32_t Timeout);
+
+
+				/**
+				 * @brief  Освобождение блокировки
+				 * @param  *Lock: блокировка
+				 * @retval @arg MY_Result_Ok    - освобождена
+				 * 		   @arg MY_Result_Error - не захвачена или захвачена другим владельцем (LOCK_OWNERSHIP = 1)
+				 */
+				MY_Result_t MY_Lock_Release(MY_Lock_t *Lock);
+
+
+				/**
+				 * @brief  Состояние блокировки
+				 * @param  *Lock: блокировка
+				 * @retval 1 - захвачена
+				 */
+				uint8_t MY_Lock_IsLocked(const MY_Lock_t *Lock);
+
+			/**
+			 * @} MY_LOCK_Functions
+			 */
+
+		/**
+		 * @} MY_LOCK
+		 */
+
+	/**
+	 * @} MY_STM32F0xx_Libraries
+	 */
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		}
+	#endif
+
+#endif
@@ -0,0 +1,215 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/log
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Отложенный двоичный журнал: строки формата только в ELF, форматирование на ПК
+ */
+
+#ifndef MY_STM32F0xx_LOG_H
+	#define MY_STM32F0xx_LOG_H 100
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		extern "C"
+		{
+	#endif
+
+	/**
+	 * @addtogroup MY_STM32F0xx_Libraries
+	 * @{
+	 */
+
+		/**
+		 * @defgroup MY_LOG
+		 * @brief    Журнал без printf() на МК
+		 *
+		 * 	MY_LOG("adc %u, t %d", value, temp) помещает строку формата в секцию .logstr, которая в скрипте
+		 * 	компоновщика объявлена как INFO: она есть только в ELF и не занимает Flash. Адрес строки в этой
+		 * 	секции (смещение от 0) - её номер. В ОЗУ записываются только слова:
+		 * 		заголовок (номер строки, количество аргументов, признак метки времени),
+		 * 		метка времени MY_SysTick_GetTick() при LOG_TIMESTAMP = 1,
+		 * 		до LOG_ARGS_MAX аргументов, приведённых к uint32_t.
+		 * 	Запись - несколько десятков тактов в короткой критической секции, поэтому MY_LOG() можно
+		 * 	вызывать из прерываний. При нехватке места запись отбрасывается целиком и учитывается.
+		 *
+		 * 	MY_LOG_Process() в суперцикле или задаче с низким приоритетом выводит записи через MY_CONSOLE
+		 * 	строками из шестнадцатеричных слов:
+		 * 		LOG 02000134 00001F40 00000C1A 00000019
+		 * 	Tools/log_decode.py находит строку формата в секции .logstr файла ELF и печатает текст,
+		 * 	остальные строки вывода консоли передаются без изменений.
+		 *
+		 * 	Поддерживаются целые аргументы: %d %i %u %x %X %o %c %p с модификаторами h, hh, l и шириной.
+		 * 	%s выводит только адрес строки, %f и 64-битные значения не поддерживаются.
+		 *	@{
+		 */
+
+			/* Подключаем основные файлы библиотек и настройки проекта */
+			#include "main.h"
+			#include "my_stm32f0xx.h"
+
+			/**
+			 * @defgroup MY_LOG_Settings
+			 * @brief    Библиотечные настройки
+			 * @{
+			 */
+				/*!< Журнал включён. При 0 вызовы MY_LOG() не генерируют кода */
+				#ifndef LOG_ENABLE
+					#define LOG_ENABLE							1U
+				#endif
+
+				/*!< Размер буфера в словах, степень двойки */
+				#ifndef LOG_BUFFER_WORDS
+					#define LOG_BUFFER_WORDS					64U
+				#endif
+
+				/*!< Метка времени в каждой записи */
+				#ifndef LOG_TIMESTAMP
+					#define LOG_TIMESTAMP						1U
+				#endif
+
+			/**
+			 * @} MY_LOG_Settings
+			 */
+
+
+			/**
+			 * @defgroup MY_LOG_Defines
+			 * @brief    Библиотечные константы
+			 * @{
+			 */
+				/*!< Наибольшее количество аргументов MY_LOG() */
+				#define LOG_ARGS_MAX							4U
+
+				/*!< Поля заголовка записи */
+				#define LOG_HEADER_ID_Msk						0x00FFFFFFU
+				#define LOG_HEADER_ARGS_Pos						24U
+				#define LOG_HEADER_TIMESTAMP					0x10000000U
+
+			/**
+			 * @} MY_LOG_Defines
+			 */
+
+
+			/**
+			 * @defgroup MY_LOG_Macros
+			 * @brief    Библиотечные макросы
+			 * @{
+			 */
+				/* Количество аргументов после строки формата, 0..4 */
+				#define MY_LOG_INT_NARGS(...)					MY_LOG_INT_NARGS_(0, ##__VA_ARGS__, 4, 3, 2, 1, 0)
+				#define MY_LOG_INT_NARGS_(_0, _1, _2, _3, _4, N, ...)	N
+
+				/* Выбор MY_LOG_WriteN по количеству аргументов */
+				#define MY_LOG_INT_CALL(N)						MY_LOG_INT_CALL_(N)
+				#define MY_LOG_INT_CALL_(N)						MY_LOG_Write##N
+
+				/* Аргументы, приведённые к слову */
+				#define MY_LOG_INT_ARG(__X__)					((uint32_t)(__X__))
+
+				/* ", (uint32_t)(a), (uint32_t)(b)..." для 0..4 аргументов */
+				#define MY_LOG_INT_MAP(...)						MY_LOG_INT_MAP_(MY_LOG_INT_NARGS(__VA_ARGS__), ##__VA_ARGS__)
+				#define MY_LOG_INT_MAP_(N, ...)					MY_LOG_INT_MAP__(N, ##__VA_ARGS__)
+				#define MY_LOG_INT_MAP__(N, ...)				MY_LOG_INT_MAP##N(__VA_ARGS__)
+				#define MY_LOG_INT_MAP0()
+				#define MY_LOG_INT_MAP1(a)						, MY_LOG_INT_ARG(a)
+				#define MY_LOG_INT_MAP2(a, b)					, MY_LOG_INT_ARG(a), MY_LOG_INT_ARG(b)
+				#define MY_LOG_INT_MAP3(a, b, c)				, MY_LOG_INT_ARG(a), MY_LOG_INT_ARG(b), MY_LOG_INT_ARG(c)
+				#define MY_LOG_INT_MAP4(a, b, c, d)				, MY_LOG_INT_ARG(a), MY_LOG_INT_ARG(b), MY_LOG_INT_ARG(c), MY_LOG_INT_ARG(d)
+
+				#if (LOG_ENABLE == 1U)
+
+					/* Запись в журнал: строка формата в .logstr, в буфер - её номер и аргументы */
+					#define MY_LOG(__FMT__, ...)																	\
+						do																							\
+						{																							\
+							static const char MY_LOG_INT_Format[] __attribute__((section(".logstr"), used)) = __FMT__;	\
+							MY_LOG_INT_CALL(MY_LOG_INT_NARGS(__VA_ARGS__))((uint32_t)MY_LOG_INT_Format		\
+								MY_LOG_INT_MAP(__VA_ARGS__));														\
+						}																							\
+						while(0)
+
+				#else
+
+					#define MY_LOG(__FMT__, ...)					do { } while(0)
+
+				#endif
+
+			/**
+			 * @}  MY_LOG_Macros
+			 */
+
+
+			/**
+			 * @defgroup MY_LOG_Typedefs
+			 * @brief    Typedefs для библиотеки
+			 * @{
+			 */
+				/**
+				 * @brief  Статистика журнала
+				 */
+				typedef struct
+				{
+					uint32_t	Written;		/*!< Записей принято */
+					uint32_t	Dropped;		/*!< Записей отброшено из-за переполнения */
+					uint32_t	Peak;			/*!< Максимальное заполнение буфера, слов */
+				}
+				MY_LOG_Stats_t;
+
+			/**
+			 * @} MY_LOG_Typedefs
+			 */
+
+
+			/**
+			 * @defgroup MY_LOG_Functions
+			 * @brief    Функции используемые в библиотеке
+			 * @{
+			 */
+				/**
+				 * @brief  Запись с 0..4 аргументами. Вызываются из MY_LOG()
+				 * @param  Id: адрес строки формата в .logstr
+				 * @param  Arg0..Arg3: аргументы
+				 * @retval Нет
+				 */
+				void MY_LOG_Write0(uint32_t Id);
+				void MY_LOG_Write1(uint32_t Id, uint32_t Arg0);
+				void MY_LOG_Write2(uint32_t Id, uint32_t Arg0, uint32_t Arg1);
+				void MY_LOG_Write3(uint32_t Id, uint32_t Arg0, uint32_t Arg1, uint32_t Arg2);
+				void MY_LOG_Write4(uint32_t Id, uint32_t Arg0, uint32_t Arg1, uint32_t Arg2, uint32_t Arg3);
+
+
+				/**
+				 * @brief  Выводит накопленные записи через MY_CONSOLE, пока в его буфере есть место
+				 * @param  Нет
+				 * @retval Количество выведенных записей
+				 */
+				uint32_t MY_LOG_Process(void);
+
+
+				/**
+				 * @brief  Статистика журнала
+				 * @param  *Stats: копия статистики
+				 * @retval Нет
+				 */
+				void MY_LOG_GetStats(MY_LOG_Stats_t *Stats);
+
+			/**
+			 * @} MY_LOG_Functions
+			 */
+
+		/**
+		 * @} MY_LOG
+		 */
+
+	/**
+	 * @} MY_STM32F0xx_Libraries
+	 */
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		}
+	#endif
+
+#endif
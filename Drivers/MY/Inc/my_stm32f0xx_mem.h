@@ -0,0 +1,214 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/mem
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Контроль глубины стека и кучи: закраска стека, high-water mark, охранная зона
+ */
+
+#ifndef MY_STM32F0xx_MEM_H
+	#define MY_STM32F0xx_MEM_H 100
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		extern "C"
+		{
+	#endif
+
+	/**
+	 * @addtogroup MY_STM32F0xx_Libraries
+	 * @{
+	 */
+
+		/**
+		 * @defgroup MY_MEM
+		 * @brief    Запас стека и кучи
+		 *
+		 * 	Reset_Handler (startup_stm32f051r8tx.s) закрашивает свободную память от конца статических
+		 * 	данных (символ _end, начало кучи) до вершины стека _estack словом MEM_PAINT_PATTERN.
+		 * 	Стек растёт вниз и затирает закраску, поэтому самое низкое затёртое слово - максимальная
+		 * 	глубина стека с момента сброса:
+		 * 		- MY_MEM_Stack_GetPeak() - двоичный поиск границы закраски, несколько десятков чтений;
+		 * 		  слово считается незатронутым, только если над ним MEM_SCAN_RUN закрашенных слов подряд,
+		 * 		  чтобы не ошибиться на незаписанных локальных массивах;
+		 * 		- MY_MEM_Stack_GetPeakExact() - линейный просмотр снизу, медленнее, но без допущений.
+		 *
+		 * 	_sbrk (sysmem.c) сообщает модулю каждую новую вершину кучи, модуль хранит текущий
+		 * 	и максимальный размер кучи и число отказов.
+		 *
+		 * 	Охранная зона - нижние MEM_GUARD_SIZE байт резерва стека (_sstack = _estack - _Min_Stack_Size).
+		 * 	При MEM_GUARD_CHECK = 1 _sbrk не отдаёт эту память куче, а SysTick_Handler проверяет закраску
+		 * 	зоны. Затёртая зона означает, что стек почти исчерпан: вызывается MY_MEM_GuardCallback(),
+		 * 	затем неопределённая инструкция (__builtin_trap(), UDF) вызывает HardFault, MY_FAULT сохраняет запись (PC указывает
+		 * 	на MY_MEM_Guard_Check) и перезапускает МК, пока стек ещё не вошёл в кучу и .bss.
+		 *
+		 * 	Контролируется основной стек (MSP). Стеки задач MY_OS находятся в .bss и сюда не входят.
+		 *	@{
+		 */
+
+			/* Подключаем основные файлы библиотек и настройки проекта */
+			#include "main.h"
+			#include "my_stm32f0xx.h"
+
+			/**
+			 * @defgroup MY_MEM_Settings
+			 * @brief    Библиотечные настройки
+			 * @{
+			 */
+				/*!< Проверка охранной зоны стека в SysTick_Handler и запрет её использования кучей */
+				#ifndef MEM_GUARD_CHECK
+					#define MEM_GUARD_CHECK						1U
+				#endif
+
+				/*!< Размер охранной зоны в байтах, кратен 4. Должен вмещать кадр HardFault и MY_FAULT_HardFault */
+				#ifndef MEM_GUARD_SIZE
+					#define MEM_GUARD_SIZE						64U
+				#endif
+
+				/*!< Количество закрашенных слов подряд, признающее границу при двоичном поиске */
+				#ifndef MEM_SCAN_RUN
+					#define MEM_SCAN_RUN						4U
+				#endif
+
+			/**
+			 * @} MY_MEM_Settings
+			 */
+
+
+			/**
+			 * @defgroup MY_MEM_Defines
+			 * @brief    Библиотечные константы
+			 * @{
+			 */
+				/*!< Слово закраски. То же значение записывает Reset_Handler */
+				#define MEM_PAINT_PATTERN						0xC5C5C5C5U
+
+			/**
+			 * @} MY_MEM_Defines
+			 */
+
+
+			/**
+			 * @defgroup MY_MEM_Macros
+			 * @brief    Библиотечные макросы
+			 * @{
+			 */
+
+			/**
+			 * @}  MY_MEM_Macros
+			 */
+
+
+			/**
+			 * @defgroup MY_MEM_Typedefs
+			 * @brief    Typedefs для библиотеки
+			 * @{
+			 */
+				/**
+				 * @brief  Статистика памяти
+				 */
+				typedef struct
+				{
+					uint32_t	StackSize;		/*!< Резерв стека из скрипта компоновщика, байт */
+					uint32_t	StackPeak;		/*!< Максимальная глубина стека с момента сброса */
+					uint32_t	StackFree;		/*!< Минимальный запас между стеком и максимумом кучи */
+					uint32_t	HeapUsed;		/*!< Занято кучей сейчас */
+					uint32_t	HeapPeak;		/*!< Максимум кучи */
+					uint32_t	HeapFailed;		/*!< Отказы _sbrk */
+				}
+				MY_MEM_Stats_t;
+
+			/**
+			 * @} MY_MEM_Typedefs
+			 */
+
+
+			/**
+			 * @defgroup MY_MEM_Functions
+			 * @brief    Функции используемые в библиотеке
+			 * @{
+			 */
+				/**
+				 * @brief  Максимальная глубина стека, двоичный поиск по закраске
+				 * @param  Нет
+				 * @retval Байт от _estack
+				 */
+				uint32_t MY_MEM_Stack_GetPeak(void);
+
+
+				/**
+				 * @brief  Максимальная глубина стека, линейный просмотр закраски
+				 * @param  Нет
+				 * @retval Байт от _estack
+				 */
+				uint32_t MY_MEM_Stack_GetPeakExact(void);
+
+
+				/**
+				 * @brief  Граница роста кучи для _sbrk
+				 * @param  *StackPtr: текущий указатель стека
+				 * @retval Указатель стека или начало охранной зоны при MEM_GUARD_CHECK = 1, что ниже
+				 */
+				char* MY_MEM_Heap_Limit(char *StackPtr);
+
+
+				/**
+				 * @brief  Учёт вершины кучи. Вызывается из _sbrk
+				 * @param  *HeapEnd: новая вершина кучи или NULL при отказе
+				 * @retval Нет
+				 */
+				void MY_MEM_Heap_Track(char *HeapEnd);
+
+
+				/**
+				 * @brief  Проверка закраски охранной зоны стека
+				 * @note   Вызывается из SysTick_Handler при MEM_GUARD_CHECK = 1. При затёртой зоне не возвращается
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_MEM_Guard_Check(void);
+
+
+				/**
+				 * @brief  Статистика стека и кучи
+				 * @param  *Stats: копия статистики
+				 * @retval Нет
+				 */
+				void MY_MEM_GetStats(MY_MEM_Stats_t *Stats);
+
+
+				/**
+				 * @brief  Выводит статистику памяти через printf()
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_MEM_Dump(void);
+
+
+				/**
+				 * @brief  Вызывается перед принудительным сбоем при затёртой охранной зоне
+				 * @note   Выполняется на почти исчерпанном стеке: только короткие действия без вызовов printf()
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_MEM_GuardCallback(void);
+
+			/**
+			 * @} MY_MEM_Functions
+			 */
+
+		/**
+		 * @} MY_MEM
+		 */
+
+	/**
+	 * @} MY_STM32F0xx_Libraries
+	 */
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		}
+	#endif
+
+#endif
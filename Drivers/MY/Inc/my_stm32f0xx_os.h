@@ -0,0 +1,277 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/os
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Вытесняющее ядро с фиксированными приоритетами
+ */
+
+#ifndef MY_STM32F0xx_OS_H
+	#define MY_STM32F0xx_OS_H 100
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		extern "C"
+		{
+	#endif
+
+	/**
+	 * @addtogroup MY_STM32F0xx_Libraries
+	 * @{
+	 */
+
+		/**
+		 * @defgroup MY_OS
+		 * @brief    Вытесняющее ядро для 8 КБ RAM
+		 *
+		 * 	- Блоки управления задачами (MY_OS_Task_t) и стеки задач выделяет приложение статически.
+		 * 	- Каждая задача имеет свой приоритет: 0 - наивысший, OS_PRIORITIES - 1 занят задачей простоя.
+		 * 	- Готовые задачи хранятся битовой маской, задача с наивысшим приоритетом находится за O(1)
+		 * 	  (выделение младшего бита и таблица де Брёйна - в Cortex-M0 нет инструкции CLZ).
+		 * 	- Переключение контекста выполняется в PendSV_Handler (Thumb-1), задачи работают на PSP,
+		 * 	  обработчики прерываний - на MSP.
+		 * 	- MY_OS_Tick() вызывается из SysTick_Handler: пробуждение задач по таймауту и вытеснение.
+		 * 	- Задача простоя вызывает MY_PWR_Enter(): ближайший таймаут ожидающей задачи - источник срока
+		 * 	  MY_PWR_Deadline_Register(), поэтому ядро спит без периодических тиков до него или до прерывания.
+		 * 	- MY_OS_Wait()/MY_OS_Notify() - ожидание по адресу объекта. На них построено ожидание
+		 * 	  MY_Lock_Acquire() (my_stm32f0xx_lock.h): задача ждёт освобождения драйвера вместо
+		 * 	  получения MY_Result_Busy.
+		 *
+		 * 	Использование:
+		 * 		MY_OS_Init();
+		 * 		MY_OS_Task_Create(&task, TaskFunc, NULL, stack, sizeof(stack) / 4, 1, "task");
+		 * 		MY_OS_Start();
+		 *
+		 * 	@note  PendSV получает наименьший приоритет: переключение выполняется только после выхода
+		 * 		   из всех обработчиков прерываний.
+		 *	@{
+		 */
+
+			/* Подключаем основные файлы библиотек и настройки проекта */
+			#include "main.h"
+			#include "my_stm32f0xx.h"
+
+			/**
+			 * @defgroup MY_OS_Settings
+			 * @brief    Библиотечные настройки
+			 * @{
+			 */
+				/*!< Количество уровней приоритета, включая уровень задачи простоя (не более 32) */
+				#ifndef OS_PRIORITIES
+					#define OS_PRIORITIES						8U
+				#endif
+
+				/*!< Размер стека задачи простоя в словах */
+				#ifndef OS_IDLE_STACK_WORDS
+					#define OS_IDLE_STACK_WORDS					48U
+				#endif
+
+				#if (OS_PRIORITIES < 2U) || (OS_PRIORITIES > 32U)
+					#error "my_stm32f0xx_os.h: OS_PRIORITIES must be in range 2..32"
+				#endif
+
+			/**
+			 * @} MY_OS_Settings
+			 */
+
+
+			/**
+			 * @defgroup MY_OS_Defines
+			 * @brief    Библиотечные константы
+			 * @{
+			 */
+				/*!< Приоритет задачи простоя */
+				#define OS_IDLE_PRIORITY						(OS_PRIORITIES - 1U)
+
+				/*!< Минимальный размер стека задачи в словах: кадр исключения и R4-R11 */
+				#define OS_STACK_WORDS_MIN						32U
+
+			/**
+			 * @} MY_OS_Defines
+			 */
+
+
+			/**
+			 * @defgroup MY_OS_Macros
+			 * @brief    Библиотечные макросы
+			 * @{
+			 */
+
+			/**
+			 * @}  MY_OS_Macros
+			 */
+
+
+			/**
+			 * @defgroup MY_OS_Typedefs
+			 * @brief    Typedefs для библиотеки
+			 * @{
+			 */
+				/**
+				 * @brief  Функция задачи
+				 */
+				typedef void (*MY_OS_TaskFunc_t)(void *Arg);
+
+
+				/**
+				 * @brief  Состояние задачи
+				 */
+				typedef enum
+				{
+					MY_OS_State_Dormant = 0x00U,	/*!< Не создана или завершилась */
+					MY_OS_State_Ready   = 0x01U,	/*!< Готова к выполнению или выполняется */
+					MY_OS_State_Blocked = 0x02U		/*!< Ждёт таймаута и/или объекта */
+				}
+				MY_OS_State_t;
+
+
+				/**
+				 * @brief  Блок управления задачей
+				 * @note   Поле SP должно быть первым - к нему обращается PendSV_Handler
+				 */
+				typedef struct
+				{
+					uint32_t*					SP;				/*!< Сохранённый указатель стека */
+					uint32_t*					StackBase;		/*!< Начало области стека */
+					uint32_t					StackWords;		/*!< Размер стека в словах */
+					uint32_t					WakeTick;		/*!< Тик пробуждения при ожидании с таймаутом */
+					const volatile void*		WaitObject;		/*!< Адрес ожидаемого объекта или NULL */
+					const char*					Name;			/*!< Имя задачи */
+					uint8_t						Priority;		/*!< Приоритет, 0 - наивысший */
+					uint8_t						Timed;			/*!< Ожидание ограничено WakeTick */
+					volatile uint8_t			State;			/*!< @ref MY_OS_State_t */
+					volatile uint8_t			WaitResult;		/*!< @ref MY_Result_t результата ожидания */
+				}
+				MY_OS_Task_t;
+
+			/**
+			 * @} MY_OS_Typedefs
+			 */
+
+
+			/**
+			 * @defgroup MY_OS_Functions
+			 * @brief    Функции используемые в библиотеке
+			 * @{
+			 */
+				/**
+				 * @brief  Инициализация ядра и создание задачи простоя
+				 * @param  Нет
+				 * @retval MY_Result_Ok
+				 */
+				MY_Result_t MY_OS_Init(void);
+
+
+				/**
+				 * @brief  Создаёт задачу
+				 * @param  *Task: блок управления задачей (статический)
+				 * @param  Func: функция задачи. Возврат из неё завершает задачу
+				 * @param  *Arg: аргумент функции
+				 * @param  *Stack: область стека, выровненная на 8 байт
+				 * @param  StackWords: размер стека в словах, не менее OS_STACK_WORDS_MIN
+				 * @param  Priority: приоритет 0..OS_PRIORITIES - 2, у каждой задачи свой
+				 * @param  *Name: имя задачи
+				 * @retval @arg MY_Result_Ok    - задача создана
+				 * 		   @arg MY_Result_Error - неверные параметры или приоритет занят
+				 */
+				MY_Result_t MY_OS_Task_Create(MY_OS_Task_t *Task, MY_OS_TaskFunc_t Func, void *Arg,
+											  uint32_t *Stack, uint32_t StackWords, uint8_t Priority, const char *Name);
+
+
+				/**
+				 * @brief  Запуск планировщика. Стек main() после этого не используется
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_OS_Start(void) __attribute__((noreturn));
+
+
+				/**
+				 * @brief  Признак работающего планировщика
+				 * @param  Нет
+				 * @retval 1 - планировщик запущен
+				 */
+				uint8_t MY_OS_IsRunning(void);
+
+
+				/**
+				 * @brief  Текущая задача
+				 * @param  Нет
+				 * @retval Указатель на блок управления или NULL до запуска
+				 */
+				MY_OS_Task_t* MY_OS_Task_Current(void);
+
+
+				/**
+				 * @brief  Обработка тика. Вызывается из SysTick_Handler
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_OS_Tick(void);
+
+
+				/**
+				 * @brief  Приостанавливает текущую задачу на Ticks тиков
+				 * @param  Ticks: время в тиках (мс)
+				 * @retval Нет
+				 */
+				void MY_OS_Delay(uint32_t Ticks);
+
+
+				/**
+				 * @brief  Ожидание уведомления по адресу объекта
+				 * @note   Вызывается только из задачи. Проверку условия и вызов выполнять при запрещённых
+				 * 		   прерываниях: функция атомарно блокирует задачу и разрешает прерывания (восстанавливает PRIMASK)
+				 * @param  *Object: адрес объекта ожидания
+				 * @param  Timeout: таймаут в тиках, MAX_DELAY - без ограничения
+				 * @retval @arg MY_Result_Ok      - получено уведомление
+				 * 		   @arg MY_Result_Timeout - истёк таймаут
+				 */
+				MY_Result_t MY_OS_Wait(const volatile void *Object, uint32_t Timeout);
+
+
+				/**
+				 * @brief  Пробуждает все задачи, ожидающие объект
+				 * @note   Можно вызывать из прерываний
+				 * @param  *Object: адрес объекта ожидания
+				 * @retval Нет
+				 */
+				void MY_OS_Notify(const volatile void *Object);
+
+
+				/**
+				 * @brief  Измеряет длительность переключения контекста в тактах HCLK
+				 * @note   Вызывается из задачи. Выполняет несколько переключений на саму себя (полное сохранение
+				 * 		   и восстановление контекста, вход и выход из PendSV) и возвращает минимум
+				 * @param  Нет
+				 * @retval Такты HCLK, 0 - планировщик не запущен
+				 */
+				uint32_t MY_OS_Benchmark_Switch(void);
+
+
+				/**
+				 * @brief  Переключение контекста. Заменяет PendSV_Handler приложения при USE_RTOS = 1
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void PendSV_Handler(void) __attribute__((naked));
+
+			/**
+			 * @} MY_OS_Functions
+			 */
+
+		/**
+		 * @} MY_OS
+		 */
+
+	/**
+	 * @} MY_STM32F0xx_Libraries
+	 */
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		}
+	#endif
+
+#endif
@@ -0,0 +1,201 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/pool
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Пулы блоков фиксированного размера вместо кучи malloc()
+ */
+
+#ifndef MY_STM32F0xx_POOL_H
+	#define MY_STM32F0xx_POOL_H 100
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		extern "C"
+		{
+	#endif
+
+	/**
+	 * @addtogroup MY_STM32F0xx_Libraries
+	 * @{
+	 */
+
+		/**
+		 * @defgroup MY_POOL
+		 * @brief    Детерминированное выделение памяти
+		 *
+		 * 	Куча newlib (_sbrk) растёт навстречу стеку и фрагментируется, время malloc() не ограничено.
+		 * 	Пулы заданы на этапе сборки списком POOL_CONFIG(размер блока, количество блоков) в порядке
+		 * 	возрастания размера, память под них - статические массивы в .bss:
+		 * 		#define POOL_CONFIG(POOL)	POOL(16U, 8U) POOL(32U, 4U) POOL(64U, 2U)
+		 *
+		 * 	Свободные блоки каждого пула связаны в список через свои первые 4 байта, поэтому выделение
+		 * 	и освобождение - снятие и возврат головы списка за O(1) в короткой критической секции.
+		 * 	MY_POOL_Alloc() берёт блок из наименьшего подходящего пула, если он исчерпан - из следующего.
+		 * 	Блок выровнен по слову, размер блока округляется до кратного 4.
+		 *
+		 * 	- MY_POOL_Alloc() при USE_RTOS = 1 может ждать освобождения блока до Timeout тиков;
+		 * 	- MY_POOL_Alloc_ISR() никогда не ждёт и подходит для обработчиков прерываний;
+		 * 	- MY_POOL_Free() можно вызывать из любого контекста, пул определяется по адресу блока.
+		 *
+		 * 	Для каждого пула считаются занятые блоки, максимум занятых (high-water mark) и отказы.
+		 *	@{
+		 */
+
+			/* Подключаем основные файлы библиотек и настройки проекта */
+			#include "main.h"
+			#include "my_stm32f0xx.h"
+
+			/**
+			 * @defgroup MY_POOL_Settings
+			 * @brief    Библиотечные настройки
+			 * @{
+			 */
+				/*!< Пулы: POOL(размер блока в байтах, количество блоков), размеры по возрастанию и различны */
+				#ifndef POOL_CONFIG
+					#define POOL_CONFIG(POOL)					POOL(16U, 8U) POOL(32U, 4U) POOL(64U, 2U)
+				#endif
+
+				/*!< Проверка адреса при освобождении: блок из пула, на границе блока, не свободен повторно */
+				#ifndef POOL_CHECK
+					#define POOL_CHECK							1U
+				#endif
+
+			/**
+			 * @} MY_POOL_Settings
+			 */
+
+
+			/**
+			 * @defgroup MY_POOL_Defines
+			 * @brief    Библиотечные константы
+			 * @{
+			 */
+				/*!< Количество пулов */
+				#define MY_POOL_INT_ONE(__SIZE__, __COUNT__)	+ 1U
+				#define POOL_COUNT								(0U POOL_CONFIG(MY_POOL_INT_ONE))
+
+			/**
+			 * @} MY_POOL_Defines
+			 */
+
+
+			/**
+			 * @defgroup MY_POOL_Macros
+			 * @brief    Библиотечные макросы
+			 * @{
+			 */
+
+			/**
+			 * @}  MY_POOL_Macros
+			 */
+
+
+			/**
+			 * @defgroup MY_POOL_Typedefs
+			 * @brief    Typedefs для библиотеки
+			 * @{
+			 */
+				/**
+				 * @brief  Статистика пула
+				 */
+				typedef struct
+				{
+					uint16_t	BlockSize;		/*!< Размер блока, байт */
+					uint16_t	Count;			/*!< Количество блоков */
+					uint16_t	Used;			/*!< Занято сейчас */
+					uint16_t	Peak;			/*!< Максимум занятых с момента MY_POOL_Init() */
+					uint32_t	Failed;			/*!< Запросы этого размера, не получившие блок ни здесь, ни в более крупных пулах */
+				}
+				MY_POOL_Stats_t;
+
+			/**
+			 * @} MY_POOL_Typedefs
+			 */
+
+
+			/**
+			 * @defgroup MY_POOL_Functions
+			 * @brief    Функции используемые в библиотеке
+			 * @{
+			 */
+				/**
+				 * @brief  Связывает все блоки в списки свободных и сбрасывает статистику
+				 * @note   Ранее выделенные блоки становятся недействительными
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_POOL_Init(void);
+
+
+				/**
+				 * @brief  Выделение блока
+				 * @param  Size: требуемый размер в байтах
+				 * @param  Timeout: ожидание освобождения в тиках (только задача ОС), 0 - без ожидания
+				 * @retval Указатель на блок или NULL
+				 */
+				void* MY_POOL_Alloc(uint32_t Size, uint32_t Timeout);
+
+
+				/**
+				 * @brief  Выделение блока без ожидания, для обработчиков прерываний
+				 * @param  Size: требуемый размер в байтах
+				 * @retval Указатель на блок или NULL
+				 */
+				void* MY_POOL_Alloc_ISR(uint32_t Size);
+
+
+				/**
+				 * @brief  Освобождение блока
+				 * @param  *Block: блок, полученный от MY_POOL_Alloc() или MY_POOL_Alloc_ISR(), NULL игнорируется
+				 * @retval @arg MY_Result_Ok    - блок возвращён в пул
+				 * 		   @arg MY_Result_Error - адрес не принадлежит пулам или блок уже свободен (POOL_CHECK = 1)
+				 */
+				MY_Result_t MY_POOL_Free(void *Block);
+
+
+				/**
+				 * @brief  Статистика пула
+				 * @param  Index: номер пула 0..POOL_COUNT - 1
+				 * @param  *Stats: копия статистики
+				 * @retval MY_Result_Error - неверный номер
+				 */
+				MY_Result_t MY_POOL_GetStats(uint32_t Index, MY_POOL_Stats_t *Stats);
+
+
+				/**
+				 * @brief  Выводит статистику пулов через printf()
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_POOL_Dump(void);
+
+
+				/**
+				 * @brief  Длительность пары MY_POOL_Alloc_ISR()/MY_POOL_Free() в тактах HCLK
+				 * @note   Лучший из 16 замеров по SysTick при запрещённых прерываниях. Нужен свободный блок
+				 * 		   в наименьшем пуле
+				 * @param  Нет
+				 * @retval Такты или 0, если свободного блока нет
+				 */
+				uint32_t MY_POOL_Benchmark(void);
+
+			/**
+			 * @} MY_POOL_Functions
+			 */
+
+		/**
+		 * @} MY_POOL
+		 */
+
+	/**
+	 * @} MY_STM32F0xx_Libraries
+	 */
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		}
+	#endif
+
+#endif
@@ -0,0 +1,224 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/profile
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Замер длительности участков кода в тактах
+ */
+
+#ifndef MY_STM32F0xx_PROFILE_H
+	#define MY_STM32F0xx_PROFILE_H 100
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		extern "C"
+		{
+	#endif
+
+	/**
+	 * @addtogroup MY_STM32F0xx_Libraries
+	 * @{
+	 */
+
+		/**
+		 * @defgroup MY_PROFILE
+		 * @brief    Профилирование участков кода
+		 *
+		 * 	В Cortex-M0 нет DWT->CYCCNT, поэтому такты считает свободно бегущий таймер.
+		 * 	На STM32F051 таймер TIM2 32-битный, связывать два 16-битных таймера не нужно:
+		 * 	TIM2 считает с предделителем 1 от тактирования таймеров (при делителе APB1 = 1 это такты HCLK).
+		 * 	При PROFILE_USE_TIM2 = 0 используется SysTick: такты HCLK из MY_SysTick_GetCycles().
+		 *
+		 * 	Использование:
+		 * 		MY_PROFILE_Init();
+		 * 		...
+		 * 		MY_PROFILE_BEGIN(I2C_Tx);
+		 * 		MY_I2C_Master_Transmit(...);
+		 * 		MY_PROFILE_END(I2C_Tx);
+		 * 		...
+		 * 		MY_PROFILE_Dump();
+		 *
+		 * 	Участок регистрируется в таблице при первом проходе по имени из макроса.
+		 * 	MY_PROFILE_BEGIN/MY_PROFILE_END должны находиться в одной области видимости.
+		 * 	При PROFILE_ENABLE = 0 макросы и функции не компилируются.
+		 *	@{
+		 */
+
+			/* Подключаем основные файлы библиотек и настройки проекта */
+			#include "main.h"
+			#include "my_stm32f0xx.h"
+
+			/**
+			 * @defgroup MY_PROFILE_Settings
+			 * @brief    Библиотечные настройки
+			 * @{
+			 */
+				/*!< Включение профилирования */
+				#ifndef PROFILE_ENABLE
+					#define PROFILE_ENABLE						0U
+				#endif
+
+				/*!< Источник тактов: 1 - TIM2, 0 - SysTick */
+				#ifndef PROFILE_USE_TIM2
+					#define PROFILE_USE_TIM2					1U
+				#endif
+
+				/*!< Максимальное количество участков */
+				#ifndef PROFILE_ZONES_MAX
+					#define PROFILE_ZONES_MAX					16U
+				#endif
+
+			/**
+			 * @} MY_PROFILE_Settings
+			 */
+
+
+			/**
+			 * @defgroup MY_PROFILE_Defines
+			 * @brief    Библиотечные константы
+			 * @{
+			 */
+
+			/**
+			 * @} MY_PROFILE_Defines
+			 */
+
+
+			/**
+			 * @defgroup MY_PROFILE_Macros
+			 * @brief    Библиотечные макросы
+			 * @{
+			 */
+				#if (PROFILE_ENABLE == 1U)
+
+					/* Начало участка: регистрация участка при первом проходе и отметка начала */
+					#define MY_PROFILE_BEGIN(__NAME__)																\
+						static MY_PROFILE_Zone_t *MY_PROFILE_Zone_##__NAME__;									\
+						uint32_t MY_PROFILE_Start_##__NAME__ = MY_PROFILE_Begin(&MY_PROFILE_Zone_##__NAME__, #__NAME__)
+
+					/* Конец участка: учёт длительности в статистике */
+					#define MY_PROFILE_END(__NAME__)																\
+						MY_PROFILE_End(MY_PROFILE_Zone_##__NAME__, MY_PROFILE_Start_##__NAME__)
+
+				#else
+
+					#define MY_PROFILE_BEGIN(__NAME__)			do { } while(0)
+					#define MY_PROFILE_END(__NAME__)			do { } while(0)
+
+				#endif
+
+			/**
+			 * @}  MY_PROFILE_Macros
+			 */
+
+
+			/**
+			 * @defgroup MY_PROFILE_Typedefs
+			 * @brief    Typedefs для библиотеки
+			 * @{
+			 */
+				/**
+				 * @brief  Статистика участка
+				 */
+				typedef struct
+				{
+					const char*	Name;			/*!< Имя участка из макроса MY_PROFILE_BEGIN */
+					uint32_t	Count;			/*!< Количество проходов */
+					uint32_t	Min;			/*!< Минимальная длительность, такты */
+					uint32_t	Max;			/*!< Максимальная длительность, такты */
+					uint64_t	Total;			/*!< Суммарная длительность, такты */
+				}
+				MY_PROFILE_Zone_t;
+
+			/**
+			 * @} MY_PROFILE_Typedefs
+			 */
+
+
+			/**
+			 * @defgroup MY_PROFILE_Functions
+			 * @brief    Функции используемые в библиотеке
+			 * @{
+			 */
+				#if (PROFILE_ENABLE == 1U)
+
+					/**
+					 * @brief  Запускает счётчик тактов и измеряет собственные накладные расходы BEGIN/END
+					 * @note   TIM2 используется профилировщиком монопольно
+					 * @param  Нет
+					 * @retval Нет
+					 */
+					void MY_PROFILE_Init(void);
+
+
+					/**
+					 * @brief  Текущее значение счётчика тактов
+					 * @param  Нет
+					 * @retval Такты, 32-битный счётчик с переполнением
+					 */
+					uint32_t MY_PROFILE_GetCycles(void);
+
+
+					/**
+					 * @brief  Начало участка. Вызывается из MY_PROFILE_BEGIN
+					 * @param  **Zone: указатель на ссылку на участок, заполняется при первом вызове
+					 * @param  *Name: имя участка
+					 * @retval Отметка начала в тактах
+					 */
+					uint32_t MY_PROFILE_Begin(MY_PROFILE_Zone_t **Zone, const char *Name);
+
+
+					/**
+					 * @brief  Конец участка. Вызывается из MY_PROFILE_END
+					 * @note   Можно вызывать из прерываний
+					 * @param  *Zone: участок, NULL - таблица переполнена, замер пропускается
+					 * @param  Start: отметка начала
+					 * @retval Нет
+					 */
+					void MY_PROFILE_End(MY_PROFILE_Zone_t *Zone, uint32_t Start);
+
+
+					/**
+					 * @brief  Возвращает участок из таблицы
+					 * @param  Index: номер участка
+					 * @retval Указатель на участок или NULL
+					 */
+					const MY_PROFILE_Zone_t* MY_PROFILE_GetZone(uint32_t Index);
+
+
+					/**
+					 * @brief  Сбрасывает статистику всех участков, регистрация сохраняется
+					 * @param  Нет
+					 * @retval Нет
+					 */
+					void MY_PROFILE_Reset(void);
+
+
+					/**
+					 * @brief  Выводит таблицу статистики через printf() (_write в syscalls.c)
+					 * @param  Нет
+					 * @retval Нет
+					 */
+					void MY_PROFILE_Dump(void);
+
+				#endif
+
+			/**
+			 * @} MY_PROFILE_Functions
+			 */
+
+		/**
+		 * @} MY_PROFILE
+		 */
+
+	/**
+	 * @} MY_STM32F0xx_Libraries
+	 */
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		}
+	#endif
+
+#endif
@@ -0,0 +1,259 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/pt
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Бесстековые сопрограммы (protothreads) для конечных автоматов драйверов
+ */
+
+#ifndef MY_STM32F0xx_PT_H
+	#define MY_STM32F0xx_PT_H 100
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		extern "C"
+		{
+	#endif
+
+	/**
+	 * @addtogroup MY_STM32F0xx_Libraries
+	 * @{
+	 */
+
+		/**
+		 * @defgroup MY_PT
+		 * @brief    Сопрограммы без собственного стека
+		 *
+		 * 	Сопрограмма - обычная функция, которую суперцикл вызывает повторно. Точка продолжения
+		 * 	хранится в MY_PT_t как номер строки, переход к ней выполняется оператором switch
+		 * 	(приём Даффа), поэтому каждая сопрограмма занимает 8 байт RAM вместо отдельного стека.
+		 *
+		 * 	Использование:
+		 * 		static MY_PT_t blink;
+		 *
+		 * 		static MY_PT_State_t Blink_Thread(MY_PT_t *pt)
+		 * 		{
+		 * 			MY_PT_BEGIN(pt);
+		 *
+		 * 			while(1)
+		 * 			{
+		 * 				MY_DISCO_LED_Toggle(LED_BLUE);
+		 * 				MY_PT_DELAY(pt, 500);
+		 * 			}
+		 *
+		 * 			MY_PT_END(pt);
+		 * 		}
+		 *
+		 * 		MY_PT_INIT(&blink);
+		 * 		while(1)
+		 * 		{
+		 * 			Blink_Thread(&blink);
+		 * 			...
+		 * 		}
+		 *
+		 * 	Ограничения:
+		 * 		- локальные переменные не сохраняются между вызовами, состояние хранится в static
+		 * 		  или в структуре контекста, содержащей MY_PT_t;
+		 * 		- внутри сопрограммы нельзя использовать switch, охватывающий точку ожидания;
+		 * 		- в одной строке допускается только одна точка ожидания.
+		 *	@{
+		 */
+
+			/* Подключаем основные файлы библиотек и настройки проекта */
+			#include "main.h"
+			#include "my_stm32f0xx.h"
+			#include "my_stm32f0xx_cortex.h"
+
+			/**
+			 * @defgroup MY_PT_Settings
+			 * @brief    Библиотечные настройки
+			 * @{
+			 */
+
+			/**
+			 * @} MY_PT_Settings
+			 */
+
+
+			/**
+			 * @defgroup MY_PT_Defines
+			 * @brief    Библиотечные константы
+			 * @{
+			 */
+
+			/**
+			 * @} MY_PT_Defines
+			 */
+
+
+			/**
+			 * @defgroup MY_PT_Macros
+			 * @brief    Библиотечные макросы
+			 * @{
+			 */
+				/* Сброс сопрограммы в начало */
+				#define MY_PT_INIT(__PT__)						((__PT__)->Line = 0U)
+
+				/* Начало тела сопрограммы */
+				#define MY_PT_BEGIN(__PT__)												\
+					{																	\
+						uint8_t MY_PT_Yielded = 1U;										\
+						(void)MY_PT_Yielded;											\
+						switch((__PT__)->Line)											\
+						{																\
+							case 0U:
+
+				/* Конец тела сопрограммы: следующий вызов начнёт её заново */
+				#define MY_PT_END(__PT__)												\
+						}																\
+						MY_PT_INIT(__PT__);												\
+						return MY_PT_State_Ended;										\
+					}
+
+				/* Ожидание, пока условие не станет истинным */
+				#define MY_PT_WAIT_UNTIL(__PT__, __COND__)								\
+					do																	\
+					{																	\
+						(__PT__)->Line = (uint16_t)__LINE__;							\
+						case __LINE__:													\
+						if(!(__COND__))													\
+						{																\
+							return MY_PT_State_Waiting;									\
+						}																\
+					} while(0)
+
+				/* Ожидание, пока условие истинно */
+				#define MY_PT_WAIT_WHILE(__PT__, __COND__)		MY_PT_WAIT_UNTIL((__PT__), !(__COND__))
+
+				/* Отдать управление суперциклу до следующего вызова */
+				#define MY_PT_YIELD(__PT__)												\
+					do																	\
+					{																	\
+						MY_PT_Yielded = 0U;												\
+						(__PT__)->Line = (uint16_t)__LINE__;							\
+						case __LINE__:													\
+						if(MY_PT_Yielded == 0U)											\
+						{																\
+							return MY_PT_State_Yielded;									\
+						}																\
+					} while(0)
+
+				/* Завершение сопрограммы досрочно */
+				#define MY_PT_EXIT(__PT__)												\
+					do																	\
+					{																	\
+						MY_PT_INIT(__PT__);												\
+						return MY_PT_State_Exited;										\
+					} while(0)
+
+				/* Перезапуск сопрограммы с начала на следующем вызове */
+				#define MY_PT_RESTART(__PT__)											\
+					do																	\
+					{																	\
+						MY_PT_INIT(__PT__);												\
+						return MY_PT_State_Waiting;										\
+					} while(0)
+
+				/* Сопрограмма ещё работает (результат вызова) */
+				#define MY_PT_SCHEDULE(__CALL__)				((__CALL__) < MY_PT_State_Exited)
+
+				/* Ожидание завершения дочерней сопрограммы */
+				#define MY_PT_WAIT_THREAD(__PT__, __CALL__)		MY_PT_WAIT_WHILE((__PT__), MY_PT_SCHEDULE(__CALL__))
+
+				/* Запуск дочерней сопрограммы и ожидание её завершения */
+				#define MY_PT_SPAWN(__PT__, __CHILD__, __CALL__)						\
+					do																	\
+					{																	\
+						MY_PT_INIT(__CHILD__);											\
+						MY_PT_WAIT_THREAD((__PT__), (__CALL__));						\
+					} while(0)
+
+				/* Отметка времени начала ожидания с таймаутом */
+				#define MY_PT_TIMER_START(__PT__)				((__PT__)->Timer = MY_SysTick_GetTick())
+
+				/* С отметки MY_PT_TIMER_START прошло не меньше __MS__ тиков */
+				#define MY_PT_EXPIRED(__PT__, __MS__)			((MY_SysTick_GetTick() - (__PT__)->Timer) >= (uint32_t)(__MS__))
+
+				/* Задержка без блокировки суперцикла */
+				#define MY_PT_DELAY(__PT__, __MS__)										\
+					do																	\
+					{																	\
+						MY_PT_TIMER_START(__PT__);										\
+						MY_PT_WAIT_UNTIL((__PT__), MY_PT_EXPIRED((__PT__), (__MS__)));	\
+					} while(0)
+
+				/* Ожидание условия не дольше __MS__ тиков. После выхода проверить условие или MY_PT_EXPIRED */
+				#define MY_PT_AWAIT_TIMEOUT(__PT__, __COND__, __MS__)					\
+					do																	\
+					{																	\
+						MY_PT_TIMER_START(__PT__);										\
+						MY_PT_WAIT_UNTIL((__PT__), (__COND__) || MY_PT_EXPIRED((__PT__), (__MS__)));	\
+					} while(0)
+
+				/* Ожидание установки всех битов __MASK__ в регистре или флаге */
+				#define MY_PT_AWAIT_FLAG(__PT__, __REG__, __MASK__)						\
+					MY_PT_WAIT_UNTIL((__PT__), (((__REG__) & (__MASK__)) == (__MASK__)))
+
+			/**
+			 * @}  MY_PT_Macros
+			 */
+
+
+			/**
+			 * @defgroup MY_PT_Typedefs
+			 * @brief    Typedefs для библиотеки
+			 * @{
+			 */
+				/**
+				 * @brief  Результат вызова сопрограммы
+				 */
+				typedef enum
+				{
+					MY_PT_State_Waiting = 0x00U,	/*!< Ожидает условия */
+					MY_PT_State_Yielded = 0x01U,	/*!< Отдала управление */
+					MY_PT_State_Exited  = 0x02U,	/*!< Завершилась через MY_PT_EXIT */
+					MY_PT_State_Ended   = 0x03U		/*!< Дошла до MY_PT_END */
+				}
+				MY_PT_State_t;
+
+
+				/**
+				 * @brief  Состояние сопрограммы
+				 */
+				typedef struct
+				{
+					uint16_t	Line;			/*!< Точка продолжения, 0 - начало */
+					uint32_t	Timer;			/*!< Отметка времени для задержек и таймаутов */
+				}
+				MY_PT_t;
+
+			/**
+			 * @} MY_PT_Typedefs
+			 */
+
+
+			/**
+			 * @defgroup MY_PT_Functions
+			 * @brief    Функции используемые в библиотеке
+			 * @{
+			 */
+
+			/**
+			 * @} MY_PT_Functions
+			 */
+
+		/**
+		 * @} MY_PT
+		 */
+
+	/**
+	 * @} MY_STM32F0xx_Libraries
+	 */
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		}
+	#endif
+
+#endif
@@ -0,0 +1,307 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/pwr
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Управление режимами пониженного потребления: Sleep, Stop, Standby
+ */
+
+#ifndef MY_STM32F0xx_PWR_H
+	#define MY_STM32F0xx_PWR_H 100
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		extern "C"
+		{
+	#endif
+
+	/**
+	 * @addtogroup MY_STM32F0xx_Libraries
+	 * @{
+	 */
+
+		/**
+		 * @defgroup MY_PWR
+		 * @brief    Менеджер питания
+		 *
+		 * 	Суперцикл (или задача простоя ОС) вызывает MY_PWR_Enter(IdleTicks), где IdleTicks - время до
+		 * 	ближайшего срока приложения в тиках или MAX_DELAY, если сроков нет. Сроки модулей менеджер
+		 * 	собирает сам: источники MY_PWR_Deadline_Register() возвращают тиков до своего ближайшего срока
+		 * 	(кнопки - до следующего отсчёта, ОС - до ближайшего таймаута задачи), и простой ограничивается
+		 * 	минимумом из них (MY_PWR_Deadline_Next()). Менеджер выбирает самый глубокий режим,
+		 * 	разрешённый одновременно:
+		 * 		- настройкой PWR_DEEPEST_STATE;
+		 * 		- счётчиками MY_PWR_Lock()/MY_PWR_Unlock() - запрет режима и всех более глубоких;
+		 * 		- зарегистрированными ограничениями MY_PWR_Constraint_Register(): например, I2C
+		 * 		  запрещает Stop, пока передача не завершена;
+		 * 		- ожидающим таймером: в Stop SysTick остановлен, поэтому при IdleTicks != MAX_DELAY
+		 * 		  допускается только Sleep (tickless через MY_SysTick_Tickless_Idle()).
+		 *
+		 * 	После выхода из Stop ядро работает от HSI. Менеджер не выполняет MY_RCC_System_Init() заново:
+		 * 	перед входом запоминаются включённые генераторы и источник SYSCLK, а после пробуждения
+		 * 	включаются те же HSE и PLL (их настройки и делители шин в RCC сохраняются) и SYSCLK
+		 * 	возвращается на прежний источник. Частоты не меняются, пересчитывать тайминги не нужно.
+		 * 	Всё это выполняется при запрещённых прерываниях, обработчик пробуждения видит исходные частоты.
+		 *
+		 * 	Статистика: число входов и время в каждом режиме, причина последнего пробуждения (IRQn
+		 * 	ожидающего прерывания) и счётчики пробуждений по источникам. В Stop SysTick не считает,
+		 * 	поэтому время в Stop добавляется, только если приложение измеряет его часами, работающими
+		 * 	в Stop (RTC), и возвращает из MY_PWR_StopTimeCallback().
+		 * 	Standby завершается сбросом: MY_PWR_Init() распознаёт его по PWR_CSR_SBF.
+		 *	@{
+		 */
+
+			/* Подключаем основные файлы библиотек и настройки проекта */
+			#include "main.h"
+			#include "my_stm32f0xx.h"
+
+			/**
+			 * @defgroup MY_PWR_Settings
+			 * @brief    Библиотечные настройки
+			 * @{
+			 */
+				/*!< Самый глубокий допустимый режим (@ref MY_PWR_State_t). Standby теряет содержимое RAM,
+					 поэтому по умолчанию не используется */
+				#ifndef PWR_DEEPEST_STATE
+					#define PWR_DEEPEST_STATE					MY_PWR_State_Stop
+				#endif
+
+				/*!< Стабилизатор в режиме пониженного потребления в Stop (дольше пробуждение) */
+				#ifndef PWR_STOP_LPREGULATOR
+					#define PWR_STOP_LPREGULATOR				1U
+				#endif
+
+				/*!< Количество регистрируемых ограничений */
+				#ifndef PWR_CONSTRAINTS_MAX
+					#define PWR_CONSTRAINTS_MAX					4U
+				#endif
+
+				/*!< Количество регистрируемых источников сроков */
+				#ifndef PWR_DEADLINES_MAX
+					#define PWR_DEADLINES_MAX					4U
+				#endif
+
+				/*!< Число итераций ожидания готовности HSE/PLL при восстановлении (прерывания запрещены, тики не идут) */
+				#ifndef PWR_RESTORE_SPIN
+					#define PWR_RESTORE_SPIN					100000U
+				#endif
+
+			/**
+			 * @} MY_PWR_Settings
+			 */
+
+
+			/**
+			 * @defgroup MY_PWR_Defines
+			 * @brief    Библиотечные константы
+			 * @{
+			 */
+				/*!< Источники пробуждения: SysTick_IRQn (индекс 0) и внешние прерывания 0..31 (индекс IRQn + 1) */
+				#define PWR_WAKE_SOURCES						33U
+
+				/*!< Причина пробуждения не определена: ожидающих прерываний нет (событие, отладчик) */
+				#define MY_PWR_WAKE_UNKNOWN						(-128)
+
+			/**
+			 * @} MY_PWR_Defines
+			 */
+
+
+			/**
+			 * @defgroup MY_PWR_Macros
+			 * @brief    Библиотечные макросы
+			 * @{
+			 */
+
+			/**
+			 * @}  MY_PWR_Macros
+			 */
+
+
+			/**
+			 * @defgroup MY_PWR_Typedefs
+			 * @brief    Typedefs для библиотеки
+			 * @{
+			 */
+				/**
+				 * @brief  Режимы питания в порядке увеличения глубины
+				 */
+				typedef enum
+				{
+					MY_PWR_State_Run     = 0x00U,	/*!< Работа, ядро не останавливается */
+					MY_PWR_State_Sleep   = 0x01U,	/*!< WFI: ядро остановлено, периферия и SysTick работают */
+					MY_PWR_State_Stop    = 0x02U,	/*!< Остановлены все частоты домена 1.8 В, RAM и регистры сохраняются */
+					MY_PWR_State_Standby = 0x03U,	/*!< Домен 1.8 В выключен, пробуждение через сброс */
+					MY_PWR_State_Count   = 0x04U
+				}
+				MY_PWR_State_t;
+
+
+				/**
+				 * @brief  Ограничение: возвращает самый глубокий режим, допустимый в данный момент.
+				 * 		   Вызывается при запрещённых прерываниях, должно быть коротким
+				 */
+				typedef MY_PWR_State_t (*MY_PWR_Constraint_Callback_t)(void);
+
+
+				/**
+				 * @brief  Источник срока: возвращает тиков до ближайшего срока модуля, MAX_DELAY - сроков нет.
+				 * 		   Вызывается при запрещённых прерываниях, должно быть коротким
+				 */
+				typedef uint32_t (*MY_PWR_Deadline_Callback_t)(void);
+
+
+				/**
+				 * @brief  Статистика менеджера питания
+				 */
+				typedef struct
+				{
+					uint32_t	Entries[MY_PWR_State_Count];	/*!< Количество входов в режим */
+					uint32_t	Residency[MY_PWR_State_Count];	/*!< Время в режиме, мс. Для Run - остаток окна */
+					uint32_t	Wakeups[PWR_WAKE_SOURCES];		/*!< Пробуждения по источникам */
+					uint32_t	RestoreFailures;				/*!< HSE/PLL не запустились после Stop, SYSCLK остался на HSI */
+					int8_t		LastWake;						/*!< IRQn последнего пробуждения или MY_PWR_WAKE_UNKNOWN */
+					uint8_t		LastState;						/*!< Режим последнего входа, @ref MY_PWR_State_t */
+					uint8_t		FromStandby;					/*!< 1 - текущий запуск после выхода из Standby */
+					uint8_t		WakeupPin;						/*!< 1 - при выходе из Standby установлен PWR_CSR_WUF */
+				}
+				MY_PWR_Stats_t;
+
+			/**
+			 * @} MY_PWR_Typedefs
+			 */
+
+
+			/**
+			 * @defgroup MY_PWR_Functions
+			 * @brief    Функции используемые в библиотеке
+			 * @{
+			 */
+				/**
+				 * @brief  Инициализация: распознаёт выход из Standby, сбрасывает флаги PWR и статистику
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_PWR_Init(void);
+
+
+				/**
+				 * @brief  Регистрирует ограничение режимов
+				 * @param  Callback: функция ограничения
+				 * @retval @arg MY_Result_Ok    - зарегистрировано или уже было зарегистрировано
+				 * 		   @arg MY_Result_Error - нет свободного места (PWR_CONSTRAINTS_MAX)
+				 */
+				MY_Result_t MY_PWR_Constraint_Register(MY_PWR_Constraint_Callback_t Callback);
+
+
+				/**
+				 * @brief  Удаляет ограничение
+				 * @param  Callback: функция ограничения
+				 * @retval Нет
+				 */
+				void MY_PWR_Constraint_Unregister(MY_PWR_Constraint_Callback_t Callback);
+
+
+				/**
+				 * @brief  Регистрирует источник срока
+				 * @param  Callback: функция, возвращающая тиков до ближайшего срока
+				 * @retval @arg MY_Result_Ok    - зарегистрировано или уже было зарегистрировано
+				 * 		   @arg MY_Result_Error - нет свободного места (PWR_DEADLINES_MAX)
+				 */
+				MY_Result_t MY_PWR_Deadline_Register(MY_PWR_Deadline_Callback_t Callback);
+
+
+				/**
+				 * @brief  Удаляет источник срока
+				 * @param  Callback: функция источника
+				 * @retval Нет
+				 */
+				void MY_PWR_Deadline_Unregister(MY_PWR_Deadline_Callback_t Callback);
+
+
+				/**
+				 * @brief  Ближайший срок зарегистрированных источников
+				 * @retval Тиков до ближайшего срока, MAX_DELAY - сроков нет
+				 */
+				uint32_t MY_PWR_Deadline_Next(void);
+
+
+				/**
+				 * @brief  Запрещает режим State и все более глубокие. Вызовы считаются
+				 * @param  State: @ref MY_PWR_State_t, начиная с MY_PWR_State_Sleep
+				 * @retval Нет
+				 */
+				void MY_PWR_Lock(MY_PWR_State_t State);
+
+
+				/**
+				 * @brief  Снимает запрет, установленный MY_PWR_Lock()
+				 * @param  State: @ref MY_PWR_State_t
+				 * @retval Нет
+				 */
+				void MY_PWR_Unlock(MY_PWR_State_t State);
+
+
+				/**
+				 * @brief  Самый глубокий режим, разрешённый сейчас
+				 * @param  IdleTicks: время до ближайшего программного срока в тиках, MAX_DELAY - сроков нет
+				 * @retval @ref MY_PWR_State_t
+				 */
+				MY_PWR_State_t MY_PWR_State_Select(uint32_t IdleTicks);
+
+
+				/**
+				 * @brief  Переход в самый глубокий разрешённый режим до пробуждения
+				 * @note   Вызывается из основного потока. Обработчик пробуждающего прерывания выполняется
+				 * 		   перед возвратом, после восстановления тактирования
+				 * @param  IdleTicks: время до ближайшего срока приложения в тиках, MAX_DELAY - сроков нет.
+				 * 		   Ограничивается ближайшим сроком источников MY_PWR_Deadline_Register()
+				 * @retval Режим, в котором находилось ядро (@ref MY_PWR_State_t)
+				 */
+				MY_PWR_State_t MY_PWR_Enter(uint32_t IdleTicks);
+
+
+				/**
+				 * @brief  Статистика с начала окна (MY_PWR_Init() или MY_PWR_Stats_Reset())
+				 * @param  *Stats: копия статистики, Residency[MY_PWR_State_Run] вычисляется на момент вызова
+				 * @retval Нет
+				 */
+				void MY_PWR_Stats_Get(MY_PWR_Stats_t *Stats);
+
+
+				/**
+				 * @brief  Сбрасывает статистику и начинает новое окно
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_PWR_Stats_Reset(void);
+
+
+				/**
+				 * @brief  Время, проведённое в Stop, по часам, работающим в Stop (например, RTC)
+				 * @note   Вызывается после восстановления тактирования при запрещённых прерываниях.
+				 * 		   Реализация по умолчанию возвращает 0 - время Stop не учитывается
+				 * @param  Нет
+				 * @retval Время в мс
+				 */
+				uint32_t MY_PWR_StopTimeCallback(void);
+
+			/**
+			 * @} MY_PWR_Functions
+			 */
+
+		/**
+		 * @} MY_PWR
+		 */
+
+	/**
+	 * @} MY_STM32F0xx_Libraries
+	 */
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		}
+	#endif
+
+#endif
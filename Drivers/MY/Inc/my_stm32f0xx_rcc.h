@@ -332,6 +332,35 @@
 			#endif
 
 
+			/**
+			 * @brief Максимальное количество обработчиков, подписанных на изменение частот
+			 */
+			#ifndef 	RCC_CLOCKCHANGE_CALLBACKS_MAX
+				#define RCC_CLOCKCHANGE_CALLBACKS_MAX					4U
+			#endif
+
+
+			/**
+			 * @brief Делители шин в профиле MY_RCC_Profile_LowPower (SYSCLK = HSI)
+			 */
+			#ifndef 	RCC_PROFILE_LOWPOWER_AHB_DIV
+				#define RCC_PROFILE_LOWPOWER_AHB_DIV					RCC_AHB_DIV1
+			#endif
+
+			#ifndef 	RCC_PROFILE_LOWPOWER_APB1_DIV
+				#define RCC_PROFILE_LOWPOWER_APB1_DIV					RCC_APB1_DIV1
+			#endif
+
+
+			/**
+			 * @brief Число опросов SWS при переключении профиля. Прерывания в это время запрещены,
+			 * 		  поэтому таймаут считается итерациями, а не тиками SysTick
+			 */
+			#ifndef 	RCC_PROFILE_SWITCH_SPIN
+				#define RCC_PROFILE_SWITCH_SPIN							10000U
+			#endif
+
+
 			/**
 			 * @} MY_Settings
 			 */
@@ -2281,6 +2310,75 @@
 		 */
 
 
+		/**
+		 * @defgroup MY_RCC_Static
+		 * @brief    Расчёт дерева частот на этапе компиляции по настройкам из main.h
+		 *
+		 * 	Значения вычисляются из RCC_OSCILLATORTYPE, RCC_SYSCLK_SOURCE, RCC_PLLSOURCE, RCC_PLL_PREDIV,
+		 * 	RCC_PLL_MUL, RCC_AHB_DIV, RCC_APB1_DIV, FLASH_LATENCY и PREFETCH_ENABLE. Проверка допустимости
+		 * 	выполняется в my_stm32f0xx_rcc.c через _Static_assert: некорректные настройки не соберутся.
+		 * 	При RCC_STATIC_INIT = 1 функция MY_RCC_System_Init() записывает эти значения в регистры напрямую.
+		 * @{
+		 */
+			/*!< Инициализация тактирования прямой записью вычисленных значений в регистры */
+			#ifndef 	RCC_STATIC_INIT
+				#define RCC_STATIC_INIT									1U
+			#endif
+
+			/*!< Предельные значения для STM32F0xx (DS, раздел Electrical characteristics) */
+			#define RCC_STATIC_SYSCLK_MAX							48000000U
+			#define RCC_STATIC_PLL_INPUT_MIN						1000000U
+			#define RCC_STATIC_PLL_INPUT_MAX						24000000U
+			#define RCC_STATIC_PLL_OUTPUT_MIN						16000000U
+			#define RCC_STATIC_PLL_OUTPUT_MAX						48000000U
+			#define RCC_STATIC_HSE_MIN								4000000U
+			#define RCC_STATIC_HSE_MAX								32000000U
+			#define RCC_STATIC_FLASH_0WS_MAX						24000000U
+
+			/*!< Множитель и предделитель PLL */
+			#define RCC_STATIC_PLL_MUL_FIELD						(((RCC_PLL_MUL) & RCC_CFGR_PLLMUL) >> RCC_CFGR_PLLMUL_Pos)
+			#define RCC_STATIC_PLL_MUL_FACTOR						((RCC_STATIC_PLL_MUL_FIELD == 0xFU) ? 16U : (RCC_STATIC_PLL_MUL_FIELD + 2U))
+			#define RCC_STATIC_PLL_PREDIV_FACTOR					((((RCC_PLL_PREDIV) & RCC_CFGR2_PREDIV) >> RCC_CFGR2_PREDIV_Pos) + 1U)
+
+			/*!< Частота на входе PLL */
+			#if defined(RCC_CFGR_PLLSRC_HSI_PREDIV)
+				#define RCC_STATIC_PLL_HSI_INPUT					(HSI_VALUE / RCC_STATIC_PLL_PREDIV_FACTOR)
+			#else
+				#define RCC_STATIC_PLL_HSI_INPUT					(HSI_VALUE / 2U)
+			#endif
+
+			#define RCC_STATIC_PLL_INPUT							(((RCC_PLLSOURCE) == RCC_PLLSOURCE_HSE) ? (HSE_VALUE / RCC_STATIC_PLL_PREDIV_FACTOR) : RCC_STATIC_PLL_HSI_INPUT)
+			#define RCC_STATIC_PLLCLK								(RCC_STATIC_PLL_INPUT * RCC_STATIC_PLL_MUL_FACTOR)
+
+			/*!< Используемые источники */
+			#define RCC_STATIC_USES_PLL								((RCC_SYSCLK_SOURCE) == RCC_SYSCLK_SOURCE_PLL)
+			#define RCC_STATIC_USES_HSE								(((RCC_SYSCLK_SOURCE) == RCC_SYSCLK_SOURCE_HSE) || (RCC_STATIC_USES_PLL && ((RCC_PLLSOURCE) == RCC_PLLSOURCE_HSE)))
+
+			/*!< Частоты SYSCLK, HCLK, PCLK1. Сдвиги повторяют AHBPrescTable и APBPrescTable */
+			#define RCC_STATIC_SYSCLK								(RCC_STATIC_USES_PLL ? RCC_STATIC_PLLCLK : (((RCC_SYSCLK_SOURCE) == RCC_SYSCLK_SOURCE_HSE) ? HSE_VALUE : HSI_VALUE))
+
+			#define RCC_STATIC_HPRE_FIELD							(((RCC_AHB_DIV) & RCC_CFGR_HPRE) >> RCC_CFGR_HPRE_Pos)
+			#define RCC_STATIC_AHB_SHIFT							((RCC_STATIC_HPRE_FIELD < 8U) ? 0U : ((RCC_STATIC_HPRE_FIELD < 12U) ? (RCC_STATIC_HPRE_FIELD - 7U) : (RCC_STATIC_HPRE_FIELD - 6U)))
+			#define RCC_STATIC_HCLK									(RCC_STATIC_SYSCLK >> RCC_STATIC_AHB_SHIFT)
+
+			#define RCC_STATIC_PPRE_FIELD							(((RCC_APB1_DIV) & RCC_CFGR_PPRE) >> RCC_CFGR_PPRE_Pos)
+			#define RCC_STATIC_APB_SHIFT							((RCC_STATIC_PPRE_FIELD < 4U) ? 0U : (RCC_STATIC_PPRE_FIELD - 3U))
+			#define RCC_STATIC_PCLK1								(RCC_STATIC_HCLK >> RCC_STATIC_APB_SHIFT)
+
+			/*!< Требуемое число тактов ожидания Flash: 0 WS до 24 МГц, 1 WS до 48 МГц */
+			#define RCC_STATIC_FLASH_LATENCY_REQUIRED				((RCC_STATIC_SYSCLK > RCC_STATIC_FLASH_0WS_MAX) ? FLASH_ACR_LATENCY : 0U)
+
+			/*!< Итоговые значения регистров */
+			#define RCC_STATIC_FLASH_ACR							((FLASH_LATENCY) | (((PREFETCH_ENABLE) != 0U) ? FLASH_ACR_PRFTBE : 0U))
+			#define RCC_STATIC_CFGR									((RCC_STATIC_USES_PLL ? ((RCC_PLLSOURCE) | (RCC_PLL_MUL)) : 0U) | (RCC_AHB_DIV) | (RCC_APB1_DIV))
+			#define RCC_STATIC_CFGR2								(RCC_STATIC_USES_PLL ? (RCC_PLL_PREDIV) : 0U)
+			#define RCC_STATIC_SWS									((RCC_SYSCLK_SOURCE) << (RCC_CFGR_SWS_Pos - RCC_CFGR_SW_Pos))
+
+		/**
+		 * @} MY_RCC_Static
+		 */
+
+
 		/**
 		 * @defgroup MY_RCC_Typedefs
 		 * @brief    RCC Typedefs используемые в библиотеке RCC для инициализации тактирования
@@ -2336,6 +2434,72 @@
 			MY_RCC_Clock_Init_t;
 
 
+			/**
+			 * @brief  Снимок дерева частот. Пересчитывается при изменении настроек RCC,
+			 * 		   функции MY_RCC_xxx_GetFreq() возвращают значения из него
+			 */
+			typedef struct
+			{
+				uint32_t SYSCLK_Freq;				/*!< Частота SYSCLK, Гц */
+				uint32_t HCLK_Freq;					/*!< Частота шины AHB (HCLK), Гц */
+				uint32_t PCLK1_Freq;				/*!< Частота шины APB1 (PCLK1), Гц */
+				uint32_t RTC_Freq;					/*!< Частота тактирования RTC, Гц */
+				uint32_t USART1_Freq;				/*!< Частота тактирования USART1, Гц */
+				uint32_t I2C1_Freq;					/*!< Частота тактирования I2C1, Гц */
+
+				#if defined(RCC_CFGR3_USART2SW)
+					uint32_t USART2_Freq;			/*!< Частота тактирования USART2, Гц */
+				#endif
+
+				#if defined(RCC_CFGR3_USART3SW)
+					uint32_t USART3_Freq;			/*!< Частота тактирования USART3, Гц */
+				#endif
+
+				#if defined(USB)
+					uint32_t USB_Freq;				/*!< Частота тактирования USB, Гц */
+				#endif
+
+				#if defined(CEC)
+					uint32_t CEC_Freq;				/*!< Частота тактирования CEC, Гц */
+				#endif
+			}
+			MY_RCC_Clocks_t;
+
+
+			/**
+			 * @brief  Обработчик изменения частот. Вызывается с уже обновлённым снимком
+			 */
+			typedef void (*MY_RCC_ClockChange_Callback_t)(const MY_RCC_Clocks_t *Clocks);
+
+
+			/**
+			 * @brief  Профили тактирования для MY_RCC_Profile_Set()
+			 */
+			typedef enum
+			{
+				MY_RCC_Profile_Run      = 0x00U,	/*!< Рабочий режим: настройки тактирования из main.h (PLL 48 МГц) */
+				MY_RCC_Profile_LowPower = 0x01U,	/*!< Пониженное потребление: SYSCLK = HSI 8 МГц, PLL и HSE выключены */
+				MY_RCC_Profile_Count    = 0x02U
+			}
+			MY_RCC_Profile_t;
+
+
+			/**
+			 * @brief  Параметры профиля тактирования
+			 */
+			typedef struct
+			{
+				uint32_t SYSCLK_Source;				/*!< Источник SYSCLK, @ref RCC_SYSCLK_SOURCE_xxx */
+				uint32_t PLL_Source;				/*!< Источник PLL, если SYSCLK_Source = RCC_SYSCLK_SOURCE_PLL */
+				uint32_t PLL_PREDIV;				/*!< Предделитель PLL */
+				uint32_t PLL_MUL;					/*!< Множитель PLL */
+				uint32_t AHBCLK_Divider;			/*!< Делитель шины AHB (HCLK) */
+				uint32_t APB1CLK_Divider;			/*!< Делитель шины APB1 (PCLK1) */
+				uint32_t FlashLatency;				/*!< Число тактов ожидания Flash для этой частоты */
+			}
+			MY_RCC_Profile_Config_t;
+
+
 			/**
 			 * @brief  Расширенные настройки тактирования для периферии
 			 */
@@ -2502,6 +2666,9 @@
 		 */
 			/**
 			 * @brief  Инициализация системного тактирования
+			 * @note   При RCC_STATIC_INIT = 1 значения регистров вычисляются на этапе компиляции (@ref MY_RCC_Static)
+			 * 		   и записываются напрямую, без структур и MY_RCC_System_DeInit(). Регистры RCC должны быть
+			 * 		   в состоянии после сброса, как после MY_System_Init().
 			 * @note   Функция @ref MY_RCC_System_Init должна вызываться для иницализации тактирования при старте
 			 * 				В ходе выполнения функции:
 			 *						- сброс к дефолтным значениям настроек системы тактирования
@@ -2609,6 +2776,7 @@
 			/**
 			 * @brief  Returns the peripheral clock frequency
 			 * @note   Returns 0 if peripheral clock is unknown
+			 * @note   Значение берётся из снимка дерева частот
 			 * @param  PeriphClk Peripheral clock identifier
 			 *         This parameter can be one of the following values:
 			 *            @arg @ref RCC_PERIPHCLK_RTC     RTC peripheral clock
@@ -2701,8 +2869,8 @@
 			 * @note   This function can be used by the user application to compute the
 			 *         baud-rate for the communication peripherals or configure other parameters.
 			 *
-			 * @note   Each time SYSCLK changes, this function must be called to update the
-			 *         right SYSCLK value. Otherwise, any configuration based on this function will be incorrect.
+			 * @note   Значение берётся из снимка дерева частот и не читает регистры RCC.
+			 *         После прямой записи в регистры RCC необходимо вызвать MY_RCC_ClockTree_Update().
 			 *
 			 * @retval SYSCLK frequency
 			 */
@@ -2711,11 +2879,7 @@
 
 			/**
 			 * @brief  Возвращает текущую частоту HCLK
-			 * @note   Each time HCLK changes, this function must be called to update the
-			 *         right HCLK value. Otherwise, any configuration based on this function will be incorrect.
-			 *
-			 * @note   The SystemCoreClock CMSIS variable is used to store System Clock Frequency
-			 *         and updated within this function
+			 * @note   Значение берётся из снимка дерева частот, SystemCoreClock обновляется вместе с ним
 			 * @retval HCLK frequency
 			 */
 			uint32_t MY_RCC_HCLK_GetFreq(void);
@@ -2723,13 +2887,95 @@
 
 			/**
 			 * @brief  Возвращает текущую частоту PCLK1
-			 * @note   Each time PCLK1 changes, this function must be called to update the right PCLK1 value.
-			 * 		   Otherwise, any configuration based on this function will be incorrect.
+			 * @note   Значение берётся из снимка дерева частот
 			 * @retval PCLK1 frequency
 			 */
 			uint32_t MY_RCC_PCLK1_GetFreq(void);
 
 
+			/**
+			 * @brief  Пересчитывает снимок дерева частот по текущим регистрам RCC
+			 * @note   Вызывается из MY_RCC_Osc_Config(), MY_RCC_Clock_Config(), MY_RCC_PeriphClock_Config()
+			 * 		   и MY_RCC_System_DeInit(). При прямой записи в регистры RCC вызывается вручную.
+			 * @note   Если снимок изменился: при смене HCLK перенастраивается SysTick на 1 мс,
+			 * 		   затем вызываются обработчики, зарегистрированные через MY_RCC_ClockChange_Register()
+			 * @param  Нет
+			 * @retval Нет
+			 */
+			void MY_RCC_ClockTree_Update(void);
+
+
+			/**
+			 * @brief  Возвращает указатель на текущий снимок дерева частот
+			 * @param  Нет
+			 * @retval Указатель на MY_RCC_Clocks_t
+			 */
+			const MY_RCC_Clocks_t* MY_RCC_Clocks_Get(void);
+
+
+			/**
+			 * @brief  Подписывает обработчик на изменение частот
+			 * @param  Callback: функция, вызываемая после пересчёта снимка
+			 * @retval @arg MY_Result_Ok    - обработчик добавлен или уже был добавлен
+			 * 		   @arg MY_Result_Error - нет места в таблице (RCC_CLOCKCHANGE_CALLBACKS_MAX)
+			 */
+			MY_Result_t MY_RCC_ClockChange_Register(MY_RCC_ClockChange_Callback_t Callback);
+
+
+			/**
+			 * @brief  Отписывает обработчик от изменения частот
+			 * @param  Callback: ранее зарегистрированная функция
+			 * @retval Нет
+			 */
+			void MY_RCC_ClockChange_Unregister(MY_RCC_ClockChange_Callback_t Callback);
+
+
+			/**
+			 * @brief  Переключает профиль тактирования
+			 * @note   Порядок переключения:
+			 * 				- при включенных прерываниях запускаются нужные профилю HSE и PLL
+			 * 				- при запрещённых прерываниях: задержка Flash увеличивается до смены частоты,
+			 * 				  одной записью CFGR меняются SYSCLK и делители шин, задержка Flash уменьшается
+			 * 				  после смены частоты, вызывается MY_RCC_ClockTree_Update() (SysTick и подписчики,
+			 * 				  например тайминги I2C), так что ни одно прерывание не видит старых значений
+			 * 				- останавливаются PLL и HSE, если они больше не нужны
+			 * @note   При ошибке профиль не меняется: SYSCLK и делители остаются прежними (или SYSCLK = HSI,
+			 * 		   если перезапускался чужой PLL), генераторы, запущенные вызовом, останавливаются
+			 * @note   Не вызывать во время обмена по I2C и другим интерфейсам, тайминги которых пересчитываются
+			 * @param  Profile: @ref MY_RCC_Profile_t
+			 * @retval @arg MY_Result_Ok      - профиль установлен
+			 * 		   @arg MY_Result_Error   - неверный профиль
+			 * 		   @arg MY_Result_Timeout - генератор не запустился или SYSCLK не переключился
+			 */
+			MY_Result_t MY_RCC_Profile_Set(MY_RCC_Profile_t Profile);
+
+
+			/**
+			 * @brief  Возвращает текущий профиль тактирования
+			 * @param  Нет
+			 * @retval @ref MY_RCC_Profile_t
+			 */
+			MY_RCC_Profile_t MY_RCC_Profile_Get(void);
+
+
+			/**
+			 * @brief  Возвращает параметры профиля тактирования
+			 * @param  Profile: @ref MY_RCC_Profile_t
+			 * @retval Указатель на параметры или NULL для неверного профиля
+			 */
+			const MY_RCC_Profile_Config_t* MY_RCC_Profile_GetConfig(MY_RCC_Profile_t Profile);
+
+
+			/**
+			 * @brief  Длительность последнего переключения профиля
+			 * @note   Время от вызова MY_RCC_Profile_Set() до работы на новой частоте с пересчитанными таймингами,
+			 * 		   включая запуск генераторов. Измеряется по SysTick, разрешение - такт HCLK
+			 * @param  *Blackout: указатель для записи времени с запрещёнными прерываниями в мкс, может быть NULL
+			 * @retval Время переключения в мкс
+			 */
+			uint32_t MY_RCC_Profile_GetSwitchTime(uint32_t *Blackout);
+
+
 			/**
 			 * @brief  Configures the RCC_OscInitStruct according to the internal RCC configuration registers.
 			 * @param  RCC_OscInitStruct pointer to an RCC_OscInitTypeDef structure that will be configured.
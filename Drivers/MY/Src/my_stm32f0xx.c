@@ -12,11 +12,11 @@
 #include "my_stm32f0xx_cortex.h"
 #include "my_stm32f0xx_rcc.h"
 #include "my_stm32f0xx_gpio.h"
+#include "my_stm32f0xx_boot.h"
 
-MY_Result_t MY_System_Init(void)
+/* Сброс регистров RCC в состояние после сброса */
+static void MY_INT_System_ClockReset(void)
 {
-	/* ##################### Сброс настроек тактирования в значения по умолчанию ##################### */
-
 	/* Устанавливаем бит HSION */
 	RCC->CR |= (uint32_t)0x00000001U;
 
@@ -44,6 +44,26 @@ MY_Result_t MY_System_Init(void)
 	/* Сброс бит PREDIV[3:0] */
 	RCC->CFGR2 &= (uint32_t)0xFFFFFFF0U;
 
+	/* Сбрасываем бит HSI14 */
+	RCC->CR2 &= (uint32_t)0xFFFFFFFEU;
+
+	/* Отключаем все прерывания */
+	RCC->CIR = 0x00000000U;
+}
+
+
+MY_Result_t MY_System_Init(void)
+{
+	/* ##################### Сброс настроек тактирования в значения по умолчанию ##################### */
+
+	/* После аппаратного сброса RCC уже в исходном состоянии, повторный сброс нужен только
+	   при переходе из загрузчика или программном перезапуске. HSEON допустим - его включает MY_BOOT_EarlyInit() */
+	if((RCC->CFGR != 0U) || (RCC->CFGR2 != 0U) || (RCC->CIR != 0U) ||
+	   ((RCC->CR & (RCC_CR_PLLON | RCC_CR_CSSON)) != 0U) || ((RCC->CR2 & RCC_CR2_HSI14ON) != 0U))
+	{
+		MY_INT_System_ClockReset();
+	}
+
 	/* Сброс битов настроек тактирования периферии*/
 	#if defined (STM32F072xB) || defined (STM32F078xx)
 
@@ -89,14 +109,9 @@ MY_Result_t MY_System_Init(void)
 
 	#endif
 
-	/* Сбрасываем бит HSI14 */
-	RCC->CR2 &= (uint32_t)0xFFFFFFFEU;
-
-	/* Отключаем все прерывания */
-	RCC->CIR = 0x00000000U;
-
-	/* Настраиваем Systick как основу для временных отсчётов и настраивает тик в 1ms (после сброса источник для тактирования - HSI) */
-	MY_SysTick_Init(MY_RCC_HCLK_GetFreq()/1000U, 0U);
+	/* Снимаем снимок дерева частот (после сброса источник для тактирования - HSI).
+	   При первом снимке там же настраивается Systick как основа для временных отсчётов с тиком в 1ms */
+	MY_RCC_ClockTree_Update();
 
 	/* Включаем тактирование на SYSCFG & COMP */
 	MY_UTILS_SetBitWithRead(&RCC->APB2ENR, RCC_APB2ENR_SYSCFGEN);
@@ -104,11 +119,22 @@ MY_Result_t MY_System_Init(void)
 	/* Включаем тактирование на блок управления питанием */
 	MY_UTILS_SetBitWithRead(&RCC->APB1ENR, RCC_APB1ENR_PWREN);
 
+	#if (NVIC_VECTORS_IN_RAM == 1U)
+
+		/* Переносим таблицу векторов в SRAM (нужно тактирование SYSCFG) */
+		MY_NVIC_Vectors_Relocate();
+
+	#endif
+
 	/* Устанавливаем приоритет прерывания SVC_IRQn (используется для работы ОС)*/
 	MY_NVIC_Priority_Set(SVC_IRQn, 0);
 
-	/* Устанавливаем приоритет прерывания PendSV_IRQn (используется для работы ОС)*/
-	MY_NVIC_Priority_Set(PendSV_IRQn, 0);
+	/* Устанавливаем приоритет прерывания PendSV_IRQn (используется для работы ОС).
+	   Наименьший: переключение контекста не должно вытеснять обработчики прерываний */
+	MY_NVIC_Priority_Set(PendSV_IRQn, (1UL << __NVIC_PRIO_BITS) - 1UL);
+
+
+	MY_BOOT_TIMESTAMP(MY_BOOT_Phase_SystemInit);
 
 
 	/* ##################### Инициализация системного тактирования  ##################### */
@@ -132,3 +158,85 @@ MY_Result_t MY_System_Init(void)
 }
 
 
+
+
+/* Ядро замера MY_RAMFUNC_Benchmark: опрос флага и ветвление на каждой итерации */
+#define MY_INT_RAMFUNC_KERNEL(__FLAG__, __COUNT__, __ACC__)			\
+	do																\
+	{																\
+		uint32_t i;													\
+		for(i = 0; i < (__COUNT__); i++)							\
+		{															\
+			if((*(__FLAG__) & (1U << (i & 7U))) != 0U)				\
+			{														\
+				(__ACC__) += i;										\
+			}														\
+			else													\
+			{														\
+				(__ACC__) ^= i;										\
+			}														\
+		}															\
+	}																\
+	while(0)
+
+
+static __attribute__((noinline)) uint32_t MY_INT_RAMFUNC_KernelFlash(volatile const uint32_t *Flag, uint32_t Count)
+{
+	uint32_t acc = 0;
+
+	MY_INT_RAMFUNC_KERNEL(Flag, Count, acc);
+
+	return acc;
+}
+
+
+static MY_RAMFUNC uint32_t MY_INT_RAMFUNC_KernelRam(volatile const uint32_t *Flag, uint32_t Count)
+{
+	uint32_t acc = 0;
+
+	MY_INT_RAMFUNC_KERNEL(Flag, Count, acc);
+
+	return acc;
+}
+
+
+/* Лучший из 8 замеров одного вызова ядра */
+static uint32_t MY_INT_RAMFUNC_Measure(uint32_t (*Kernel)(volatile const uint32_t *, uint32_t))
+{
+	static volatile uint32_t flag = 0x5AU;
+	uint32_t best = 0xFFFFFFFFU;
+	uint32_t primask;
+	uint32_t start;
+	uint32_t end;
+	uint32_t cycles;
+	uint32_t n;
+
+	for(n = 0; n < 8U; n++)
+	{
+		primask = __get_PRIMASK();
+		__disable_irq();
+
+		start = SysTick->VAL;
+		Kernel(&flag, 64U);
+		end = SysTick->VAL;
+
+		__set_PRIMASK(primask);
+
+		/* SysTick считает вниз, при перезагрузке добавляется период */
+		cycles = (start >= end) ? (start - end) : (start + (SysTick->LOAD + 1U) - end);
+
+		if(cycles < best)
+		{
+			best = cycles;
+		}
+	}
+
+	return best;
+}
+
+
+void MY_RAMFUNC_Benchmark(uint32_t *FlashCycles, uint32_t *RamCycles)
+{
+	*FlashCycles = MY_INT_RAMFUNC_Measure(MY_INT_RAMFUNC_KernelFlash);
+	*RamCycles = MY_INT_RAMFUNC_Measure(MY_INT_RAMFUNC_KernelRam);
+}
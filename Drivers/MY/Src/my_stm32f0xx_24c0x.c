@@ -33,7 +33,7 @@ MY_Result_t MY_24C0X_Init(I2C_TypeDef* I2Cx, MY_I2C_PinsPack_t pinspack)
 	EEPROM_I2C_Init->TypeAcknowledge = EEPROM_24C0X_TYPEACKNOLEGE;
 	EEPROM_I2C_Init->Pinspack = pinspack;
 	EEPROM_I2C_Init->State = MY_I2C_State_Reset;
-	EEPROM_I2C_Init->Lock = MY_Lock_Off;
+	MY_Lock_Init(&EEPROM_I2C_Init->Lock);
 
 	/* Пробуем инициализировать */
 	if(MY_I2C_Init(I2Cx) == MY_Result_Ok)
@@ -76,3 +76,51 @@ uint8_t MY_24C0X_ReadByte(I2C_TypeDef* I2Cx, uint8_t address_byte)
 
 	return tmp;
 }
+
+
+MY_PT_State_t MY_24C0X_PT_WriteByte(MY_24C0X_PT_t *Ctx, I2C_TypeDef* I2Cx, uint8_t address_byte, uint8_t data)
+{
+	MY_I2C_Init_t* I2C_Handler = MY_I2C_GetHandler(I2Cx);
+
+	MY_PT_BEGIN(&Ctx->PT);
+
+	Ctx->Buffer[0] = address_byte;
+	Ctx->Buffer[1] = data;
+
+	MY_I2C_PT_AWAIT(&Ctx->PT, &Ctx->I2C, MY_I2C_PT_Master_Transmit(&Ctx->I2C, I2C_Handler, EEPROM_24C0X_ADDR, Ctx->Buffer, 2, EEPROM_24C0X_TIMEOUT));
+
+	Ctx->Result = Ctx->I2C.Result;
+
+	/* Цикл записи во внутреннюю память EEPROM */
+	if(Ctx->Result == MY_Result_Ok)
+	{
+		MY_PT_DELAY(&Ctx->PT, 2);
+	}
+
+	MY_PT_END(&Ctx->PT);
+}
+
+
+MY_PT_State_t MY_24C0X_PT_ReadByte(MY_24C0X_PT_t *Ctx, I2C_TypeDef* I2Cx, uint8_t address_byte, uint8_t *data)
+{
+	MY_I2C_Init_t* I2C_Handler = MY_I2C_GetHandler(I2Cx);
+
+	MY_PT_BEGIN(&Ctx->PT);
+
+	/* Отправляем адрес ячейки */
+	Ctx->Buffer[0] = address_byte;
+
+	MY_I2C_PT_AWAIT(&Ctx->PT, &Ctx->I2C, MY_I2C_PT_Master_Transmit(&Ctx->I2C, I2C_Handler, EEPROM_24C0X_ADDR, Ctx->Buffer, 1, EEPROM_24C0X_TIMEOUT));
+
+	Ctx->Result = Ctx->I2C.Result;
+
+	/* Читаем значение */
+	if(Ctx->Result == MY_Result_Ok)
+	{
+		MY_I2C_PT_AWAIT(&Ctx->PT, &Ctx->I2C, MY_I2C_PT_Master_Receive(&Ctx->I2C, I2C_Handler, EEPROM_24C0X_ADDR, data, 1, EEPROM_24C0X_TIMEOUT));
+
+		Ctx->Result = Ctx->I2C.Result;
+	}
+
+	MY_PT_END(&Ctx->PT);
+}
@@ -0,0 +1,215 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/arena
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Арена для временных буферов: выделение сдвигом указателя, освобождение областями
+ */
+#include "my_stm32f0xx_arena.h"
+#include "my_stm32f0xx_utils.h"
+
+/* Границы секции .arena из скрипта компоновщика */
+extern uint8_t _sarena[];
+extern uint8_t _earena[];
+
+/* Вершина (смещение от _sarena) и максимум вершины: общий и с начала текущей области */
+static uint32_t MY_INT_ARENA_Top = 0;
+static uint32_t MY_INT_ARENA_Peak = 0;
+static uint32_t MY_INT_ARENA_HighWater = 0;
+static uint32_t MY_INT_ARENA_Failed = 0;
+
+/* Отчёт по областям */
+static MY_ARENA_Scope_t MY_INT_ARENA_Scopes[ARENA_SCOPES_MAX];
+static uint32_t MY_INT_ARENA_ScopesCount = 0;
+
+
+static uint32_t MY_INT_ARENA_Size(void)
+{
+	return (uint32_t)(_earena - _sarena);
+}
+
+
+void MY_ARENA_Init(void)
+{
+	uint32_t i;
+
+	MY_INT_ARENA_Top = 0;
+	MY_INT_ARENA_Peak = 0;
+	MY_INT_ARENA_HighWater = 0;
+	MY_INT_ARENA_Failed = 0;
+
+	/* Области остаются зарегистрированными: на записи ссылаются статические указатели в функциях */
+	for(i = 0; i < MY_INT_ARENA_ScopesCount; i++)
+	{
+		MY_INT_ARENA_Scopes[i].Count = 0;
+		MY_INT_ARENA_Scopes[i].Last = 0;
+		MY_INT_ARENA_Scopes[i].Peak = 0;
+		MY_INT_ARENA_Scopes[i].Failed = 0;
+	}
+}
+
+
+void* MY_ARENA_AllocAligned(uint32_t Size, uint32_t Align)
+{
+	uint32_t base = (uint32_t)_sarena;
+	uint32_t start;
+	uint32_t end;
+
+	if((Align == 0U) || ((Align & (Align - 1U)) != 0U))
+	{
+		return NULL;
+	}
+
+	/* Выравнивается абсолютный адрес, а не смещение */
+	start = ((base + MY_INT_ARENA_Top + (Align - 1U)) & ~(Align - 1U)) - base;
+	end = start + Size;
+
+	/* Переполнение: не хватает места или размер настолько велик, что сумма перешла через 0 */
+	if((end > MY_INT_ARENA_Size()) || (end < start))
+	{
+		MY_INT_ARENA_Failed++;
+
+		MY_ARENA_FailureCallback(end - MY_INT_ARENA_Top, MY_ARENA_GetFree());
+
+		return NULL;
+	}
+
+	MY_INT_ARENA_Top = end;
+
+	if(end > MY_INT_ARENA_HighWater)
+	{
+		MY_INT_ARENA_HighWater = end;
+	}
+
+	if(end > MY_INT_ARENA_Peak)
+	{
+		MY_INT_ARENA_Peak = end;
+	}
+
+	return _sarena + start;
+}
+
+
+void* MY_ARENA_Alloc(uint32_t Size)
+{
+	return MY_ARENA_AllocAligned(Size, ARENA_ALIGN);
+}
+
+
+MY_ARENA_Mark_t MY_ARENA_Mark(void)
+{
+	return MY_INT_ARENA_Top;
+}
+
+
+MY_Result_t MY_ARENA_Release(MY_ARENA_Mark_t Mark)
+{
+	if(Mark > MY_INT_ARENA_Top)
+	{
+		return MY_Result_Error;
+	}
+
+	MY_INT_ARENA_Top = Mark;
+
+	return MY_Result_Ok;
+}
+
+
+uint32_t MY_ARENA_GetFree(void)
+{
+	return MY_INT_ARENA_Size() - MY_INT_ARENA_Top;
+}
+
+
+void MY_ARENA_Scope_Begin(MY_ARENA_Scope_t **Scope, const char *Name, MY_ARENA_Frame_t *Frame)
+{
+	/* Регистрация области при первом проходе */
+	if((*Scope == NULL) && (MY_INT_ARENA_ScopesCount < ARENA_SCOPES_MAX))
+	{
+		*Scope = &MY_INT_ARENA_Scopes[MY_INT_ARENA_ScopesCount++];
+		(*Scope)->Name = Name;
+	}
+
+	/* Максимум вершины внешней области сохраняется и отсчитывается заново от текущей вершины */
+	Frame->Mark = MY_INT_ARENA_Top;
+	Frame->HighWater = MY_INT_ARENA_HighWater;
+	Frame->Failed = MY_INT_ARENA_Failed;
+
+	MY_INT_ARENA_HighWater = MY_INT_ARENA_Top;
+}
+
+
+void MY_ARENA_Scope_End(MY_ARENA_Scope_t *Scope, MY_ARENA_Frame_t *Frame)
+{
+	uint32_t used = MY_INT_ARENA_HighWater - Frame->Mark;
+
+	if(Scope != NULL)
+	{
+		Scope->Count++;
+		Scope->Last = used;
+		Scope->Failed += MY_INT_ARENA_Failed - Frame->Failed;
+
+		if(used > Scope->Peak)
+		{
+			Scope->Peak = used;
+		}
+	}
+
+	MY_ARENA_Release(Frame->Mark);
+
+	/* Вершина внутренней области - часть максимума внешней */
+	if(Frame->HighWater > MY_INT_ARENA_HighWater)
+	{
+		MY_INT_ARENA_HighWater = Frame->HighWater;
+	}
+}
+
+
+void MY_ARENA_GetStats(MY_ARENA_Stats_t *Stats)
+{
+	Stats->Size = MY_INT_ARENA_Size();
+	Stats->Used = MY_INT_ARENA_Top;
+	Stats->Peak = MY_INT_ARENA_Peak;
+	Stats->Failed = MY_INT_ARENA_Failed;
+}
+
+
+const MY_ARENA_Scope_t* MY_ARENA_GetScope(uint32_t Index)
+{
+	if(Index >= MY_INT_ARENA_ScopesCount)
+	{
+		return NULL;
+	}
+
+	return &MY_INT_ARENA_Scopes[Index];
+}
+
+
+void MY_ARENA_Dump(void)
+{
+	const MY_ARENA_Scope_t *scope;
+	uint32_t i;
+
+	printf("arena: size %lu, used %lu, peak %lu, failed %lu\r\n", (unsigned long)MY_INT_ARENA_Size(),
+		   (unsigned long)MY_INT_ARENA_Top, (unsigned long)MY_INT_ARENA_Peak, (unsigned long)MY_INT_ARENA_Failed);
+	printf("%-16s %10s %8s %8s %8s\r\n", "scope", "count", "last", "peak", "failed");
+
+	for(i = 0; i < MY_INT_ARENA_ScopesCount; i++)
+	{
+		scope = &MY_INT_ARENA_Scopes[i];
+
+		printf("%-16s %10lu %8lu %8lu %8lu\r\n", scope->Name, (unsigned long)scope->Count,
+			   (unsigned long)scope->Last, (unsigned long)scope->Peak, (unsigned long)scope->Failed);
+	}
+}
+
+
+__attribute__((weak)) void MY_ARENA_FailureCallback(uint32_t Size, uint32_t Free)
+{
+	/* Prevent unused argument(s) compilation warning */
+	UNUSED(Size);
+	UNUSED(Free);
+
+	/* NOTE : This function should not be modified, when the callback is needed, the @ref MY_ARENA_FailureCallback should be implemented in the user file */
+}
@@ -0,0 +1,155 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/boot
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Последовательность запуска и замер времени загрузки
+ */
+#include "my_stm32f0xx_rcc.h"
+#include "my_stm32f0xx_boot.h"
+
+#if (BOOT_TIMESTAMP_ENABLE == 1U)
+
+	/* Времена этапов в мкс от сброса */
+	static uint32_t MY_INT_BOOT_Timestamps[MY_BOOT_Phase_Count];
+
+	/* Значение TIM2 и частота его тактирования на момент предыдущей отметки */
+	static uint32_t MY_INT_BOOT_LastCount;
+	static uint32_t MY_INT_BOOT_LastClock;
+
+	/* Накопленное время в мкс */
+	static uint32_t MY_INT_BOOT_Elapsed;
+
+
+	/* Текущая частота тактирования TIM2 по регистрам RCC */
+	static uint32_t MY_INT_BOOT_TimerClock(void)
+	{
+		uint32_t cfgr = RCC->CFGR;
+		uint32_t clock;
+
+		switch (cfgr & RCC_CFGR_SWS)
+		{
+			case RCC_SYSCLKSOURCE_STATUS_PLLCLK:
+				clock = RCC_STATIC_PLLCLK;
+				break;
+
+			case RCC_SYSCLKSOURCE_STATUS_HSE:
+				clock = HSE_VALUE;
+				break;
+
+			default:
+				clock = HSI_VALUE;
+				break;
+		}
+
+		clock >>= AHBPrescTable[(cfgr & RCC_CFGR_HPRE) >> RCC_CFGR_HPRE_Pos];
+
+		/* При делителе APB больше 1 таймеры тактируются удвоенной частотой PCLK */
+		if(APBPrescTable[(cfgr & RCC_CFGR_PPRE) >> RCC_CFGR_PPRE_Pos] != 0U)
+		{
+			clock = (clock >> APBPrescTable[(cfgr & RCC_CFGR_PPRE) >> RCC_CFGR_PPRE_Pos]) << 1U;
+		}
+
+		return clock;
+	}
+
+#endif
+
+
+void MY_BOOT_EarlyInit(void)
+{
+	/* HSE запускается первым: время его выхода на режим перекрывается инициализацией .data/.bss */
+	if(RCC_STATIC_USES_HSE)
+	{
+		if(RCC_HSE_BYPASS_STATE)
+		{
+			SET_BIT(RCC->CR, RCC_CR_HSEBYP);
+		}
+
+		SET_BIT(RCC->CR, RCC_CR_HSEON);
+	}
+
+	#if (BOOT_TIMESTAMP_ENABLE == 1U)
+
+		/* TIM2 32-битный: считает такты от сброса без переполнения всё время загрузки */
+		SET_BIT(RCC->APB1ENR, RCC_APB1ENR_TIM2EN);
+		(void)READ_BIT(RCC->APB1ENR, RCC_APB1ENR_TIM2EN);
+
+		TIM2->PSC = 0U;
+		TIM2->ARR = 0xFFFFFFFFU;
+		TIM2->CNT = 0U;
+		TIM2->CR1 = TIM_CR1_CEN;
+
+	#endif
+}
+
+
+void MY_BOOT_Timestamp(MY_BOOT_Phase_t Phase)
+{
+	#if (BOOT_TIMESTAMP_ENABLE == 1U)
+
+		uint32_t count;
+		uint32_t clock_mhz;
+
+		if((Phase == MY_BOOT_Phase_Reset) || (Phase >= MY_BOOT_Phase_Count))
+		{
+			return;
+		}
+
+		/* Таймер уже остановлен после входа в main() */
+		if(MY_INT_BOOT_Timestamps[MY_BOOT_Phase_Main] != 0U)
+		{
+			return;
+		}
+
+		count = TIM2->CNT;
+
+		/* Отрезок с прошлой отметки считается по частоте, действовавшей на её момент.
+		   Смена частоты всегда окружена отметками, поэтому погрешность мала */
+		clock_mhz = ((MY_INT_BOOT_LastClock != 0U) ? MY_INT_BOOT_LastClock : HSI_VALUE) / 1000000U;
+
+		MY_INT_BOOT_Elapsed += (count - MY_INT_BOOT_LastCount) / clock_mhz;
+		MY_INT_BOOT_LastCount = count;
+		MY_INT_BOOT_LastClock = MY_INT_BOOT_TimerClock();
+
+		MY_INT_BOOT_Timestamps[Phase] = MY_INT_BOOT_Elapsed;
+
+		/* Замер окончен - возвращаем TIM2 в состояние после сброса */
+		if(Phase == MY_BOOT_Phase_Main)
+		{
+			TIM2->CR1 = 0U;
+
+			SET_BIT(RCC->APB1RSTR, RCC_APB1RSTR_TIM2RST);
+			CLEAR_BIT(RCC->APB1RSTR, RCC_APB1RSTR_TIM2RST);
+
+			CLEAR_BIT(RCC->APB1ENR, RCC_APB1ENR_TIM2EN);
+		}
+
+	#else
+
+		UNUSED(Phase);
+
+	#endif
+}
+
+
+uint32_t MY_BOOT_GetTimestamp(MY_BOOT_Phase_t Phase)
+{
+	#if (BOOT_TIMESTAMP_ENABLE == 1U)
+
+		if(Phase >= MY_BOOT_Phase_Count)
+		{
+			return 0U;
+		}
+
+		return MY_INT_BOOT_Timestamps[Phase];
+
+	#else
+
+		UNUSED(Phase);
+
+		return 0U;
+
+	#endif
+}
@@ -0,0 +1,313 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/button
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Обработка кнопок с подавлением дребезга контактов
+ */
+#include "my_stm32f0xx_button.h"
+#include "my_stm32f0xx_cortex.h"
+#include "my_stm32f0xx_pwr.h"
+
+/* Описание зарегистрированной кнопки */
+typedef struct
+{
+	uint8_t 			Port;			/* Индекс порта в MY_INT_BUTTON_Ports */
+	uint16_t 			Pin;			/* Маска пина */
+	uint16_t 			HoldSamples;	/* Длительность текущего удержания в отсчётах */
+	volatile uint8_t 	PressCount;		/* Счётчик нажатий, пишется только в прерывании */
+	volatile uint8_t 	ReleaseCount;	/* Счётчик отпусканий, пишется только в прерывании */
+	uint8_t 			PressSeen;		/* Последнее прочитанное значение PressCount */
+	uint8_t 			ReleaseSeen;	/* Последнее прочитанное значение ReleaseCount */
+}
+MY_INT_BUTTON_t;
+
+static MY_BUTTON_Port_t MY_INT_BUTTON_Ports[BUTTON_PORTS_MAX];
+static MY_INT_BUTTON_t MY_INT_BUTTON_Buttons[BUTTON_MAX];
+static volatile uint8_t MY_INT_BUTTON_PortsCount = 0;
+static volatile uint8_t MY_INT_BUTTON_Count = 0;
+static uint32_t MY_INT_BUTTON_LastSample = 0;
+
+/* Очередь событий: пишет только прерывание (Head), читает только основной цикл (Tail) */
+static MY_BUTTON_Event_t MY_INT_BUTTON_Queue[BUTTON_EVENT_QUEUE_SIZE];
+static volatile uint8_t MY_INT_BUTTON_QueueHead = 0;
+static volatile uint8_t MY_INT_BUTTON_QueueTail = 0;
+static volatile uint32_t MY_INT_BUTTON_Dropped = 0;
+
+
+static void MY_INT_BUTTON_PushEvent(uint8_t button, MY_BUTTON_EventType_t event)
+{
+	uint8_t head = MY_INT_BUTTON_QueueHead;
+	uint8_t next = (uint8_t)((head + 1U) & (BUTTON_EVENT_QUEUE_SIZE - 1U));
+
+	/* Очередь заполнена, событие теряется */
+	if(next == MY_INT_BUTTON_QueueTail)
+	{
+		MY_INT_BUTTON_Dropped++;
+		return;
+	}
+
+	MY_INT_BUTTON_Queue[head].Button = button;
+	MY_INT_BUTTON_Queue[head].Event = event;
+
+	/* Индекс публикуется после записи данных */
+	MY_INT_BUTTON_QueueHead = next;
+}
+
+
+MY_Result_t MY_BUTTON_Init(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, uint8_t PressedState, uint8_t *ButtonId)
+{
+	uint8_t port;
+
+	if(MY_INT_BUTTON_Count >= BUTTON_MAX)
+	{
+		return MY_Result_Error;
+	}
+
+	/* Ищем порт среди уже опрашиваемых */
+	for(port = 0; port < MY_INT_BUTTON_PortsCount; port++)
+	{
+		if(MY_INT_BUTTON_Ports[port].GPIOx == GPIOx)
+		{
+			break;
+		}
+	}
+
+	if(port == MY_INT_BUTTON_PortsCount)
+	{
+		if(MY_INT_BUTTON_PortsCount >= BUTTON_PORTS_MAX)
+		{
+			return MY_Result_Error;
+		}
+
+		MY_INT_BUTTON_Ports[port].GPIOx = GPIOx;
+		MY_INT_BUTTON_Ports[port].Mask = 0;
+		MY_INT_BUTTON_Ports[port].Invert = 0;
+		MY_INT_BUTTON_Ports[port].State = 0;
+		MY_INT_BUTTON_Ports[port].Cnt0 = 0;
+		MY_INT_BUTTON_Ports[port].Cnt1 = 0;
+
+		/* Порт с пустой маской опрашивается вхолостую, поэтому публикуется сразу */
+		MY_INT_BUTTON_PortsCount++;
+	}
+
+	MY_INT_BUTTON_Buttons[MY_INT_BUTTON_Count].Port = port;
+	MY_INT_BUTTON_Buttons[MY_INT_BUTTON_Count].Pin = GPIO_Pin;
+	MY_INT_BUTTON_Buttons[MY_INT_BUTTON_Count].HoldSamples = 0;
+	MY_INT_BUTTON_Buttons[MY_INT_BUTTON_Count].PressCount = 0;
+	MY_INT_BUTTON_Buttons[MY_INT_BUTTON_Count].ReleaseCount = 0;
+	MY_INT_BUTTON_Buttons[MY_INT_BUTTON_Count].PressSeen = 0;
+	MY_INT_BUTTON_Buttons[MY_INT_BUTTON_Count].ReleaseSeen = 0;
+
+	if(PressedState == 0)
+	{
+		MY_INT_BUTTON_Ports[port].Invert |= GPIO_Pin;
+	}
+
+	/* Маска дополняется последней: до этого пин не участвует в опросе */
+	MY_INT_BUTTON_Ports[port].Mask |= GPIO_Pin;
+
+	*ButtonId = MY_INT_BUTTON_Count;
+
+	MY_INT_BUTTON_Count++;
+
+	/* Простой без тиков не должен пропускать отсчёты */
+	MY_PWR_Deadline_Register(MY_BUTTON_GetIdleTicks);
+
+	return MY_Result_Ok;
+}
+
+
+void MY_BUTTON_Tick(void)
+{
+	if(MY_INT_BUTTON_PortsCount == 0)
+	{
+		return;
+	}
+
+	/* Период считается по uwTick: после простоя без тиков (tickless) обработчик вызывается реже 1 мс */
+	if((MY_SysTick_GetTick() - MY_INT_BUTTON_LastSample) >= BUTTON_SAMPLE_PERIOD)
+	{
+		MY_INT_BUTTON_LastSample = MY_SysTick_GetTick();
+
+		MY_BUTTON_Sample();
+	}
+}
+
+
+uint32_t MY_BUTTON_GetIdleTicks(void)
+{
+	uint32_t elapsed;
+
+	if(MY_INT_BUTTON_PortsCount == 0)
+	{
+		return 0xFFFFFFFFU;
+	}
+
+	elapsed = MY_SysTick_GetTick() - MY_INT_BUTTON_LastSample;
+
+	return (elapsed >= BUTTON_SAMPLE_PERIOD) ? 0U : (BUTTON_SAMPLE_PERIOD - elapsed);
+}
+
+
+uint16_t MY_BUTTON_Debounce(MY_BUTTON_Port_t *Port, uint16_t Sample)
+{
+	uint16_t delta;
+	uint16_t toggle;
+
+	/* Приводим к виду 1 - нажата и оставляем только пины кнопок */
+	Sample ^= Port->Invert;
+
+	/* Пины, у которых отсчёт отличается от устойчивого состояния */
+	delta = (uint16_t)((Sample ^ Port->State) & Port->Mask);
+
+	/* Инкремент 2-битного счётчика там, где есть расхождение, и сброс там, где его нет */
+	Port->Cnt1 = (uint16_t)((Port->Cnt1 ^ Port->Cnt0) & delta);
+	Port->Cnt0 = (uint16_t)(~Port->Cnt0 & delta);
+
+	/* Счётчик переполнился - новое значение продержалось 4 отсчёта подряд */
+	toggle = (uint16_t)(delta & ~(Port->Cnt0 | Port->Cnt1));
+
+	Port->State ^= toggle;
+
+	return toggle;
+}
+
+
+void MY_BUTTON_Sample(void)
+{
+	uint16_t toggled[BUTTON_PORTS_MAX];
+	uint8_t i;
+
+	for(i = 0; i < MY_INT_BUTTON_PortsCount; i++)
+	{
+		toggled[i] = MY_BUTTON_Debounce(&MY_INT_BUTTON_Ports[i], (uint16_t)MY_GPIO_GetPortInputValue(MY_INT_BUTTON_Ports[i].GPIOx));
+	}
+
+	for(i = 0; i < MY_INT_BUTTON_Count; i++)
+	{
+		MY_INT_BUTTON_t *button = &MY_INT_BUTTON_Buttons[i];
+		uint16_t state = MY_INT_BUTTON_Ports[button->Port].State & button->Pin;
+
+		if(toggled[button->Port] & button->Pin)
+		{
+			button->HoldSamples = 0;
+
+			if(state)
+			{
+				button->PressCount++;
+				MY_INT_BUTTON_PushEvent(i, MY_BUTTON_Event_Press);
+			}
+			else
+			{
+				button->ReleaseCount++;
+				MY_INT_BUTTON_PushEvent(i, MY_BUTTON_Event_Release);
+			}
+		}
+		else if(state)
+		{
+			/* Удержание: насыщаем счётчик, чтобы не было переполнения */
+			if(button->HoldSamples < 0xFFFFU)
+			{
+				button->HoldSamples++;
+			}
+
+			if(button->HoldSamples == BUTTON_LONGPRESS_SAMPLES)
+			{
+				MY_INT_BUTTON_PushEvent(i, MY_BUTTON_Event_LongPress);
+			}
+#if (BUTTON_REPEAT_SAMPLES > 0U)
+			else if(button->HoldSamples > BUTTON_LONGPRESS_SAMPLES)
+			{
+				if(((button->HoldSamples - BUTTON_LONGPRESS_SAMPLES) % BUTTON_REPEAT_SAMPLES) == 0U)
+				{
+					MY_INT_BUTTON_PushEvent(i, MY_BUTTON_Event_Repeat);
+				}
+
+				/* Перезапуск отсчёта повтора до насыщения счётчика */
+				if(button->HoldSamples >= (0xFFFFU - BUTTON_REPEAT_SAMPLES))
+				{
+					button->HoldSamples = BUTTON_LONGPRESS_SAMPLES;
+				}
+			}
+#endif
+		}
+	}
+}
+
+
+MY_Result_t MY_BUTTON_GetEvent(MY_BUTTON_Event_t *Event)
+{
+	uint8_t tail = MY_INT_BUTTON_QueueTail;
+
+	if(tail == MY_INT_BUTTON_QueueHead)
+	{
+		return MY_Result_Error;
+	}
+
+	*Event = MY_INT_BUTTON_Queue[tail];
+
+	MY_INT_BUTTON_QueueTail = (uint8_t)((tail + 1U) & (BUTTON_EVENT_QUEUE_SIZE - 1U));
+
+	return MY_Result_Ok;
+}
+
+
+uint8_t MY_BUTTON_IsPressed(uint8_t ButtonId)
+{
+	if(ButtonId >= MY_INT_BUTTON_Count)
+	{
+		return 0;
+	}
+
+	return (MY_INT_BUTTON_Ports[MY_INT_BUTTON_Buttons[ButtonId].Port].State & MY_INT_BUTTON_Buttons[ButtonId].Pin) ? 1 : 0;
+}
+
+
+uint8_t MY_BUTTON_OnPressed(uint8_t ButtonId)
+{
+	uint8_t count;
+
+	if(ButtonId >= MY_INT_BUTTON_Count)
+	{
+		return 0;
+	}
+
+	count = MY_INT_BUTTON_Buttons[ButtonId].PressCount;
+
+	if(count != MY_INT_BUTTON_Buttons[ButtonId].PressSeen)
+	{
+		MY_INT_BUTTON_Buttons[ButtonId].PressSeen = count;
+		return 1;
+	}
+
+	return 0;
+}
+
+
+uint8_t MY_BUTTON_OnReleased(uint8_t ButtonId)
+{
+	uint8_t count;
+
+	if(ButtonId >= MY_INT_BUTTON_Count)
+	{
+		return 0;
+	}
+
+	count = MY_INT_BUTTON_Buttons[ButtonId].ReleaseCount;
+
+	if(count != MY_INT_BUTTON_Buttons[ButtonId].ReleaseSeen)
+	{
+		MY_INT_BUTTON_Buttons[ButtonId].ReleaseSeen = count;
+		return 1;
+	}
+
+	return 0;
+}
+
+
+uint32_t MY_BUTTON_GetDroppedEvents(void)
+{
+	return MY_INT_BUTTON_Dropped;
+}
@@ -0,0 +1,214 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/console
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Буферизованный неблокирующий вывод printf() через USART1
+ */
+#include "my_stm32f0xx_console.h"
+#include "my_stm32f0xx_rcc.h"
+#include "my_stm32f0xx_gpio.h"
+#include "my_stm32f0xx_cortex.h"
+#include "my_stm32f0xx_pwr.h"
+#include "my_stm32f0xx_utils.h"
+
+#if ((CONSOLE_BUFFER_SIZE & (CONSOLE_BUFFER_SIZE - 1U)) != 0U)
+	#error "CONSOLE_BUFFER_SIZE must be a power of two"
+#endif
+
+#define MY_INT_CONSOLE_MASK						(CONSOLE_BUFFER_SIZE - 1U)
+
+/* Кольцевой буфер: счётчики идут непрерывно, индекс - младшие биты. Reserve - место, занятое писателями,
+   Head - конец скопированных данных, Tail - конец переданных, его меняет только прерывание */
+static uint8_t MY_INT_CONSOLE_Buffer[CONSOLE_BUFFER_SIZE];
+static volatile uint32_t MY_INT_CONSOLE_Reserve = 0;
+static volatile uint32_t MY_INT_CONSOLE_Head = 0;
+static volatile uint32_t MY_INT_CONSOLE_Tail = 0;
+
+/* Писатели, которые заняли место и ещё копируют данные */
+static volatile uint32_t MY_INT_CONSOLE_Writers = 0;
+
+/* Статистика меняется при запрещённых прерываниях */
+static MY_CONSOLE_Stats_t MY_INT_CONSOLE_Stats;
+
+static uint8_t MY_INT_CONSOLE_Ready = 0;
+
+
+static void MY_INT_CONSOLE_SetBaudrate(void)
+{
+	uint32_t clock = MY_RCC_PeriphClock_GetFreq(RCC_PERIPHCLK_USART1);
+
+	/* BRR можно менять только при выключенном USART. Передаваемый байт будет потерян */
+	CLEAR_BIT(USART1->CR1, USART_CR1_UE);
+
+	/* Передискретизация 16: BRR = fCK / скорость с округлением */
+	USART1->BRR = (clock + (CONSOLE_BAUDRATE / 2U)) / CONSOLE_BAUDRATE;
+
+	SET_BIT(USART1->CR1, USART_CR1_UE);
+}
+
+
+static void MY_INT_CONSOLE_ClockChanged(const MY_RCC_Clocks_t *Clocks)
+{
+	UNUSED(Clocks);
+
+	MY_INT_CONSOLE_SetBaudrate();
+}
+
+
+static MY_PWR_State_t MY_INT_CONSOLE_PowerConstraint(void)
+{
+	/* В Stop USART не тактируется: ждём передачи буфера и последнего байта из сдвигового регистра */
+	if((MY_INT_CONSOLE_Head != MY_INT_CONSOLE_Tail) || !READ_BIT(USART1->ISR, USART_ISR_TC))
+	{
+		return MY_PWR_State_Sleep;
+	}
+
+	return MY_PWR_State_Standby;
+}
+
+
+void MY_CONSOLE_Init(void)
+{
+	MY_RCC_USART1_CLK_ENABLE();
+
+	MY_GPIO_InitAlternate(CONSOLE_TX_PORT, CONSOLE_TX_PIN, MY_GPIO_OType_PP, MY_GPIO_PuPd_Up, MY_GPIO_Speed_High, CONSOLE_TX_AF);
+
+	/* 8N1, только передача */
+	USART1->CR1 = USART_CR1_TE;
+	USART1->CR2 = 0;
+	USART1->CR3 = 0;
+
+	MY_INT_CONSOLE_SetBaudrate();
+
+	MY_RCC_ClockChange_Register(MY_INT_CONSOLE_ClockChanged);
+	MY_PWR_Constraint_Register(MY_INT_CONSOLE_PowerConstraint);
+
+	MY_NVIC_Priority_Set(USART1_IRQn, CONSOLE_IRQ_PRIORITY);
+	MY_NVIC_EnableIRQ(USART1_IRQn);
+
+	MY_INT_CONSOLE_Ready = 1;
+
+	/* Вывод, накопленный до инициализации */
+	if(MY_INT_CONSOLE_Head != MY_INT_CONSOLE_Tail)
+	{
+		SET_BIT(USART1->CR1, USART_CR1_TXEIE);
+	}
+}
+
+
+uint32_t MY_CONSOLE_Write(const char *Data, uint32_t Size)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t reserve;
+	uint32_t used;
+	uint32_t count;
+	uint32_t i;
+
+	/* Занимаем место: короткая секция, копирование идёт при разрешённых прерываниях */
+	__disable_irq();
+
+	reserve = MY_INT_CONSOLE_Reserve;
+	used = reserve - MY_INT_CONSOLE_Tail;
+	count = CONSOLE_BUFFER_SIZE - used;
+
+	if(count < Size)
+	{
+		MY_INT_CONSOLE_Stats.Dropped += Size - count;
+		MY_INT_CONSOLE_Stats.Overflows++;
+	}
+	else
+	{
+		count = Size;
+	}
+
+	MY_INT_CONSOLE_Reserve = reserve + count;
+	MY_INT_CONSOLE_Writers++;
+
+	MY_INT_CONSOLE_Stats.Written += count;
+
+	if((used + count) > MY_INT_CONSOLE_Stats.Peak)
+	{
+		MY_INT_CONSOLE_Stats.Peak = used + count;
+	}
+
+	__set_PRIMASK(primask);
+
+	for(i = 0; i < count; i++)
+	{
+		MY_INT_CONSOLE_Buffer[(reserve + i) & MY_INT_CONSOLE_MASK] = (uint8_t)Data[i];
+	}
+
+	__disable_irq();
+
+	/* Писатель в прерывании заканчивает раньше прерванного: Head сдвигает последний из вложенных,
+	   когда скопировано всё занятое. Данные должны оказаться в буфере раньше нового Head */
+	if(--MY_INT_CONSOLE_Writers == 0U)
+	{
+		__DMB();
+
+		if((MY_INT_CONSOLE_Reserve != MY_INT_CONSOLE_Head) && MY_INT_CONSOLE_Ready)
+		{
+			SET_BIT(USART1->CR1, USART_CR1_TXEIE);
+		}
+
+		MY_INT_CONSOLE_Head = MY_INT_CONSOLE_Reserve;
+	}
+
+	__set_PRIMASK(primask);
+
+	return count;
+}
+
+
+uint32_t MY_CONSOLE_GetFree(void)
+{
+	return CONSOLE_BUFFER_SIZE - (MY_INT_CONSOLE_Reserve - MY_INT_CONSOLE_Tail);
+}
+
+
+MY_Result_t MY_CONSOLE_Flush(uint32_t Timeout)
+{
+	uint32_t tickstart = MY_SysTick_GetTick();
+
+	while((MY_INT_CONSOLE_Head != MY_INT_CONSOLE_Tail) || (MY_INT_CONSOLE_Ready && !READ_BIT(USART1->ISR, USART_ISR_TC)))
+	{
+		/* Без инициализации буфер никогда не опустеет */
+		if(!MY_INT_CONSOLE_Ready || ((MY_SysTick_GetTick() - tickstart) >= Timeout))
+		{
+			return MY_Result_Timeout;
+		}
+	}
+
+	return MY_Result_Ok;
+}
+
+
+void MY_CONSOLE_GetStats(MY_CONSOLE_Stats_t *Stats)
+{
+	*Stats = MY_INT_CONSOLE_Stats;
+}
+
+
+void MY_CONSOLE_IRQHandler(void)
+{
+	uint32_t tail = MY_INT_CONSOLE_Tail;
+
+	if(!READ_BIT(USART1->ISR, USART_ISR_TXE) || !READ_BIT(USART1->CR1, USART_CR1_TXEIE))
+	{
+		return;
+	}
+
+	if(tail == MY_INT_CONSOLE_Head)
+	{
+		CLEAR_BIT(USART1->CR1, USART_CR1_TXEIE);
+
+		return;
+	}
+
+	/* Запись TDR сбрасывает TXE */
+	USART1->TDR = MY_INT_CONSOLE_Buffer[tail & MY_INT_CONSOLE_MASK];
+
+	MY_INT_CONSOLE_Tail = tail + 1U;
+}
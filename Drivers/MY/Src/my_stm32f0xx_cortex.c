@@ -8,10 +8,100 @@
  */
 
 #include "my_stm32f0xx_cortex.h"
+#include "my_stm32f0xx_utils.h"
 
 /* Глобальная переменная, в которой содержится текущее значение счетчика таймера SysTick */
 volatile uint32_t uwTick;
 
+/* Таблица векторов во Flash из startup_stm32f051r8tx.s */
+extern const MY_NVIC_Handler_t g_pfnVectors[MY_NVIC_VECTORS_COUNT];
+
+#if (NVIC_VECTORS_IN_RAM == 1U)
+
+	/* Таблица векторов в SRAM, линкер размещает её по адресу 0x20000000 */
+	static volatile MY_NVIC_Handler_t MY_INT_NVIC_Vectors[MY_NVIC_VECTORS_COUNT] __attribute__((section(".ram_vector"), used));
+
+#endif
+
+/* Старшее слово 64-битного счётчика тиков и счётчик последовательности для чтения без разрыва.
+   MY_INT_SysTick_Seq меняется при каждом обновлении счётчика тиков */
+static volatile uint32_t MY_INT_SysTick_TickHigh;
+static volatile uint32_t MY_INT_SysTick_Seq;
+
+
+/* Увеличение счётчика тиков с переносом в старшее слово.
+   Обновление выполняется при запрещённых прерываниях: читатель в прерывании с более высоким
+   приоритетом не может застать его незавершённым и ждать бесконечно */
+MY_RAMFUNC static void MY_INT_SysTick_Advance(uint32_t Ticks)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t low;
+
+	__disable_irq();
+
+	low = uwTick + Ticks;
+
+	if(low < uwTick)
+	{
+		MY_INT_SysTick_TickHigh++;
+	}
+
+	uwTick = low;
+	MY_INT_SysTick_Seq++;
+
+	__set_PRIMASK(primask);
+}
+
+
+/* Согласованный снимок: тики и значение счётчика SysTick */
+static uint64_t MY_INT_SysTick_Snapshot(uint32_t *Val, uint32_t *Load)
+{
+	uint32_t seq;
+	uint32_t low;
+	uint32_t high;
+	uint32_t val;
+	uint32_t load;
+
+	do
+	{
+		seq = MY_INT_SysTick_Seq;
+		__DMB();
+
+		low = uwTick;
+		high = MY_INT_SysTick_TickHigh;
+		load = SysTick->LOAD;
+		val = SysTick->VAL;
+
+		/* Счётчик перезагрузился, а прерывание ещё не обработано
+		   (вызов из прерывания с более высоким приоритетом или при запрещённых прерываниях) */
+		if(SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+		{
+			val = SysTick->VAL;
+
+			if(++low == 0U)
+			{
+				high++;
+			}
+		}
+
+		__DMB();
+	}
+	while(seq != MY_INT_SysTick_Seq);
+
+	if(Val != NULL)
+	{
+		*Val = val;
+	}
+
+	if(Load != NULL)
+	{
+		*Load = load;
+	}
+
+	return ((uint64_t)high << 32) | low;
+}
+
+
 void MY_SysTick_Init(uint32_t ticks, uint32_t TickPriority)
 {
 	/* Настраиваем источник тактирования для SysTick */
@@ -44,18 +134,71 @@ void MY_SysTick_ClockSourceConfig(uint32_t ClockSource)
 }
 
 
-void MY_SysTick_IncTick(void)
+MY_RAMFUNC void MY_SysTick_IncTick(void)
 {
-	uwTick++;
+	MY_INT_SysTick_Advance(1U);
 }
 
 
-uint32_t MY_SysTick_GetTick(void)
+MY_RAMFUNC uint32_t MY_SysTick_GetTick(void)
 {
 	return uwTick;
 }
 
 
+uint64_t MY_SysTick_GetTick64(void)
+{
+	return MY_INT_SysTick_Snapshot(NULL, NULL);
+}
+
+
+uint64_t MY_SysTick_GetMicros(void)
+{
+	uint32_t val;
+	uint32_t load;
+	uint64_t ticks = MY_INT_SysTick_Snapshot(&val, &load);
+
+	/* Тик - 1 мс, дробная часть по уже отсчитанной части периода SysTick */
+	return (ticks * 1000U) + ((((uint64_t)(load - val)) * 1000U) / (load + 1U));
+}
+
+
+uint64_t MY_SysTick_GetCycles(void)
+{
+	uint32_t val;
+	uint32_t load;
+	uint64_t ticks = MY_INT_SysTick_Snapshot(&val, &load);
+
+	return (ticks * (load + 1U)) + (load - val);
+}
+
+
+uint64_t MY_SysTick_Deadline(uint32_t TimeoutUs)
+{
+	return MY_SysTick_GetMicros() + TimeoutUs;
+}
+
+
+uint8_t MY_SysTick_Deadline_Expired(uint64_t Deadline)
+{
+	return (MY_SysTick_GetMicros() >= Deadline) ? 1U : 0U;
+}
+
+
+uint32_t MY_SysTick_Deadline_Remaining(uint64_t Deadline)
+{
+	uint64_t now = MY_SysTick_GetMicros();
+
+	if(now >= Deadline)
+	{
+		return 0U;
+	}
+
+	/* Насыщение для сроков дальше ~71 минуты */
+	return ((Deadline - now) > 0xFFFFFFFFU) ? 0xFFFFFFFFU : (uint32_t)(Deadline - now);
+}
+
+
 void MY_SysTick_SuspendTick(void)
 {
 	/* Выключаем прерывания от SysTick */
@@ -70,6 +213,101 @@ void MY_SysTick_ResumeTick(void)
 }
 
 
+uint32_t MY_SysTick_Tickless_Idle(uint32_t IdleTicks)
+{
+	uint32_t per_tick = SysTick->LOAD + 1U;
+	uint32_t max_ticks = SysTick_LOAD_RELOAD_Msk / per_tick;
+	uint32_t reload;
+	uint32_t next;
+	uint32_t since;
+	uint32_t val;
+	uint32_t completed;
+	uint32_t ctrl;
+	uint32_t primask;
+
+	if(IdleTicks > max_ticks)
+	{
+		IdleTicks = max_ticks;
+	}
+
+	/* Короткий простой - достаточно дождаться следующего тика */
+	if(IdleTicks < SYSTICK_TICKLESS_MIN_IDLE)
+	{
+		__WFI();
+
+		return 0U;
+	}
+
+	/* WFI пробуждает ядро и при запрещённых прерываниях, обработчик выполнится после компенсации */
+	primask = __get_PRIMASK();
+	__disable_irq();
+
+	CLEAR_BIT(SysTick->CTRL, SysTick_CTRL_ENABLE_Msk);
+
+	/* Тик уже наступил - uwTick должен увеличиться в обработчике, спать нельзя */
+	if(SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+	{
+		SET_BIT(SysTick->CTRL, SysTick_CTRL_ENABLE_Msk);
+		__set_PRIMASK(primask);
+
+		return 0U;
+	}
+
+	/* Тактов до границы текущего тика. VAL = 0 без ожидающего прерывания - граница уже обработана */
+	val = SysTick->VAL;
+	next = (val != 0U) ? val : per_tick;
+
+	/* После запуска первый такт загружает LOAD, поэтому счётчик обнулится через reload + 1 тактов:
+	   ровно на границе IdleTicks-го тика */
+	reload = (next - 1U) + (per_tick * (IdleTicks - 1U));
+
+	SysTick->LOAD = reload;
+	SysTick->VAL = 0U;
+	SET_BIT(SysTick->CTRL, SysTick_CTRL_ENABLE_Msk);
+
+	__DSB();
+	__WFI();
+	__ISB();
+
+	/* Чтение CTRL сбрасывает COUNTFLAG, поэтому остановка выполняется записью прочитанного значения.
+	   Повторное чтение ловит обнуление счётчика между первым чтением и остановкой */
+	ctrl = SysTick->CTRL;
+	SysTick->CTRL = ctrl & ~SysTick_CTRL_ENABLE_Msk;
+	ctrl |= SysTick->CTRL;
+	val = SysTick->VAL;
+
+	/* Тактов от границы тика, предшествовавшей сну. Если интервал истёк (COUNTFLAG), счётчик
+	   перезагрузился на границе IdleTicks-го тика и VAL отсчитывается от неё */
+	since = (ctrl & SysTick_CTRL_COUNTFLAG_Msk) ? (per_tick * IdleTicks) : (per_tick - next);
+	since += (val != 0U) ? (reload - val + 1U) : 0U;
+
+	/* Последний тик полного интервала добавит ожидающее прерывание SysTick */
+	completed = (since / per_tick) - ((ctrl & SysTick_CTRL_COUNTFLAG_Msk) ? 1U : 0U);
+
+	/* Остаток текущего тика, чтобы фаза SysTick не сбилась. При LOAD = 0 прерывания нет:
+	   граница через такт учитывается сразу, а счётчик отсчитывает до следующей */
+	reload = (per_tick - 1U) - (since % per_tick);
+
+	if(reload == 0U)
+	{
+		completed++;
+		reload = per_tick;
+	}
+
+	/* Один период с вычисленным остатком, затем снова 1 мс */
+	SysTick->LOAD = reload;
+	SysTick->VAL = 0U;
+	SET_BIT(SysTick->CTRL, SysTick_CTRL_ENABLE_Msk);
+	SysTick->LOAD = per_tick - 1U;
+
+	MY_INT_SysTick_Advance(completed);
+
+	__set_PRIMASK(primask);
+
+	return completed;
+}
+
+
 void MY_NVIC_EnableIRQ(IRQn_Type IRQn)
 {
 	/* Включаем прерывание */
@@ -126,6 +364,97 @@ void MY_NVIC_SystemReset(void)
 }
 
 
+MY_Result_t MY_NVIC_Vectors_Relocate(void)
+{
+	#if (NVIC_VECTORS_IN_RAM == 1U)
+
+		uint32_t primask = __get_PRIMASK();
+		uint32_t i;
+
+		__disable_irq();
+
+		for(i = 0; i < MY_NVIC_VECTORS_COUNT; i++)
+		{
+			MY_INT_NVIC_Vectors[i] = g_pfnVectors[i];
+		}
+
+		/* MEM_MODE = 11: по адресу 0x00000000 отображается SRAM */
+		MODIFY_REG(SYSCFG->CFGR1, SYSCFG_CFGR1_MEM_MODE, SYSCFG_CFGR1_MEM_MODE);
+
+		__DSB();
+		__ISB();
+
+		__set_PRIMASK(primask);
+
+		return MY_Result_Ok;
+
+	#else
+
+		return MY_Result_Error;
+
+	#endif
+}
+
+
+MY_Result_t MY_NVIC_SetVector(IRQn_Type IRQn, MY_NVIC_Handler_t Handler)
+{
+	#if (NVIC_VECTORS_IN_RAM == 1U)
+
+		int32_t index = (int32_t)IRQn + 16;
+
+		/* Вектор сброса и начальный указатель стека читаются только из Flash при сбросе */
+		if((index < 2) || (index >= (int32_t)MY_NVIC_VECTORS_COUNT) || (Handler == NULL))
+		{
+			return MY_Result_Error;
+		}
+
+		if((SYSCFG->CFGR1 & SYSCFG_CFGR1_MEM_MODE) != SYSCFG_CFGR1_MEM_MODE)
+		{
+			return MY_Result_Error;
+		}
+
+		/* Запись слова атомарна, прерывание видит либо старый, либо новый обработчик */
+		MY_INT_NVIC_Vectors[index] = Handler;
+
+		__DSB();
+		__ISB();
+
+		return MY_Result_Ok;
+
+	#else
+
+		UNUSED(IRQn);
+		UNUSED(Handler);
+
+		return MY_Result_Error;
+
+	#endif
+}
+
+
+MY_NVIC_Handler_t MY_NVIC_GetVector(IRQn_Type IRQn)
+{
+	int32_t index = (int32_t)IRQn + 16;
+
+	if((index < 1) || (index >= (int32_t)MY_NVIC_VECTORS_COUNT))
+	{
+		return NULL;
+	}
+
+	#if (NVIC_VECTORS_IN_RAM == 1U)
+
+		/* Действующая таблица - та, что отображена на адрес 0x00000000 */
+		if((SYSCFG->CFGR1 & SYSCFG_CFGR1_MEM_MODE) == SYSCFG_CFGR1_MEM_MODE)
+		{
+			return MY_INT_NVIC_Vectors[index];
+		}
+
+	#endif
+
+	return g_pfnVectors[index];
+}
+
+
 uint32_t MY_REVID_Get(void)
 {
 	return((DBGMCU->IDCODE) >> 16U);
@@ -8,12 +8,22 @@
  */
 #include "my_stm32f0xx_cortex.h"
 #include "my_stm32f0xx_delay.h"
+#include "my_stm32f0xx_os.h"
 
 void MY_Delay_ms(__IO uint32_t delay_ms)
 {
 	uint32_t tickstart = MY_SysTick_GetTick();
 	uint32_t wait = delay_ms;
 
+	#if (USE_RTOS == 1U)
+		/* Из задачи - ожидание без загрузки процессора */
+		if(MY_OS_IsRunning() && (__get_IPSR() == 0U))
+		{
+			MY_OS_Delay(wait);
+			return;
+		}
+	#endif
+
 	/* Добавим период для гарантии отсчёта одного периода
 	if (wait < MAX_DELAY)
 	{
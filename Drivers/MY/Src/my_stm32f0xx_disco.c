@@ -9,9 +9,10 @@
 
 #include "my_stm32f0xx_disco.h"
 #include "my_stm32f0xx_gpio.h"
+#include "my_stm32f0xx_button.h"
 
-/* Статус текущего состояния кнопки в событиях нажата/отпущена */
-static volatile uint8_t MY_INT_DISCO_ButtonPressed = 0;
+/* Номер кнопки в обработчике MY_BUTTON */
+static uint8_t MY_INT_DISCO_ButtonId = 0xFF;
 
 
 void MY_DISCO_LedInit(void)
@@ -28,55 +29,23 @@ void MY_DISCO_ButtonInit(void)
 {
 	/* Устанавливает пины как вход */
 	MY_GPIO_Init(DISCO_BUTTON_PORT, DISCO_BUTTON_PIN, MY_GPIO_Mode_In, MY_GPIO_OType_PP, DISCO_BUTTON_PULL, MY_GPIO_Speed_High);
+
+	/* Повторная инициализация не должна занимать ещё один слот */
+	if(MY_INT_DISCO_ButtonId == 0xFF)
+	{
+		MY_BUTTON_Init(DISCO_BUTTON_PORT, DISCO_BUTTON_PIN, DISCO_BUTTON_PRESSED, &MY_INT_DISCO_ButtonId);
+	}
 }
 
 
 uint8_t MY_DISCO_ButtonOnPressed(void)
 {
-	/* If button is now pressed, but was not already pressed */
-	if (MY_DISCO_ButtonPressed())
-	{
-		if (!MY_INT_DISCO_ButtonPressed)
-		{
-			/* Set flag */
-			MY_INT_DISCO_ButtonPressed = 1;
-
-			/* Return button onpressed */
-			return 1;
-		}
-	}
-	else
-	{
-		/* Clear flag */
-		MY_INT_DISCO_ButtonPressed = 0;
-	}
-
-	/* Button is not pressed or it was already pressed before */
-	return 0;
+	/* Фронты считает обработчик дребезга, отдельно для нажатия и отпускания */
+	return MY_BUTTON_OnPressed(MY_INT_DISCO_ButtonId);
 }
 
 
 uint8_t MY_DISCO_ButtonOnReleased(void)
 {
-	/* If button is now released, but was not already released */
-	if (!MY_DISCO_ButtonPressed())
-	{
-		if (MY_INT_DISCO_ButtonPressed)
-		{
-			/* Set flag */
-			MY_INT_DISCO_ButtonPressed = 0;
-
-			/* Return button onreleased */
-			return 1;
-		}
-	}
-	else
-	{
-		/* Set flag */
-		MY_INT_DISCO_ButtonPressed = 1;
-	}
-
-	/* Button is not released or it was already released before */
-	return 0;
+	return MY_BUTTON_OnReleased(MY_INT_DISCO_ButtonId);
 }
-
@@ -7,4 +7,718 @@
  * @brief   Утилиты для работы с DMA
  */
 
+#include <string.h>
 #include "my_stm32f0xx_dma.h"
+#include "my_stm32f0xx_rcc.h"
+#include "my_stm32f0xx_cortex.h"
+#include "my_stm32f0xx_pwr.h"
+
+/* Приватные функции */
+static void MY_DMA_INT_SetConfig(MY_DMA_Handle_t *DMA_Handler, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength);
+static MY_Result_t MY_DMA_INT_Prepare(MY_DMA_Handle_t *DMA_Handler, uint32_t DataLength);
+static MY_PWR_State_t MY_DMA_INT_PowerConstraint(void);
+static MY_Result_t MY_DMA_INT_Mem_Run(uint8_t *Dst, const uint8_t *Src, uint8_t Value, uint32_t Size, MY_DMA_Mem_Callback_t Callback, void *Context, uint8_t Mode);
+
+
+/* Структуры каналов DMA1 */
+static MY_DMA_Handle_t DMA1Handlers[DMA_CHANNELS] =
+{
+	{DMA1_Channel1},
+	{DMA1_Channel2},
+	{DMA1_Channel3},
+	{DMA1_Channel4},
+	{DMA1_Channel5}
+};
+
+
+/* Завершение асинхронного копирования и значение для заполнения (источник DMA без инкремента) */
+static MY_DMA_Mem_Callback_t MY_DMA_INT_MemCallback;
+static void *MY_DMA_INT_MemContext;
+static uint32_t MY_DMA_INT_MemPattern;
+
+
+/* Режимы MY_DMA_INT_Mem_Run() */
+#define MY_DMA_INT_MEM_SET			0x01U		/*!< Заполнение вместо копирования */
+#define MY_DMA_INT_MEM_ASYNC		0x02U		/*!< Без ожидания, завершение в прерывании */
+#define MY_DMA_INT_MEM_FORCE		0x04U		/*!< DMA независимо от порога (измерение) */
+
+
+/* Флаги канала в DMA_ISR и DMA_IFCR */
+#define MY_DMA_INT_FLAGS(__HANDLER__, __FLAG__)		((uint32_t)(__FLAG__) << (__HANDLER__)->ChannelIndex)
+
+
+MY_DMA_Handle_t* MY_DMA_GetHandler(DMA_Channel_TypeDef *Channel)
+{
+	uint32_t i;
+
+	for(i = 0; i < DMA_CHANNELS; i++)
+	{
+		if(DMA1Handlers[i].Instance == Channel)
+		{
+			return &DMA1Handlers[i];
+		}
+	}
+
+	/* Return invalid */
+	return 0;
+}
+
+
+MY_Result_t MY_DMA_Init(DMA_Channel_TypeDef *Channel, MY_DMA_Init_t *Init)
+{
+	MY_DMA_Handle_t *DMA_Handler = MY_DMA_GetHandler(Channel);
+	uint32_t index;
+
+	/* Проверяем валидность переданных параметров */
+	if((DMA_Handler == NULL) || (Init == NULL))
+	{
+		return MY_Result_Error;
+	}
+
+	/* Циклический режим не может быть использован для передачи memory-to-memory */
+	if((Init->Direction == DMA_MEMORY_TO_MEMORY) && (Init->Mode == DMA_MODE_CIRCULAR))
+	{
+		return MY_Result_Error;
+	}
+
+	/* Блокируем структуру */
+	if(MY_Lock_Acquire(&DMA_Handler->Lock, DMA_TIMEOUT_BUSY) != MY_Result_Ok)
+	{
+		return MY_Result_Busy;
+	}
+
+	if(DMA_Handler->State == MY_DMA_State_Busy)
+	{
+		MY_Lock_Release(&DMA_Handler->Lock);
+
+		return MY_Result_Busy;
+	}
+
+	MY_RCC_DMA1_CLK_ENABLE();
+
+	/* Каналы расположены в DMA1 подряд через 20 байт, флаги канала занимают 4 бита */
+	index = ((uint32_t)Channel - (uint32_t)DMA1_Channel1) / ((uint32_t)DMA1_Channel2 - (uint32_t)DMA1_Channel1);
+
+	DMA_Handler->ChannelIndex = index * 4U;
+	DMA_Handler->IRQn = (index == 0U) ? DMA1_Channel1_IRQn : ((index <= 2U) ? DMA1_Channel2_3_IRQn : DMA1_Channel4_5_IRQn);
+	DMA_Handler->Init = *Init;
+
+	/* Канал выключен, записываем конфигурацию целиком */
+	Channel->CCR = Init->Direction | Init->PeriphInc | Init->MemInc | Init->PeriphDataAlignment |
+				   Init->MemDataAlignment | Init->Mode | Init->Priority;
+
+	DMA1->IFCR = MY_DMA_INT_FLAGS(DMA_Handler, DMA_FLAG_GL);
+
+	DMA_Handler->XferCpltCallback = NULL;
+	DMA_Handler->XferHalfCpltCallback = NULL;
+	DMA_Handler->XferErrorCallback = NULL;
+	DMA_Handler->XferAbortCallback = NULL;
+
+	DMA_Handler->ErrorCode = DMA_ERROR_NONE;
+	DMA_Handler->State = MY_DMA_State_Ready;
+
+	/* Пока идёт передача, тактирование DMA нельзя останавливать */
+	MY_PWR_Constraint_Register(MY_DMA_INT_PowerConstraint);
+
+	MY_Lock_Release(&DMA_Handler->Lock);
+
+	return MY_Result_Ok;
+}
+
+
+MY_Result_t MY_DMA_DeInit(MY_DMA_Handle_t *DMA_Handler)
+{
+	if((DMA_Handler == NULL) || (DMA_Handler->State == MY_DMA_State_Reset))
+	{
+		return MY_Result_Error;
+	}
+
+	if(MY_Lock_Acquire(&DMA_Handler->Lock, DMA_TIMEOUT_BUSY) != MY_Result_Ok)
+	{
+		return MY_Result_Busy;
+	}
+
+	/* Выключаем канал и сбрасываем его регистры */
+	CLEAR_BIT(DMA_Handler->Instance->CCR, DMA_CCR_EN);
+
+	DMA_Handler->Instance->CCR = 0U;
+	DMA_Handler->Instance->CNDTR = 0U;
+	DMA_Handler->Instance->CPAR = 0U;
+	DMA_Handler->Instance->CMAR = 0U;
+
+	DMA1->IFCR = MY_DMA_INT_FLAGS(DMA_Handler, DMA_FLAG_GL);
+
+	DMA_Handler->ErrorCode = DMA_ERROR_NONE;
+	DMA_Handler->State = MY_DMA_State_Reset;
+
+	MY_Lock_Release(&DMA_Handler->Lock);
+
+	return MY_Result_Ok;
+}
+
+
+/* Проверка и перевод канала в Busy. Блокировка удерживается только на время проверки:
+   передача завершается в прерывании, где чужую блокировку освободить нельзя */
+static MY_Result_t MY_DMA_INT_Prepare(MY_DMA_Handle_t *DMA_Handler, uint32_t DataLength)
+{
+	if((DMA_Handler == NULL) || (DataLength == 0U) || (DataLength > DMA_CNDTR_NDT))
+	{
+		return MY_Result_Error;
+	}
+
+	if(MY_Lock_Acquire(&DMA_Handler->Lock, DMA_TIMEOUT_BUSY) != MY_Result_Ok)
+	{
+		return MY_Result_Busy;
+	}
+
+	if(DMA_Handler->State == MY_DMA_State_Busy)
+	{
+		MY_Lock_Release(&DMA_Handler->Lock);
+
+		return MY_Result_Busy;
+	}
+
+	if(DMA_Handler->State == MY_DMA_State_Reset)
+	{
+		MY_Lock_Release(&DMA_Handler->Lock);
+
+		return MY_Result_Error;
+	}
+
+	DMA_Handler->State = MY_DMA_State_Busy;
+	DMA_Handler->ErrorCode = DMA_ERROR_NONE;
+
+	MY_Lock_Release(&DMA_Handler->Lock);
+
+	return MY_Result_Ok;
+}
+
+
+/* Запись адресов и длины в выключенный канал */
+static void MY_DMA_INT_SetConfig(MY_DMA_Handle_t *DMA_Handler, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength)
+{
+	CLEAR_BIT(DMA_Handler->Instance->CCR, DMA_CCR_EN);
+
+	DMA1->IFCR = MY_DMA_INT_FLAGS(DMA_Handler, DMA_FLAG_GL);
+
+	DMA_Handler->Instance->CNDTR = DataLength;
+
+	/* Для memory-to-memory источником считается периферийный адрес (CPAR) */
+	if(DMA_Handler->Init.Direction == DMA_MEMORY_TO_PERIPH)
+	{
+		DMA_Handler->Instance->CPAR = DstAddress;
+		DMA_Handler->Instance->CMAR = SrcAddress;
+	}
+	else
+	{
+		DMA_Handler->Instance->CPAR = SrcAddress;
+		DMA_Handler->Instance->CMAR = DstAddress;
+	}
+}
+
+
+MY_Result_t MY_DMA_Start(MY_DMA_Handle_t *DMA_Handler, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength)
+{
+	MY_Result_t result = MY_DMA_INT_Prepare(DMA_Handler, DataLength);
+
+	if(result != MY_Result_Ok)
+	{
+		return result;
+	}
+
+	MY_DMA_INT_SetConfig(DMA_Handler, SrcAddress, DstAddress, DataLength);
+
+	CLEAR_BIT(DMA_Handler->Instance->CCR, DMA_CCR_TCIE | DMA_CCR_HTIE | DMA_CCR_TEIE);
+	SET_BIT(DMA_Handler->Instance->CCR, DMA_CCR_EN);
+
+	return MY_Result_Ok;
+}
+
+
+MY_Result_t MY_DMA_Start_IT(MY_DMA_Handle_t *DMA_Handler, uint32_t SrcAddress, uint32_t DstAddress, uint32_t DataLength)
+{
+	MY_Result_t result = MY_DMA_INT_Prepare(DMA_Handler, DataLength);
+	uint32_t interrupts = DMA_CCR_TCIE | DMA_CCR_TEIE;
+
+	if(result != MY_Result_Ok)
+	{
+		return result;
+	}
+
+	MY_DMA_INT_SetConfig(DMA_Handler, SrcAddress, DstAddress, DataLength);
+
+	/* Прерывание половины передачи нужно только для двойной буферизации */
+	if(DMA_Handler->XferHalfCpltCallback != NULL)
+	{
+		interrupts |= DMA_CCR_HTIE;
+	}
+
+	MODIFY_REG(DMA_Handler->Instance->CCR, DMA_CCR_TCIE | DMA_CCR_HTIE | DMA_CCR_TEIE, interrupts);
+	SET_BIT(DMA_Handler->Instance->CCR, DMA_CCR_EN);
+
+	return MY_Result_Ok;
+}
+
+
+MY_Result_t MY_DMA_PollForTransfer(MY_DMA_Handle_t *DMA_Handler, MY_DMA_LevelComplete_t CompleteLevel, uint32_t Timeout)
+{
+	uint32_t tickstart;
+	uint32_t flag;
+	uint32_t isr;
+
+	if(DMA_Handler->State != MY_DMA_State_Busy)
+	{
+		DMA_Handler->ErrorCode = DMA_ERROR_NO_XFER;
+
+		return MY_Result_Error;
+	}
+
+	/* Циклическая передача не завершается */
+	if((CompleteLevel == MY_DMA_Full_Transfer) && (DMA_Handler->Instance->CCR & DMA_CCR_CIRC))
+	{
+		DMA_Handler->ErrorCode = DMA_ERROR_NOT_SUPPORTED;
+
+		return MY_Result_Error;
+	}
+
+	flag = MY_DMA_INT_FLAGS(DMA_Handler, (CompleteLevel == MY_DMA_Full_Transfer) ? DMA_FLAG_TC : DMA_FLAG_HT);
+
+	tickstart = MY_SysTick_GetTick();
+
+	while(((isr = DMA1->ISR) & flag) == 0U)
+	{
+		if(isr & MY_DMA_INT_FLAGS(DMA_Handler, DMA_FLAG_TE))
+		{
+			/* При ошибке канал выключается аппаратно */
+			DMA1->IFCR = MY_DMA_INT_FLAGS(DMA_Handler, DMA_FLAG_GL);
+
+			DMA_Handler->ErrorCode = DMA_ERROR_TE;
+			DMA_Handler->State = MY_DMA_State_Ready;
+
+			return MY_Result_Error;
+		}
+
+		if((Timeout != MAX_DELAY) && ((MY_SysTick_GetTick() - tickstart) > Timeout))
+		{
+			DMA_Handler->ErrorCode = DMA_ERROR_TIMEOUT;
+			DMA_Handler->State = MY_DMA_State_Timeout;
+
+			return MY_Result_Timeout;
+		}
+	}
+
+	if(CompleteLevel == MY_DMA_Full_Transfer)
+	{
+		DMA1->IFCR = MY_DMA_INT_FLAGS(DMA_Handler, DMA_FLAG_GL);
+
+		CLEAR_BIT(DMA_Handler->Instance->CCR, DMA_CCR_EN);
+
+		DMA_Handler->State = MY_DMA_State_Ready;
+	}
+	else
+	{
+		DMA1->IFCR = MY_DMA_INT_FLAGS(DMA_Handler, DMA_FLAG_HT);
+	}
+
+	return MY_Result_Ok;
+}
+
+
+MY_Result_t MY_DMA_Abort(MY_DMA_Handle_t *DMA_Handler)
+{
+	uint32_t primask;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+
+	/* Прерывание завершения могло прийти раньше */
+	if((DMA_Handler->State != MY_DMA_State_Busy) && (DMA_Handler->State != MY_DMA_State_Timeout))
+	{
+		__set_PRIMASK(primask);
+
+		DMA_Handler->ErrorCode = DMA_ERROR_NO_XFER;
+
+		return MY_Result_Error;
+	}
+
+	CLEAR_BIT(DMA_Handler->Instance->CCR, DMA_CCR_TCIE | DMA_CCR_HTIE | DMA_CCR_TEIE | DMA_CCR_EN);
+
+	DMA1->IFCR = MY_DMA_INT_FLAGS(DMA_Handler, DMA_FLAG_GL);
+
+	DMA_Handler->State = MY_DMA_State_Ready;
+
+	__set_PRIMASK(primask);
+
+	if(DMA_Handler->XferAbortCallback != NULL)
+	{
+		DMA_Handler->XferAbortCallback(DMA_Handler);
+	}
+
+	return MY_Result_Ok;
+}
+
+
+void MY_DMA_IRQHandler(MY_DMA_Handle_t *DMA_Handler)
+{
+	uint32_t isr = DMA1->ISR;
+	uint32_t ccr = DMA_Handler->Instance->CCR;
+
+	/* Канал не инициализирован: флаги общего вектора принадлежат соседнему каналу */
+	if(DMA_Handler->State == MY_DMA_State_Reset)
+	{
+		return;
+	}
+
+	/* Половина передачи */
+	if((isr & MY_DMA_INT_FLAGS(DMA_Handler, DMA_FLAG_HT)) && (ccr & DMA_CCR_HTIE))
+	{
+		/* В нормальном режиме второй половины не будет - прерывание больше не нужно */
+		if((ccr & DMA_CCR_CIRC) == 0U)
+		{
+			CLEAR_BIT(DMA_Handler->Instance->CCR, DMA_CCR_HTIE);
+		}
+
+		DMA1->IFCR = MY_DMA_INT_FLAGS(DMA_Handler, DMA_FLAG_HT);
+
+		if(DMA_Handler->XferHalfCpltCallback != NULL)
+		{
+			DMA_Handler->XferHalfCpltCallback(DMA_Handler);
+		}
+	}
+
+	/* Передача завершена */
+	else if((isr & MY_DMA_INT_FLAGS(DMA_Handler, DMA_FLAG_TC)) && (ccr & DMA_CCR_TCIE))
+	{
+		if((ccr & DMA_CCR_CIRC) == 0U)
+		{
+			CLEAR_BIT(DMA_Handler->Instance->CCR, DMA_CCR_TCIE | DMA_CCR_HTIE | DMA_CCR_TEIE);
+
+			DMA_Handler->State = MY_DMA_State_Ready;
+		}
+
+		DMA1->IFCR = MY_DMA_INT_FLAGS(DMA_Handler, DMA_FLAG_TC);
+
+		if(DMA_Handler->XferCpltCallback != NULL)
+		{
+			DMA_Handler->XferCpltCallback(DMA_Handler);
+		}
+	}
+
+	/* Ошибка передачи: канал выключен аппаратно */
+	else if((isr & MY_DMA_INT_FLAGS(DMA_Handler, DMA_FLAG_TE)) && (ccr & DMA_CCR_TEIE))
+	{
+		CLEAR_BIT(DMA_Handler->Instance->CCR, DMA_CCR_TCIE | DMA_CCR_HTIE | DMA_CCR_TEIE);
+
+		DMA1->IFCR = MY_DMA_INT_FLAGS(DMA_Handler, DMA_FLAG_GL);
+
+		DMA_Handler->ErrorCode = DMA_ERROR_TE;
+		DMA_Handler->State = MY_DMA_State_Ready;
+
+		if(DMA_Handler->XferErrorCallback != NULL)
+		{
+			DMA_Handler->XferErrorCallback(DMA_Handler);
+		}
+	}
+}
+
+
+void MY_DMA_IRQ_Dispatch(IRQn_Type IRQn)
+{
+	uint32_t i;
+
+	/* Каналы 2-3 и 4-5 делят вектор: обслуживаем все каналы, флаги которых могли его вызвать */
+	for(i = 0; i < DMA_CHANNELS; i++)
+	{
+		if((DMA1Handlers[i].State != MY_DMA_State_Reset) && (DMA1Handlers[i].IRQn == IRQn))
+		{
+			MY_DMA_IRQHandler(&DMA1Handlers[i]);
+		}
+	}
+}
+
+
+uint32_t MY_DMA_GetCounter(MY_DMA_Handle_t *DMA_Handler)
+{
+	return DMA_Handler->Instance->CNDTR;
+}
+
+
+MY_DMA_State_t MY_DMA_GetState(MY_DMA_Handle_t *DMA_Handler)
+{
+	return DMA_Handler->State;
+}
+
+
+uint32_t MY_DMA_GetError(MY_DMA_Handle_t *DMA_Handler)
+{
+	return DMA_Handler->ErrorCode;
+}
+
+
+static MY_PWR_State_t MY_DMA_INT_PowerConstraint(void)
+{
+	uint32_t i;
+
+	for(i = 0; i < DMA_CHANNELS; i++)
+	{
+		if(DMA1Handlers[i].State == MY_DMA_State_Busy)
+		{
+			return MY_PWR_State_Sleep;
+		}
+	}
+
+	return MY_PWR_State_Standby;
+}
+
+
+/* Канал копирования памяти, настраивается при первом использовании */
+static MY_DMA_Handle_t* MY_DMA_INT_Mem_Handler(void)
+{
+	MY_DMA_Handle_t *DMA_Handler = MY_DMA_GetHandler(DMA_MEM_CHANNEL);
+	MY_DMA_Init_t init;
+
+	if(DMA_Handler->State == MY_DMA_State_Reset)
+	{
+		init.Direction = DMA_MEMORY_TO_MEMORY;
+		init.PeriphInc = DMA_PERIPH_INC_ENABLE;
+		init.MemInc = DMA_MEMORY_INC_ENABLE;
+		init.PeriphDataAlignment = DMA_PERIPH_DATAALIGN_WORD;
+		init.MemDataAlignment = DMA_MEMORY_DATAALIGN_WORD;
+		init.Mode = DMA_MODE_NORMAL;
+		init.Priority = DMA_MEM_PRIORITY;
+
+		MY_DMA_Init(DMA_MEM_CHANNEL, &init);
+	}
+
+	return DMA_Handler;
+}
+
+
+static void MY_DMA_INT_Mem_Complete(MY_DMA_Handle_t *DMA_Handler)
+{
+	UNUSED(DMA_Handler);
+
+	if(MY_DMA_INT_MemCallback != NULL)
+	{
+		MY_DMA_INT_MemCallback(MY_Result_Ok, MY_DMA_INT_MemContext);
+	}
+}
+
+
+static void MY_DMA_INT_Mem_Error(MY_DMA_Handle_t *DMA_Handler)
+{
+	UNUSED(DMA_Handler);
+
+	if(MY_DMA_INT_MemCallback != NULL)
+	{
+		MY_DMA_INT_MemCallback(MY_Result_Error, MY_DMA_INT_MemContext);
+	}
+}
+
+
+/* Копирование или заполнение процессором */
+static MY_Result_t MY_DMA_INT_Mem_Cpu(uint8_t *Dst, const uint8_t *Src, uint8_t Value, uint32_t Size, MY_DMA_Mem_Callback_t Callback, void *Context, uint8_t Mode)
+{
+	if(Mode & MY_DMA_INT_MEM_SET)
+	{
+		memset(Dst, Value, Size);
+	}
+	else
+	{
+		memcpy(Dst, Src, Size);
+	}
+
+	if((Mode & MY_DMA_INT_MEM_ASYNC) && (Callback != NULL))
+	{
+		Callback(MY_Result_Ok, Context);
+	}
+
+	return MY_Result_Ok;
+}
+
+
+/* Копирование или заполнение: невыровненные начало и конец - процессором, середина - DMA */
+static MY_Result_t MY_DMA_INT_Mem_Run(uint8_t *Dst, const uint8_t *Src, uint8_t Value, uint32_t Size, MY_DMA_Mem_Callback_t Callback, void *Context, uint8_t Mode)
+{
+	MY_DMA_Handle_t *DMA_Handler;
+	uint32_t misalign = (Mode & MY_DMA_INT_MEM_SET) ? 0U : (((uint32_t)Dst ^ (uint32_t)Src) & 3U);
+	uint32_t unit = ((misalign & 1U) != 0U) ? 1U : ((misalign != 0U) ? 2U : 4U);
+	uint32_t head = (unit - ((uint32_t)Dst & (unit - 1U))) & (unit - 1U);
+	uint32_t body = (Size > head) ? ((Size - head) & ~(unit - 1U)) : 0U;
+	uint32_t threshold = (unit == 4U) ? DMA_MEM_THRESHOLD : DMA_MEM_THRESHOLD_UNALIGNED;
+	uint32_t size_bits = (unit == 4U) ? (DMA_PERIPH_DATAALIGN_WORD | DMA_MEMORY_DATAALIGN_WORD) :
+						 ((unit == 2U) ? (DMA_PERIPH_DATAALIGN_HALFWORD | DMA_MEMORY_DATAALIGN_HALFWORD) : 0U);
+	uint32_t source;
+	MY_Result_t result;
+
+	/* Мало данных для DMA - процессор быстрее */
+	if((body == 0U) || ((body < threshold) && !(Mode & MY_DMA_INT_MEM_FORCE)))
+	{
+		return MY_DMA_INT_Mem_Cpu(Dst, Src, Value, Size, Callback, Context, Mode);
+	}
+
+	/* Канал настраивается только для копий, которые действительно идут через DMA */
+	DMA_Handler = MY_DMA_INT_Mem_Handler();
+
+	result = MY_DMA_INT_Prepare(DMA_Handler, body / unit);
+
+	/* Канал занят асинхронной операцией: синхронный вызов не ждёт её, а копирует процессором */
+	if((result == MY_Result_Busy) && !(Mode & MY_DMA_INT_MEM_ASYNC))
+	{
+		return MY_DMA_INT_Mem_Cpu(Dst, Src, Value, Size, Callback, Context, Mode);
+	}
+
+	if(result != MY_Result_Ok)
+	{
+		return result;
+	}
+
+	/* Начало и конец вне выровненной середины */
+	if(Mode & MY_DMA_INT_MEM_SET)
+	{
+		memset(Dst, Value, head);
+		memset(Dst + head + body, Value, Size - head - body);
+
+		MY_DMA_INT_MemPattern = 0x01010101U * Value;
+		source = (uint32_t)&MY_DMA_INT_MemPattern;
+	}
+	else
+	{
+		memcpy(Dst, Src, head);
+		memcpy(Dst + head + body, Src + head + body, Size - head - body);
+
+		source = (uint32_t)(Src + head);
+	}
+
+	DMA_Handler->Init.PeriphInc = (Mode & MY_DMA_INT_MEM_SET) ? DMA_PERIPH_INC_DISABLE : DMA_PERIPH_INC_ENABLE;
+	DMA_Handler->Init.PeriphDataAlignment = size_bits & DMA_CCR_PSIZE;
+	DMA_Handler->Init.MemDataAlignment = size_bits & DMA_CCR_MSIZE;
+
+	/* Канал выключен и не занят - перезаписываем конфигурацию целиком */
+	DMA_Handler->Instance->CCR = DMA_MEMORY_TO_MEMORY | DMA_MEMORY_INC_ENABLE | DMA_Handler->Init.PeriphInc |
+								 size_bits | DMA_Handler->Init.Priority;
+
+	MY_DMA_INT_SetConfig(DMA_Handler, source, (uint32_t)(Dst + head), body / unit);
+
+	if(Mode & MY_DMA_INT_MEM_ASYNC)
+	{
+		MY_DMA_INT_MemCallback = Callback;
+		MY_DMA_INT_MemContext = Context;
+
+		DMA_Handler->XferCpltCallback = MY_DMA_INT_Mem_Complete;
+		DMA_Handler->XferHalfCpltCallback = NULL;
+		DMA_Handler->XferErrorCallback = MY_DMA_INT_Mem_Error;
+
+		MY_NVIC_EnableIRQ(DMA_Handler->IRQn);
+
+		SET_BIT(DMA_Handler->Instance->CCR, DMA_CCR_TCIE | DMA_CCR_TEIE | DMA_CCR_EN);
+
+		return MY_Result_Ok;
+	}
+
+	SET_BIT(DMA_Handler->Instance->CCR, DMA_CCR_EN);
+
+	result = MY_DMA_PollForTransfer(DMA_Handler, MY_DMA_Full_Transfer, DMA_MEM_TIMEOUT);
+
+	if(result == MY_Result_Timeout)
+	{
+		MY_DMA_Abort(DMA_Handler);
+	}
+
+	return result;
+}
+
+
+MY_Result_t MY_DMA_Memcpy(void *Dst, const void *Src, uint32_t Size)
+{
+	return MY_DMA_INT_Mem_Run((uint8_t *)Dst, (const uint8_t *)Src, 0U, Size, NULL, NULL, 0U);
+}
+
+
+MY_Result_t MY_DMA_Memset(void *Dst, uint8_t Value, uint32_t Size)
+{
+	return MY_DMA_INT_Mem_Run((uint8_t *)Dst, NULL, Value, Size, NULL, NULL, MY_DMA_INT_MEM_SET);
+}
+
+
+MY_Result_t MY_DMA_Memcpy_IT(void *Dst, const void *Src, uint32_t Size, MY_DMA_Mem_Callback_t Callback, void *Context)
+{
+	return MY_DMA_INT_Mem_Run((uint8_t *)Dst, (const uint8_t *)Src, 0U, Size, Callback, Context, MY_DMA_INT_MEM_ASYNC);
+}
+
+
+MY_Result_t MY_DMA_Memset_IT(void *Dst, uint8_t Value, uint32_t Size, MY_DMA_Mem_Callback_t Callback, void *Context)
+{
+	return MY_DMA_INT_Mem_Run((uint8_t *)Dst, NULL, Value, Size, Callback, Context, MY_DMA_INT_MEM_SET | MY_DMA_INT_MEM_ASYNC);
+}
+
+
+uint8_t MY_DMA_Mem_IsBusy(void)
+{
+	return (MY_DMA_GetHandler(DMA_MEM_CHANNEL)->State == MY_DMA_State_Busy) ? 1U : 0U;
+}
+
+
+/* Такты HCLK между двумя значениями SysTick->VAL (счёт вниз, не более одной перезагрузки) */
+static uint32_t MY_DMA_INT_Cycles(uint32_t Start, uint32_t End)
+{
+	return (Start >= End) ? (Start - End) : (Start + (SysTick->LOAD + 1U) - End);
+}
+
+
+uint32_t MY_DMA_Mem_Crossover(uint8_t *Buffer, uint32_t Size)
+{
+	uint32_t half = (Size / 2U) & ~3U;
+	uint32_t primask;
+	uint32_t size;
+	uint32_t start;
+	uint32_t cpu;
+	uint32_t dma;
+	uint32_t cycles;
+	uint32_t i;
+
+	if(MY_DMA_Mem_IsBusy())
+	{
+		return 0;
+	}
+
+	for(size = 4U; size <= half; size *= 2U)
+	{
+		cpu = 0xFFFFFFFFU;
+		dma = 0xFFFFFFFFU;
+
+		/* Лучший из нескольких замеров: исключаем промахи предвыборки Flash */
+		for(i = 0; i < 4U; i++)
+		{
+			primask = __get_PRIMASK();
+			__disable_irq();
+
+			start = SysTick->VAL;
+			memcpy(Buffer + half, Buffer, size);
+			cycles = MY_DMA_INT_Cycles(start, SysTick->VAL);
+
+			if(cycles < cpu)
+			{
+				cpu = cycles;
+			}
+
+			start = SysTick->VAL;
+			MY_DMA_INT_Mem_Run(Buffer + half, Buffer, 0U, size, NULL, NULL, MY_DMA_INT_MEM_FORCE);
+			cycles = MY_DMA_INT_Cycles(start, SysTick->VAL);
+
+			if(cycles < dma)
+			{
+				dma = cycles;
+			}
+
+			__set_PRIMASK(primask);
+		}
+
+		if(dma < cpu)
+		{
+			return size;
+		}
+	}
+
+	return 0;
+}
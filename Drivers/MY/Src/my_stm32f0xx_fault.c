@@ -0,0 +1,160 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/fault
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Сохранение состояния ядра при HardFault
+ */
+#include "my_stm32f0xx_fault.h"
+#include "my_stm32f0xx_cortex.h"
+
+/* Признак прочитанной записи: счётчик сбоев действителен, но сама запись уже выдана */
+#define FAULT_RECORD_CLEARED					(~FAULT_RECORD_MAGIC)
+
+/* Границы RAM из линкер-скрипта */
+extern uint32_t _estack;
+
+/* Запись о сбое, startup её не обнуляет */
+static MY_FAULT_Record_t MY_INT_FAULT_Record __attribute__((section(".noinit")));
+
+
+static uint32_t MY_INT_FAULT_Checksum(const MY_FAULT_Record_t *Record)
+{
+	const uint32_t *word = (const uint32_t *)Record;
+	uint32_t count = (sizeof(MY_FAULT_Record_t) / sizeof(uint32_t)) - 1U;
+	uint32_t sum = 0x5A5A5A5AU;
+	uint32_t i;
+
+	for(i = 0; i < count; i++)
+	{
+		sum = ((sum << 5) | (sum >> 27)) ^ word[i];
+	}
+
+	return sum;
+}
+
+
+static uint8_t MY_INT_FAULT_IsValid(void)
+{
+	if((MY_INT_FAULT_Record.Magic != FAULT_RECORD_MAGIC) && (MY_INT_FAULT_Record.Magic != FAULT_RECORD_CLEARED))
+	{
+		return 0;
+	}
+
+	return (MY_INT_FAULT_Record.Checksum == MY_INT_FAULT_Checksum(&MY_INT_FAULT_Record)) ? 1 : 0;
+}
+
+
+void MY_FAULT_HardFault(uint32_t *Frame, uint32_t ExcReturn)
+{
+	uint32_t address = (uint32_t)Frame;
+	uint32_t top = (uint32_t)&_estack;
+	uint32_t i;
+
+	MY_INT_FAULT_Record.Count = MY_INT_FAULT_IsValid() ? (MY_INT_FAULT_Record.Count + 1U) : 1U;
+
+	MY_INT_FAULT_Record.ExcReturn = ExcReturn;
+	MY_INT_FAULT_Record.SP = address;
+	MY_INT_FAULT_Record.Uptime = MY_SysTick_GetTick();
+	MY_INT_FAULT_Record.StackWords = 0;
+
+	/* Кадр читается только если указатель стека в пределах RAM: при переполнении стека его может не быть */
+	if(((address & 0x3U) == 0U) && (address >= SRAM_BASE) && ((address + (8U * sizeof(uint32_t))) <= top))
+	{
+		MY_INT_FAULT_Record.R0 = Frame[0];
+		MY_INT_FAULT_Record.R1 = Frame[1];
+		MY_INT_FAULT_Record.R2 = Frame[2];
+		MY_INT_FAULT_Record.R3 = Frame[3];
+		MY_INT_FAULT_Record.R12 = Frame[4];
+		MY_INT_FAULT_Record.LR = Frame[5];
+		MY_INT_FAULT_Record.PC = Frame[6];
+		MY_INT_FAULT_Record.xPSR = Frame[7];
+
+		/* Стек прерванного кода над кадром, до вершины RAM */
+		for(i = 0; (i < FAULT_STACK_WORDS) && ((address + ((8U + i + 1U) * sizeof(uint32_t))) <= top); i++)
+		{
+			MY_INT_FAULT_Record.Stack[i] = Frame[8U + i];
+		}
+
+		MY_INT_FAULT_Record.StackWords = i;
+	}
+	else
+	{
+		MY_INT_FAULT_Record.R0 = 0;
+		MY_INT_FAULT_Record.R1 = 0;
+		MY_INT_FAULT_Record.R2 = 0;
+		MY_INT_FAULT_Record.R3 = 0;
+		MY_INT_FAULT_Record.R12 = 0;
+		MY_INT_FAULT_Record.LR = 0;
+		MY_INT_FAULT_Record.PC = 0;
+		MY_INT_FAULT_Record.xPSR = 0;
+	}
+
+	for(i = MY_INT_FAULT_Record.StackWords; i < FAULT_STACK_WORDS; i++)
+	{
+		MY_INT_FAULT_Record.Stack[i] = 0;
+	}
+
+	MY_INT_FAULT_Record.Magic = FAULT_RECORD_MAGIC;
+	MY_INT_FAULT_Record.Checksum = MY_INT_FAULT_Checksum(&MY_INT_FAULT_Record);
+
+	/* Запись должна попасть в RAM до сброса */
+	__DSB();
+
+	MY_NVIC_SystemReset();
+
+	while(1)
+	{
+
+	}
+}
+
+
+const MY_FAULT_Record_t* MY_FAULT_GetLast(void)
+{
+	if((MY_INT_FAULT_Record.Magic != FAULT_RECORD_MAGIC) || !MY_INT_FAULT_IsValid())
+	{
+		return NULL;
+	}
+
+	return &MY_INT_FAULT_Record;
+}
+
+
+void MY_FAULT_Clear(void)
+{
+	if(!MY_INT_FAULT_IsValid())
+	{
+		return;
+	}
+
+	MY_INT_FAULT_Record.Magic = FAULT_RECORD_CLEARED;
+	MY_INT_FAULT_Record.Checksum = MY_INT_FAULT_Checksum(&MY_INT_FAULT_Record);
+}
+
+
+void MY_FAULT_Dump(void)
+{
+	const MY_FAULT_Record_t *record = MY_FAULT_GetLast();
+	uint32_t i;
+
+	if(record == NULL)
+	{
+		printf("FAULT none\r\n");
+		return;
+	}
+
+	printf("FAULT count=%lu uptime=%lu\r\n", (unsigned long)record->Count, (unsigned long)record->Uptime);
+	printf("FAULT pc=0x%08lX lr=0x%08lX xpsr=0x%08lX sp=0x%08lX exc=0x%08lX\r\n",
+		   (unsigned long)record->PC, (unsigned long)record->LR, (unsigned long)record->xPSR,
+		   (unsigned long)record->SP, (unsigned long)record->ExcReturn);
+	printf("FAULT r0=0x%08lX r1=0x%08lX r2=0x%08lX r3=0x%08lX r12=0x%08lX\r\n",
+		   (unsigned long)record->R0, (unsigned long)record->R1, (unsigned long)record->R2,
+		   (unsigned long)record->R3, (unsigned long)record->R12);
+
+	for(i = 0; i < record->StackWords; i++)
+	{
+		printf("FAULT stack[%lu]=0x%08lX\r\n", (unsigned long)i, (unsigned long)record->Stack[i]);
+	}
+}
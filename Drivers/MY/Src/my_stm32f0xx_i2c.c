@@ -7,7 +7,9 @@
  * @brief   Утилиты для работы с I2C
  */
 #include "my_stm32f0xx.h"
+#include "my_stm32f0xx_rcc.h"
 #include "my_stm32f0xx_i2c.h"
+#include "my_stm32f0xx_pwr.h"
 
 
 #define MAX_NBYTE_SIZE      255U
@@ -23,6 +25,27 @@
 	static void MY_I2C2_INT_InitPins(MY_I2C_PinsPack_t pinspack);
 #endif
 
+/* Функция возвращает частоту тактирования I2Cx */
+static uint32_t MY_I2C_INT_GetClock(I2C_TypeDef* I2Cx);
+
+/* Функция пересчитывает TIMINGR для проинициализированного I2C */
+static void MY_I2C_INT_UpdateTiming(MY_I2C_Init_t* I2C_Handler);
+
+/* Функция записывает TIMINGR, на время записи I2C выключается */
+static void MY_I2C_INT_ApplyTiming(MY_I2C_Init_t* I2C_Handler);
+
+/* Функция разблокирует I2C, применяя отложенный пересчёт TIMINGR */
+static void MY_I2C_INT_Unlock(MY_I2C_Init_t* I2C_Handler);
+
+/* Обработчик изменения частот RCC */
+static void MY_I2C_INT_ClockChanged(const MY_RCC_Clocks_t *Clocks);
+
+/* Ограничение режимов питания на время передачи */
+static MY_PWR_State_t MY_I2C_INT_PowerConstraint(void);
+
+/* Общая сопрограмма передачи и приёма */
+static MY_PT_State_t MY_I2C_INT_PT_Transfer(MY_I2C_PT_t *Ctx, MY_I2C_Init_t *I2C_Handler, uint16_t device_address, uint8_t *pData, uint16_t size, uint32_t timeout, uint8_t read);
+
 
 /* Струкутура для I2C */
 #ifdef I2C1
@@ -72,12 +95,15 @@ MY_Result_t MY_I2C_Init(I2C_TypeDef* I2Cx)
 		return MY_Result_Error;
 	}
 
+	/* Блокируем структуру */
+	if (MY_Lock_Acquire(&I2C_Handler->Lock, I2C_TIMEOUT_BUSY) != MY_Result_Ok)
+	{
+		return MY_Result_Busy;
+	}
+
 	/* Если периферия еще не была инициализирована - включаем тактирование и инициализируем GPIO пины*/
 	if(I2C_Handler->State == MY_I2C_State_Reset)
 	{
-		/* Блокируем структуру */
-		MY_LOCK(I2C_Handler);
-
 		#ifdef I2C1
 			if (I2C_Handler->Instance == I2C1)
 			{
@@ -102,25 +128,18 @@ MY_Result_t MY_I2C_Init(I2C_TypeDef* I2Cx)
 	MY_I2C_DISABLE(I2C_Handler->Instance);
 
 	/*---------------------------- Конфигурация I2Cx TIMINGR ------------------*/
-	/* Вычисляем значение скорости тактирования I2C*/
-	if(I2C_Handler->ClockSpeed == 100000)
-	{
-		/* 100kHz @ 48MHz SYSCLK clock */
-		I2C_Timing = 0x20303E5D;
-	}
-	else if(I2C_Handler->ClockSpeed == 400000)
-	{
-		/* 400kHz @ 48MHz SYSCLK clock */
-		I2C_Timing = 0x2010091A;
-	}
-	else if(I2C_Handler->ClockSpeed == 1000000)
-	{
-		/* 1000kHz @ 48MHz SYSCLK*/
-		I2C_Timing = 0x20000209;
-	}
+	/* Вычисляем значение скорости тактирования I2C от фактической частоты тактирования I2Cx */
+	I2C_Timing = MY_I2C_Timing_Calc(MY_I2C_INT_GetClock(I2C_Handler->Instance), I2C_Handler->ClockSpeed);
 
 	/* Настройка частоты I2Cx */
 	I2C_Handler->Instance->TIMINGR = I2C_Timing;
+	I2C_Handler->TimingPending = 0U;
+
+	/* При смене частот RCC значение TIMINGR будет пересчитано автоматически */
+	MY_RCC_ClockChange_Register(MY_I2C_INT_ClockChanged);
+
+	/* Пока идёт передача, тактирование I2C нельзя останавливать */
+	MY_PWR_Constraint_Register(MY_I2C_INT_PowerConstraint);
 
 
 	/*---------------------------- Конфигурация I2Cx OAR1 ---------------------*/
@@ -170,17 +189,222 @@ MY_Result_t MY_I2C_Init(I2C_TypeDef* I2Cx)
 	/* Включаем I2C */
 	MY_I2C_ENABLE(I2C_Handler->Instance);
 
-	/* Разблокируем I2C */
-	MY_UNLOCK(I2C_Handler);
-
 	I2C_Handler->ErrorCode = I2C_ERROR_NONE;
 	I2C_Handler->State = MY_I2C_State_Ready;
 	I2C_Handler->Mode = MY_I2C_Mode_None;
 
+	/* Разблокируем I2C */
+	MY_I2C_INT_Unlock(I2C_Handler);
+
 	return MY_Result_Ok;
 }
 
 
+uint32_t MY_I2C_Timing_Calc(uint32_t I2C_Clock, uint32_t ClockSpeed)
+{
+	uint32_t presc, tick_khz, period, low, high, scldel, sdadel;
+	uint32_t setup_ns, hold_ns;
+
+	/* Проверенные значения для типовых частот */
+	if(I2C_Clock == 48000000U)
+	{
+		if(ClockSpeed == 100000U)
+		{
+			/* 100kHz @ 48MHz */
+			return 0x20303E5DU;
+		}
+		else if(ClockSpeed == 400000U)
+		{
+			/* 400kHz @ 48MHz */
+			return 0x2010091AU;
+		}
+		else if(ClockSpeed == 1000000U)
+		{
+			/* 1000kHz @ 48MHz */
+			return 0x20000209U;
+		}
+	}
+	else if(I2C_Clock == 8000000U)
+	{
+		if(ClockSpeed == 100000U)
+		{
+			/* 100kHz @ 8MHz, RM0091 */
+			return 0x10420F13U;
+		}
+		else if(ClockSpeed == 400000U)
+		{
+			/* 400kHz @ 8MHz, RM0091 */
+			return 0x00310309U;
+		}
+		else if(ClockSpeed == 1000000U)
+		{
+			/* Fast-mode Plus @ 8MHz, RM0091 (фактически ~500kHz) */
+			return 0x00100306U;
+		}
+	}
+
+	if((I2C_Clock == 0U) || (ClockSpeed == 0U))
+	{
+		return 0U;
+	}
+
+	/* Предделитель выбираем так, чтобы период SCL укладывался в SCLL + SCLH с запасом */
+	period = I2C_Clock / ClockSpeed;
+	presc = (period > 0U) ? ((period - 1U) / 384U) : 0U;
+
+	if(presc > 15U)
+	{
+		presc = 15U;
+	}
+
+	tick_khz = (I2C_Clock / (presc + 1U)) / 1000U;
+	period = (tick_khz * 1000U) / ClockSpeed;
+
+	/* Standard-mode: tLOW >= 4.7 мкс, tHIGH >= 4.0 мкс; Fast-mode(Plus): tLOW примерно вдвое больше tHIGH */
+	if(ClockSpeed <= 100000U)
+	{
+		low = (period * 54U) / 100U;
+		setup_ns = 250U;
+		hold_ns = 300U;
+	}
+	else if(ClockSpeed <= 400000U)
+	{
+		low = (period * 2U) / 3U;
+		setup_ns = 100U;
+		hold_ns = 300U;
+	}
+	else
+	{
+		low = (period * 2U) / 3U;
+		setup_ns = 50U;
+		hold_ns = 120U;
+	}
+
+	high = period - low;
+
+	low = (low < 1U) ? 1U : ((low > 256U) ? 256U : low);
+	high = (high < 1U) ? 1U : ((high > 256U) ? 256U : high);
+
+	/* Задержки в периодах tPRESC с округлением вверх */
+	scldel = ((setup_ns * tick_khz) + 999999U) / 1000000U;
+	sdadel = ((hold_ns * tick_khz) + 999999U) / 1000000U;
+
+	scldel = (scldel > 16U) ? 15U : ((scldel > 0U) ? (scldel - 1U) : 0U);
+	sdadel = (sdadel > 15U) ? 15U : sdadel;
+
+	return ((presc << I2C_TIMINGR_PRESC_Pos) | (scldel << I2C_TIMINGR_SCLDEL_Pos) | (sdadel << I2C_TIMINGR_SDADEL_Pos) |
+			((high - 1U) << I2C_TIMINGR_SCLH_Pos) | ((low - 1U) << I2C_TIMINGR_SCLL_Pos));
+}
+
+
+static uint32_t MY_I2C_INT_GetClock(I2C_TypeDef* I2Cx)
+{
+	#ifdef I2C1
+
+		/* I2C1 тактируется от HSI или SYSCLK в зависимости от RCC_CFGR3 */
+		if (I2Cx == I2C1)
+		{
+			return MY_RCC_PeriphClock_GetFreq(RCC_PERIPHCLK_I2C1);
+		}
+
+	#endif
+
+	/* Остальные I2C тактируются от PCLK1 */
+	return MY_RCC_PCLK1_GetFreq();
+}
+
+
+static void MY_I2C_INT_UpdateTiming(MY_I2C_Init_t* I2C_Handler)
+{
+	/* Периферия еще не инициализирована - значение будет вычислено в MY_I2C_Init() */
+	if ((I2C_Handler->Instance == NULL) || (I2C_Handler->State == MY_I2C_State_Reset))
+	{
+		return;
+	}
+
+	/* Флаг взводится до попытки захвата: если I2C занят, владелец применит его в MY_I2C_INT_Unlock() */
+	I2C_Handler->TimingPending = 1U;
+
+	if (MY_Lock_TryAcquire(&I2C_Handler->Lock) == MY_Result_Ok)
+	{
+		MY_I2C_INT_Unlock(I2C_Handler);
+	}
+}
+
+
+static void MY_I2C_INT_ApplyTiming(MY_I2C_Init_t* I2C_Handler)
+{
+	uint32_t enabled;
+
+	/* TIMINGR можно менять только при выключенном I2C */
+	enabled = READ_BIT(I2C_Handler->Instance->CR1, I2C_CR1_PE);
+
+	MY_I2C_DISABLE(I2C_Handler->Instance);
+
+	I2C_Handler->Instance->TIMINGR = MY_I2C_Timing_Calc(MY_I2C_INT_GetClock(I2C_Handler->Instance), I2C_Handler->ClockSpeed);
+
+	if (enabled)
+	{
+		MY_I2C_ENABLE(I2C_Handler->Instance);
+	}
+}
+
+
+static void MY_I2C_INT_Unlock(MY_I2C_Init_t* I2C_Handler)
+{
+	/* Частота могла смениться между проверкой флага и освобождением - тогда блокировка захватывается снова */
+	do
+	{
+		/* Выключать I2C можно только вне передачи */
+		if (I2C_Handler->TimingPending && (I2C_Handler->State == MY_I2C_State_Ready))
+		{
+			I2C_Handler->TimingPending = 0U;
+
+			MY_I2C_INT_ApplyTiming(I2C_Handler);
+		}
+
+		MY_Lock_Release(&I2C_Handler->Lock);
+	}
+	while (I2C_Handler->TimingPending && (I2C_Handler->State == MY_I2C_State_Ready) &&
+		   (MY_Lock_TryAcquire(&I2C_Handler->Lock) == MY_Result_Ok));
+}
+
+
+static void MY_I2C_INT_ClockChanged(const MY_RCC_Clocks_t *Clocks)
+{
+	UNUSED(Clocks);
+
+	#ifdef I2C1
+		MY_I2C_INT_UpdateTiming(&I2C1Handler);
+	#endif
+
+	#ifdef I2C2
+		MY_I2C_INT_UpdateTiming(&I2C2Handler);
+	#endif
+}
+
+
+static MY_PWR_State_t MY_I2C_INT_PowerConstraint(void)
+{
+	/* Блокировка удерживается всю передачу, в том числе сопрограммой между вызовами суперцикла */
+	#ifdef I2C1
+		if(MY_Lock_IsLocked(&I2C1Handler.Lock))
+		{
+			return MY_PWR_State_Sleep;
+		}
+	#endif
+
+	#ifdef I2C2
+		if(MY_Lock_IsLocked(&I2C2Handler.Lock))
+		{
+			return MY_PWR_State_Sleep;
+		}
+	#endif
+
+	return MY_PWR_State_Standby;
+}
+
+
 MY_Result_t MY_I2C_IsDeviceReady(I2C_TypeDef* I2Cx, uint16_t device_address, uint32_t trials, uint32_t timeout)
 {
 	/* Получаем указатель на структуру */
@@ -189,18 +413,23 @@ MY_Result_t MY_I2C_IsDeviceReady(I2C_TypeDef* I2Cx, uint16_t device_address, uin
 	uint32_t tickstart = 0U;
 	__IO uint32_t I2C_Trials = 0U;
 
+	/* Блокируем периферию, ожидая освобождения другим процессом */
+	if (MY_Lock_Acquire(&I2C_Handler->Lock, timeout) != MY_Result_Ok)
+	{
+		return MY_Result_Busy;
+	}
+
 	/* Если периферия инициализирована */
 	if (I2C_Handler->State == MY_I2C_State_Ready)
 	{
 		/* Если взведен флаг "I2C занят" */
 	    if (MY_I2C_GET_FLAG(I2C_Handler->Instance, I2C_FLAG_BUSY) == SET)
 	    {
+	    	MY_I2C_INT_Unlock(I2C_Handler);
+
 	    	return MY_Result_Busy;
 	    }
 
-	    /* Блокируем периферию */
-	    MY_LOCK(I2C_Handler);
-
 	    /* Меняем состояние на "Занят" */
 	    I2C_Handler->State = MY_I2C_State_Busy;
 
@@ -228,7 +457,7 @@ MY_Result_t MY_I2C_IsDeviceReady(I2C_TypeDef* I2Cx, uint16_t device_address, uin
 	    				I2C_Handler->State = MY_I2C_State_Ready;
 
 	    				/* Разблокируем структуру */
-	    				MY_UNLOCK(I2C_Handler);
+	    				MY_I2C_INT_Unlock(I2C_Handler);
 
 	    				return MY_Result_Timeout;
 	    			}
@@ -251,7 +480,7 @@ MY_Result_t MY_I2C_IsDeviceReady(I2C_TypeDef* I2Cx, uint16_t device_address, uin
 	    		I2C_Handler->State = MY_I2C_State_Ready;
 
 	    		/* Разблокируем процесс */
-	    		MY_UNLOCK(I2C_Handler);
+	    		MY_I2C_INT_Unlock(I2C_Handler);
 
 	    		return MY_Result_Ok;
 	    	}
@@ -292,12 +521,14 @@ MY_Result_t MY_I2C_IsDeviceReady(I2C_TypeDef* I2Cx, uint16_t device_address, uin
 	    I2C_Handler->State = MY_I2C_State_Ready;
 
 	    /* Разблокируем процесс */
-	    MY_UNLOCK(I2C_Handler);
+	    MY_I2C_INT_Unlock(I2C_Handler);
 
 	    return MY_Result_Timeout;
 	 }
 	 else
 	 {
+		 MY_I2C_INT_Unlock(I2C_Handler);
+
 		 return MY_Result_Busy;
 	 }
 }
@@ -341,12 +572,15 @@ MY_Result_t MY_I2C_Master_Transmit(MY_I2C_Init_t *I2C_Handler, uint16_t device_a
 {
 	uint32_t tickstart = 0U;
 
+	/* Блокируем структуру, ожидая освобождения другим процессом */
+	if (MY_Lock_Acquire(&I2C_Handler->Lock, timeout) != MY_Result_Ok)
+	{
+		return MY_Result_Busy;
+	}
+
 	/* Если периферия инициализирована */
 	if (I2C_Handler->State == MY_I2C_State_Ready)
 	{
-		/* Блокируем структуру */
-		MY_LOCK(I2C_Handler);
-
 		/* Получаем текущее значение счетчика SysTick для управления таймаутом */
 		tickstart = MY_SysTick_GetTick();
 
@@ -463,12 +697,14 @@ MY_Result_t MY_I2C_Master_Transmit(MY_I2C_Init_t *I2C_Handler, uint16_t device_a
 		 I2C_Handler->Mode  = MY_I2C_Mode_None;
 
 		 /* Разблокируем процесс */
-		 MY_UNLOCK(I2C_Handler);
+		 MY_I2C_INT_Unlock(I2C_Handler);
 
 		 return MY_Result_Ok;
 	}
 	else
 	{
+		 MY_I2C_INT_Unlock(I2C_Handler);
+
 		 return MY_Result_Busy;
 	}
 }
@@ -499,11 +735,14 @@ MY_Result_t MY_I2C_Master_Receive(MY_I2C_Init_t *I2C_Handler, uint16_t DevAddres
 {
 	uint32_t tickstart = 0U;
 
-	if (I2C_Handler->State == MY_I2C_State_Ready)
+	/* Process Locked */
+	if (MY_Lock_Acquire(&I2C_Handler->Lock, Timeout) != MY_Result_Ok)
 	{
-		/* Process Locked */
-		MY_LOCK(I2C_Handler);
+		return MY_Result_Busy;
+	}
 
+	if (I2C_Handler->State == MY_I2C_State_Ready)
+	{
 		/* Init tickstart for timeout management*/
 	    tickstart = MY_SysTick_GetTick();
 
@@ -599,18 +838,20 @@ MY_Result_t MY_I2C_Master_Receive(MY_I2C_Init_t *I2C_Handler, uint16_t DevAddres
 	    I2C_Handler->Mode  = MY_I2C_Mode_None;
 
 	    /* Process Unlocked */
-	    MY_UNLOCK(I2C_Handler);
+	    MY_I2C_INT_Unlock(I2C_Handler);
 
 	    return MY_Result_Ok;
 	}
 	else
 	{
+		MY_I2C_INT_Unlock(I2C_Handler);
+
 		return MY_Result_Busy;
 	}
 }
 
 
-MY_Result_t MY_I2C_WaitOnFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32_t flag, FlagStatus status, uint32_t timeout, uint32_t tickstart)
+MY_RAMFUNC MY_Result_t MY_I2C_WaitOnFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32_t flag, FlagStatus status, uint32_t timeout, uint32_t tickstart)
 {
 	while (MY_I2C_GET_FLAG(I2C_Handler->Instance, flag) == status)
 	{
@@ -624,7 +865,7 @@ MY_Result_t MY_I2C_WaitOnFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32_t f
 	    		I2C_Handler->Mode = MY_I2C_Mode_None;
 
 	    		/* Разблокируем процесс */
-	    		MY_UNLOCK(I2C_Handler);
+	    		MY_I2C_INT_Unlock(I2C_Handler);
 
 	    		return MY_Result_Timeout;
 	    	}
@@ -635,7 +876,7 @@ MY_Result_t MY_I2C_WaitOnFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32_t f
 }
 
 
-MY_Result_t MY_I2C_WaitOnTXISFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32_t Timeout, uint32_t Tickstart)
+MY_RAMFUNC MY_Result_t MY_I2C_WaitOnTXISFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32_t Timeout, uint32_t Tickstart)
 {
 	while (MY_I2C_GET_FLAG(I2C_Handler->Instance, I2C_FLAG_TXIS) == RESET)
 	{
@@ -655,7 +896,7 @@ MY_Result_t MY_I2C_WaitOnTXISFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32
 	    		I2C_Handler->Mode = MY_I2C_Mode_None;
 
 	    		/* Process Unlocked */
-	    		MY_UNLOCK(I2C_Handler);
+	    		MY_I2C_INT_Unlock(I2C_Handler);
 
 	    		return MY_Result_Timeout;
 	    	}
@@ -666,7 +907,7 @@ MY_Result_t MY_I2C_WaitOnTXISFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32
 
 }
 
-MY_Result_t MY_I2C_WaitOnRXNEFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32_t Timeout, uint32_t Tickstart)
+MY_RAMFUNC MY_Result_t MY_I2C_WaitOnRXNEFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32_t Timeout, uint32_t Tickstart)
 {
 	while (MY_I2C_GET_FLAG(I2C_Handler->Instance, I2C_FLAG_RXNE) == RESET)
 	{
@@ -690,7 +931,7 @@ MY_Result_t MY_I2C_WaitOnRXNEFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32
 	    	I2C_Handler->Mode = MY_I2C_Mode_None;
 
 	    	/* Process Unlocked */
-	    	MY_UNLOCK(I2C_Handler);
+	    	MY_I2C_INT_Unlock(I2C_Handler);
 
 	    	return MY_Result_Error;
 	    }
@@ -702,7 +943,7 @@ MY_Result_t MY_I2C_WaitOnRXNEFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32
 	    	I2C_Handler->State = MY_I2C_State_Ready;
 
 	    	/* Process Unlocked */
-	    	MY_UNLOCK(I2C_Handler);
+	    	MY_I2C_INT_Unlock(I2C_Handler);
 
 	      return MY_Result_Timeout;
 	    }
@@ -712,7 +953,7 @@ MY_Result_t MY_I2C_WaitOnRXNEFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32
 }
 
 
-MY_Result_t MY_I2C_IsAcknowledgeFailed(MY_I2C_Init_t *I2C_Handler, uint32_t Timeout, uint32_t Tickstart)
+MY_RAMFUNC MY_Result_t MY_I2C_IsAcknowledgeFailed(MY_I2C_Init_t *I2C_Handler, uint32_t Timeout, uint32_t Tickstart)
 {
 	if (MY_I2C_GET_FLAG(I2C_Handler->Instance, I2C_FLAG_AF) == SET)
 	{
@@ -729,7 +970,7 @@ MY_Result_t MY_I2C_IsAcknowledgeFailed(MY_I2C_Init_t *I2C_Handler, uint32_t Time
 	    			I2C_Handler->Mode = MY_I2C_Mode_None;
 
 	    			/* Process Unlocked */
-	    			MY_UNLOCK(I2C_Handler);
+	    			MY_I2C_INT_Unlock(I2C_Handler);
 	    			return MY_Result_Timeout;
 	    		}
 	    	}
@@ -752,7 +993,7 @@ MY_Result_t MY_I2C_IsAcknowledgeFailed(MY_I2C_Init_t *I2C_Handler, uint32_t Time
 	    I2C_Handler->Mode = MY_I2C_Mode_None;
 
 	    /* Process Unlocked */
-	    MY_UNLOCK(I2C_Handler);
+	    MY_I2C_INT_Unlock(I2C_Handler);
 
 		return MY_Result_Error;
 
@@ -763,7 +1004,7 @@ MY_Result_t MY_I2C_IsAcknowledgeFailed(MY_I2C_Init_t *I2C_Handler, uint32_t Time
 }
 
 
-MY_Result_t MY_I2C_WaitOnSTOPFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32_t Timeout, uint32_t Tickstart)
+MY_RAMFUNC MY_Result_t MY_I2C_WaitOnSTOPFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32_t Timeout, uint32_t Tickstart)
 {
 	while (MY_I2C_GET_FLAG(I2C_Handler->Instance, I2C_FLAG_STOPF) == RESET)
 	{
@@ -781,7 +1022,7 @@ MY_Result_t MY_I2C_WaitOnSTOPFlagUntilTimeout(MY_I2C_Init_t *I2C_Handler, uint32
 	    	I2C_Handler->Mode = MY_I2C_Mode_None;
 
 	    	/* Process Unlocked */
-	    	MY_UNLOCK(I2C_Handler);
+	    	MY_I2C_INT_Unlock(I2C_Handler);
 
 	    	return MY_Result_Timeout;
 	    }
@@ -852,6 +1093,180 @@ MY_Result_t MY_I2C_Write(I2C_TypeDef* I2Cx, uint8_t device_address, uint8_t regi
 	return MY_Result_Ok;
 }
 
+static uint8_t MY_I2C_INT_PT_TryLock(MY_I2C_PT_t *Ctx, MY_I2C_Init_t *I2C_Handler)
+{
+	if (MY_Lock_TryAcquire(&I2C_Handler->Lock) != MY_Result_Ok)
+	{
+		return 0U;
+	}
+
+	if (I2C_Handler->State != MY_I2C_State_Ready)
+	{
+		MY_I2C_INT_Unlock(I2C_Handler);
+
+		return 0U;
+	}
+
+	I2C_Handler->State = MY_I2C_State_Busy;
+	Ctx->Result = MY_Result_Ok;
+
+	return 1U;
+}
+
+
+static void MY_I2C_INT_PT_Release(MY_I2C_PT_t *Ctx, MY_I2C_Init_t *I2C_Handler, MY_Result_t Result)
+{
+	/* Возвращаем структуру в исходное состояние */
+	I2C_Handler->State = MY_I2C_State_Ready;
+	I2C_Handler->Mode  = MY_I2C_Mode_None;
+
+	/* Разблокируем процесс */
+	MY_I2C_INT_Unlock(I2C_Handler);
+
+	Ctx->Result = Result;
+}
+
+
+static void MY_I2C_INT_PT_Config(MY_I2C_PT_t *Ctx, MY_I2C_Init_t *I2C_Handler, uint16_t device_address, uint32_t request)
+{
+	/* Больше MAX_NBYTE_SIZE байт передаётся частями в режиме Reload */
+	if (Ctx->Count > MAX_NBYTE_SIZE)
+	{
+		Ctx->Chunk = (uint8_t)MAX_NBYTE_SIZE;
+		MY_I2C_TransferConfig(I2C_Handler, device_address, Ctx->Chunk, I2C_RELOAD_MODE, request);
+	}
+	else
+	{
+		Ctx->Chunk = (uint8_t)Ctx->Count;
+		MY_I2C_TransferConfig(I2C_Handler, device_address, Ctx->Chunk, I2C_AUTOEND_MODE, request);
+	}
+}
+
+
+static MY_PT_State_t MY_I2C_INT_PT_Transfer(MY_I2C_PT_t *Ctx, MY_I2C_Init_t *I2C_Handler, uint16_t device_address, uint8_t *pData, uint16_t size, uint32_t timeout, uint8_t read)
+{
+	I2C_TypeDef *I2Cx = I2C_Handler->Instance;
+	uint32_t data_flag = read ? I2C_FLAG_RXNE : I2C_FLAG_TXIS;
+
+	MY_PT_BEGIN(&Ctx->PT);
+
+	/* Ждём, пока I2C освободит другой процесс */
+	Ctx->Result = MY_Result_Busy;
+	MY_PT_AWAIT_TIMEOUT(&Ctx->PT, MY_I2C_INT_PT_TryLock(Ctx, I2C_Handler), timeout);
+
+	if (Ctx->Result != MY_Result_Ok)
+	{
+		MY_PT_EXIT(&Ctx->PT);
+	}
+
+	/* Ждём пока не будет снят флаг I2C BUSY */
+	MY_PT_AWAIT_TIMEOUT(&Ctx->PT, MY_I2C_GET_FLAG(I2Cx, I2C_FLAG_BUSY) == RESET, I2C_TIMEOUT_BUSY);
+
+	if (MY_I2C_GET_FLAG(I2Cx, I2C_FLAG_BUSY) == SET)
+	{
+		MY_I2C_INT_PT_Release(Ctx, I2C_Handler, MY_Result_Timeout);
+		MY_PT_EXIT(&Ctx->PT);
+	}
+
+	/* Заносим параметры текущего состояния I2C */
+	I2C_Handler->State     = read ? MY_I2C_State_Busy_Rx : MY_I2C_State_Busy_Tx;
+	I2C_Handler->Mode      = MY_I2C_Mode_Master;
+	I2C_Handler->ErrorCode = I2C_ERROR_NONE;
+
+	Ctx->Data  = pData;
+	Ctx->Count = size;
+
+	MY_I2C_INT_PT_Config(Ctx, I2C_Handler, device_address, read ? I2C_GENERATE_START_READ : I2C_GENERATE_START_WRITE);
+	MY_PT_TIMER_START(&Ctx->PT);
+
+	while (Ctx->Count > 0U)
+	{
+		/* Ждём TXIS/RXNE, NACK или STOP */
+		MY_PT_WAIT_UNTIL(&Ctx->PT, ((I2Cx->ISR & (data_flag | I2C_FLAG_AF | I2C_FLAG_STOPF)) != 0U) || MY_PT_EXPIRED(&Ctx->PT, timeout));
+
+		if (MY_I2C_GET_FLAG(I2Cx, data_flag) == RESET)
+		{
+			break;
+		}
+
+		if (read)
+		{
+			(*Ctx->Data++) = (uint8_t)I2Cx->RXDR;
+		}
+		else
+		{
+			I2Cx->TXDR = (*Ctx->Data++);
+		}
+
+		Ctx->Count--;
+		Ctx->Chunk--;
+
+		/* Часть передана, загружаем следующую. NACK последнего байта части приходит вместо TCR */
+		if ((Ctx->Chunk == 0U) && (Ctx->Count != 0U))
+		{
+			MY_PT_WAIT_UNTIL(&Ctx->PT, ((I2Cx->ISR & (I2C_FLAG_TCR | I2C_FLAG_AF)) != 0U) || MY_PT_EXPIRED(&Ctx->PT, timeout));
+
+			if (MY_I2C_GET_FLAG(I2Cx, I2C_FLAG_TCR) == RESET)
+			{
+				break;
+			}
+
+			MY_I2C_INT_PT_Config(Ctx, I2C_Handler, device_address, I2C_NO_STARTSTOP);
+		}
+	}
+
+	/* В режиме AUTOEND STOP генерируется автоматически */
+	if (Ctx->Count == 0U)
+	{
+		MY_PT_WAIT_UNTIL(&Ctx->PT, ((I2Cx->ISR & (I2C_FLAG_STOPF | I2C_FLAG_AF)) != 0U) || MY_PT_EXPIRED(&Ctx->PT, timeout));
+	}
+
+	/* NACK: после него STOP также формируется автоматически */
+	if (MY_I2C_GET_FLAG(I2Cx, I2C_FLAG_AF) == SET)
+	{
+		MY_PT_WAIT_UNTIL(&Ctx->PT, (MY_I2C_GET_FLAG(I2Cx, I2C_FLAG_STOPF) == SET) || MY_PT_EXPIRED(&Ctx->PT, timeout));
+
+		MY_I2C_CLEAR_FLAG(I2Cx, I2C_FLAG_AF);
+		MY_I2C_CLEAR_FLAG(I2Cx, I2C_FLAG_STOPF);
+		MY_I2C_Flush_TXDR(I2C_Handler);
+		MY_I2C_RESET_CR2(I2Cx);
+
+		I2C_Handler->ErrorCode = I2C_ERROR_AF;
+
+		MY_I2C_INT_PT_Release(Ctx, I2C_Handler, MY_Result_Error);
+		MY_PT_EXIT(&Ctx->PT);
+	}
+
+	if (MY_I2C_GET_FLAG(I2Cx, I2C_FLAG_STOPF) == RESET)
+	{
+		I2C_Handler->ErrorCode |= I2C_ERROR_TIMEOUT;
+
+		MY_I2C_INT_PT_Release(Ctx, I2C_Handler, MY_Result_Timeout);
+		MY_PT_EXIT(&Ctx->PT);
+	}
+
+	/* Сбрасываем флаг STOP и регистр CR2 */
+	MY_I2C_CLEAR_FLAG(I2Cx, I2C_FLAG_STOPF);
+	MY_I2C_RESET_CR2(I2Cx);
+
+	/* STOP раньше последнего байта при приёме - ошибка, как в MY_I2C_WaitOnRXNEFlagUntilTimeout() */
+	MY_I2C_INT_PT_Release(Ctx, I2C_Handler, (Ctx->Count == 0U) ? MY_Result_Ok : MY_Result_Error);
+
+	MY_PT_END(&Ctx->PT);
+}
+
+
+MY_PT_State_t MY_I2C_PT_Master_Transmit(MY_I2C_PT_t *Ctx, MY_I2C_Init_t *I2C_Handler, uint16_t device_address, uint8_t *pData, uint16_t size, uint32_t timeout)
+{
+	return MY_I2C_INT_PT_Transfer(Ctx, I2C_Handler, device_address, pData, size, timeout, 0U);
+}
+
+
+MY_PT_State_t MY_I2C_PT_Master_Receive(MY_I2C_PT_t *Ctx, MY_I2C_Init_t *I2C_Handler, uint16_t device_address, uint8_t *pData, uint16_t size, uint32_t timeout)
+{
+	return MY_I2C_INT_PT_Transfer(Ctx, I2C_Handler, device_address, pData, size, timeout, 1U);
+}
+
 /* Приватные функции */
 static void MY_I2C1_INT_InitPins(MY_I2C_PinsPack_t pinspack)
 {
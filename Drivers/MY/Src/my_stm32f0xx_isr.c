@@ -0,0 +1,241 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/isr
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Статистика обработчиков прерываний: длительность, вложенность, задержка, загрузка
+ */
+#include "my_stm32f0xx_isr.h"
+
+#if (ISR_STATS_ENABLE == 1U)
+
+#include "my_stm32f0xx_cortex.h"
+
+/* Таблица записей и отображение IRQn + 16 -> номер записи + 1 (0 - запись не выделена) */
+static MY_ISR_Stats_t MY_INT_ISR_Stats[ISR_STATS_SLOTS];
+static uint8_t MY_INT_ISR_Map[ISR_STATS_VECTORS];
+static uint32_t MY_INT_ISR_SlotsCount = 0;
+
+/* Текущая глубина вложения и такты вложенных обработчиков на каждом уровне */
+static uint32_t MY_INT_ISR_Depth = 0;
+static uint32_t MY_INT_ISR_Child[ISR_STATS_NEST_MAX + 1U];
+
+/* Максимальная задержка входа в SysTick_Handler и начало окна загрузки */
+static uint32_t MY_INT_ISR_MaxLatency = 0;
+static uint32_t MY_INT_ISR_WindowTick = 0;
+
+
+/* Такты между двумя значениями SysTick->VAL (счёт вниз, не более одной перезагрузки) */
+static uint32_t MY_INT_ISR_Elapsed(uint32_t Start, uint32_t End)
+{
+	return (Start >= End) ? (Start - End) : (Start + (SysTick->LOAD + 1U) - End);
+}
+
+
+static MY_ISR_Stats_t* MY_INT_ISR_Slot(IRQn_Type IRQn, uint8_t Allocate)
+{
+	uint32_t index = (uint32_t)((int32_t)IRQn + 16);
+	MY_ISR_Stats_t *slot;
+
+	if(index >= ISR_STATS_VECTORS)
+	{
+		return NULL;
+	}
+
+	if(MY_INT_ISR_Map[index] != 0U)
+	{
+		return &MY_INT_ISR_Stats[MY_INT_ISR_Map[index] - 1U];
+	}
+
+	if(!Allocate || (MY_INT_ISR_SlotsCount >= ISR_STATS_SLOTS))
+	{
+		return NULL;
+	}
+
+	slot = &MY_INT_ISR_Stats[MY_INT_ISR_SlotsCount++];
+
+	slot->IRQn = (int8_t)IRQn;
+	slot->MaxDepth = 0;
+	slot->Count = 0;
+	slot->LastEntry = 0;
+	slot->Max = 0;
+	slot->Total = 0;
+
+	MY_INT_ISR_Map[index] = (uint8_t)MY_INT_ISR_SlotsCount;
+
+	return slot;
+}
+
+
+uint32_t MY_ISR_Enter(IRQn_Type IRQn)
+{
+	uint32_t start = SysTick->VAL;
+	uint32_t primask = __get_PRIMASK();
+	MY_ISR_Stats_t *slot;
+
+	__disable_irq();
+
+	MY_INT_ISR_Depth++;
+
+	if(MY_INT_ISR_Depth <= ISR_STATS_NEST_MAX)
+	{
+		MY_INT_ISR_Child[MY_INT_ISR_Depth] = 0;
+	}
+
+	slot = MY_INT_ISR_Slot(IRQn, 1U);
+
+	if(slot != NULL)
+	{
+		slot->Count++;
+		slot->LastEntry = MY_SysTick_GetTick();
+
+		if(MY_INT_ISR_Depth > slot->MaxDepth)
+		{
+			slot->MaxDepth = (uint8_t)MY_INT_ISR_Depth;
+		}
+	}
+
+	/* Запрос SysTick возникает при перезагрузке: от неё до входа прошло LOAD - VAL тактов */
+	if((IRQn == SysTick_IRQn) && ((SysTick->LOAD - start) > MY_INT_ISR_MaxLatency))
+	{
+		MY_INT_ISR_MaxLatency = SysTick->LOAD - start;
+	}
+
+	__set_PRIMASK(primask);
+
+	return start;
+}
+
+
+void MY_ISR_Exit(IRQn_Type IRQn, uint32_t Start)
+{
+	uint32_t end = SysTick->VAL;
+	uint32_t primask = __get_PRIMASK();
+	uint32_t total;
+	uint32_t self;
+	MY_ISR_Stats_t *slot;
+
+	__disable_irq();
+
+	total = MY_INT_ISR_Elapsed(Start, end);
+	self = total;
+
+	/* Время вложенных обработчиков учитывается у них, а не у прерванного */
+	if((MY_INT_ISR_Depth > 0U) && (MY_INT_ISR_Depth <= ISR_STATS_NEST_MAX))
+	{
+		self = (total > MY_INT_ISR_Child[MY_INT_ISR_Depth]) ? (total - MY_INT_ISR_Child[MY_INT_ISR_Depth]) : 0U;
+	}
+
+	if(MY_INT_ISR_Depth > 0U)
+	{
+		MY_INT_ISR_Depth--;
+	}
+
+	if((MY_INT_ISR_Depth > 0U) && (MY_INT_ISR_Depth <= ISR_STATS_NEST_MAX))
+	{
+		MY_INT_ISR_Child[MY_INT_ISR_Depth] += total;
+	}
+
+	slot = MY_INT_ISR_Slot(IRQn, 0U);
+
+	if(slot != NULL)
+	{
+		slot->Total += self;
+
+		if(self > slot->Max)
+		{
+			slot->Max = self;
+		}
+	}
+
+	__set_PRIMASK(primask);
+}
+
+
+const MY_ISR_Stats_t* MY_ISR_GetStats(IRQn_Type IRQn)
+{
+	return MY_INT_ISR_Slot(IRQn, 0U);
+}
+
+
+uint32_t MY_ISR_GetMaxLatency(void)
+{
+	return MY_INT_ISR_MaxLatency;
+}
+
+
+uint32_t MY_ISR_GetLoad(IRQn_Type IRQn)
+{
+	const MY_ISR_Stats_t *slot = MY_INT_ISR_Slot(IRQn, 0U);
+	uint64_t window = (uint64_t)(MY_SysTick_GetTick() - MY_INT_ISR_WindowTick) * (SysTick->LOAD + 1U);
+	uint64_t total;
+	uint32_t primask;
+
+	if((slot == NULL) || (window == 0U))
+	{
+		return 0;
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+	total = slot->Total;
+	__set_PRIMASK(primask);
+
+	return (uint32_t)((total * 10000U) / window);
+}
+
+
+void MY_ISR_Reset(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t i;
+
+	__disable_irq();
+
+	/* Записи остаются закреплёнными за своими IRQn */
+	for(i = 0; i < MY_INT_ISR_SlotsCount; i++)
+	{
+		MY_INT_ISR_Stats[i].MaxDepth = 0;
+		MY_INT_ISR_Stats[i].Count = 0;
+		MY_INT_ISR_Stats[i].Max = 0;
+		MY_INT_ISR_Stats[i].Total = 0;
+	}
+
+	MY_INT_ISR_MaxLatency = 0;
+	MY_INT_ISR_WindowTick = MY_SysTick_GetTick();
+
+	__set_PRIMASK(primask);
+}
+
+
+void MY_ISR_Dump(void)
+{
+	uint32_t i;
+
+	printf("isr: window %lu ms, SysTick latency max %lu cycles\r\n",
+		   (unsigned long)(MY_SysTick_GetTick() - MY_INT_ISR_WindowTick), (unsigned long)MY_INT_ISR_MaxLatency);
+	printf("%6s %10s %10s %10s %10s %6s %8s\r\n", "irq", "count", "last", "max", "avg", "depth", "load%");
+
+	for(i = 0; i < MY_INT_ISR_SlotsCount; i++)
+	{
+		MY_ISR_Stats_t stats;
+		uint32_t primask = __get_PRIMASK();
+		uint32_t load;
+		uint32_t avg;
+
+		/* Копия записи, чтобы значения были согласованы */
+		__disable_irq();
+		stats = MY_INT_ISR_Stats[i];
+		__set_PRIMASK(primask);
+
+		avg = (stats.Count != 0U) ? (uint32_t)(stats.Total / stats.Count) : 0U;
+		load = MY_ISR_GetLoad((IRQn_Type)stats.IRQn);
+
+		printf("%6d %10lu %10lu %10lu %10lu %6u %5lu.%02lu\r\n", (int)stats.IRQn, (unsigned long)stats.Count,
+			   (unsigned long)stats.LastEntry, (unsigned long)stats.Max, (unsigned long)avg, (unsigned)stats.MaxDepth,
+			   (unsigned long)(load / 100U), (unsigned long)(load % 100U));
+	}
+}
+
+#endif
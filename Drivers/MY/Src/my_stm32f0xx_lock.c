@@ -0,0 +1,249 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/lock
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Блокировки и критические секции
+ */
+#include "my_stm32f0xx_lock.h"
+#include "my_stm32f0xx_cortex.h"
+#include "my_stm32f0xx_os.h"
+
+/* Глубина вложения критических секций и PRIMASK на входе во внешнюю */
+static volatile uint32_t MY_INT_LOCK_Nesting = 0;
+static volatile uint32_t MY_INT_LOCK_Primask = 0;
+
+
+#if (LOCK_OWNERSHIP == 1U)
+
+/* Идентификатор текущего контекста выполнения */
+static uint32_t MY_INT_LOCK_Owner(void)
+{
+	uint32_t ipsr = __get_IPSR();
+
+	/* Номер исключения: 2..47, не пересекается с MY_LOCK_OWNER_MAIN и адресами задач */
+	if(ipsr != 0U)
+	{
+		return ipsr;
+	}
+
+	#if (USE_RTOS == 1U)
+
+		if(MY_OS_IsRunning())
+		{
+			return (uint32_t)MY_OS_Task_Current();
+		}
+
+	#endif
+
+	return MY_LOCK_OWNER_MAIN;
+}
+
+#endif
+
+
+/* Атомарная проверка и захват. Вызывается в критической секции */
+static MY_Result_t MY_INT_LOCK_Take(MY_Lock_t *Lock)
+{
+	#if (LOCK_OWNERSHIP == 1U)
+
+		uint32_t owner = MY_INT_LOCK_Owner();
+
+		if(Lock->State == MY_Lock_On)
+		{
+			return (Lock->Owner == owner) ? MY_Result_Error : MY_Result_Busy;
+		}
+
+		Lock->Owner = owner;
+
+	#else
+
+		if(Lock->State == MY_Lock_On)
+		{
+			return MY_Result_Busy;
+		}
+
+	#endif
+
+	Lock->State = MY_Lock_On;
+
+	#if (LOCK_STATISTICS == 1U)
+		Lock->Acquired++;
+	#endif
+
+	return MY_Result_Ok;
+}
+
+
+void MY_Critical_Enter(void)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+
+	if(MY_INT_LOCK_Nesting++ == 0U)
+	{
+		MY_INT_LOCK_Primask = primask;
+	}
+}
+
+
+void MY_Critical_Exit(void)
+{
+	if(MY_INT_LOCK_Nesting == 0U)
+	{
+		return;
+	}
+
+	if(--MY_INT_LOCK_Nesting == 0U)
+	{
+		__set_PRIMASK(MY_INT_LOCK_Primask);
+	}
+}
+
+
+void MY_Lock_Init(MY_Lock_t *Lock)
+{
+	MY_Critical_Enter();
+
+	Lock->State = MY_Lock_Off;
+
+	#if (LOCK_OWNERSHIP == 1U)
+		Lock->Owner = MY_LOCK_OWNER_NONE;
+	#endif
+
+	#if (LOCK_STATISTICS == 1U)
+		Lock->Acquired = 0;
+		Lock->Contended = 0;
+	#endif
+
+	MY_Critical_Exit();
+}
+
+
+MY_Result_t MY_Lock_TryAcquire(MY_Lock_t *Lock)
+{
+	MY_Result_t result;
+
+	MY_Critical_Enter();
+
+	result = MY_INT_LOCK_Take(Lock);
+
+	#if (LOCK_STATISTICS == 1U)
+		if(result == MY_Result_Busy)
+		{
+			Lock->Contended++;
+		}
+	#endif
+
+	MY_Critical_Exit();
+
+	return result;
+}
+
+
+MY_Result_t MY_Lock_Acquire(MY_Lock_t *Lock, uint32_t Timeout)
+{
+	uint32_t tickstart = MY_SysTick_GetTick();
+	uint32_t elapsed;
+	MY_Result_t result;
+
+	result = MY_Lock_TryAcquire(Lock);
+
+	if((result != MY_Result_Busy) || (Timeout == 0U) || (__get_IPSR() != 0U))
+	{
+		return result;
+	}
+
+	while(1)
+	{
+		elapsed = MY_SysTick_GetTick() - tickstart;
+
+		if((Timeout != MAX_DELAY) && (elapsed >= Timeout))
+		{
+			return MY_Result_Timeout;
+		}
+
+		#if (USE_RTOS == 1U)
+
+			if(MY_OS_IsRunning())
+			{
+				/* Не через MY_Critical_Enter(): задача переключается внутри MY_OS_Wait(), счётчик вложения общий */
+				uint32_t primask = __get_PRIMASK();
+
+				__disable_irq();
+
+				result = MY_INT_LOCK_Take(Lock);
+
+				/* Проверка и переход в ожидание атомарны: MY_OS_Wait() сама разрешает прерывания */
+				if(result == MY_Result_Busy)
+				{
+					MY_OS_Wait(Lock, (Timeout == MAX_DELAY) ? MAX_DELAY : (Timeout - elapsed));
+				}
+
+				__set_PRIMASK(primask);
+
+				if(result != MY_Result_Busy)
+				{
+					return result;
+				}
+
+				continue;
+			}
+
+		#endif
+
+		result = MY_Lock_TryAcquire(Lock);
+
+		if(result != MY_Result_Busy)
+		{
+			return result;
+		}
+	}
+}
+
+
+MY_Result_t MY_Lock_Release(MY_Lock_t *Lock)
+{
+	MY_Critical_Enter();
+
+	#if (LOCK_OWNERSHIP == 1U)
+
+		if((Lock->State != MY_Lock_On) || (Lock->Owner != MY_INT_LOCK_Owner()))
+		{
+			MY_Critical_Exit();
+
+			return MY_Result_Error;
+		}
+
+		Lock->Owner = MY_LOCK_OWNER_NONE;
+
+	#else
+
+		if(Lock->State != MY_Lock_On)
+		{
+			MY_Critical_Exit();
+
+			return MY_Result_Error;
+		}
+
+	#endif
+
+	Lock->State = MY_Lock_Off;
+
+	MY_Critical_Exit();
+
+	#if (USE_RTOS == 1U)
+		/* Пробуждаем задачи, ожидающие блокировку */
+		MY_OS_Notify(Lock);
+	#endif
+
+	return MY_Result_Ok;
+}
+
+
+uint8_t MY_Lock_IsLocked(const MY_Lock_t *Lock)
+{
+	return (Lock->State == MY_Lock_On) ? 1U : 0U;
+}
@@ -0,0 +1,187 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/log
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Отложенный двоичный журнал: строки формата только в ELF, форматирование на ПК
+ */
+#include "my_stm32f0xx_log.h"
+#include "my_stm32f0xx_cortex.h"
+#include "my_stm32f0xx_console.h"
+
+#if ((LOG_BUFFER_WORDS & (LOG_BUFFER_WORDS - 1U)) != 0U)
+	#error "LOG_BUFFER_WORDS must be a power of two"
+#endif
+
+#define MY_INT_LOG_MASK							(LOG_BUFFER_WORDS - 1U)
+
+/* Слов в записи помимо аргументов */
+#if (LOG_TIMESTAMP == 1U)
+	#define MY_INT_LOG_HEADER_WORDS				2U
+#else
+	#define MY_INT_LOG_HEADER_WORDS				1U
+#endif
+
+/* Строка вывода: "LOG" и до 6 слов по 9 символов, "\r\n" */
+#define MY_INT_LOG_LINE_SIZE					(3U + ((MY_INT_LOG_HEADER_WORDS + LOG_ARGS_MAX) * 9U) + 2U)
+
+/* Кольцевой буфер слов: запись под PRIMASK из любого контекста, чтение только из MY_LOG_Process() */
+static uint32_t MY_INT_LOG_Buffer[LOG_BUFFER_WORDS];
+static volatile uint32_t MY_INT_LOG_Head = 0;
+static volatile uint32_t MY_INT_LOG_Tail = 0;
+
+static MY_LOG_Stats_t MY_INT_LOG_Stats;
+
+
+/* Резервирует место и записывает запись целиком или отбрасывает её */
+static void MY_INT_LOG_Push(uint32_t Id, const uint32_t *Args, uint32_t Count)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t words = MY_INT_LOG_HEADER_WORDS + Count;
+	uint32_t head;
+	uint32_t used;
+	uint32_t i;
+
+	__disable_irq();
+
+	head = MY_INT_LOG_Head;
+	used = head - MY_INT_LOG_Tail;
+
+	if((LOG_BUFFER_WORDS - used) < words)
+	{
+		MY_INT_LOG_Stats.Dropped++;
+
+		__set_PRIMASK(primask);
+
+		return;
+	}
+
+	#if (LOG_TIMESTAMP == 1U)
+		MY_INT_LOG_Buffer[head++ & MY_INT_LOG_MASK] = (Id & LOG_HEADER_ID_Msk) | (Count << LOG_HEADER_ARGS_Pos) | LOG_HEADER_TIMESTAMP;
+		MY_INT_LOG_Buffer[head++ & MY_INT_LOG_MASK] = MY_SysTick_GetTick();
+	#else
+		MY_INT_LOG_Buffer[head++ & MY_INT_LOG_MASK] = (Id & LOG_HEADER_ID_Msk) | (Count << LOG_HEADER_ARGS_Pos);
+	#endif
+
+	for(i = 0; i < Count; i++)
+	{
+		MY_INT_LOG_Buffer[head++ & MY_INT_LOG_MASK] = Args[i];
+	}
+
+	MY_INT_LOG_Head = head;
+
+	MY_INT_LOG_Stats.Written++;
+
+	if((used + words) > MY_INT_LOG_Stats.Peak)
+	{
+		MY_INT_LOG_Stats.Peak = used + words;
+	}
+
+	__set_PRIMASK(primask);
+}
+
+
+void MY_LOG_Write0(uint32_t Id)
+{
+	MY_INT_LOG_Push(Id, NULL, 0);
+}
+
+
+void MY_LOG_Write1(uint32_t Id, uint32_t Arg0)
+{
+	MY_INT_LOG_Push(Id, &Arg0, 1);
+}
+
+
+void MY_LOG_Write2(uint32_t Id, uint32_t Arg0, uint32_t Arg1)
+{
+	uint32_t args[2] = { Arg0, Arg1 };
+
+	MY_INT_LOG_Push(Id, args, 2);
+}
+
+
+void MY_LOG_Write3(uint32_t Id, uint32_t Arg0, uint32_t Arg1, uint32_t Arg2)
+{
+	uint32_t args[3] = { Arg0, Arg1, Arg2 };
+
+	MY_INT_LOG_Push(Id, args, 3);
+}
+
+
+void MY_LOG_Write4(uint32_t Id, uint32_t Arg0, uint32_t Arg1, uint32_t Arg2, uint32_t Arg3)
+{
+	uint32_t args[4] = { Arg0, Arg1, Arg2, Arg3 };
+
+	MY_INT_LOG_Push(Id, args, 4);
+}
+
+
+uint32_t MY_LOG_Process(void)
+{
+	static const char hex[] = "0123456789ABCDEF";
+	char line[MY_INT_LOG_LINE_SIZE];
+	uint32_t records = 0;
+	uint32_t tail = MY_INT_LOG_Tail;
+	uint32_t words;
+	uint32_t word;
+	uint32_t length;
+	uint32_t i;
+	int32_t shift;
+
+	while(tail != MY_INT_LOG_Head)
+	{
+		/* Запись выводится только целиком */
+		if(MY_CONSOLE_GetFree() < MY_INT_LOG_LINE_SIZE)
+		{
+			break;
+		}
+
+		word = MY_INT_LOG_Buffer[tail & MY_INT_LOG_MASK];
+		words = ((word & LOG_HEADER_TIMESTAMP) ? 2U : 1U) + ((word >> LOG_HEADER_ARGS_Pos) & 0x0FU);
+
+		line[0] = 'L';
+		line[1] = 'O';
+		line[2] = 'G';
+		length = 3;
+
+		/* Шестнадцатеричные слова без printf() */
+		for(i = 0; i < words; i++)
+		{
+			word = MY_INT_LOG_Buffer[(tail + i) & MY_INT_LOG_MASK];
+			line[length++] = ' ';
+
+			for(shift = 28; shift >= 0; shift -= 4)
+			{
+				line[length++] = hex[(word >> shift) & 0x0FU];
+			}
+		}
+
+		line[length++] = '\r';
+		line[length++] = '\n';
+
+		tail += words;
+
+		/* Место освобождается только после чтения всех слов записи */
+		MY_INT_LOG_Tail = tail;
+
+		MY_CONSOLE_Write(line, length);
+
+		records++;
+	}
+
+	return records;
+}
+
+
+void MY_LOG_GetStats(MY_LOG_Stats_t *Stats)
+{
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+
+	*Stats = MY_INT_LOG_Stats;
+
+	__set_PRIMASK(primask);
+}
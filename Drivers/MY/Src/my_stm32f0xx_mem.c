@@ -0,0 +1,190 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/mem
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Контроль глубины стека и кучи: закраска стека, high-water mark, охранная зона
+ */
+#include "my_stm32f0xx_mem.h"
+#include "my_stm32f0xx_cortex.h"
+
+/* Символы скрипта компоновщика: начало кучи, низ резерва стека и вершина стека */
+extern uint32_t _end[];
+extern uint32_t _sstack[];
+extern uint32_t _estack[];
+
+/* Вершина кучи: текущая и максимальная. NULL - куча не использовалась */
+static char *MY_INT_MEM_HeapEnd = NULL;
+static char *MY_INT_MEM_HeapPeak = NULL;
+static uint32_t MY_INT_MEM_HeapFailed = 0;
+
+
+/* Нижняя граница закраски: над максимумом кучи, выровнено по слову */
+static uint32_t* MY_INT_MEM_Bottom(void)
+{
+	if(MY_INT_MEM_HeapPeak == NULL)
+	{
+		return _end;
+	}
+
+	return (uint32_t *)(((uint32_t)MY_INT_MEM_HeapPeak + 3U) & ~3U);
+}
+
+
+/* Верхняя граница закраски: ниже текущего указателя стека закраска ещё может сохраниться */
+static uint32_t* MY_INT_MEM_Top(void)
+{
+	return (uint32_t *)(__get_MSP() & ~3U);
+}
+
+
+/* Слово и MEM_SCAN_RUN - 1 слов над ним закрашены */
+static uint8_t MY_INT_MEM_IsPainted(const uint32_t *Word, const uint32_t *Top)
+{
+	uint32_t i;
+
+	for(i = 0; (i < MEM_SCAN_RUN) && (&Word[i] < Top); i++)
+	{
+		if(Word[i] != MEM_PAINT_PATTERN)
+		{
+			return 0;
+		}
+	}
+
+	return 1;
+}
+
+
+uint32_t MY_MEM_Stack_GetPeak(void)
+{
+	const uint32_t *top = MY_INT_MEM_Top();
+	const uint32_t *low = MY_INT_MEM_Bottom();
+	const uint32_t *high = top;
+	const uint32_t *mid;
+
+	/* Закраска снизу до границы, затёртые слова выше: ищем первое слово без серии закраски */
+	while(low < high)
+	{
+		mid = low + ((uint32_t)(high - low) / 2U);
+
+		if(MY_INT_MEM_IsPainted(mid, top))
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+
+	/* Серия короче MEM_SCAN_RUN у самой границы: дочитываем до первого затёртого слова */
+	while((low < top) && (*low == MEM_PAINT_PATTERN))
+	{
+		low++;
+	}
+
+	return (uint32_t)((const uint8_t *)_estack - (const uint8_t *)low);
+}
+
+
+uint32_t MY_MEM_Stack_GetPeakExact(void)
+{
+	const uint32_t *top = MY_INT_MEM_Top();
+	const uint32_t *word = MY_INT_MEM_Bottom();
+
+	while((word < top) && (*word == MEM_PAINT_PATTERN))
+	{
+		word++;
+	}
+
+	return (uint32_t)((const uint8_t *)_estack - (const uint8_t *)word);
+}
+
+
+char* MY_MEM_Heap_Limit(char *StackPtr)
+{
+	#if (MEM_GUARD_CHECK == 1U)
+
+		if(StackPtr > (char *)_sstack)
+		{
+			return (char *)_sstack;
+		}
+
+	#endif
+
+	return StackPtr;
+}
+
+
+void MY_MEM_Heap_Track(char *HeapEnd)
+{
+	if(HeapEnd == NULL)
+	{
+		MY_INT_MEM_HeapFailed++;
+
+		return;
+	}
+
+	MY_INT_MEM_HeapEnd = HeapEnd;
+
+	if(HeapEnd > MY_INT_MEM_HeapPeak)
+	{
+		MY_INT_MEM_HeapPeak = HeapEnd;
+	}
+}
+
+
+void MY_MEM_Guard_Check(void)
+{
+	#if (MEM_GUARD_CHECK == 1U)
+
+		const uint32_t *word;
+
+		for(word = _sstack; word < &_sstack[MEM_GUARD_SIZE / 4U]; word++)
+		{
+			if(*word != MEM_PAINT_PATTERN)
+			{
+				MY_MEM_GuardCallback();
+
+				/* Принудительный HardFault: запись MY_FAULT и перезапуск, пока стек не затёр .bss */
+				__builtin_trap();
+			}
+		}
+
+	#endif
+}
+
+
+void MY_MEM_GetStats(MY_MEM_Stats_t *Stats)
+{
+	char *heap = (char *)_end;
+	uint32_t peak = MY_MEM_Stack_GetPeak();
+
+	Stats->StackSize = (uint32_t)((uint8_t *)_estack - (uint8_t *)_sstack);
+	Stats->StackPeak = peak;
+	Stats->StackFree = (uint32_t)((char *)_estack - peak - (char *)MY_INT_MEM_Bottom());
+
+	Stats->HeapUsed = (MY_INT_MEM_HeapEnd != NULL) ? (uint32_t)(MY_INT_MEM_HeapEnd - heap) : 0U;
+	Stats->HeapPeak = (MY_INT_MEM_HeapPeak != NULL) ? (uint32_t)(MY_INT_MEM_HeapPeak - heap) : 0U;
+	Stats->HeapFailed = MY_INT_MEM_HeapFailed;
+}
+
+
+void MY_MEM_Dump(void)
+{
+	MY_MEM_Stats_t stats;
+
+	MY_MEM_GetStats(&stats);
+
+	printf("stack: size %lu, peak %lu (exact %lu), free %lu\r\n", (unsigned long)stats.StackSize,
+		   (unsigned long)stats.StackPeak, (unsigned long)MY_MEM_Stack_GetPeakExact(), (unsigned long)stats.StackFree);
+	printf("heap: used %lu, peak %lu, failed %lu\r\n", (unsigned long)stats.HeapUsed,
+		   (unsigned long)stats.HeapPeak, (unsigned long)stats.HeapFailed);
+}
+
+
+__attribute__((weak)) void MY_MEM_GuardCallback(void)
+{
+	/* NOTE : This function should not be modified, when the callback is needed, the @ref MY_MEM_GuardCallback should be implemented in the user file */
+}
@@ -0,0 +1,477 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/os
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Вытесняющее ядро с фиксированными приоритетами
+ */
+#include "my_stm32f0xx_os.h"
+#include "my_stm32f0xx_cortex.h"
+#include "my_stm32f0xx_pwr.h"
+#include "my_stm32f0xx_utils.h"
+
+#if (USE_RTOS == 1U)
+
+/* Начальное значение xPSR в кадре задачи: бит Thumb */
+#define OS_INITIAL_XPSR							0x01000000U
+
+/* Вершина стека из линкер-скрипта: после запуска стек main() отдаётся прерываниям */
+extern uint32_t _estack;
+
+/* Задачи по приоритетам и битовая маска готовых: бит N - задача с приоритетом N */
+static MY_OS_Task_t* MY_INT_OS_Tasks[OS_PRIORITIES];
+static volatile uint32_t MY_INT_OS_ReadyMask = 0;
+static volatile uint8_t MY_INT_OS_Running = 0;
+
+/* Текущая и следующая задачи, используются в PendSV_Handler */
+static MY_OS_Task_t* volatile MY_INT_OS_Current __attribute__((used)) = NULL;
+static MY_OS_Task_t* volatile MY_INT_OS_Next __attribute__((used)) = NULL;
+
+/* Задача простоя */
+static MY_OS_Task_t MY_INT_OS_IdleTask;
+static uint32_t MY_INT_OS_IdleStack[OS_IDLE_STACK_WORDS] __attribute__((aligned(8)));
+
+/* Позиция младшего установленного бита по произведению на последовательность де Брёйна */
+static const uint8_t MY_INT_OS_DeBruijn[32] =
+{
+	 0,  1, 28,  2, 29, 14, 24,  3, 30, 22, 20, 15, 25, 17,  4,  8,
+	31, 27, 13, 23, 21, 19, 16,  7, 26, 12, 18,  6, 11,  5, 10,  9
+};
+
+
+static uint32_t MY_INT_OS_Highest(uint32_t Mask)
+{
+	return MY_INT_OS_DeBruijn[((Mask & (0U - Mask)) * 0x077CB531U) >> 27];
+}
+
+
+/* Выбор задачи с наивысшим приоритетом. Вызывается при запрещённых прерываниях */
+static void MY_INT_OS_Schedule(void)
+{
+	MY_OS_Task_t *next;
+
+	if(!MY_INT_OS_Running)
+	{
+		return;
+	}
+
+	/* Задача простоя всегда готова, маска не бывает пустой */
+	next = MY_INT_OS_Tasks[MY_INT_OS_Highest(MY_INT_OS_ReadyMask)];
+
+	if(next != MY_INT_OS_Current)
+	{
+		MY_INT_OS_Next = next;
+		SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+	}
+}
+
+
+static void MY_INT_OS_Wakeup(MY_OS_Task_t *Task, MY_Result_t Result)
+{
+	Task->WaitObject = NULL;
+	Task->Timed = 0;
+	Task->WaitResult = (uint8_t)Result;
+	Task->State = MY_OS_State_Ready;
+
+	MY_INT_OS_ReadyMask |= (1UL << Task->Priority);
+}
+
+
+/* Сюда возвращается функция задачи */
+static void MY_INT_OS_TaskExit(void)
+{
+	MY_OS_Task_t *task;
+
+	__disable_irq();
+
+	task = MY_INT_OS_Current;
+	task->State = MY_OS_State_Dormant;
+
+	MY_INT_OS_ReadyMask &= ~(1UL << task->Priority);
+	MY_INT_OS_Tasks[task->Priority] = NULL;
+
+	MY_INT_OS_Schedule();
+
+	__enable_irq();
+
+	while(1)
+	{
+
+	}
+}
+
+
+/* Тиков до ближайшего таймаута ожидающей задачи: источник срока для простоя без тиков */
+static uint32_t MY_INT_OS_IdleTicks(void)
+{
+	uint32_t now = MY_SysTick_GetTick();
+	uint32_t next = MAX_DELAY;
+	int32_t left;
+	uint32_t i;
+
+	if(!MY_INT_OS_Running)
+	{
+		return MAX_DELAY;
+	}
+
+	for(i = 0; i < OS_IDLE_PRIORITY; i++)
+	{
+		MY_OS_Task_t *task = MY_INT_OS_Tasks[i];
+
+		if((task != NULL) && (task->State == MY_OS_State_Blocked) && task->Timed)
+		{
+			/* Та же арифметика, что в MY_OS_Tick(): срок наступил - спать нельзя */
+			left = (int32_t)(task->WakeTick - now);
+
+			if(left <= 0)
+			{
+				return 0U;
+			}
+
+			if((uint32_t)left < next)
+			{
+				next = (uint32_t)left;
+			}
+		}
+	}
+
+	return next;
+}
+
+
+static void MY_INT_OS_Idle(void *Arg)
+{
+	UNUSED(Arg);
+
+	while(1)
+	{
+		/* Своего срока у простоя нет: сон ограничивают источники сроков, в том числе MY_INT_OS_IdleTicks() */
+		MY_PWR_Enter(MAX_DELAY);
+	}
+}
+
+
+static MY_Result_t MY_INT_OS_Task_Setup(MY_OS_Task_t *Task, MY_OS_TaskFunc_t Func, void *Arg,
+										uint32_t *Stack, uint32_t StackWords, uint8_t Priority, const char *Name)
+{
+	uint32_t *sp;
+	uint32_t primask;
+	uint32_t i;
+
+	if((Task == NULL) || (Func == NULL) || (Stack == NULL) || (StackWords < OS_STACK_WORDS_MIN) || (Priority >= OS_PRIORITIES))
+	{
+		return MY_Result_Error;
+	}
+
+	/* Вершина стека выравнивается на 8 байт по AAPCS */
+	sp = (uint32_t *)(((uint32_t)(Stack + StackWords)) & ~0x7U);
+
+	/* Кадр исключения, который восстановит ядро при первом выходе из PendSV */
+	*(--sp) = OS_INITIAL_XPSR;							/* xPSR */
+	*(--sp) = ((uint32_t)Func) & ~0x1U;					/* PC */
+	*(--sp) = (uint32_t)MY_INT_OS_TaskExit;				/* LR */
+	*(--sp) = 0U;										/* R12 */
+	*(--sp) = 0U;										/* R3 */
+	*(--sp) = 0U;										/* R2 */
+	*(--sp) = 0U;										/* R1 */
+	*(--sp) = (uint32_t)Arg;							/* R0 */
+
+	/* R4-R11, сохраняемые программно */
+	for(i = 0; i < 8U; i++)
+	{
+		*(--sp) = 0U;
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+
+	if(MY_INT_OS_Tasks[Priority] != NULL)
+	{
+		__set_PRIMASK(primask);
+
+		return MY_Result_Error;
+	}
+
+	Task->SP = sp;
+	Task->StackBase = Stack;
+	Task->StackWords = StackWords;
+	Task->WakeTick = 0;
+	Task->WaitObject = NULL;
+	Task->Name = Name;
+	Task->Priority = Priority;
+	Task->Timed = 0;
+	Task->State = MY_OS_State_Ready;
+	Task->WaitResult = (uint8_t)MY_Result_Ok;
+
+	MY_INT_OS_Tasks[Priority] = Task;
+	MY_INT_OS_ReadyMask |= (1UL << Priority);
+
+	/* Задача, созданная из работающей задачи, может сразу её вытеснить */
+	MY_INT_OS_Schedule();
+
+	__set_PRIMASK(primask);
+
+	return MY_Result_Ok;
+}
+
+
+MY_Result_t MY_OS_Init(void)
+{
+	uint32_t i;
+
+	MY_INT_OS_Running = 0;
+	MY_INT_OS_ReadyMask = 0;
+	MY_INT_OS_Current = NULL;
+	MY_INT_OS_Next = NULL;
+
+	for(i = 0; i < OS_PRIORITIES; i++)
+	{
+		MY_INT_OS_Tasks[i] = NULL;
+	}
+
+	/* PendSV ниже всех прерываний: переключение только после выхода из обработчиков */
+	MY_NVIC_Priority_Set(PendSV_IRQn, (1UL << __NVIC_PRIO_BITS) - 1UL);
+
+	/* Простой без тиков просыпается к ближайшему таймауту задачи */
+	MY_PWR_Deadline_Register(MY_INT_OS_IdleTicks);
+
+	return MY_INT_OS_Task_Setup(&MY_INT_OS_IdleTask, MY_INT_OS_Idle, NULL, MY_INT_OS_IdleStack,
+								OS_IDLE_STACK_WORDS, (uint8_t)OS_IDLE_PRIORITY, "idle");
+}
+
+
+MY_Result_t MY_OS_Task_Create(MY_OS_Task_t *Task, MY_OS_TaskFunc_t Func, void *Arg,
+							  uint32_t *Stack, uint32_t StackWords, uint8_t Priority, const char *Name)
+{
+	/* Уровень задачи простоя не выдаётся */
+	if(Priority >= OS_IDLE_PRIORITY)
+	{
+		return MY_Result_Error;
+	}
+
+	return MY_INT_OS_Task_Setup(Task, Func, Arg, Stack, StackWords, Priority, Name);
+}
+
+
+void MY_OS_Start(void)
+{
+	__disable_irq();
+
+	MY_INT_OS_Running = 1;
+	MY_INT_OS_Current = NULL;
+	MY_INT_OS_Next = MY_INT_OS_Tasks[MY_INT_OS_Highest(MY_INT_OS_ReadyMask)];
+
+	/* PendSV без текущей задачи только загружает контекст первой */
+	SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+
+	__enable_irq();
+	__ISB();
+
+	while(1)
+	{
+
+	}
+}
+
+
+uint8_t MY_OS_IsRunning(void)
+{
+	return MY_INT_OS_Running;
+}
+
+
+MY_OS_Task_t* MY_OS_Task_Current(void)
+{
+	return MY_INT_OS_Current;
+}
+
+
+void MY_OS_Tick(void)
+{
+	uint32_t now = MY_SysTick_GetTick();
+	uint32_t primask;
+	uint32_t i;
+
+	if(!MY_INT_OS_Running)
+	{
+		return;
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+
+	for(i = 0; i < OS_IDLE_PRIORITY; i++)
+	{
+		MY_OS_Task_t *task = MY_INT_OS_Tasks[i];
+
+		if((task != NULL) && (task->State == MY_OS_State_Blocked) && task->Timed && ((int32_t)(now - task->WakeTick) >= 0))
+		{
+			MY_INT_OS_Wakeup(task, MY_Result_Timeout);
+		}
+	}
+
+	MY_INT_OS_Schedule();
+
+	__set_PRIMASK(primask);
+}
+
+
+MY_Result_t MY_OS_Wait(const volatile void *Object, uint32_t Timeout)
+{
+	MY_OS_Task_t *task;
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+
+	task = MY_INT_OS_Current;
+
+	/* Ожидать может только задача, а не обработчик прерывания или main() до запуска */
+	if(!MY_INT_OS_Running || (task == NULL) || (__get_IPSR() != 0U) || (Timeout == 0U))
+	{
+		__set_PRIMASK(primask);
+
+		return MY_Result_Timeout;
+	}
+
+	task->WaitObject = Object;
+	task->Timed = (Timeout != MAX_DELAY) ? 1U : 0U;
+	task->WakeTick = MY_SysTick_GetTick() + Timeout;
+	task->WaitResult = (uint8_t)MY_Result_Timeout;
+	task->State = MY_OS_State_Blocked;
+
+	MY_INT_OS_ReadyMask &= ~(1UL << task->Priority);
+
+	MY_INT_OS_Schedule();
+
+	/* Отложенный PendSV выполняется здесь, задача продолжит работу после пробуждения */
+	__enable_irq();
+	__ISB();
+
+	__set_PRIMASK(primask);
+
+	return (MY_Result_t)task->WaitResult;
+}
+
+
+void MY_OS_Notify(const volatile void *Object)
+{
+	uint32_t primask;
+	uint32_t i;
+
+	if(Object == NULL)
+	{
+		return;
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+
+	for(i = 0; i < OS_IDLE_PRIORITY; i++)
+	{
+		MY_OS_Task_t *task = MY_INT_OS_Tasks[i];
+
+		if((task != NULL) && (task->State == MY_OS_State_Blocked) && (task->WaitObject == Object))
+		{
+			MY_INT_OS_Wakeup(task, MY_Result_Ok);
+		}
+	}
+
+	MY_INT_OS_Schedule();
+
+	__set_PRIMASK(primask);
+}
+
+
+void MY_OS_Delay(uint32_t Ticks)
+{
+	/* Без объекта ожидания задачу пробуждает только таймаут */
+	MY_OS_Wait(NULL, Ticks);
+}
+
+
+uint32_t MY_OS_Benchmark_Switch(void)
+{
+	uint32_t best = 0xFFFFFFFFU;
+	uint32_t start;
+	uint32_t end;
+	uint32_t cycles;
+	uint32_t i;
+
+	if(!MY_INT_OS_Running || (MY_INT_OS_Current == NULL) || (__get_IPSR() != 0U))
+	{
+		return 0;
+	}
+
+	for(i = 0; i < 16U; i++)
+	{
+		__disable_irq();
+
+		/* Переключение на саму себя: полное сохранение и восстановление контекста */
+		MY_INT_OS_Next = MY_INT_OS_Current;
+
+		start = SysTick->VAL;
+		SCB->ICSR = SCB_ICSR_PENDSVSET_Msk;
+		__enable_irq();
+		__ISB();
+		end = SysTick->VAL;
+
+		/* SysTick считает вниз, при перезагрузке добавляется период */
+		cycles = (start >= end) ? (start - end) : (start + (SysTick->LOAD + 1U) - end);
+
+		if(cycles < best)
+		{
+			best = cycles;
+		}
+	}
+
+	return best;
+}
+
+
+void PendSV_Handler(void)
+{
+	/* Thumb-1: STM/LDM только для R0-R7, R8-R11 переносятся через R4-R7.
+	 * Контекст в стеке задачи снизу вверх: R4-R7, R8-R11, кадр исключения */
+	__asm volatile
+	(
+		"cpsid i                  \n"
+		"ldr   r2, =MY_INT_OS_Current \n"
+		"ldr   r1, [r2]           \n"
+		"cmp   r1, #0             \n"
+		"beq   1f                 \n"
+		"mrs   r0, psp            \n"
+		"subs  r0, #32            \n"
+		"str   r0, [r1]           \n"
+		"stmia r0!, {r4-r7}       \n"
+		"mov   r4, r8             \n"
+		"mov   r5, r9             \n"
+		"mov   r6, r10            \n"
+		"mov   r7, r11            \n"
+		"stmia r0!, {r4-r7}       \n"
+		"b     2f                 \n"
+		"1:                       \n"
+		"ldr   r0, =_estack       \n"
+		"msr   msp, r0            \n"
+		"2:                       \n"
+		"ldr   r3, =MY_INT_OS_Next \n"
+		"ldr   r1, [r3]           \n"
+		"str   r1, [r2]           \n"
+		"ldr   r0, [r1]           \n"
+		"adds  r0, #16            \n"
+		"ldmia r0!, {r4-r7}       \n"
+		"mov   r8, r4             \n"
+		"mov   r9, r5             \n"
+		"mov   r10, r6            \n"
+		"mov   r11, r7            \n"
+		"msr   psp, r0            \n"
+		"subs  r0, #32            \n"
+		"ldmia r0!, {r4-r7}       \n"
+		"cpsie i                  \n"
+		"ldr   r0, =0xFFFFFFFD    \n"
+		"bx    r0                 \n"
+		".ltorg                   \n"
+	);
+}
+
+#endif
@@ -0,0 +1,379 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/pool
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Пулы блоков фиксированного размера вместо кучи malloc()
+ */
+#include "my_stm32f0xx_pool.h"
+#include "my_stm32f0xx_cortex.h"
+#include "my_stm32f0xx_utils.h"
+#include "my_stm32f0xx_os.h"
+
+/* Свободный блок: ссылка на следующий хранится в самом блоке */
+typedef struct MY_INT_POOL_Block_s
+{
+	struct MY_INT_POOL_Block_s *Next;
+}
+MY_INT_POOL_Block_t;
+
+
+/* Описание пула */
+typedef struct
+{
+	MY_INT_POOL_Block_t	*Free;			/* Голова списка свободных блоков */
+	uint32_t			*Storage;		/* Память пула */
+	uint16_t			Stride;			/* Размер блока, округлённый до слова */
+	uint16_t			Count;
+	uint16_t			Used;
+	uint16_t			Peak;
+	uint32_t			Failed;
+}
+MY_INT_POOL_t;
+
+
+/* Память пулов: по массиву слов на каждую строку POOL_CONFIG */
+#define MY_INT_POOL_WORDS(__SIZE__)						(((__SIZE__) + 3U) / 4U)
+#define MY_INT_POOL_STORAGE(__SIZE__, __COUNT__)		static uint32_t MY_INT_POOL_Storage_##__SIZE__[MY_INT_POOL_WORDS(__SIZE__) * (__COUNT__)];
+#define MY_INT_POOL_DESCRIPTOR(__SIZE__, __COUNT__)		{ NULL, MY_INT_POOL_Storage_##__SIZE__, (uint16_t)(MY_INT_POOL_WORDS(__SIZE__) * 4U), (__COUNT__), 0U, 0U, 0U },
+
+POOL_CONFIG(MY_INT_POOL_STORAGE)
+
+static MY_INT_POOL_t MY_INT_POOL_Pools[POOL_COUNT] =
+{
+	POOL_CONFIG(MY_INT_POOL_DESCRIPTOR)
+};
+
+
+/* Снятие блока с наименьшего подходящего пула. Вызывается при запрещённых прерываниях */
+static void* MY_INT_POOL_Take(uint32_t Size)
+{
+	MY_INT_POOL_t *pool;
+	MY_INT_POOL_Block_t *block;
+	uint32_t i;
+
+	for(i = 0; i < POOL_COUNT; i++)
+	{
+		pool = &MY_INT_POOL_Pools[i];
+
+		if(pool->Stride < Size)
+		{
+			continue;
+		}
+
+		block = pool->Free;
+
+		/* Пул подходящего размера исчерпан - пробуем следующий, более крупный */
+		if(block == NULL)
+		{
+			continue;
+		}
+
+		pool->Free = block->Next;
+
+		if(++pool->Used > pool->Peak)
+		{
+			pool->Peak = pool->Used;
+		}
+
+		return block;
+	}
+
+	return NULL;
+}
+
+
+/* Отказ учитывается в наименьшем подходящем пуле, когда исчерпаны и все более крупные.
+   Запрос больше самого крупного блока не относится ни к одному пулу */
+static void MY_INT_POOL_Fail(uint32_t Size)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t i;
+
+	__disable_irq();
+
+	for(i = 0; i < POOL_COUNT; i++)
+	{
+		if(MY_INT_POOL_Pools[i].Stride >= Size)
+		{
+			MY_INT_POOL_Pools[i].Failed++;
+
+			break;
+		}
+	}
+
+	__set_PRIMASK(primask);
+}
+
+
+/* Снятие блока без учёта отказа: MY_POOL_Alloc() учитывает отказ только после ожидания */
+static void* MY_INT_POOL_TryTake(uint32_t Size)
+{
+	uint32_t primask = __get_PRIMASK();
+	void *block;
+
+	__disable_irq();
+
+	block = MY_INT_POOL_Take(Size);
+
+	__set_PRIMASK(primask);
+
+	return block;
+}
+
+
+void MY_POOL_Init(void)
+{
+	MY_INT_POOL_t *pool;
+	MY_INT_POOL_Block_t *block;
+	uint32_t primask = __get_PRIMASK();
+	uint32_t i;
+	uint32_t n;
+
+	__disable_irq();
+
+	for(i = 0; i < POOL_COUNT; i++)
+	{
+		pool = &MY_INT_POOL_Pools[i];
+		pool->Free = NULL;
+
+		/* Связываем с конца, чтобы первым выделялся блок с наименьшим адресом */
+		for(n = pool->Count; n > 0U; n--)
+		{
+			block = (MY_INT_POOL_Block_t *)((uint8_t *)pool->Storage + ((n - 1U) * pool->Stride));
+			block->Next = pool->Free;
+			pool->Free = block;
+		}
+
+		pool->Used = 0;
+		pool->Peak = 0;
+		pool->Failed = 0;
+	}
+
+	__set_PRIMASK(primask);
+}
+
+
+void* MY_POOL_Alloc_ISR(uint32_t Size)
+{
+	void *block = MY_INT_POOL_TryTake(Size);
+
+	if(block == NULL)
+	{
+		MY_INT_POOL_Fail(Size);
+	}
+
+	return block;
+}
+
+
+void* MY_POOL_Alloc(uint32_t Size, uint32_t Timeout)
+{
+	void *block = MY_INT_POOL_TryTake(Size);
+
+	#if (USE_RTOS == 1U)
+
+		uint32_t tickstart = MY_SysTick_GetTick();
+		uint32_t elapsed;
+		uint32_t primask;
+
+		while((block == NULL) && (Timeout != 0U) && (__get_IPSR() == 0U) && MY_OS_IsRunning())
+		{
+			elapsed = MY_SysTick_GetTick() - tickstart;
+
+			if((Timeout != MAX_DELAY) && (elapsed >= Timeout))
+			{
+				break;
+			}
+
+			primask = __get_PRIMASK();
+			__disable_irq();
+
+			block = MY_INT_POOL_Take(Size);
+
+			/* Проверка и переход в ожидание атомарны: MY_OS_Wait() сама разрешает прерывания */
+			if(block == NULL)
+			{
+				MY_OS_Wait(MY_INT_POOL_Pools, (Timeout == MAX_DELAY) ? MAX_DELAY : (Timeout - elapsed));
+			}
+
+			__set_PRIMASK(primask);
+		}
+
+	#else
+
+		UNUSED(Timeout);
+
+	#endif
+
+	if(block == NULL)
+	{
+		MY_INT_POOL_Fail(Size);
+	}
+
+	return block;
+}
+
+
+MY_Result_t MY_POOL_Free(void *Block)
+{
+	MY_INT_POOL_t *pool;
+	uint32_t primask;
+	uint32_t offset;
+	uint32_t i;
+
+	if(Block == NULL)
+	{
+		return MY_Result_Ok;
+	}
+
+	for(i = 0; i < POOL_COUNT; i++)
+	{
+		pool = &MY_INT_POOL_Pools[i];
+		offset = (uint32_t)((uint8_t *)Block - (uint8_t *)pool->Storage);
+
+		/* Адрес ниже начала пула даёт большое беззнаковое смещение */
+		if(offset < ((uint32_t)pool->Stride * pool->Count))
+		{
+			break;
+		}
+	}
+
+	if(i == POOL_COUNT)
+	{
+		return MY_Result_Error;
+	}
+
+	#if (POOL_CHECK == 1U)
+
+		if((offset % pool->Stride) != 0U)
+		{
+			return MY_Result_Error;
+		}
+
+	#endif
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+
+	#if (POOL_CHECK == 1U)
+
+		/* Повторное освобождение: блок уже в списке свободных. Проход по списку - только в отладочной проверке */
+		{
+			MY_INT_POOL_Block_t *free;
+
+			for(free = pool->Free; free != NULL; free = free->Next)
+			{
+				if(free == Block)
+				{
+					__set_PRIMASK(primask);
+
+					return MY_Result_Error;
+				}
+			}
+		}
+
+	#endif
+
+	((MY_INT_POOL_Block_t *)Block)->Next = pool->Free;
+	pool->Free = (MY_INT_POOL_Block_t *)Block;
+	pool->Used--;
+
+	__set_PRIMASK(primask);
+
+	#if (USE_RTOS == 1U)
+		/* Пробуждаем задачи, ожидающие блок */
+		MY_OS_Notify(MY_INT_POOL_Pools);
+	#endif
+
+	return MY_Result_Ok;
+}
+
+
+MY_Result_t MY_POOL_GetStats(uint32_t Index, MY_POOL_Stats_t *Stats)
+{
+	MY_INT_POOL_t *pool;
+	uint32_t primask;
+
+	if(Index >= POOL_COUNT)
+	{
+		return MY_Result_Error;
+	}
+
+	pool = &MY_INT_POOL_Pools[Index];
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+
+	Stats->BlockSize = pool->Stride;
+	Stats->Count = pool->Count;
+	Stats->Used = pool->Used;
+	Stats->Peak = pool->Peak;
+	Stats->Failed = pool->Failed;
+
+	__set_PRIMASK(primask);
+
+	return MY_Result_Ok;
+}
+
+
+void MY_POOL_Dump(void)
+{
+	MY_POOL_Stats_t stats;
+	uint32_t i;
+
+	printf("%6s %6s %6s %6s %8s\r\n", "block", "count", "used", "peak", "failed");
+
+	for(i = 0; i < POOL_COUNT; i++)
+	{
+		MY_POOL_GetStats(i, &stats);
+
+		printf("%6u %6u %6u %6u %8lu\r\n", (unsigned)stats.BlockSize, (unsigned)stats.Count,
+			   (unsigned)stats.Used, (unsigned)stats.Peak, (unsigned long)stats.Failed);
+	}
+}
+
+
+uint32_t MY_POOL_Benchmark(void)
+{
+	uint32_t best = 0xFFFFFFFFU;
+	uint32_t primask;
+	uint32_t start;
+	uint32_t end;
+	uint32_t cycles;
+	uint16_t peak = MY_INT_POOL_Pools[0].Peak;
+	void *block;
+	uint32_t i;
+
+	for(i = 0; i < 16U; i++)
+	{
+		primask = __get_PRIMASK();
+		__disable_irq();
+
+		start = SysTick->VAL;
+		block = MY_POOL_Alloc_ISR(1U);
+		MY_POOL_Free(block);
+		end = SysTick->VAL;
+
+		__set_PRIMASK(primask);
+
+		if(block == NULL)
+		{
+			return 0;
+		}
+
+		/* SysTick считает вниз, при перезагрузке добавляется период */
+		cycles = (start >= end) ? (start - end) : (start + (SysTick->LOAD + 1U) - end);
+
+		if(cycles < best)
+		{
+			best = cycles;
+		}
+	}
+
+	/* Замер не должен влиять на статистику приложения */
+	MY_INT_POOL_Pools[0].Peak = peak;
+
+	return best;
+}
@@ -0,0 +1,227 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/profile
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Замер длительности участков кода в тактах
+ */
+#include "my_stm32f0xx_profile.h"
+
+#if (PROFILE_ENABLE == 1U)
+
+#include "my_stm32f0xx_utils.h"
+#include "my_stm32f0xx_rcc.h"
+#include "my_stm32f0xx_cortex.h"
+
+/* Таблица участков */
+static MY_PROFILE_Zone_t MY_INT_PROFILE_Zones[PROFILE_ZONES_MAX];
+static uint32_t MY_INT_PROFILE_ZonesCount = 0;
+
+/* Собственная длительность пары BEGIN/END, вычитается из замеров */
+static uint32_t MY_INT_PROFILE_Overhead = 0;
+
+
+/* Частота счётчика тактов */
+static uint32_t MY_INT_PROFILE_GetClock(void)
+{
+	#if (PROFILE_USE_TIM2 == 1U)
+
+		/* При делителе APB больше 1 таймеры тактируются удвоенной частотой PCLK */
+		if((RCC->CFGR & RCC_CFGR_PPRE) != RCC_APB1_DIV1)
+		{
+			return MY_RCC_PCLK1_GetFreq() * 2U;
+		}
+
+		return MY_RCC_PCLK1_GetFreq();
+
+	#else
+
+		return MY_RCC_HCLK_GetFreq();
+
+	#endif
+}
+
+
+static void MY_INT_PROFILE_ResetZone(MY_PROFILE_Zone_t *Zone)
+{
+	Zone->Count = 0;
+	Zone->Min = 0xFFFFFFFFU;
+	Zone->Max = 0;
+	Zone->Total = 0;
+}
+
+
+void MY_PROFILE_Init(void)
+{
+	MY_PROFILE_Zone_t calibration = { "", 0, 0, 0, 0 };
+	uint32_t start;
+	uint32_t i;
+
+	#if (PROFILE_USE_TIM2 == 1U)
+
+		MY_UTILS_SetBitWithRead(&RCC->APB1ENR, RCC_APB1ENR_TIM2EN);
+
+		TIM2->CR1 = 0U;
+		TIM2->PSC = 0U;
+		TIM2->ARR = 0xFFFFFFFFU;
+
+		/* Загружаем предделитель */
+		TIM2->EGR = TIM_EGR_UG;
+		TIM2->CR1 = TIM_CR1_CEN;
+
+	#endif
+
+	/* Накладные расходы - минимум из нескольких пустых замеров */
+	MY_INT_PROFILE_Overhead = 0;
+	MY_INT_PROFILE_ResetZone(&calibration);
+
+	for(i = 0; i < 8U; i++)
+	{
+		start = MY_PROFILE_GetCycles();
+		MY_PROFILE_End(&calibration, start);
+	}
+
+	MY_INT_PROFILE_Overhead = calibration.Min;
+}
+
+
+uint32_t MY_PROFILE_GetCycles(void)
+{
+	#if (PROFILE_USE_TIM2 == 1U)
+
+		return TIM2->CNT;
+
+	#else
+
+		/* Снимок тиков и счётчика учитывает перезагрузку, прерывание которой ещё не обработано */
+		return (uint32_t)MY_SysTick_GetCycles();
+
+	#endif
+}
+
+
+uint32_t MY_PROFILE_Begin(MY_PROFILE_Zone_t **Zone, const char *Name)
+{
+	uint32_t primask;
+
+	if(*Zone == NULL)
+	{
+		primask = __get_PRIMASK();
+		__disable_irq();
+
+		/* Повторная проверка: участок мог зарегистрировать обработчик прерывания */
+		if((*Zone == NULL) && (MY_INT_PROFILE_ZonesCount < PROFILE_ZONES_MAX))
+		{
+			MY_PROFILE_Zone_t *zone = &MY_INT_PROFILE_Zones[MY_INT_PROFILE_ZonesCount++];
+
+			MY_INT_PROFILE_ResetZone(zone);
+			zone->Name = Name;
+
+			*Zone = zone;
+		}
+
+		__set_PRIMASK(primask);
+	}
+
+	return MY_PROFILE_GetCycles();
+}
+
+
+void MY_PROFILE_End(MY_PROFILE_Zone_t *Zone, uint32_t Start)
+{
+	uint32_t cycles = MY_PROFILE_GetCycles() - Start;
+	uint32_t primask;
+
+	if(Zone == NULL)
+	{
+		return;
+	}
+
+	cycles = (cycles > MY_INT_PROFILE_Overhead) ? (cycles - MY_INT_PROFILE_Overhead) : 0U;
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+
+	Zone->Count++;
+	Zone->Total += cycles;
+
+	if(cycles < Zone->Min)
+	{
+		Zone->Min = cycles;
+	}
+
+	if(cycles > Zone->Max)
+	{
+		Zone->Max = cycles;
+	}
+
+	__set_PRIMASK(primask);
+}
+
+
+const MY_PROFILE_Zone_t* MY_PROFILE_GetZone(uint32_t Index)
+{
+	if(Index >= MY_INT_PROFILE_ZonesCount)
+	{
+		return NULL;
+	}
+
+	return &MY_INT_PROFILE_Zones[Index];
+}
+
+
+void MY_PROFILE_Reset(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t i;
+
+	__disable_irq();
+
+	for(i = 0; i < MY_INT_PROFILE_ZonesCount; i++)
+	{
+		MY_INT_PROFILE_ResetZone(&MY_INT_PROFILE_Zones[i]);
+	}
+
+	__set_PRIMASK(primask);
+}
+
+
+void MY_PROFILE_Dump(void)
+{
+	uint32_t clock_mhz = MY_INT_PROFILE_GetClock() / 1000000U;
+	uint32_t i;
+
+	if(clock_mhz == 0U)
+	{
+		clock_mhz = 1U;
+	}
+
+	printf("profile: %lu MHz, overhead %lu cycles\r\n", (unsigned long)clock_mhz, (unsigned long)MY_INT_PROFILE_Overhead);
+	printf("%-16s %10s %10s %10s %10s %10s\r\n", "zone", "count", "min", "max", "avg", "avg_us");
+
+	for(i = 0; i < MY_INT_PROFILE_ZonesCount; i++)
+	{
+		MY_PROFILE_Zone_t zone;
+		uint32_t primask = __get_PRIMASK();
+		uint32_t avg;
+
+		/* Копия участка, чтобы значения были согласованы */
+		__disable_irq();
+		zone = MY_INT_PROFILE_Zones[i];
+		__set_PRIMASK(primask);
+
+		if(zone.Count == 0U)
+		{
+			printf("%-16s %10lu %10s %10s %10s %10s\r\n", zone.Name, 0UL, "-", "-", "-", "-");
+			continue;
+		}
+
+		avg = (uint32_t)(zone.Total / zone.Count);
+
+		printf("%-16s %10lu %10lu %10lu %10lu %10lu\r\n", zone.Name, (unsigned long)zone.Count,
+			   (unsigned long)zone.Min, (unsigned long)zone.Max, (unsigned long)avg, (unsigned long)(avg / clock_mhz));
+	}
+}
+
+#endif
@@ -0,0 +1,508 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/pwr
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Управление режимами пониженного потребления: Sleep, Stop, Standby
+ */
+#include <string.h>
+#include "my_stm32f0xx_pwr.h"
+#include "my_stm32f0xx_rcc.h"
+#include "my_stm32f0xx_cortex.h"
+
+/* Зарегистрированные ограничения и счётчики запретов по режимам */
+static MY_PWR_Constraint_Callback_t MY_INT_PWR_Constraints[PWR_CONSTRAINTS_MAX];
+static volatile uint8_t MY_INT_PWR_Locks[MY_PWR_State_Count];
+
+/* Зарегистрированные источники сроков */
+static MY_PWR_Deadline_Callback_t MY_INT_PWR_Deadlines[PWR_DEADLINES_MAX];
+
+/* Статистика и начало окна */
+static MY_PWR_Stats_t MY_INT_PWR_Stats;
+static uint32_t MY_INT_PWR_WindowTick;
+
+
+/* Ожидание бита в регистре RCC счётчиком итераций: прерывания запрещены, тики не идут */
+static MY_Result_t MY_INT_PWR_Spin(volatile uint32_t *Reg, uint32_t Mask, uint32_t Value)
+{
+	uint32_t spin = PWR_RESTORE_SPIN;
+
+	while((*Reg & Mask) != Value)
+	{
+		if(--spin == 0U)
+		{
+			return MY_Result_Timeout;
+		}
+	}
+
+	return MY_Result_Ok;
+}
+
+
+/* Возврат тактирования после Stop: ядро проснулось на HSI, HSE и PLL выключены аппаратно.
+   Настройки PLL, делители шин и задержка Flash сохранились, поэтому достаточно включить
+   генераторы и вернуть прежний источник SYSCLK - частоты остаются прежними */
+static MY_Result_t MY_INT_PWR_Clock_Restore(uint32_t Cr, uint32_t Sw)
+{
+	if(Cr & RCC_CR_HSEON)
+	{
+		SET_BIT(RCC->CR, RCC_CR_HSEON);
+
+		if(MY_INT_PWR_Spin(&RCC->CR, RCC_CR_HSERDY, RCC_CR_HSERDY) != MY_Result_Ok)
+		{
+			return MY_Result_Timeout;
+		}
+	}
+
+	if(Cr & RCC_CR_PLLON)
+	{
+		SET_BIT(RCC->CR, RCC_CR_PLLON);
+
+		if(MY_INT_PWR_Spin(&RCC->CR, RCC_CR_PLLRDY, RCC_CR_PLLRDY) != MY_Result_Ok)
+		{
+			return MY_Result_Timeout;
+		}
+	}
+
+	if(Sw != RCC_CFGR_SW_HSI)
+	{
+		MODIFY_REG(RCC->CFGR, RCC_CFGR_SW, Sw);
+
+		if(MY_INT_PWR_Spin(&RCC->CFGR, RCC_CFGR_SWS, Sw << (RCC_CFGR_SWS_Pos - RCC_CFGR_SW_Pos)) != MY_Result_Ok)
+		{
+			return MY_Result_Timeout;
+		}
+	}
+
+	return MY_Result_Ok;
+}
+
+
+/* Причина пробуждения - ожидающее разрешённое прерывание. Вызывается при запрещённых прерываниях */
+static void MY_INT_PWR_Wake_Record(void)
+{
+	uint32_t pending = NVIC->ISPR[0U] & NVIC->ISER[0U];
+	int32_t irqn = MY_PWR_WAKE_UNKNOWN;
+	uint32_t i;
+
+	if(SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+	{
+		irqn = SysTick_IRQn;
+	}
+	else if(pending != 0U)
+	{
+		for(i = 0; (pending & (1UL << i)) == 0U; i++)
+		{
+		}
+
+		irqn = (int32_t)i;
+	}
+
+	MY_INT_PWR_Stats.LastWake = (int8_t)irqn;
+
+	if(irqn != MY_PWR_WAKE_UNKNOWN)
+	{
+		MY_INT_PWR_Stats.Wakeups[irqn + 1]++;
+	}
+}
+
+
+/* Stop: SLEEPDEEP без PDDS. Возвращает время в Stop по MY_PWR_StopTimeCallback() */
+static uint32_t MY_INT_PWR_Stop(void)
+{
+	uint32_t cr = RCC->CR & (RCC_CR_HSEON | RCC_CR_PLLON);
+	uint32_t sw = RCC->CFGR & RCC_CFGR_SW;
+
+	#if (PWR_STOP_LPREGULATOR == 1U)
+		MODIFY_REG(PWR->CR, PWR_CR_PDDS | PWR_CR_LPDS, PWR_CR_LPDS | PWR_CR_CWUF);
+	#else
+		MODIFY_REG(PWR->CR, PWR_CR_PDDS | PWR_CR_LPDS, PWR_CR_CWUF);
+	#endif
+
+	SET_BIT(SCB->SCR, SCB_SCR_SLEEPDEEP_Msk);
+
+	__DSB();
+	__WFI();
+	__ISB();
+
+	CLEAR_BIT(SCB->SCR, SCB_SCR_SLEEPDEEP_Msk);
+
+	/* Если пробуждение было мгновенным (прерывание уже ожидало), генераторы не выключались */
+	if(MY_INT_PWR_Clock_Restore(cr, sw) != MY_Result_Ok)
+	{
+		/* Остаёмся на HSI: пересчитываем дерево частот, SysTick и таймингов периферии */
+		MY_INT_PWR_Stats.RestoreFailures++;
+
+		MY_RCC_ClockTree_Update();
+	}
+
+	return MY_PWR_StopTimeCallback();
+}
+
+
+/* Standby: SLEEPDEEP с PDDS. Возврат только если прерывание уже ожидало и вход не состоялся */
+static void MY_INT_PWR_Standby(void)
+{
+	SET_BIT(PWR->CR, PWR_CR_PDDS | PWR_CR_CWUF | PWR_CR_CSBF);
+	SET_BIT(SCB->SCR, SCB_SCR_SLEEPDEEP_Msk);
+
+	__DSB();
+	__WFI();
+	__ISB();
+
+	CLEAR_BIT(SCB->SCR, SCB_SCR_SLEEPDEEP_Msk);
+	CLEAR_BIT(PWR->CR, PWR_CR_PDDS);
+}
+
+
+void MY_PWR_Init(void)
+{
+	uint32_t csr = PWR->CSR;
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+
+	memset(&MY_INT_PWR_Stats, 0, sizeof(MY_INT_PWR_Stats));
+
+	MY_INT_PWR_Stats.LastWake = MY_PWR_WAKE_UNKNOWN;
+	MY_INT_PWR_Stats.LastState = MY_PWR_State_Run;
+	MY_INT_PWR_Stats.FromStandby = (csr & PWR_CSR_SBF) ? 1U : 0U;
+	MY_INT_PWR_Stats.WakeupPin = (MY_INT_PWR_Stats.FromStandby && (csr & PWR_CSR_WUF)) ? 1U : 0U;
+
+	SET_BIT(PWR->CR, PWR_CR_CSBF | PWR_CR_CWUF);
+
+	MY_INT_PWR_WindowTick = MY_SysTick_GetTick();
+
+	__set_PRIMASK(primask);
+}
+
+
+MY_Result_t MY_PWR_Constraint_Register(MY_PWR_Constraint_Callback_t Callback)
+{
+	uint32_t i;
+	uint32_t free = PWR_CONSTRAINTS_MAX;
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+
+	for(i = 0; i < PWR_CONSTRAINTS_MAX; i++)
+	{
+		if(MY_INT_PWR_Constraints[i] == Callback)
+		{
+			__set_PRIMASK(primask);
+
+			return MY_Result_Ok;
+		}
+
+		if((MY_INT_PWR_Constraints[i] == NULL) && (free == PWR_CONSTRAINTS_MAX))
+		{
+			free = i;
+		}
+	}
+
+	if(free == PWR_CONSTRAINTS_MAX)
+	{
+		__set_PRIMASK(primask);
+
+		return MY_Result_Error;
+	}
+
+	MY_INT_PWR_Constraints[free] = Callback;
+
+	__set_PRIMASK(primask);
+
+	return MY_Result_Ok;
+}
+
+
+void MY_PWR_Constraint_Unregister(MY_PWR_Constraint_Callback_t Callback)
+{
+	uint32_t i;
+
+	for(i = 0; i < PWR_CONSTRAINTS_MAX; i++)
+	{
+		if(MY_INT_PWR_Constraints[i] == Callback)
+		{
+			MY_INT_PWR_Constraints[i] = NULL;
+		}
+	}
+}
+
+
+MY_Result_t MY_PWR_Deadline_Register(MY_PWR_Deadline_Callback_t Callback)
+{
+	uint32_t i;
+	uint32_t free = PWR_DEADLINES_MAX;
+	uint32_t primask = __get_PRIMASK();
+
+	__disable_irq();
+
+	for(i = 0; i < PWR_DEADLINES_MAX; i++)
+	{
+		if(MY_INT_PWR_Deadlines[i] == Callback)
+		{
+			__set_PRIMASK(primask);
+
+			return MY_Result_Ok;
+		}
+
+		if((MY_INT_PWR_Deadlines[i] == NULL) && (free == PWR_DEADLINES_MAX))
+		{
+			free = i;
+		}
+	}
+
+	if(free == PWR_DEADLINES_MAX)
+	{
+		__set_PRIMASK(primask);
+
+		return MY_Result_Error;
+	}
+
+	MY_INT_PWR_Deadlines[free] = Callback;
+
+	__set_PRIMASK(primask);
+
+	return MY_Result_Ok;
+}
+
+
+void MY_PWR_Deadline_Unregister(MY_PWR_Deadline_Callback_t Callback)
+{
+	uint32_t i;
+
+	for(i = 0; i < PWR_DEADLINES_MAX; i++)
+	{
+		if(MY_INT_PWR_Deadlines[i] == Callback)
+		{
+			MY_INT_PWR_Deadlines[i] = NULL;
+		}
+	}
+}
+
+
+uint32_t MY_PWR_Deadline_Next(void)
+{
+	MY_PWR_Deadline_Callback_t callback;
+	uint32_t next = MAX_DELAY;
+	uint32_t ticks;
+	uint32_t i;
+
+	for(i = 0; (i < PWR_DEADLINES_MAX) && (next != 0U); i++)
+	{
+		callback = MY_INT_PWR_Deadlines[i];
+
+		if(callback != NULL)
+		{
+			ticks = callback();
+
+			if(ticks < next)
+			{
+				next = ticks;
+			}
+		}
+	}
+
+	return next;
+}
+
+
+void MY_PWR_Lock(MY_PWR_State_t State)
+{
+	uint32_t primask;
+
+	if((State == MY_PWR_State_Run) || (State >= MY_PWR_State_Count))
+	{
+		return;
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+
+	if(MY_INT_PWR_Locks[State] != 0xFFU)
+	{
+		MY_INT_PWR_Locks[State]++;
+	}
+
+	__set_PRIMASK(primask);
+}
+
+
+void MY_PWR_Unlock(MY_PWR_State_t State)
+{
+	uint32_t primask;
+
+	if((State == MY_PWR_State_Run) || (State >= MY_PWR_State_Count))
+	{
+		return;
+	}
+
+	primask = __get_PRIMASK();
+	__disable_irq();
+
+	if(MY_INT_PWR_Locks[State] != 0U)
+	{
+		MY_INT_PWR_Locks[State]--;
+	}
+
+	__set_PRIMASK(primask);
+}
+
+
+MY_PWR_State_t MY_PWR_State_Select(uint32_t IdleTicks)
+{
+	MY_PWR_State_t deepest = PWR_DEEPEST_STATE;
+	MY_PWR_State_t allowed;
+	uint32_t i;
+
+	/* Срок уже наступил */
+	if(IdleTicks == 0U)
+	{
+		return MY_PWR_State_Run;
+	}
+
+	/* Запрет режима запрещает и все более глубокие */
+	for(i = MY_PWR_State_Sleep; i <= (uint32_t)deepest; i++)
+	{
+		if(MY_INT_PWR_Locks[i] != 0U)
+		{
+			deepest = (MY_PWR_State_t)(i - 1U);
+
+			break;
+		}
+	}
+
+	for(i = 0; (i < PWR_CONSTRAINTS_MAX) && (deepest > MY_PWR_State_Run); i++)
+	{
+		if(MY_INT_PWR_Constraints[i] != NULL)
+		{
+			allowed = MY_INT_PWR_Constraints[i]();
+
+			if(allowed < deepest)
+			{
+				deepest = allowed;
+			}
+		}
+	}
+
+	/* Программный срок отсчитывает SysTick, который в Stop и Standby остановлен */
+	if((IdleTicks != MAX_DELAY) && (deepest > MY_PWR_State_Sleep))
+	{
+		deepest = MY_PWR_State_Sleep;
+	}
+
+	return deepest;
+}
+
+
+MY_PWR_State_t MY_PWR_Enter(uint32_t IdleTicks)
+{
+	MY_PWR_State_t state;
+	uint32_t primask = __get_PRIMASK();
+	uint32_t tickstart;
+	uint32_t ticks;
+	uint32_t residency = 0;
+
+	/* Выбор и вход атомарны: прерывание между ними могло бы установить новый запрет или срок.
+	   WFI пробуждает ядро и при запрещённых прерываниях, обработчик выполнится после восстановления частот */
+	__disable_irq();
+
+	/* Срок приложения ограничивается ближайшим сроком модулей */
+	ticks = MY_PWR_Deadline_Next();
+
+	if(ticks < IdleTicks)
+	{
+		IdleTicks = ticks;
+	}
+
+	state = MY_PWR_State_Select(IdleTicks);
+
+	if(state == MY_PWR_State_Run)
+	{
+		__set_PRIMASK(primask);
+
+		return state;
+	}
+
+	MY_INT_PWR_Stats.Entries[state]++;
+	MY_INT_PWR_Stats.LastState = (uint8_t)state;
+
+	tickstart = MY_SysTick_GetTick();
+
+	switch(state)
+	{
+		case MY_PWR_State_Standby:
+			MY_INT_PWR_Standby();
+
+			/* Вход не состоялся: прерывание уже ожидало */
+			break;
+
+		case MY_PWR_State_Stop:
+			residency = MY_INT_PWR_Stop();
+			break;
+
+		default:
+			MY_SysTick_Tickless_Idle(IdleTicks);
+
+			residency = MY_SysTick_GetTick() - tickstart;
+			break;
+	}
+
+	MY_INT_PWR_Stats.Residency[state] += residency;
+
+	MY_INT_PWR_Wake_Record();
+
+	__set_PRIMASK(primask);
+
+	return state;
+}
+
+
+void MY_PWR_Stats_Get(MY_PWR_Stats_t *Stats)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint32_t elapsed;
+
+	__disable_irq();
+
+	*Stats = MY_INT_PWR_Stats;
+
+	/* Время в Stop не входит в тики SysTick, поэтому из окна вычитается только Sleep */
+	elapsed = MY_SysTick_GetTick() - MY_INT_PWR_WindowTick;
+	Stats->Residency[MY_PWR_State_Run] = (elapsed > Stats->Residency[MY_PWR_State_Sleep]) ?
+										 (elapsed - Stats->Residency[MY_PWR_State_Sleep]) : 0U;
+
+	__set_PRIMASK(primask);
+}
+
+
+void MY_PWR_Stats_Reset(void)
+{
+	uint32_t primask = __get_PRIMASK();
+	uint8_t from_standby;
+	uint8_t wakeup_pin;
+
+	__disable_irq();
+
+	/* Причина текущего запуска сохраняется */
+	from_standby = MY_INT_PWR_Stats.FromStandby;
+	wakeup_pin = MY_INT_PWR_Stats.WakeupPin;
+
+	memset(&MY_INT_PWR_Stats, 0, sizeof(MY_INT_PWR_Stats));
+
+	MY_INT_PWR_Stats.LastWake = MY_PWR_WAKE_UNKNOWN;
+	MY_INT_PWR_Stats.FromStandby = from_standby;
+	MY_INT_PWR_Stats.WakeupPin = wakeup_pin;
+
+	MY_INT_PWR_WindowTick = MY_SysTick_GetTick();
+
+	__set_PRIMASK(primask);
+}
+
+
+__attribute__((weak)) uint32_t MY_PWR_StopTimeCallback(void)
+{
+	/* NOTE : This function should not be modified, when the callback is needed, the @ref MY_PWR_StopTimeCallback should be implemented in the user file */
+	return 0U;
+}
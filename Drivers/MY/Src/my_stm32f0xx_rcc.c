@@ -7,12 +7,149 @@
  * @brief   Библиотека RCC для STM32F0xx
  */
 
+#include <string.h>
 #include "my_stm32f0xx_rcc.h"
+#include "my_stm32f0xx_boot.h"
 
 extern uint32_t SystemCoreClock;
 
+/* Снимок дерева частот, пересчитывается в MY_RCC_ClockTree_Update() */
+static MY_RCC_Clocks_t MY_INT_RCC_Clocks;
+
+/* Обработчики изменения частот */
+static MY_RCC_ClockChange_Callback_t MY_INT_RCC_ClockCallbacks[RCC_CLOCKCHANGE_CALLBACKS_MAX];
+
+/* Профили тактирования */
+static const MY_RCC_Profile_Config_t MY_INT_RCC_Profiles[MY_RCC_Profile_Count] =
+{
+	/* MY_RCC_Profile_Run: настройки из main.h, совпадает с MY_RCC_System_Init() */
+	{ RCC_SYSCLK_SOURCE, RCC_PLLSOURCE, RCC_PLL_PREDIV, RCC_PLL_MUL, RCC_AHB_DIV, RCC_APB1_DIV, FLASH_LATENCY },
+
+	/* MY_RCC_Profile_LowPower: HSI 8 МГц без PLL, Flash без тактов ожидания */
+	{ RCC_SYSCLK_SOURCE_HSI, 0U, 0U, 0U, RCC_PROFILE_LOWPOWER_AHB_DIV, RCC_PROFILE_LOWPOWER_APB1_DIV, 0U }
+};
+
+/* Текущий профиль и длительность последнего переключения в мкс */
+static MY_RCC_Profile_t MY_INT_RCC_Profile = MY_RCC_Profile_Run;
+static uint32_t MY_INT_RCC_ProfileSwitchTime;
+static uint32_t MY_INT_RCC_ProfileBlackout;
+
+/* Приватные функции декодирования регистров RCC */
+static uint32_t MY_INT_RCC_SysClock_Calc(void);
+static uint32_t MY_INT_RCC_PeriphClock_Calc(uint32_t PeriphClock);
+
+
+/* Проверка настроек тактирования из main.h на этапе компиляции */
+#if defined(RCC_OSCILLATORTYPE) && defined(RCC_SYSCLK_SOURCE) && defined(RCC_PLLSOURCE) && \
+	defined(RCC_PLL_PREDIV) && defined(RCC_PLL_MUL) && defined(RCC_AHB_DIV) && defined(RCC_APB1_DIV) && defined(FLASH_LATENCY)
+
+	_Static_assert(!RCC_STATIC_USES_HSE || ((RCC_OSCILLATORTYPE) & RCC_OSCILLATORTYPE_HSE),
+				   "main.h: HSE is used by SYSCLK or PLL but RCC_OSCILLATORTYPE does not enable it");
+
+	_Static_assert(!RCC_STATIC_USES_HSE || ((HSE_VALUE >= RCC_STATIC_HSE_MIN) && (HSE_VALUE <= RCC_STATIC_HSE_MAX)),
+				   "main.h: HSE_VALUE is outside of 4..32 MHz");
+
+	_Static_assert(!RCC_STATIC_USES_PLL || ((RCC_STATIC_PLL_INPUT >= RCC_STATIC_PLL_INPUT_MIN) && (RCC_STATIC_PLL_INPUT <= RCC_STATIC_PLL_INPUT_MAX)),
+				   "main.h: PLL input frequency is outside of 1..24 MHz, check RCC_PLL_PREDIV");
+
+	_Static_assert(!RCC_STATIC_USES_PLL || ((RCC_STATIC_PLLCLK >= RCC_STATIC_PLL_OUTPUT_MIN) && (RCC_STATIC_PLLCLK <= RCC_STATIC_PLL_OUTPUT_MAX)),
+				   "main.h: PLL output frequency is outside of 16..48 MHz, check RCC_PLL_MUL");
+
+	_Static_assert(RCC_STATIC_SYSCLK <= RCC_STATIC_SYSCLK_MAX,
+				   "main.h: SYSCLK exceeds 48 MHz");
+
+	_Static_assert(((FLASH_LATENCY) & ~FLASH_ACR_LATENCY) == 0U,
+				   "main.h: FLASH_LATENCY must be 0 or FLASH_ACR_LATENCY");
+
+	_Static_assert((FLASH_LATENCY) >= RCC_STATIC_FLASH_LATENCY_REQUIRED,
+				   "main.h: FLASH_LATENCY is too low for SYSCLK above 24 MHz");
+
+#endif
+
 MY_Result_t MY_RCC_System_Init(void)
 {
+#if (RCC_STATIC_INIT == 1U)
+
+	/* Переменная используемая для отсчёта таймаутов */
+	uint32_t tickstart = 0U;
+
+	/* Задержка Flash выставляется до повышения частоты */
+	FLASH->ACR = RCC_STATIC_FLASH_ACR;
+
+	/* Калибровка HSI, если он выбран в настройках */
+	if((RCC_OSCILLATORTYPE) & RCC_OSCILLATORTYPE_HSI)
+	{
+		MODIFY_REG(RCC->CR, RCC_CR_HSITRIM, (uint32_t)(RCC_HSICALIBRATION_VALUE) << RCC_CR_HSITRIM_Pos);
+	}
+
+	/* Запуск HSE. Условия вычисляются при компиляции, лишние ветви компилятор отбрасывает.
+	   Обычно HSE уже запущен в MY_BOOT_EarlyInit() и к этому моменту готов */
+	if(RCC_STATIC_USES_HSE)
+	{
+		if(RCC_HSE_BYPASS_STATE)
+		{
+			SET_BIT(RCC->CR, RCC_CR_HSEBYP);
+		}
+
+		SET_BIT(RCC->CR, RCC_CR_HSEON);
+
+		tickstart = MY_SysTick_GetTick();
+
+		while(MY_RCC_GET_FLAG(RCC_FLAG_HSERDY) == RESET)
+		{
+			if((MY_SysTick_GetTick() - tickstart) > HSE_TIMEOUT_VALUE)
+			{
+				return MY_Result_Timeout;
+			}
+		}
+
+		MY_BOOT_TIMESTAMP(MY_BOOT_Phase_HSEReady);
+	}
+
+	/* Источник, множитель, предделитель PLL и делители шин - одной записью, SYSCLK пока от HSI */
+	RCC->CFGR2 = RCC_STATIC_CFGR2;
+	RCC->CFGR = RCC_STATIC_CFGR;
+
+	/* Запуск PLL */
+	if(RCC_STATIC_USES_PLL)
+	{
+		SET_BIT(RCC->CR, RCC_CR_PLLON);
+
+		tickstart = MY_SysTick_GetTick();
+
+		while(MY_RCC_GET_FLAG(RCC_FLAG_PLLRDY) == RESET)
+		{
+			if((MY_SysTick_GetTick() - tickstart) > PLL_TIMEOUT_VALUE)
+			{
+				return MY_Result_Timeout;
+			}
+		}
+
+		MY_BOOT_TIMESTAMP(MY_BOOT_Phase_PLLReady);
+	}
+
+	/* Переключение SYSCLK */
+	RCC->CFGR = RCC_STATIC_CFGR | (RCC_SYSCLK_SOURCE);
+
+	tickstart = MY_SysTick_GetTick();
+
+	while((RCC->CFGR & RCC_CFGR_SWS) != RCC_STATIC_SWS)
+	{
+		if((MY_SysTick_GetTick() - tickstart) > CLOCKSWITCH_TIMEOUT_VALUE)
+		{
+			return MY_Result_Timeout;
+		}
+	}
+
+	MY_BOOT_TIMESTAMP(MY_BOOT_Phase_ClockSwitched);
+
+	/* Обновляем снимок частот и SystemCoreClock, SysTick перенастраивается на новую HCLK */
+	MY_RCC_ClockTree_Update();
+
+	return MY_Result_Ok;
+
+#else
+
 	/* Структуры для настроек */
 	MY_RCC_Clock_Init_t  RCC_Clock_InitStruct;
 	MY_RCC_Osc_Init_t 	 RCC_Osc_InitStruct;
@@ -67,11 +204,15 @@ MY_Result_t MY_RCC_System_Init(void)
 
 	return MY_Result_Ok;
 
+#endif
 }
 
 
 void MY_RCC_System_DeInit(void)
 {
+	/* Переменная используемая для отсчёта таймаутов */
+	uint32_t tickstart = 0U;
+
 	/* Устанавливаем бит HSION, HSITRIM[4:0] к значениям устанавливаемым при сбросе */
 	SET_BIT(RCC->CR, RCC_CR_HSION | RCC_CR_HSITRIM_4);
 
@@ -96,8 +237,19 @@ void MY_RCC_System_DeInit(void)
 	/* Отключаем все прерывания */
 	CLEAR_REG(RCC->CIR);
 
-	/* Обновление глобальной переменной SystemCoreClock */
-	SystemCoreClock = HSI_VALUE;
+	/* Дожидаемся фактического переключения SYSCLK на HSI, чтобы снимок был верным */
+	tickstart = MY_SysTick_GetTick();
+
+	while(MY_RCC_GET_SYSCLK_SOURCE() != RCC_SYSCLKSOURCE_STATUS_HSI)
+	{
+		if((MY_SysTick_GetTick() - tickstart) > CLOCKSWITCH_TIMEOUT_VALUE)
+		{
+			break;
+		}
+	}
+
+	/* Обновление снимка частот и глобальной переменной SystemCoreClock */
+	MY_RCC_ClockTree_Update();
 }
 
 
@@ -536,6 +688,9 @@ MY_Result_t	MY_RCC_Osc_Config(MY_RCC_Osc_Init_t *RCC_Osc_InitStruct)
 		}
 	}
 
+	/* Обновляем снимок частот: могли измениться HSE, HSI или LSE */
+	MY_RCC_ClockTree_Update();
+
 	return MY_Result_Ok;
 }
 
@@ -548,13 +703,13 @@ MY_Result_t MY_RCC_Clock_Config(MY_RCC_Clock_Init_t *RCC_Clock_InitStruct, uint3
 	/* Для корректного чтения данных с FLASH памяти, число периодов ожидания (LATENCY)
 	   должно быть корректно установлено в соответствии с частотой CPU (HCLK) на используемом МК.
 	   Увеличивается количество периодов ожидания при использовании высокой частоты CPU (от 24MHz) */
-	if(FLASH_LATENCY > (FLASH->ACR & FLASH_ACR_LATENCY))
+	if(FlashLatency > (FLASH->ACR & FLASH_ACR_LATENCY))
 	{
 		/* Записываем новое количество периодов ожидания в бит LATENCY в регистре FLASH_ACR */
 		FLASH->ACR = (FLASH->ACR&(~FLASH_ACR_LATENCY)) | (FlashLatency);
 
 		/* Проверяем установилось ли значение в поле LATENCY в регистре FLASH_ACR */
-		if((FLASH->ACR & FLASH_ACR_LATENCY) != FLASH_LATENCY)
+		if((FLASH->ACR & FLASH_ACR_LATENCY) != FlashLatency)
 		{
 			return MY_Result_Error;
 		}
@@ -672,13 +827,13 @@ MY_Result_t MY_RCC_Clock_Config(MY_RCC_Clock_Init_t *RCC_Clock_InitStruct, uint3
 	}
 
 	/* Если используется частота <24МГц - записываем значение предвыборки */
-	if(FLASH_LATENCY < (FLASH->ACR & FLASH_ACR_LATENCY))
+	if(FlashLatency < (FLASH->ACR & FLASH_ACR_LATENCY))
 	{
 		/* Записываем новое значение LATENCY в регистр FLASH_ACR */
-		FLASH->ACR = (FLASH->ACR&(~FLASH_ACR_LATENCY)) | (FLASH_LATENCY);
+		FLASH->ACR = (FLASH->ACR&(~FLASH_ACR_LATENCY)) | (FlashLatency);
 
 		/* Проверяем установилось ли значение в регистре */
-		if((FLASH->ACR & FLASH_ACR_LATENCY) != FLASH_LATENCY)
+		if((FLASH->ACR & FLASH_ACR_LATENCY) != FlashLatency)
 		{
 			return MY_Result_Error;
 		}
@@ -691,11 +846,8 @@ MY_Result_t MY_RCC_Clock_Config(MY_RCC_Clock_Init_t *RCC_Clock_InitStruct, uint3
 		MODIFY_REG(RCC->CFGR, RCC_CFGR_PPRE, RCC_Clock_InitStruct->APB1CLK_Divider);
 	}
 
-	/* Обновляем значение глобальной переменной SystemCoreClock */
-	SystemCoreClock = MY_RCC_SysClock_GetFreq() >> AHBPrescTable[(RCC->CFGR & RCC_CFGR_HPRE)>> RCC_CFGR_HPRE_BITNUMBER];
-
-	/* Устанавливаем значение для SysTick таймера, чтобы получить ровно 1 мс. */
-	MY_SysTick_Init(SystemCoreClock/1000U, 0U);
+	/* Обновляем снимок частот и SystemCoreClock. При смене HCLK там же перенастраивается SysTick на 1 мс. */
+	MY_RCC_ClockTree_Update();
 
 	return MY_Result_Ok;
 
@@ -859,6 +1011,9 @@ MY_Result_t MY_RCC_PeriphClock_Config(MY_RCC_PeriphClock_Init_t *RCC_PeriphClock
 
 	#endif
 
+	/* Обновляем снимок частот периферии */
+	MY_RCC_ClockTree_Update();
+
 	return MY_Result_Ok;
 }
 
@@ -939,7 +1094,7 @@ void MY_RCC_PeriphClock_GetConfig(MY_RCC_PeriphClock_Init_t *RCC_PeriphClock_Ini
 }
 
 
-uint32_t MY_RCC_PeriphClock_GetFreq(uint32_t PeriphClock)
+static uint32_t MY_INT_RCC_PeriphClock_Calc(uint32_t PeriphClock)
 {
 	/* frequency == 0 : means that no available frequency for the peripheral */
 	uint32_t frequency = 0U;
@@ -1186,7 +1341,7 @@ uint32_t MY_RCC_PeriphClock_GetFreq(uint32_t PeriphClock)
 }
 
 
-uint32_t MY_RCC_SysClock_GetFreq(void)
+static uint32_t MY_INT_RCC_SysClock_Calc(void)
 {
 	const uint8_t PLLMULFactorTable[16] = { 2U, 3U, 4U, 5U, 6U, 7U, 8U, 9U, 10U, 11U, 12U, 13U, 14U, 15U, 16U, 16U};
 	const uint8_t PLLPREDIVFactorTable[16] = { 1U, 2U, 3U, 4U, 5U, 6U, 7U, 8U, 9U,  10U, 11U, 12U, 13U, 14U, 15U, 16U};
@@ -1282,16 +1437,466 @@ uint32_t MY_RCC_SysClock_GetFreq(void)
 }
 
 
+uint32_t MY_RCC_PeriphClock_GetFreq(uint32_t PeriphClock)
+{
+	switch (PeriphClock)
+	{
+		case RCC_PERIPHCLK_RTC:
+			return MY_INT_RCC_Clocks.RTC_Freq;
+
+		case RCC_PERIPHCLK_USART1:
+			return MY_INT_RCC_Clocks.USART1_Freq;
+
+		case RCC_PERIPHCLK_I2C1:
+			return MY_INT_RCC_Clocks.I2C1_Freq;
+
+		#if defined(RCC_CFGR3_USART2SW)
+
+		case RCC_PERIPHCLK_USART2:
+			return MY_INT_RCC_Clocks.USART2_Freq;
+
+		#endif
+
+		#if defined(RCC_CFGR3_USART3SW)
+
+		case RCC_PERIPHCLK_USART3:
+			return MY_INT_RCC_Clocks.USART3_Freq;
+
+		#endif
+
+		#if defined(USB)
+
+		case RCC_PERIPHCLK_USB:
+			return MY_INT_RCC_Clocks.USB_Freq;
+
+		#endif
+
+		#if defined(CEC)
+
+		case RCC_PERIPHCLK_CEC:
+			return MY_INT_RCC_Clocks.CEC_Freq;
+
+		#endif
+
+		default:
+			return 0U;
+	}
+}
+
+
+uint32_t MY_RCC_SysClock_GetFreq(void)
+{
+	return MY_INT_RCC_Clocks.SYSCLK_Freq;
+}
+
+
 uint32_t MY_RCC_HCLK_GetFreq(void)
 {
-	return SystemCoreClock;
+	return MY_INT_RCC_Clocks.HCLK_Freq;
 }
 
 
 uint32_t MY_RCC_PCLK1_GetFreq(void)
 {
-	/* Get HCLK source and Compute PCLK1 frequency */
-	return (MY_RCC_HCLK_GetFreq() >> APBPrescTable[(RCC->CFGR & RCC_CFGR_PPRE) >> RCC_CFGR_PPRE_BITNUMBER]);
+	return MY_INT_RCC_Clocks.PCLK1_Freq;
+}
+
+
+void MY_RCC_ClockTree_Update(void)
+{
+	MY_RCC_Clocks_t previous = MY_INT_RCC_Clocks;
+	uint32_t i;
+
+	/* Сначала частоты шин: расчёт частот периферии использует их через геттеры */
+	MY_INT_RCC_Clocks.SYSCLK_Freq = MY_INT_RCC_SysClock_Calc();
+	MY_INT_RCC_Clocks.HCLK_Freq = MY_INT_RCC_Clocks.SYSCLK_Freq >> AHBPrescTable[(RCC->CFGR & RCC_CFGR_HPRE) >> RCC_CFGR_HPRE_BITNUMBER];
+	MY_INT_RCC_Clocks.PCLK1_Freq = MY_INT_RCC_Clocks.HCLK_Freq >> APBPrescTable[(RCC->CFGR & RCC_CFGR_PPRE) >> RCC_CFGR_PPRE_BITNUMBER];
+
+	MY_INT_RCC_Clocks.RTC_Freq = MY_INT_RCC_PeriphClock_Calc(RCC_PERIPHCLK_RTC);
+	MY_INT_RCC_Clocks.USART1_Freq = MY_INT_RCC_PeriphClock_Calc(RCC_PERIPHCLK_USART1);
+	MY_INT_RCC_Clocks.I2C1_Freq = MY_INT_RCC_PeriphClock_Calc(RCC_PERIPHCLK_I2C1);
+
+	#if defined(RCC_CFGR3_USART2SW)
+		MY_INT_RCC_Clocks.USART2_Freq = MY_INT_RCC_PeriphClock_Calc(RCC_PERIPHCLK_USART2);
+	#endif
+
+	#if defined(RCC_CFGR3_USART3SW)
+		MY_INT_RCC_Clocks.USART3_Freq = MY_INT_RCC_PeriphClock_Calc(RCC_PERIPHCLK_USART3);
+	#endif
+
+	#if defined(USB)
+		MY_INT_RCC_Clocks.USB_Freq = MY_INT_RCC_PeriphClock_Calc(RCC_PERIPHCLK_USB);
+	#endif
+
+	#if defined(CEC)
+		MY_INT_RCC_Clocks.CEC_Freq = MY_INT_RCC_PeriphClock_Calc(RCC_PERIPHCLK_CEC);
+	#endif
+
+	/* Обновляем значение глобальной переменной SystemCoreClock */
+	SystemCoreClock = MY_INT_RCC_Clocks.HCLK_Freq;
+
+	/* Частоты не изменились - перенастраивать нечего */
+	if(memcmp(&previous, &MY_INT_RCC_Clocks, sizeof(MY_RCC_Clocks_t)) == 0)
+	{
+		return;
+	}
+
+	/* Устанавливаем значение для SysTick таймера, чтобы получить ровно 1 мс. */
+	if(previous.HCLK_Freq != MY_INT_RCC_Clocks.HCLK_Freq)
+	{
+		MY_SysTick_Init(MY_INT_RCC_Clocks.HCLK_Freq / 1000U, 0U);
+	}
+
+	/* Оповещаем подписчиков */
+	for(i = 0; i < RCC_CLOCKCHANGE_CALLBACKS_MAX; i++)
+	{
+		if(MY_INT_RCC_ClockCallbacks[i] != NULL)
+		{
+			MY_INT_RCC_ClockCallbacks[i](&MY_INT_RCC_Clocks);
+		}
+	}
+}
+
+
+const MY_RCC_Clocks_t* MY_RCC_Clocks_Get(void)
+{
+	return &MY_INT_RCC_Clocks;
+}
+
+
+MY_Result_t MY_RCC_ClockChange_Register(MY_RCC_ClockChange_Callback_t Callback)
+{
+	uint32_t i;
+	uint32_t free_slot = RCC_CLOCKCHANGE_CALLBACKS_MAX;
+
+	for(i = 0; i < RCC_CLOCKCHANGE_CALLBACKS_MAX; i++)
+	{
+		/* Повторная регистрация не дублирует вызовы */
+		if(MY_INT_RCC_ClockCallbacks[i] == Callback)
+		{
+			return MY_Result_Ok;
+		}
+
+		if((MY_INT_RCC_ClockCallbacks[i] == NULL) && (free_slot == RCC_CLOCKCHANGE_CALLBACKS_MAX))
+		{
+			free_slot = i;
+		}
+	}
+
+	if(free_slot == RCC_CLOCKCHANGE_CALLBACKS_MAX)
+	{
+		return MY_Result_Error;
+	}
+
+	MY_INT_RCC_ClockCallbacks[free_slot] = Callback;
+
+	return MY_Result_Ok;
+}
+
+
+void MY_RCC_ClockChange_Unregister(MY_RCC_ClockChange_Callback_t Callback)
+{
+	uint32_t i;
+
+	for(i = 0; i < RCC_CLOCKCHANGE_CALLBACKS_MAX; i++)
+	{
+		if(MY_INT_RCC_ClockCallbacks[i] == Callback)
+		{
+			MY_INT_RCC_ClockCallbacks[i] = NULL;
+		}
+	}
+}
+
+
+/* Время от перезапуска SysTick в мкс. Используется сразу после MY_RCC_ClockTree_Update(), пока не прошёл тик */
+static uint32_t MY_INT_RCC_SysTick_Us(void)
+{
+	uint32_t load = SysTick->LOAD;
+
+	return ((load - SysTick->VAL) * 1000U) / (load + 1U);
+}
+
+
+/* Ожидание флага готовности генератора */
+static MY_Result_t MY_INT_RCC_WaitFlag(uint32_t Flag, FlagStatus State, uint32_t Timeout)
+{
+	uint32_t tickstart = MY_SysTick_GetTick();
+
+	/* MY_RCC_GET_FLAG() возвращает сам бит, а не SET */
+	while(((MY_RCC_GET_FLAG(Flag) != 0U) ? SET : RESET) != State)
+	{
+		if((MY_SysTick_GetTick() - tickstart) > Timeout)
+		{
+			return MY_Result_Timeout;
+		}
+	}
+
+	return MY_Result_Ok;
+}
+
+
+/* Переключение SYSCLK и делителей при запрещённых прерываниях.
+   Задержка Flash до смены частоты выставляется в максимум из старой и новой, после - в новую */
+static MY_Result_t MY_INT_RCC_Switch(uint32_t SysClk, uint32_t Dividers, uint32_t FlashLatency)
+{
+	uint32_t spin = RCC_PROFILE_SWITCH_SPIN;
+	uint32_t cfgr = RCC->CFGR & (RCC_CFGR_SW | RCC_CFGR_HPRE | RCC_CFGR_PPRE);
+
+	if(FlashLatency > (FLASH->ACR & FLASH_ACR_LATENCY))
+	{
+		MODIFY_REG(FLASH->ACR, FLASH_ACR_LATENCY, FlashLatency);
+	}
+
+	MODIFY_REG(RCC->CFGR, RCC_CFGR_SW | RCC_CFGR_HPRE | RCC_CFGR_PPRE, SysClk | Dividers);
+
+	while((RCC->CFGR & RCC_CFGR_SWS) != (SysClk << (RCC_CFGR_SWS_Pos - RCC_CFGR_SW_Pos)))
+	{
+		if(--spin == 0U)
+		{
+			/* Запрос переключения и делители возвращаются к прежним.
+			   Задержка Flash остаётся увеличенной - это безопасно для любой частоты */
+			MODIFY_REG(RCC->CFGR, RCC_CFGR_SW | RCC_CFGR_HPRE | RCC_CFGR_PPRE, cfgr);
+
+			return MY_Result_Timeout;
+		}
+	}
+
+	if(FlashLatency < (FLASH->ACR & FLASH_ACR_LATENCY))
+	{
+		MODIFY_REG(FLASH->ACR, FLASH_ACR_LATENCY, FlashLatency);
+	}
+
+	return MY_Result_Ok;
+}
+
+
+/* Откат после ошибки MY_RCC_Profile_Set(): генераторы, включённые этим вызовом и не тактирующие SYSCLK, выключаются */
+static void MY_INT_RCC_Profile_Rollback(uint32_t Cr)
+{
+	uint32_t sws = MY_RCC_GET_SYSCLK_SOURCE();
+	uint32_t pll_hse = (sws == RCC_SYSCLKSOURCE_STATUS_PLLCLK) && ((RCC->CFGR & RCC_CFGR_PLLSRC) == RCC_PLLSOURCE_HSE);
+
+	if(!(Cr & RCC_CR_PLLON) && (sws != RCC_SYSCLKSOURCE_STATUS_PLLCLK))
+	{
+		CLEAR_BIT(RCC->CR, RCC_CR_PLLON);
+	}
+
+	if(!(Cr & RCC_CR_HSEON) && (sws != RCC_SYSCLKSOURCE_STATUS_HSE) && !pll_hse)
+	{
+		CLEAR_BIT(RCC->CR, RCC_CR_HSEON);
+		CLEAR_BIT(RCC->CR, RCC_CR_HSEBYP);
+	}
+}
+
+
+MY_Result_t MY_RCC_Profile_Set(MY_RCC_Profile_t Profile)
+{
+	const MY_RCC_Profile_Config_t *config;
+	uint32_t start;
+	uint32_t blackout;
+	uint32_t before;
+	uint32_t hclk;
+	uint32_t primask;
+	uint32_t uses_pll;
+	uint32_t uses_hse;
+	uint32_t uses_hsi;
+	uint32_t pll_cfgr;
+	uint32_t cr;
+	MY_Result_t result;
+
+	if(Profile >= MY_RCC_Profile_Count)
+	{
+		return MY_Result_Error;
+	}
+
+	/* Состояние генераторов для отката при ошибке */
+	cr = RCC->CR;
+
+	start = (uint32_t)MY_SysTick_GetMicros();
+
+	config = &MY_INT_RCC_Profiles[Profile];
+
+	uses_pll = (config->SYSCLK_Source == RCC_SYSCLK_SOURCE_PLL);
+	uses_hse = (config->SYSCLK_Source == RCC_SYSCLK_SOURCE_HSE) || (uses_pll && (config->PLL_Source == RCC_PLLSOURCE_HSE));
+	uses_hsi = (config->SYSCLK_Source == RCC_SYSCLK_SOURCE_HSI) || (uses_pll && (config->PLL_Source != RCC_PLLSOURCE_HSE));
+	pll_cfgr = uses_pll ? (config->PLL_Source | config->PLL_MUL) : 0U;
+
+
+	/*------------------- Запуск генераторов, прерывания разрешены -------------------*/
+	if(uses_hsi)
+	{
+		SET_BIT(RCC->CR, RCC_CR_HSION);
+
+		if(MY_INT_RCC_WaitFlag(RCC_FLAG_HSIRDY, SET, HSI_TIMEOUT_VALUE) != MY_Result_Ok)
+		{
+			MY_INT_RCC_Profile_Rollback(cr);
+
+			return MY_Result_Timeout;
+		}
+	}
+
+	if(uses_hse)
+	{
+		if(RCC_HSE_BYPASS_STATE && !READ_BIT(RCC->CR, RCC_CR_HSEON))
+		{
+			SET_BIT(RCC->CR, RCC_CR_HSEBYP);
+		}
+
+		SET_BIT(RCC->CR, RCC_CR_HSEON);
+
+		if(MY_INT_RCC_WaitFlag(RCC_FLAG_HSERDY, SET, HSE_TIMEOUT_VALUE) != MY_Result_Ok)
+		{
+			MY_INT_RCC_Profile_Rollback(cr);
+
+			return MY_Result_Timeout;
+		}
+	}
+
+	if(uses_pll)
+	{
+		/* PLL работает с другими настройками - его нужно остановить, а SYSCLK временно перевести на HSI */
+		if(READ_BIT(RCC->CR, RCC_CR_PLLON) &&
+		   (((RCC->CFGR & (RCC_CFGR_PLLSRC | RCC_CFGR_PLLMUL)) != pll_cfgr) || ((RCC->CFGR2 & RCC_CFGR2_PREDIV) != config->PLL_PREDIV)))
+		{
+			if(MY_RCC_GET_SYSCLK_SOURCE() == RCC_SYSCLKSOURCE_STATUS_PLLCLK)
+			{
+				SET_BIT(RCC->CR, RCC_CR_HSION);
+
+				if(MY_INT_RCC_WaitFlag(RCC_FLAG_HSIRDY, SET, HSI_TIMEOUT_VALUE) != MY_Result_Ok)
+				{
+					MY_INT_RCC_Profile_Rollback(cr);
+
+					return MY_Result_Timeout;
+				}
+
+				primask = __get_PRIMASK();
+				__disable_irq();
+
+				result = MY_INT_RCC_Switch(RCC_SYSCLK_SOURCE_HSI, RCC->CFGR & (RCC_CFGR_HPRE | RCC_CFGR_PPRE), FLASH->ACR & FLASH_ACR_LATENCY);
+
+				if(result == MY_Result_Ok)
+				{
+					MY_RCC_ClockTree_Update();
+				}
+
+				__set_PRIMASK(primask);
+
+				if(result != MY_Result_Ok)
+				{
+					MY_INT_RCC_Profile_Rollback(cr);
+
+					return result;
+				}
+			}
+
+			CLEAR_BIT(RCC->CR, RCC_CR_PLLON);
+
+			if(MY_INT_RCC_WaitFlag(RCC_FLAG_PLLRDY, RESET, PLL_TIMEOUT_VALUE) != MY_Result_Ok)
+			{
+				MY_INT_RCC_Profile_Rollback(cr);
+
+				return MY_Result_Timeout;
+			}
+		}
+
+		if(!READ_BIT(RCC->CR, RCC_CR_PLLON))
+		{
+			MODIFY_REG(RCC->CFGR2, RCC_CFGR2_PREDIV, config->PLL_PREDIV);
+			MODIFY_REG(RCC->CFGR, RCC_CFGR_PLLSRC | RCC_CFGR_PLLMUL, pll_cfgr);
+
+			SET_BIT(RCC->CR, RCC_CR_PLLON);
+
+			if(MY_INT_RCC_WaitFlag(RCC_FLAG_PLLRDY, SET, PLL_TIMEOUT_VALUE) != MY_Result_Ok)
+			{
+				MY_INT_RCC_Profile_Rollback(cr);
+
+				return MY_Result_Timeout;
+			}
+		}
+	}
+
+
+	/*------------- Переключение частоты и пересчёт таймингов, прерывания запрещены -------------*/
+	primask = __get_PRIMASK();
+	__disable_irq();
+
+	blackout = (uint32_t)MY_SysTick_GetMicros();
+
+	result = MY_INT_RCC_Switch(config->SYSCLK_Source, config->AHBCLK_Divider | config->APB1CLK_Divider, config->FlashLatency);
+
+	if(result != MY_Result_Ok)
+	{
+		__set_PRIMASK(primask);
+
+		MY_INT_RCC_Profile_Rollback(cr);
+
+		return result;
+	}
+
+	/* SysTick после смены HCLK перезапускается в MY_RCC_ClockTree_Update(),
+	   поэтому время до пересчёта фиксируется заранее, а после - отсчитывается от перезапуска */
+	before = (uint32_t)MY_SysTick_GetMicros();
+	hclk = MY_RCC_HCLK_GetFreq();
+
+	MY_RCC_ClockTree_Update();
+
+	if(hclk != MY_RCC_HCLK_GetFreq())
+	{
+		before += MY_INT_RCC_SysTick_Us();
+	}
+	else
+	{
+		before = (uint32_t)MY_SysTick_GetMicros();
+	}
+
+	MY_INT_RCC_Profile = Profile;
+	MY_INT_RCC_ProfileSwitchTime = before - start;
+	MY_INT_RCC_ProfileBlackout = before - blackout;
+
+	__set_PRIMASK(primask);
+
+
+	/*------------------------ Остановка ненужных генераторов ------------------------*/
+	if(!uses_pll)
+	{
+		CLEAR_BIT(RCC->CR, RCC_CR_PLLON);
+	}
+
+	/* HSE оставляем, если от него тактируется RTC или включен CSS */
+	if(!uses_hse && ((RCC->BDCR & RCC_BDCR_RTCSEL) != RCC_BDCR_RTCSEL_HSE) && !READ_BIT(RCC->CR, RCC_CR_CSSON))
+	{
+		CLEAR_BIT(RCC->CR, RCC_CR_HSEON);
+	}
+
+	return MY_Result_Ok;
+}
+
+
+MY_RCC_Profile_t MY_RCC_Profile_Get(void)
+{
+	return MY_INT_RCC_Profile;
+}
+
+
+const MY_RCC_Profile_Config_t* MY_RCC_Profile_GetConfig(MY_RCC_Profile_t Profile)
+{
+	if(Profile >= MY_RCC_Profile_Count)
+	{
+		return NULL;
+	}
+
+	return &MY_INT_RCC_Profiles[Profile];
+}
+
+
+uint32_t MY_RCC_Profile_GetSwitchTime(uint32_t *Blackout)
+{
+	if(Blackout != NULL)
+	{
+		*Blackout = MY_INT_RCC_ProfileBlackout;
+	}
+
+	return MY_INT_RCC_ProfileSwitchTime;
 }
 
 
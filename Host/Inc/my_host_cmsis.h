@@ -0,0 +1,108 @@
+/**
+ * @author  Андрей Заостровных
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Сборка библиотеки на ПК (x86-64): замена встроенных функций ядра CMSIS
+ */
+
+#ifndef MY_HOST_CMSIS_H
+	#define MY_HOST_CMSIS_H 100
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		extern "C"
+		{
+	#endif
+
+	/**
+	 * @addtogroup MY_STM32F0xx_Libraries
+	 * @{
+	 */
+
+		/**
+		 * @defgroup MY_HOST
+		 * @brief    Сборка на ПК
+		 *
+		 * 	Заголовок подключается ко всем файлам цели host (make host) ключом -include. Он определяет
+		 * 	защитный макрос cmsis_gcc.h, поэтому ассемблерные вставки Cortex-M0 не компилируются, а их место
+		 * 	занимают функции ниже: PRIMASK и IPSR - переменные, барьеры - барьеры компилятора x86-64,
+		 * 	WFE - пустой, WFI вызывает модель сна MY_HOST_WFI, если тест её задал.
+		 *
+		 * 	Регистры периферии остаются по своим адресам: my_host_sim.c отображает память на адреса
+		 * 	PERIPH_BASE, AHB2 (GPIO), SCS и системной памяти до вызова main(). Сборка без PIE, поэтому
+		 * 	статические данные лежат ниже 4 ГБ и приведения указателей к uint32_t в драйверах корректны.
+		 *	@{
+		 */
+
+			#include <stdint.h>
+
+			/* Вместо cmsis_gcc.h */
+			#define __CMSIS_GCC_H
+
+			/* Секция .ramfunc и long_call имеют смысл только для Cortex-M0: MY_RAMFUNC пустой */
+			#define RAMFUNC_ENABLE							0U
+
+			/**
+			 * @defgroup MY_HOST_Functions
+			 * @brief    Функции используемые в библиотеке
+			 * @{
+			 */
+				/*!< Состояние PRIMASK, MSP и IPSR моделируемого ядра */
+				extern volatile uint32_t MY_HOST_PRIMASK;
+				extern volatile uint32_t MY_HOST_MSP;
+				extern volatile uint32_t MY_HOST_IPSR;
+
+				/*!< Модель сна в WFI: продвигает время до пробуждения, 0 - WFI пустой */
+				extern void (*volatile MY_HOST_WFI)(void);
+
+				static inline void __enable_irq(void)					{ MY_HOST_PRIMASK = 0U; __atomic_signal_fence(__ATOMIC_SEQ_CST); }
+				static inline void __disable_irq(void)					{ MY_HOST_PRIMASK = 1U; __atomic_signal_fence(__ATOMIC_SEQ_CST); }
+				static inline uint32_t __get_PRIMASK(void)				{ return MY_HOST_PRIMASK; }
+				static inline void __set_PRIMASK(uint32_t priMask)		{ MY_HOST_PRIMASK = priMask; __atomic_signal_fence(__ATOMIC_SEQ_CST); }
+
+				static inline uint32_t __get_CONTROL(void)				{ return 0U; }
+				static inline void __set_CONTROL(uint32_t control)		{ (void)control; }
+				static inline uint32_t __get_IPSR(void)					{ return MY_HOST_IPSR; }
+				static inline uint32_t __get_APSR(void)					{ return 0U; }
+				static inline uint32_t __get_xPSR(void)					{ return 0U; }
+				static inline uint32_t __get_PSP(void)					{ return 0U; }
+				static inline void __set_PSP(uint32_t topOfProcStack)	{ (void)topOfProcStack; }
+				static inline uint32_t __get_MSP(void)					{ return MY_HOST_MSP; }
+				static inline void __set_MSP(uint32_t topOfMainStack)	{ MY_HOST_MSP = topOfMainStack; }
+
+				static inline void __NOP(void)							{ __asm volatile ("nop"); }
+				static inline void __WFI(void)							{ if(MY_HOST_WFI != 0) { MY_HOST_WFI(); } }
+				static inline void __WFE(void)							{ }
+				static inline void __SEV(void)							{ }
+				static inline void __ISB(void)							{ __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+				static inline void __DSB(void)							{ __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+				static inline void __DMB(void)							{ __atomic_thread_fence(__ATOMIC_SEQ_CST); }
+
+				static inline uint32_t __REV(uint32_t value)			{ return __builtin_bswap32(value); }
+				static inline uint32_t __REV16(uint32_t value)			{ return ((value & 0x00FF00FFU) << 8) | ((value >> 8) & 0x00FF00FFU); }
+				static inline int32_t __REVSH(int32_t value)			{ return (int16_t)__builtin_bswap16((uint16_t)value); }
+				static inline uint32_t __ROR(uint32_t op1, uint32_t op2)	{ op2 &= 31U; return (op2 == 0U) ? op1 : ((op1 >> op2) | (op1 << (32U - op2))); }
+
+				#define __BKPT(value)									do { } while(0)
+				#define __CLZ(value)									((uint8_t)(((value) == 0U) ? 32U : (uint32_t)__builtin_clz(value)))
+
+			/**
+			 * @} MY_HOST_Functions
+			 */
+
+		/**
+		 * @} MY_HOST
+		 */
+
+	/**
+	 * @} MY_STM32F0xx_Libraries
+	 */
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		}
+	#endif
+
+#endif
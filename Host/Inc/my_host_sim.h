@@ -0,0 +1,170 @@
+/**
+ * @author  Андрей Заостровных
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Сборка библиотеки на ПК: модель регистров, пошаговое выполнение и прерывания
+ */
+
+#ifndef MY_HOST_SIM_H
+	#define MY_HOST_SIM_H 100
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		extern "C"
+		{
+	#endif
+
+	/**
+	 * @addtogroup MY_STM32F0xx_Libraries
+	 * @{
+	 */
+
+		/**
+		 * @defgroup MY_HOST_SIM
+		 * @brief    Модель МК для тестов и замеров на ПК
+		 *
+		 * 	Периферия - обычная память по адресам регистров: драйвер видит то, что записал сам или тест.
+		 * 	Регистры, которые меняет аппаратура (флаги готовности, счётчики DMA), ведёт тест: между
+		 * 	вызовами драйвера или из обработчика шага.
+		 *
+		 * 	MY_HOST_Step_Run() выполняет функцию по одной инструкции x86-64 (флаг TF, SIGTRAP) и перед
+		 * 	каждой вызывает обработчик шага. На нём построены:
+		 * 		- модели аппаратуры, которая меняет регистры во время опроса (задержка готовности RCC);
+		 * 		- MY_HOST_Preempt_Run() - прерывание на заданной границе инструкций с учётом PRIMASK.
+		 * 	Границы инструкций x86-64 не совпадают с Thumb, но каждый доступ к памяти - отдельная
+		 * 	инструкция, поэтому перебор всех границ проверяет те же окна гонок, что и на МК.
+		 *	@{
+		 */
+
+			#include <stdint.h>
+
+			/**
+			 * @defgroup MY_HOST_SIM_Defines
+			 * @brief    Библиотечные константы
+			 * @{
+			 */
+				/*!< Шаг, который никогда не наступит: задержка "никогда", прерывание не запрашивается */
+				#define MY_HOST_NEVER							0xFFFFFFFFU
+
+			/**
+			 * @} MY_HOST_SIM_Defines
+			 */
+
+
+			/**
+			 * @defgroup MY_HOST_SIM_Typedefs
+			 * @brief    Typedefs для библиотеки
+			 * @{
+			 */
+				/*!< Функция потока, обработчика прерывания или шага */
+				typedef void (*MY_HOST_Func_t)(void);
+
+
+				/*!< Задержки модели RCC, в инструкциях */
+				typedef struct
+				{
+					uint32_t	HSE;		/*!< HSEON - HSERDY, MY_HOST_NEVER - кварц не запускается */
+					uint32_t	PLL;		/*!< PLLON - PLLRDY при готовом источнике PLL */
+					uint32_t	Switch;		/*!< Запись SW - SWS при готовом источнике */
+					uint32_t	Tick;		/*!< Инструкций на тик MY_SysTick_IncTick(), 0 - время стоит */
+				}
+				MY_HOST_RCC_Delays_t;
+
+			/**
+			 * @} MY_HOST_SIM_Typedefs
+			 */
+
+
+			/**
+			 * @defgroup MY_HOST_SIM_Functions
+			 * @brief    Функции используемые в библиотеке
+			 * @{
+			 */
+				/*!< Таблица векторов во Flash (g_pfnVectors): обнуляется один раз при запуске, тест может её заполнить */
+				extern MY_HOST_Func_t MY_HOST_Vectors[];
+
+
+				/**
+				 * @brief  Обнуляет периферию и записывает значения регистров после сброса
+				 * @note   Состояние драйверов (статические переменные) не меняется
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_HOST_Reset(void);
+
+
+				/**
+				 * @brief  Выполняет функцию по одной инструкции
+				 * @param  Func: выполняемая функция
+				 * @param  Hook: вызывается перед каждой инструкцией Func, NULL - только подсчёт
+				 * @retval Количество выполненных инструкций
+				 */
+				uint32_t MY_HOST_Step_Run(MY_HOST_Func_t Func, MY_HOST_Func_t Hook);
+
+
+				/**
+				 * @brief  Номер текущей инструкции внутри MY_HOST_Step_Run()
+				 * @param  Нет
+				 * @retval Номер от 0
+				 */
+				uint32_t MY_HOST_Step_Count(void);
+
+
+				/**
+				 * @brief  Выполняет поток с запросом прерывания перед инструкцией At
+				 * @note   Обработчик выполняется на первой границе, где PRIMASK = 0, с MY_HOST_IPSR = Exception.
+				 * 		   Прерывание, не обслуженное до конца потока, выполняется после него
+				 * @param  Thread: основной поток
+				 * @param  Isr: обработчик прерывания
+				 * @param  Exception: номер исключения (SysTick - 15, IRQn + 16)
+				 * @param  At: номер инструкции потока, MY_HOST_NEVER - без прерывания
+				 * @retval Количество инструкций потока
+				 */
+				uint32_t MY_HOST_Preempt_Run(MY_HOST_Func_t Thread, MY_HOST_Func_t Isr, uint32_t Exception, uint32_t At);
+
+
+				/**
+				 * @brief  Номер инструкции, перед которой выполнился обработчик в последнем MY_HOST_Preempt_Run()
+				 * @param  Нет
+				 * @retval Номер инструкции или MY_HOST_NEVER, если обработчик выполнился после потока
+				 */
+				uint32_t MY_HOST_Preempt_Taken(void);
+
+
+				/**
+				 * @brief  Задаёт задержки модели RCC и сбрасывает её счётчики
+				 * @note   MY_HOST_Reset() выставляет нулевые задержки: готовность на следующей инструкции, время стоит
+				 * @param  *Delays: задержки
+				 * @retval Нет
+				 */
+				void MY_HOST_RCC_Config(const MY_HOST_RCC_Delays_t *Delays);
+
+
+				/**
+				 * @brief  Шаг модели RCC: флаги готовности HSE/PLL, SWS и тики SysTick
+				 * @note   Обработчик шага для MY_HOST_Step_Run() или его часть
+				 * @param  Нет
+				 * @retval Нет
+				 */
+				void MY_HOST_RCC_Hook(void);
+
+			/**
+			 * @} MY_HOST_SIM_Functions
+			 */
+
+		/**
+		 * @} MY_HOST_SIM
+		 */
+
+	/**
+	 * @} MY_STM32F0xx_Libraries
+	 */
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		}
+	#endif
+
+#endif
@@ -0,0 +1,115 @@
+/**
+ * @author  Андрей Заостровных
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Сборка библиотеки на ПК: проверки для тестов make host-test
+ */
+
+#ifndef MY_HOST_TEST_H
+	#define MY_HOST_TEST_H 100
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		extern "C"
+		{
+	#endif
+
+	/**
+	 * @addtogroup MY_STM32F0xx_Libraries
+	 * @{
+	 */
+
+		/**
+		 * @defgroup MY_HOST_TEST
+		 * @brief    Тесты на ПК
+		 *
+		 * 	Каждый файл каталога Host/Test - отдельная программа со своей функцией main(): тест запускает
+		 * 	случаи через MY_HOST_RUN() и возвращает MY_HOST_TEST_Report(). Неудачная проверка печатает
+		 * 	файл, строку и значения, но не прерывает случай.
+		 *	@{
+		 */
+
+			#include <stdio.h>
+			#include <stdint.h>
+
+			#include "my_host_sim.h"
+
+			/**
+			 * @defgroup MY_HOST_TEST_Macros
+			 * @brief    Библиотечные макросы
+			 * @{
+			 */
+				/*!< Проверка условия */
+				#define MY_HOST_CHECK(__COND__)															\
+					MY_HOST_TEST_Check((__COND__) ? 1U : 0U, __FILE__, __LINE__, #__COND__)
+
+				/*!< Проверка равенства целых значений: каждое вычисляется один раз, при ошибке печатаются оба */
+				#define MY_HOST_EQUAL(__ACTUAL__, __EXPECTED__)											\
+					MY_HOST_TEST_Equal((uint64_t)(__ACTUAL__), (uint64_t)(__EXPECTED__),				\
+									   __FILE__, __LINE__, #__ACTUAL__ " == " #__EXPECTED__)
+
+				/*!< Случай теста: периферия модели сбрасывается перед каждым */
+				#define MY_HOST_RUN(__CASE__)															\
+					do																					\
+					{																					\
+						MY_HOST_Reset();																\
+						printf("  %s\n", #__CASE__);													\
+						__CASE__();																		\
+					}																					\
+					while(0)
+
+			/**
+			 * @}  MY_HOST_TEST_Macros
+			 */
+
+
+			/**
+			 * @defgroup MY_HOST_TEST_Functions
+			 * @brief    Функции используемые в библиотеке
+			 * @{
+			 */
+				/**
+				 * @brief  Учёт проверки условия, используется MY_HOST_CHECK()
+				 * @param  Passed: 1 - условие выполнено
+				 * @param  *File, Line, *Text: место и текст проверки
+				 * @retval Passed
+				 */
+				uint32_t MY_HOST_TEST_Check(uint32_t Passed, const char *File, int Line, const char *Text);
+
+
+				/**
+				 * @brief  Учёт проверки равенства, используется MY_HOST_EQUAL()
+				 * @param  Actual, Expected: сравниваемые значения
+				 * @param  *File, Line, *Text: место и текст проверки
+				 * @retval 1 - значения равны
+				 */
+				uint32_t MY_HOST_TEST_Equal(uint64_t Actual, uint64_t Expected, const char *File, int Line, const char *Text);
+
+
+				/**
+				 * @brief  Итог теста
+				 * @param  *Name: имя теста
+				 * @retval Код завершения программы: 0 - все проверки прошли
+				 */
+				int MY_HOST_TEST_Report(const char *Name);
+
+			/**
+			 * @} MY_HOST_TEST_Functions
+			 */
+
+		/**
+		 * @} MY_HOST_TEST
+		 */
+
+	/**
+	 * @} MY_STM32F0xx_Libraries
+	 */
+
+	/* C++ detection */
+	#ifdef __cplusplus
+		}
+	#endif
+
+#endif
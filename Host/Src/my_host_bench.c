@@ -0,0 +1,136 @@
+/**
+ * @author  Andrey Zaostrovnykh
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Сборка библиотеки на ПК: замеры программных путей драйверов
+ */
+#include <stdio.h>
+#include <time.h>
+
+#include "my_host_cmsis.h"
+#include "my_stm32f0xx.h"
+#include "my_stm32f0xx_pool.h"
+#include "my_stm32f0xx_arena.h"
+#include "my_stm32f0xx_console.h"
+#include "my_stm32f0xx_log.h"
+
+/* Повторов операции в одном замере и замеров, из которых берётся лучший */
+#define MY_INT_BENCH_LOOPS						100000U
+#define MY_INT_BENCH_RUNS						5U
+
+typedef void (*MY_INT_BENCH_Func_t)(void);
+
+
+static uint64_t MY_INT_BENCH_Now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return ((uint64_t)ts.tv_sec * 1000000000ULL) + (uint64_t)ts.tv_nsec;
+}
+
+
+/* Лучшее время одной операции из MY_INT_BENCH_RUNS замеров, как в MY_*_Benchmark() на МК */
+static void MY_INT_BENCH_Run(const char *Name, MY_INT_BENCH_Func_t Func)
+{
+	uint64_t best = UINT64_MAX;
+	uint64_t start;
+	uint64_t time;
+	uint32_t run;
+	uint32_t i;
+
+	for(run = 0; run < MY_INT_BENCH_RUNS; run++)
+	{
+		start = MY_INT_BENCH_Now();
+
+		for(i = 0; i < MY_INT_BENCH_LOOPS; i++)
+		{
+			Func();
+		}
+
+		time = MY_INT_BENCH_Now() - start;
+
+		if(time < best)
+		{
+			best = time;
+		}
+	}
+
+	printf("%-28s %8.1f ns\n", Name, (double)best / MY_INT_BENCH_LOOPS);
+}
+
+
+static void MY_INT_BENCH_Pool(void)
+{
+	void *block = MY_POOL_Alloc(24U, 0U);
+
+	MY_POOL_Free(block);
+}
+
+
+static void MY_INT_BENCH_Arena(void)
+{
+	MY_ARENA_Mark_t mark = MY_ARENA_Mark();
+
+	MY_ARENA_Alloc(24U);
+	MY_ARENA_Alloc(40U);
+	MY_ARENA_Release(mark);
+}
+
+
+/* Передача буфера консоли обработчиком прерывания: TXE в модели всегда установлен */
+static void MY_INT_BENCH_Drain(void)
+{
+	SET_BIT(USART1->CR1, USART_CR1_TXEIE);
+
+	while(MY_CONSOLE_GetFree() != CONSOLE_BUFFER_SIZE)
+	{
+		MY_CONSOLE_IRQHandler();
+	}
+}
+
+
+static void MY_INT_BENCH_Console(void)
+{
+	static const char text[] = "temperature 23.5\r\n";
+
+	MY_CONSOLE_Write(text, sizeof(text) - 1U);
+
+	MY_INT_BENCH_Drain();
+}
+
+
+static void MY_INT_BENCH_LogWrite(void)
+{
+	static uint32_t count = 0;
+
+	MY_LOG("sensor %u value %d", count, -5);
+
+	/* Каждые 8 записей журнал выводится в консоль и передаётся, чтобы буфер не переполнялся */
+	if(++count % 8U == 0U)
+	{
+		while(MY_LOG_Process() != 0U)
+		{
+			MY_INT_BENCH_Drain();
+		}
+	}
+}
+
+
+int main(void)
+{
+	MY_POOL_Init();
+	MY_ARENA_Init();
+
+	printf("host benchmark, best of %u runs x %u operations\n", MY_INT_BENCH_RUNS, MY_INT_BENCH_LOOPS);
+
+	MY_INT_BENCH_Run("MY_POOL_Alloc + Free", MY_INT_BENCH_Pool);
+	MY_INT_BENCH_Run("MY_ARENA_Alloc x2 + Release", MY_INT_BENCH_Arena);
+	MY_INT_BENCH_Run("MY_CONSOLE_Write + drain", MY_INT_BENCH_Console);
+	MY_INT_BENCH_Run("MY_LOG (2 args) + output", MY_INT_BENCH_LogWrite);
+
+	return 0;
+}
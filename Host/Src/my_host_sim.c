@@ -0,0 +1,335 @@
+/**
+ * @author  Андрей Заостровных
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Сборка библиотеки на ПК: моделируемая карта регистров и символы скрипта компоновщика
+ */
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <signal.h>
+#include <sys/mman.h>
+
+#include "my_host_cmsis.h"
+#include "my_host_sim.h"
+#include "my_stm32f0xx.h"
+#include "my_stm32f0xx_cortex.h"
+#include "my_stm32f0xx_mem.h"
+
+#ifndef MAP_FIXED_NOREPLACE
+	#define MAP_FIXED_NOREPLACE					MAP_FIXED
+#endif
+
+/* Размеры моделируемой памяти, как у STM32F051R8. Без суффикса U: подставляются и в ассемблер */
+#define MY_HOST_RAM_SIZE						0x2000
+#define MY_HOST_STACK_SIZE						0x400
+#define MY_HOST_ARENA_SIZE						0x200
+
+#define MY_HOST_STR(__X__)						MY_HOST_STR2(__X__)
+#define MY_HOST_STR2(__X__)						#__X__
+
+/* Области адресного пространства, к которым обращаются драйверы */
+typedef struct
+{
+	uint32_t	Base;
+	uint32_t	Size;
+}
+MY_HOST_Region_t;
+
+static const MY_HOST_Region_t MY_INT_HOST_Regions[] =
+{
+	{ PERIPH_BASE,		0x00030000U },		/* APB и AHB1: RCC, USART, I2C, DMA, FLASH, DBGMCU */
+	{ AHB2PERIPH_BASE,	0x00002000U },		/* GPIOA..GPIOF */
+	{ SCS_BASE,			0x00001000U },		/* SysTick, NVIC, SCB */
+	{ 0x1FFFF000U,		0x00001000U },		/* Системная память: UID, объём Flash, Option bytes */
+};
+
+volatile uint32_t MY_HOST_PRIMASK = 0;
+volatile uint32_t MY_HOST_MSP = 0;
+volatile uint32_t MY_HOST_IPSR = 0;
+void (*volatile MY_HOST_WFI)(void) = NULL;
+
+/* Пошаговое выполнение: счётчик инструкций и обработчик шага */
+static volatile uint32_t MY_INT_HOST_Stepping = 0;
+static volatile uint32_t MY_INT_HOST_Steps = 0;
+static MY_HOST_Func_t MY_INT_HOST_Hook = NULL;
+
+/* Прерывание для MY_HOST_Preempt_Run() */
+static MY_HOST_Func_t MY_INT_HOST_Isr = NULL;
+static uint32_t MY_INT_HOST_Exception = 0;
+static uint32_t MY_INT_HOST_At = MY_HOST_NEVER;
+static uint32_t MY_INT_HOST_Pending = 0;
+static uint32_t MY_INT_HOST_Taken = MY_HOST_NEVER;
+
+/* Модель RCC: задержки и счётчики инструкций с момента запроса */
+static MY_HOST_RCC_Delays_t MY_INT_HOST_RCC_Delays;
+static uint32_t MY_INT_HOST_RCC_HSE;
+static uint32_t MY_INT_HOST_RCC_PLL;
+static uint32_t MY_INT_HOST_RCC_Switch;
+static uint32_t MY_INT_HOST_RCC_Tick;
+
+/* ОЗУ МК: куча от _end, резерв стека от _sstack до _estack. MSP моделируется вершиной стека */
+__attribute__((aligned(8))) uint32_t MY_HOST_RAM[MY_HOST_RAM_SIZE / 4];
+__attribute__((aligned(8))) uint8_t MY_HOST_Arena[MY_HOST_ARENA_SIZE];
+
+/* Таблица векторов Flash (g_pfnVectors) для MY_NVIC_GetVector() и MY_NVIC_Vectors_Relocate(), тест может её заполнить */
+MY_HOST_Func_t MY_HOST_Vectors[MY_NVIC_VECTORS_COUNT];
+
+/* Символы скрипта компоновщика - адреса внутри массивов выше */
+__asm__
+(
+	".globl _end     \n"
+	".set   _end,    MY_HOST_RAM \n"
+	".globl _estack  \n"
+	".set   _estack, MY_HOST_RAM + " MY_HOST_STR(MY_HOST_RAM_SIZE) " \n"
+	".globl _sstack  \n"
+	".set   _sstack, MY_HOST_RAM + " MY_HOST_STR(MY_HOST_RAM_SIZE) " - " MY_HOST_STR(MY_HOST_STACK_SIZE) " \n"
+	".globl _sarena  \n"
+	".set   _sarena, MY_HOST_Arena \n"
+	".globl _earena  \n"
+	".set   _earena, MY_HOST_Arena + " MY_HOST_STR(MY_HOST_ARENA_SIZE) " \n"
+	".globl g_pfnVectors \n"
+	".set   g_pfnVectors, MY_HOST_Vectors \n"
+);
+
+
+void MY_HOST_Reset(void)
+{
+	uint32_t i;
+
+	for(i = 0; i < (sizeof(MY_INT_HOST_Regions) / sizeof(MY_INT_HOST_Regions[0])); i++)
+	{
+		memset((void *)(uintptr_t)MY_INT_HOST_Regions[i].Base, 0, MY_INT_HOST_Regions[i].Size);
+	}
+
+	/* Значения регистров после сброса, от которых зависят драйверы */
+	RCC->CR = RCC_CR_HSION | RCC_CR_HSIRDY;
+	RCC->CSR = 0x0C000000U;
+	USART1->ISR = USART_ISR_TXE | USART_ISR_TC;
+	USART2->ISR = USART_ISR_TXE | USART_ISR_TC;
+	I2C1->ISR = I2C_ISR_TXE;
+	I2C2->ISR = I2C_ISR_TXE;
+
+	/* Свободное ОЗУ закрашено, как после Reset_Handler */
+	for(i = 0; i < (MY_HOST_RAM_SIZE / 4); i++)
+	{
+		MY_HOST_RAM[i] = MEM_PAINT_PATTERN;
+	}
+
+	MY_HOST_MSP = (uint32_t)(uintptr_t)&MY_HOST_RAM[MY_HOST_RAM_SIZE / 4];
+	MY_HOST_PRIMASK = 0;
+	MY_HOST_IPSR = 0;
+	MY_HOST_WFI = NULL;
+
+	MY_HOST_RCC_Config(&(MY_HOST_RCC_Delays_t){ 0 });
+}
+
+
+void MY_HOST_RCC_Config(const MY_HOST_RCC_Delays_t *Delays)
+{
+	MY_INT_HOST_RCC_Delays = *Delays;
+
+	MY_INT_HOST_RCC_HSE = 0;
+	MY_INT_HOST_RCC_PLL = 0;
+	MY_INT_HOST_RCC_Switch = 0;
+	MY_INT_HOST_RCC_Tick = 0;
+}
+
+
+/* Генератор готов через Delay инструкций после включения, выключение сбрасывает готовность */
+static uint32_t MY_INT_HOST_RCC_Osc(uint32_t Cr, uint32_t On, uint32_t Ready, uint32_t Source, uint32_t *Count, uint32_t Delay)
+{
+	if((Cr & On) == 0U)
+	{
+		*Count = 0;
+
+		return Cr & ~Ready;
+	}
+
+	if(((Cr & Ready) == 0U) && Source && (Delay != MY_HOST_NEVER) && (++(*Count) >= Delay))
+	{
+		Cr |= Ready;
+	}
+
+	return Cr;
+}
+
+
+void MY_HOST_RCC_Hook(void)
+{
+	uint32_t cr = RCC->CR;
+	uint32_t cfgr = RCC->CFGR;
+	uint32_t sw = cfgr & RCC_CFGR_SW;
+	uint32_t ready;
+
+	cr = (cr & RCC_CR_HSION) ? (cr | RCC_CR_HSIRDY) : (cr & ~RCC_CR_HSIRDY);
+	cr = MY_INT_HOST_RCC_Osc(cr, RCC_CR_HSEON, RCC_CR_HSERDY, 1U, &MY_INT_HOST_RCC_HSE, MY_INT_HOST_RCC_Delays.HSE);
+
+	/* PLL захватывается только от готового источника */
+	ready = ((cfgr & RCC_CFGR_PLLSRC) == RCC_CFGR_PLLSRC_HSE_PREDIV) ? (cr & RCC_CR_HSERDY) : (cr & RCC_CR_HSIRDY);
+	cr = MY_INT_HOST_RCC_Osc(cr, RCC_CR_PLLON, RCC_CR_PLLRDY, ready, &MY_INT_HOST_RCC_PLL, MY_INT_HOST_RCC_Delays.PLL);
+
+	RCC->CR = cr;
+
+	/* Переключение SYSCLK: SWS повторяет SW, когда выбранный источник готов */
+	if(((cfgr & RCC_CFGR_SWS) >> RCC_CFGR_SWS_Pos) != sw)
+	{
+		ready = (sw == RCC_CFGR_SW_HSE) ? (cr & RCC_CR_HSERDY) : (sw == RCC_CFGR_SW_PLL) ? (cr & RCC_CR_PLLRDY) : (cr & RCC_CR_HSIRDY);
+
+		if(ready && (++MY_INT_HOST_RCC_Switch >= MY_INT_HOST_RCC_Delays.Switch))
+		{
+			RCC->CFGR = (cfgr & ~RCC_CFGR_SWS) | (sw << RCC_CFGR_SWS_Pos);
+
+			MY_INT_HOST_RCC_Switch = 0;
+		}
+	}
+
+	if((MY_INT_HOST_RCC_Delays.Tick != 0U) && (++MY_INT_HOST_RCC_Tick >= MY_INT_HOST_RCC_Delays.Tick))
+	{
+		MY_INT_HOST_RCC_Tick = 0;
+
+		MY_SysTick_IncTick();
+	}
+}
+
+
+/* SIGTRAP после каждой инструкции при установленном TF. Обработчик сигнала выполняется без TF */
+static void MY_INT_HOST_Trap(int Signal, siginfo_t *Info, void *Context)
+{
+	(void)Signal;
+	(void)Info;
+	(void)Context;
+
+	if(!MY_INT_HOST_Stepping)
+	{
+		return;
+	}
+
+	if(MY_INT_HOST_Hook != NULL)
+	{
+		MY_INT_HOST_Hook();
+	}
+
+	MY_INT_HOST_Steps++;
+}
+
+
+uint32_t MY_HOST_Step_Run(MY_HOST_Func_t Func, MY_HOST_Func_t Hook)
+{
+	MY_INT_HOST_Hook = Hook;
+	MY_INT_HOST_Steps = 0;
+
+	/* TF: ловушка после каждой инструкции до его сброса */
+	__asm volatile ("pushfq \n orq $0x100, (%%rsp) \n popfq" ::: "memory", "cc");
+
+	MY_INT_HOST_Stepping = 1;
+
+	Func();
+
+	MY_INT_HOST_Stepping = 0;
+
+	__asm volatile ("pushfq \n andq $-0x101, (%%rsp) \n popfq" ::: "memory", "cc");
+
+	MY_INT_HOST_Hook = NULL;
+
+	return MY_INT_HOST_Steps;
+}
+
+
+uint32_t MY_HOST_Step_Count(void)
+{
+	return MY_INT_HOST_Steps;
+}
+
+
+/* Вход в обработчик: как на ядре, PRIMASK не меняется, IPSR - номер исключения */
+static void MY_INT_HOST_Enter(void)
+{
+	uint32_t ipsr = MY_HOST_IPSR;
+
+	MY_INT_HOST_Pending = 0;
+	MY_HOST_IPSR = MY_INT_HOST_Exception;
+
+	MY_INT_HOST_Isr();
+
+	MY_HOST_IPSR = ipsr;
+}
+
+
+static void MY_INT_HOST_PreemptHook(void)
+{
+	if(MY_INT_HOST_Steps == MY_INT_HOST_At)
+	{
+		MY_INT_HOST_Pending = 1;
+	}
+
+	if(MY_INT_HOST_Pending && (MY_HOST_PRIMASK == 0U))
+	{
+		MY_INT_HOST_Taken = MY_INT_HOST_Steps;
+
+		MY_INT_HOST_Enter();
+	}
+}
+
+
+uint32_t MY_HOST_Preempt_Run(MY_HOST_Func_t Thread, MY_HOST_Func_t Isr, uint32_t Exception, uint32_t At)
+{
+	uint32_t steps;
+
+	MY_INT_HOST_Isr = Isr;
+	MY_INT_HOST_Exception = Exception;
+	MY_INT_HOST_At = At;
+	MY_INT_HOST_Pending = 0;
+	MY_INT_HOST_Taken = MY_HOST_NEVER;
+
+	steps = MY_HOST_Step_Run(Thread, MY_INT_HOST_PreemptHook);
+
+	/* Запрос на последней инструкции или под PRIMASK до конца потока */
+	if(MY_INT_HOST_Pending || ((At != MY_HOST_NEVER) && (At >= steps)))
+	{
+		MY_INT_HOST_Enter();
+	}
+
+	MY_INT_HOST_At = MY_HOST_NEVER;
+
+	return steps;
+}
+
+
+uint32_t MY_HOST_Preempt_Taken(void)
+{
+	return MY_INT_HOST_Taken;
+}
+
+
+/* Выполняется до main(): отображает области периферии на их адреса */
+__attribute__((constructor)) static void MY_INT_HOST_Init(void)
+{
+	struct sigaction action;
+	uint32_t i;
+	void *area;
+
+	for(i = 0; i < (sizeof(MY_INT_HOST_Regions) / sizeof(MY_INT_HOST_Regions[0])); i++)
+	{
+		area = mmap((void *)(uintptr_t)MY_INT_HOST_Regions[i].Base, MY_INT_HOST_Regions[i].Size, PROT_READ | PROT_WRITE,
+					MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+
+		if(area != (void *)(uintptr_t)MY_INT_HOST_Regions[i].Base)
+		{
+			fprintf(stderr, "host: cannot map 0x%08lX\n", (unsigned long)MY_INT_HOST_Regions[i].Base);
+
+			exit(EXIT_FAILURE);
+		}
+	}
+
+	memset(&action, 0, sizeof(action));
+	action.sa_sigaction = MY_INT_HOST_Trap;
+	action.sa_flags = SA_SIGINFO;
+	sigemptyset(&action.sa_mask);
+	sigaction(SIGTRAP, &action, NULL);
+
+	MY_HOST_Reset();
+}
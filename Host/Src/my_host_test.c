@@ -0,0 +1,54 @@
+/**
+ * @author  Андрей Заостровных
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Сборка библиотеки на ПК: проверки для тестов make host-test
+ */
+#include "my_host_test.h"
+
+static uint32_t MY_INT_HOST_TEST_Checks = 0;
+static uint32_t MY_INT_HOST_TEST_Failed = 0;
+
+
+uint32_t MY_HOST_TEST_Check(uint32_t Passed, const char *File, int Line, const char *Text)
+{
+	MY_INT_HOST_TEST_Checks++;
+
+	if(!Passed)
+	{
+		MY_INT_HOST_TEST_Failed++;
+
+		printf("%s:%d: FAIL %s\n", File, Line, Text);
+	}
+
+	return Passed;
+}
+
+
+uint32_t MY_HOST_TEST_Equal(uint64_t Actual, uint64_t Expected, const char *File, int Line, const char *Text)
+{
+	MY_INT_HOST_TEST_Checks++;
+
+	if(Actual != Expected)
+	{
+		MY_INT_HOST_TEST_Failed++;
+
+		printf("%s:%d: FAIL %s (0x%llX, expected 0x%llX)\n", File, Line, Text,
+			   (unsigned long long)Actual, (unsigned long long)Expected);
+
+		return 0;
+	}
+
+	return 1;
+}
+
+
+int MY_HOST_TEST_Report(const char *Name)
+{
+	printf("%s: %lu checks, %lu failed\n", Name, (unsigned long)MY_INT_HOST_TEST_Checks,
+		   (unsigned long)MY_INT_HOST_TEST_Failed);
+
+	return (MY_INT_HOST_TEST_Failed == 0U) ? 0 : 1;
+}
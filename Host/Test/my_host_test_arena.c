@@ -0,0 +1,325 @@
+/**
+ * @author  Андрей Заостровных
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/arena
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Тест MY_ARENA: выравнивание, переполнение и MY_ARENA_FailureCallback(), максимумы
+ * 			вложенных областей, освобождение к устаревшей отметке
+ */
+
+#include <string.h>
+#include "my_host_test.h"
+#include "my_stm32f0xx_arena.h"
+
+/* Границы арены (my_host_sim.c) */
+extern uint8_t _sarena[];
+extern uint8_t _earena[];
+
+/* Вызовы MY_ARENA_FailureCallback() */
+static uint32_t MY_INT_TEST_Failures;
+static uint32_t MY_INT_TEST_FailSize;
+static uint32_t MY_INT_TEST_FailFree;
+
+
+void MY_ARENA_FailureCallback(uint32_t Size, uint32_t Free)
+{
+	MY_INT_TEST_Failures++;
+	MY_INT_TEST_FailSize = Size;
+	MY_INT_TEST_FailFree = Free;
+}
+
+
+static MY_ARENA_Stats_t MY_INT_TEST_Stats(void)
+{
+	MY_ARENA_Stats_t stats;
+
+	MY_ARENA_GetStats(&stats);
+
+	return stats;
+}
+
+
+/* Отчёт области по имени */
+static const MY_ARENA_Scope_t* MY_INT_TEST_Scope(const char *Name)
+{
+	const MY_ARENA_Scope_t *scope;
+	uint32_t i;
+
+	for(i = 0; (scope = MY_ARENA_GetScope(i)) != NULL; i++)
+	{
+		if(strcmp(scope->Name, Name) == 0)
+		{
+			return scope;
+		}
+	}
+
+	return NULL;
+}
+
+
+static void MY_INT_TEST_Setup(void)
+{
+	MY_ARENA_Init();
+
+	MY_INT_TEST_Failures = 0;
+	MY_INT_TEST_FailSize = 0;
+	MY_INT_TEST_FailFree = 0;
+}
+
+
+/* Выравнивается абсолютный адрес, по умолчанию ARENA_ALIGN. Неверное выравнивание - NULL без учёта отказа */
+static void MY_INT_TEST_Align(void)
+{
+	uint8_t *a;
+	uint8_t *b;
+	uint8_t *c;
+
+	MY_INT_TEST_Setup();
+
+	a = MY_ARENA_Alloc(1U);
+	b = MY_ARENA_Alloc(1U);
+
+	MY_HOST_CHECK(a == _sarena);
+	MY_HOST_EQUAL(b - a, ARENA_ALIGN);
+	MY_HOST_EQUAL(MY_ARENA_Mark(), ARENA_ALIGN + 1U);
+
+	/* Без выравнивания - вплотную */
+	c = MY_ARENA_AllocAligned(3U, 1U);
+	MY_HOST_CHECK(c == b + 1U);
+
+	/* Выравнивание больше выравнивания самой арены: пропуск считается от адреса */
+	c = MY_ARENA_AllocAligned(5U, 64U);
+
+	MY_HOST_EQUAL((uintptr_t)c & 63U, 0U);
+	MY_HOST_CHECK((c > b) && (c - b <= 64));
+	MY_HOST_EQUAL(MY_ARENA_Mark(), (uint32_t)(c - _sarena) + 5U);
+
+	a = MY_ARENA_AllocAligned(0U, 8U);
+
+	MY_HOST_EQUAL((uintptr_t)a & 7U, 0U);
+	MY_HOST_EQUAL(MY_ARENA_Mark(), (uint32_t)(a - _sarena));
+
+	MY_HOST_CHECK(MY_ARENA_AllocAligned(4U, 0U) == NULL);
+	MY_HOST_CHECK(MY_ARENA_AllocAligned(4U, 12U) == NULL);
+	MY_HOST_EQUAL(MY_INT_TEST_Stats().Failed, 0U);
+	MY_HOST_EQUAL(MY_INT_TEST_Failures, 0U);
+}
+
+
+/* Переполнение: NULL, вершина не меняется, MY_ARENA_FailureCallback() получает запрос с выравниванием и остаток */
+static void MY_INT_TEST_Overflow(void)
+{
+	uint32_t size = (uint32_t)(_earena - _sarena);
+	uint8_t *a;
+
+	MY_INT_TEST_Setup();
+
+	MY_HOST_EQUAL(MY_INT_TEST_Stats().Size, size);
+	MY_HOST_EQUAL(MY_ARENA_GetFree(), size);
+
+	a = MY_ARENA_Alloc(size - 8U);
+	MY_HOST_CHECK(a == _sarena);
+
+	MY_HOST_CHECK(MY_ARENA_Alloc(9U) == NULL);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Failures, 1U);
+	MY_HOST_EQUAL(MY_INT_TEST_FailSize, 9U);
+	MY_HOST_EQUAL(MY_INT_TEST_FailFree, 8U);
+	MY_HOST_EQUAL(MY_ARENA_Mark(), size - 8U);
+
+	/* Пропуск на выравнивание входит в запрос */
+	MY_HOST_CHECK(MY_ARENA_AllocAligned(1U, 1U) != NULL);
+	MY_HOST_CHECK(MY_ARENA_AllocAligned(6U, 4U) == NULL);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Failures, 2U);
+	MY_HOST_EQUAL(MY_INT_TEST_FailSize, 3U + 6U);
+	MY_HOST_EQUAL(MY_INT_TEST_FailFree, 7U);
+
+	/* Размер, при котором конец переходит через 0 */
+	MY_HOST_CHECK(MY_ARENA_Alloc(0xFFFFFFFFU) == NULL);
+	MY_HOST_CHECK(MY_ARENA_AllocAligned(0xFFFFFFF0U, 16U) == NULL);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Failures, 4U);
+	MY_HOST_EQUAL(MY_INT_TEST_Stats().Failed, 4U);
+	MY_HOST_EQUAL(MY_ARENA_Mark(), size - 7U);
+
+	/* Остаток выделяется целиком */
+	MY_HOST_CHECK(MY_ARENA_AllocAligned(7U, 1U) == _sarena + size - 7U);
+	MY_HOST_EQUAL(MY_ARENA_GetFree(), 0U);
+	MY_HOST_EQUAL(MY_INT_TEST_Stats().Peak, size);
+	MY_HOST_EQUAL(MY_INT_TEST_Failures, 4U);
+
+	/* MY_ARENA_Init() освобождает всё и сбрасывает статистику */
+	MY_ARENA_Init();
+
+	MY_HOST_EQUAL(MY_INT_TEST_Stats().Used, 0U);
+	MY_HOST_EQUAL(MY_INT_TEST_Stats().Peak, 0U);
+	MY_HOST_EQUAL(MY_INT_TEST_Stats().Failed, 0U);
+}
+
+
+/* Внутренняя область: выделяет Size байт, Fail - дополнительно запрос больше арены */
+static void MY_INT_TEST_Inner(uint32_t Size, uint32_t Fail)
+{
+	MY_ARENA_SCOPE_BEGIN(Inner);
+
+	MY_HOST_CHECK(MY_ARENA_Alloc(Size) != NULL);
+
+	if(Fail)
+	{
+		MY_HOST_CHECK(MY_ARENA_Alloc(0x10000U) == NULL);
+	}
+
+	MY_ARENA_SCOPE_END(Inner);
+}
+
+
+/* Внешняя область: Before байт, внутренняя область, After байт */
+static void MY_INT_TEST_Outer(uint32_t Before, uint32_t Inner, uint32_t After, uint32_t Fail)
+{
+	MY_ARENA_SCOPE_BEGIN(Outer);
+
+	MY_HOST_CHECK(MY_ARENA_Alloc(Before) != NULL);
+
+	MY_INT_TEST_Inner(Inner, Fail);
+
+	MY_HOST_CHECK(MY_ARENA_Alloc(After) != NULL);
+
+	MY_ARENA_SCOPE_END(Outer);
+}
+
+
+/* Область, которая освобождает свой буфер до вложенной области */
+static void MY_INT_TEST_Freed(void)
+{
+	MY_ARENA_Mark_t mark;
+
+	MY_ARENA_SCOPE_BEGIN(Freed);
+
+	mark = MY_ARENA_Mark();
+	MY_HOST_CHECK(MY_ARENA_Alloc(100U) != NULL);
+	MY_HOST_EQUAL(MY_ARENA_Release(mark), MY_Result_Ok);
+
+	MY_INT_TEST_Inner(10U, 0U);
+
+	MY_ARENA_SCOPE_END(Freed);
+}
+
+
+/* Максимум внешней области включает максимум внутренней, даже если та уже освобождена */
+static void MY_INT_TEST_Scopes(void)
+{
+	const MY_ARENA_Scope_t *outer;
+	const MY_ARENA_Scope_t *inner;
+	uint8_t *base;
+
+	MY_INT_TEST_Setup();
+
+	/* Выделение до областей не относится к ним */
+	base = MY_ARENA_Alloc(16U);
+
+	MY_INT_TEST_Outer(32U, 64U, 16U, 0U);
+
+	outer = MY_INT_TEST_Scope("Outer");
+	inner = MY_INT_TEST_Scope("Inner");
+
+	MY_HOST_CHECK((outer != NULL) && (inner != NULL));
+
+	if((outer == NULL) || (inner == NULL))
+	{
+		return;
+	}
+
+	MY_HOST_EQUAL(outer->Count, 1U);
+	MY_HOST_EQUAL(outer->Last, 32U + 64U);
+	MY_HOST_EQUAL(inner->Last, 64U);
+	MY_HOST_EQUAL(MY_ARENA_Mark(), 16U);
+	MY_HOST_EQUAL(MY_INT_TEST_Stats().Peak, 16U + 32U + 64U);
+
+	/* Второй проход: после внутренней области внешняя выделяет больше, чем та занимала */
+	MY_INT_TEST_Outer(8U, 24U, 100U, 0U);
+
+	MY_HOST_EQUAL(outer->Count, 2U);
+	MY_HOST_EQUAL(outer->Last, 8U + 100U);
+	MY_HOST_EQUAL(outer->Peak, 8U + 100U);
+	MY_HOST_EQUAL(inner->Count, 2U);
+	MY_HOST_EQUAL(inner->Last, 24U);
+	MY_HOST_EQUAL(inner->Peak, 64U);
+
+	/* Отказ внутри внутренней области учитывается в обеих */
+	MY_INT_TEST_Outer(4U, 4U, 4U, 1U);
+
+	MY_HOST_EQUAL(inner->Failed, 1U);
+	MY_HOST_EQUAL(outer->Failed, 1U);
+	MY_HOST_EQUAL(outer->Last, 4U + 4U);
+	MY_HOST_EQUAL(MY_INT_TEST_Failures, 1U);
+
+	/* Внутренняя область вне внешней: внешняя не меняется */
+	MY_INT_TEST_Inner(200U, 0U);
+
+	MY_HOST_EQUAL(inner->Count, 4U);
+	MY_HOST_EQUAL(inner->Peak, 200U);
+	MY_HOST_EQUAL(outer->Count, 3U);
+	MY_HOST_EQUAL(outer->Peak, 8U + 100U);
+
+	MY_HOST_EQUAL(MY_ARENA_Mark(), 16U);
+	MY_HOST_CHECK(MY_ARENA_Alloc(4U) == base + 16U);
+
+	/* Внутренняя область после освобождения внутри внешней не стирает её прежний максимум */
+	MY_INT_TEST_Freed();
+
+	MY_HOST_EQUAL(MY_INT_TEST_Scope("Freed")->Last, 100U);
+	MY_HOST_EQUAL(inner->Last, 10U);
+
+	/* MY_ARENA_Init() обнуляет отчёты, области остаются зарегистрированными */
+	MY_ARENA_Init();
+
+	MY_HOST_CHECK(MY_INT_TEST_Scope("Outer") == outer);
+	MY_HOST_EQUAL(outer->Count, 0U);
+	MY_HOST_EQUAL(inner->Peak, 0U);
+}
+
+
+/* Отметка выше вершины - область уже освобождена: ошибка, вершина не меняется */
+static void MY_INT_TEST_Release(void)
+{
+	MY_ARENA_Mark_t outer;
+	MY_ARENA_Mark_t inner;
+	uint8_t *a;
+
+	MY_INT_TEST_Setup();
+
+	outer = MY_ARENA_Mark();
+	a = MY_ARENA_Alloc(40U);
+
+	inner = MY_ARENA_Mark();
+	MY_HOST_CHECK(MY_ARENA_Alloc(20U) != NULL);
+
+	MY_HOST_EQUAL(MY_ARENA_Release(outer), MY_Result_Ok);
+	MY_HOST_EQUAL(MY_ARENA_Mark(), 0U);
+
+	MY_HOST_EQUAL(MY_ARENA_Release(inner), MY_Result_Error);
+	MY_HOST_EQUAL(MY_ARENA_Mark(), 0U);
+
+	/* Освобождённая память выделяется снова, повторное освобождение к той же отметке допустимо */
+	MY_HOST_CHECK(MY_ARENA_Alloc(8U) == a);
+	MY_HOST_EQUAL(MY_ARENA_Release(outer), MY_Result_Ok);
+	MY_HOST_EQUAL(MY_ARENA_Release(outer), MY_Result_Ok);
+	MY_HOST_EQUAL(MY_ARENA_GetFree(), (uint32_t)(_earena - _sarena));
+
+	/* Максимум не уменьшается освобождением */
+	MY_HOST_EQUAL(MY_INT_TEST_Stats().Peak, 60U);
+	MY_HOST_EQUAL(MY_INT_TEST_Stats().Used, 0U);
+}
+
+
+int main(void)
+{
+	MY_HOST_RUN(MY_INT_TEST_Align);
+	MY_HOST_RUN(MY_INT_TEST_Overflow);
+	MY_HOST_RUN(MY_INT_TEST_Scopes);
+	MY_HOST_RUN(MY_INT_TEST_Release);
+
+	return MY_HOST_TEST_Report("arena");
+}
@@ -0,0 +1,233 @@
+/**
+ * @author  Андрей Заостровных
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/boot
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Тест последовательности загрузки на модели RCC с задержками готовности
+ */
+
+/* Метки этапов включены только здесь: драйверы с ними собираются в этом файле */
+#define BOOT_TIMESTAMP_ENABLE					1U
+
+#include "my_host_test.h"
+#include "../../Drivers/MY/Src/my_stm32f0xx_boot.c"
+#include "../../Drivers/MY/Src/my_stm32f0xx_rcc.c"
+#include "../../Drivers/MY/Src/my_stm32f0xx.c"
+
+/* Инструкций на тик SysTick в модели */
+#define MY_INT_TEST_TICK						100U
+
+/* Инициализация .data/.bss в Reset_Handler */
+#define MY_INT_TEST_MEMINIT_WORDS				256U
+
+static volatile uint32_t MY_INT_TEST_Ram[MY_INT_TEST_MEMINIT_WORDS];
+
+static MY_Result_t MY_INT_TEST_Result;
+
+/* Наблюдения обработчика шага */
+static uint32_t MY_INT_TEST_HSEOn;
+static uint32_t MY_INT_TEST_HSEStops;
+static uint32_t MY_INT_TEST_LatencyErrors;
+static uint32_t MY_INT_TEST_MemInit;
+
+
+static void MY_INT_TEST_Hook(void)
+{
+	uint32_t hse = RCC->CR & RCC_CR_HSEON;
+
+	/* Включение HSE и его повторный запуск */
+	if(hse && (MY_INT_TEST_HSEOn == MY_HOST_NEVER))
+	{
+		MY_INT_TEST_HSEOn = MY_HOST_Step_Count();
+	}
+
+	MY_HOST_RCC_Hook();
+
+	if(hse && !(RCC->CR & RCC_CR_HSEON))
+	{
+		MY_INT_TEST_HSEStops++;
+	}
+
+	/* 48 МГц от PLL без задержки Flash */
+	if(((RCC->CFGR & RCC_CFGR_SWS) == RCC_CFGR_SWS_PLL) && !(FLASH->ACR & FLASH_ACR_LATENCY))
+	{
+		MY_INT_TEST_LatencyErrors++;
+	}
+
+	/* TIM2 считает такты: 8 на инструкцию */
+	if(TIM2->CR1 & TIM_CR1_CEN)
+	{
+		TIM2->CNT += 8U;
+	}
+}
+
+
+/* Reset_Handler: EarlyInit, .data/.bss, MY_System_Init(), вход в main() */
+static void MY_INT_TEST_Boot(void)
+{
+	uint32_t i;
+
+	MY_BOOT_EarlyInit();
+
+	for(i = 0; i < MY_INT_TEST_MEMINIT_WORDS; i++)
+	{
+		MY_INT_TEST_Ram[i] = 0;
+	}
+
+	MY_BOOT_Timestamp(MY_BOOT_Phase_MemInit);
+	MY_INT_TEST_MemInit = MY_HOST_Step_Count();
+
+	MY_INT_TEST_Result = MY_System_Init();
+
+	MY_BOOT_Timestamp(MY_BOOT_Phase_Main);
+}
+
+
+/* Загрузка с заданными задержками, возвращает число инструкций */
+static uint32_t MY_INT_TEST_Run(uint32_t Hse, uint32_t Pll, uint32_t Switch)
+{
+	MY_HOST_RCC_Config(&(MY_HOST_RCC_Delays_t){ .HSE = Hse, .PLL = Pll, .Switch = Switch, .Tick = MY_INT_TEST_TICK });
+
+	memset(MY_INT_BOOT_Timestamps, 0, sizeof(MY_INT_BOOT_Timestamps));
+	MY_INT_BOOT_LastCount = 0;
+	MY_INT_BOOT_LastClock = 0;
+	MY_INT_BOOT_Elapsed = 0;
+
+	MY_INT_TEST_HSEOn = MY_HOST_NEVER;
+	MY_INT_TEST_HSEStops = 0;
+	MY_INT_TEST_LatencyErrors = 0;
+
+	return MY_HOST_Step_Run(MY_INT_TEST_Boot, MY_INT_TEST_Hook);
+}
+
+
+static void MY_INT_TEST_CheckBooted(void)
+{
+	uint32_t phase;
+
+	MY_HOST_EQUAL(MY_INT_TEST_Result, MY_Result_Ok);
+	MY_HOST_EQUAL(RCC->CFGR & RCC_CFGR_SWS, RCC_CFGR_SWS_PLL);
+	MY_HOST_EQUAL(SystemCoreClock, RCC_STATIC_SYSCLK);
+	MY_HOST_EQUAL(MY_INT_TEST_LatencyErrors, 0U);
+
+	/* HSE включён до инициализации RAM и не перезапускался */
+	MY_HOST_CHECK(MY_INT_TEST_HSEOn < MY_INT_TEST_MemInit);
+	MY_HOST_EQUAL(MY_INT_TEST_HSEStops, 0U);
+
+	/* Метки всех этапов, по возрастанию */
+	for(phase = MY_BOOT_Phase_MemInit; phase < MY_BOOT_Phase_Count; phase++)
+	{
+		MY_HOST_CHECK(MY_BOOT_GetTimestamp(phase) != 0U);
+		MY_HOST_CHECK(MY_BOOT_GetTimestamp(phase) >= MY_BOOT_GetTimestamp(phase - 1U));
+	}
+
+	/* TIM2 возвращён в состояние после сброса */
+	MY_HOST_EQUAL(TIM2->CR1, 0U);
+	MY_HOST_EQUAL(RCC->APB1ENR & RCC_APB1ENR_TIM2EN, 0U);
+}
+
+
+/* Время от MY_System_Init() до готовности HSE */
+static uint32_t MY_INT_TEST_HSEWait(void)
+{
+	return MY_BOOT_GetTimestamp(MY_BOOT_Phase_HSEReady) - MY_BOOT_GetTimestamp(MY_BOOT_Phase_SystemInit);
+}
+
+
+/* Кварц успевает за инициализацию RAM: MY_RCC_System_Init() ждёт его не дольше, чем мгновенно готовый */
+static void MY_INT_TEST_Overlap(void)
+{
+	uint32_t ready;
+
+	MY_INT_TEST_Run(0U, 20U, 4U);
+	MY_INT_TEST_CheckBooted();
+
+	ready = MY_INT_TEST_HSEWait();
+
+	MY_HOST_Reset();
+
+	MY_INT_TEST_Run(MY_INT_TEST_MEMINIT_WORDS, 20U, 4U);
+	MY_INT_TEST_CheckBooted();
+
+	MY_HOST_EQUAL(MY_INT_TEST_HSEWait(), ready);
+}
+
+
+/* Медленный кварц: ожидание после MY_System_Init() растёт вместе с задержкой */
+static void MY_INT_TEST_Delays(void)
+{
+	static const uint32_t hse[] = { 0U, 100U, 2000U, 5000U, 9000U };
+	uint32_t last = 0;
+	uint32_t steps;
+	uint32_t i;
+
+	for(i = 0; i < (sizeof(hse) / sizeof(hse[0])); i++)
+	{
+		MY_HOST_Reset();
+
+		steps = MY_INT_TEST_Run(hse[i], 20U, 4U);
+		MY_INT_TEST_CheckBooted();
+
+		MY_HOST_CHECK(steps >= last);
+		MY_HOST_CHECK(steps >= hse[i]);
+
+		last = steps;
+	}
+
+	/* Кварц, не успевший за инициализацию RAM, виден между SystemInit и HSEReady */
+	MY_HOST_CHECK(MY_INT_TEST_HSEWait() > 1000U);
+}
+
+
+/* HSE не запускается: таймаут HSE_TIMEOUT_VALUE, SYSCLK остаётся от HSI */
+static void MY_INT_TEST_HSEFail(void)
+{
+	uint32_t tickstart = MY_SysTick_GetTick();
+
+	MY_INT_TEST_Run(MY_HOST_NEVER, 20U, 4U);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Result, MY_Result_Error);
+	MY_HOST_EQUAL(RCC->CFGR & RCC_CFGR_SWS, RCC_CFGR_SWS_HSI);
+	MY_HOST_EQUAL(RCC->CR & RCC_CR_PLLON, 0U);
+	MY_HOST_CHECK(MY_SysTick_GetTick() - tickstart > HSE_TIMEOUT_VALUE);
+	MY_HOST_EQUAL(MY_BOOT_GetTimestamp(MY_BOOT_Phase_HSEReady), 0U);
+}
+
+
+/* PLL не захватывается: таймаут PLL_TIMEOUT_VALUE */
+static void MY_INT_TEST_PLLFail(void)
+{
+	MY_INT_TEST_Run(10U, MY_HOST_NEVER, 4U);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Result, MY_Result_Error);
+	MY_HOST_EQUAL(RCC->CFGR & RCC_CFGR_SWS, RCC_CFGR_SWS_HSI);
+	MY_HOST_CHECK(MY_BOOT_GetTimestamp(MY_BOOT_Phase_HSEReady) != 0U);
+	MY_HOST_EQUAL(MY_BOOT_GetTimestamp(MY_BOOT_Phase_PLLReady), 0U);
+}
+
+
+/* Программный перезапуск с работающим PLL: RCC сбрасывается и загрузка повторяется */
+static void MY_INT_TEST_Warm(void)
+{
+	MY_INT_TEST_Run(10U, 20U, 4U);
+	MY_INT_TEST_CheckBooted();
+
+	MY_INT_TEST_Run(10U, 20U, 4U);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Result, MY_Result_Ok);
+	MY_HOST_EQUAL(RCC->CFGR & RCC_CFGR_SWS, RCC_CFGR_SWS_PLL);
+	MY_HOST_EQUAL(MY_INT_TEST_LatencyErrors, 0U);
+}
+
+
+int main(void)
+{
+	MY_HOST_RUN(MY_INT_TEST_Overlap);
+	MY_HOST_RUN(MY_INT_TEST_Delays);
+	MY_HOST_RUN(MY_INT_TEST_HSEFail);
+	MY_HOST_RUN(MY_INT_TEST_PLLFail);
+	MY_HOST_RUN(MY_INT_TEST_Warm);
+
+	return MY_HOST_TEST_Report("boot");
+}
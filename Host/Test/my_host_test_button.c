@@ -0,0 +1,344 @@
+/**
+ * @author  Андрей Заостровных
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/button
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Тест MY_BUTTON: вертикальный счётчик и очередь событий
+ */
+#include "my_host_test.h"
+#include "my_stm32f0xx_button.h"
+#include "my_stm32f0xx_cortex.h"
+
+/* Кнопки на GPIOA: PA0 - нажатие высоким уровнем, PA1 - низким */
+static uint8_t MY_INT_TEST_Button0;
+static uint8_t MY_INT_TEST_Button1;
+
+
+/* Выставляет уровни и выполняет один отсчёт */
+static void MY_INT_TEST_Sample(uint16_t Idr)
+{
+	GPIOA->IDR = Idr;
+
+	MY_BUTTON_Sample();
+}
+
+
+static uint32_t MY_INT_TEST_Drain(void)
+{
+	MY_BUTTON_Event_t event;
+	uint32_t count = 0;
+
+	while(MY_BUTTON_GetEvent(&event) == MY_Result_Ok)
+	{
+		count++;
+	}
+
+	return count;
+}
+
+
+/* Переключение ровно на 4-м одинаковом отсчёте, каждый пин независимо */
+static void MY_INT_TEST_Debounce(void)
+{
+	MY_BUTTON_Port_t port = { .GPIOx = GPIOA, .Mask = 0xFFFFU };
+	uint32_t pin;
+	uint32_t n;
+
+	for(n = 1; n <= 3U; n++)
+	{
+		MY_HOST_EQUAL(MY_BUTTON_Debounce(&port, 0x0001U), 0U);
+	}
+
+	MY_HOST_EQUAL(MY_BUTTON_Debounce(&port, 0x0001U), 0x0001U);
+	MY_HOST_EQUAL(port.State, 0x0001U);
+
+	/* Устойчивое значение больше не переключает */
+	MY_HOST_EQUAL(MY_BUTTON_Debounce(&port, 0x0001U), 0U);
+
+	/* Три отсчёта дребезга и возврат: счётчик сбрасывается, следующие 3 отсчёта тоже не переключают */
+	MY_BUTTON_Debounce(&port, 0x0000U);
+	MY_BUTTON_Debounce(&port, 0x0000U);
+	MY_BUTTON_Debounce(&port, 0x0000U);
+	MY_HOST_EQUAL(MY_BUTTON_Debounce(&port, 0x0001U), 0U);
+
+	for(n = 1; n <= 3U; n++)
+	{
+		MY_HOST_EQUAL(MY_BUTTON_Debounce(&port, 0x0000U), 0U);
+	}
+
+	MY_HOST_EQUAL(MY_BUTTON_Debounce(&port, 0x0000U), 0x0001U);
+	MY_HOST_EQUAL(port.State, 0x0000U);
+
+	/* 16 пинов со сдвигом начала на 1 отсчёт: пин k переключается на отсчёте k + 4 */
+	for(n = 1; n <= 20U; n++)
+	{
+		uint16_t sample = (uint16_t)((n >= 16U) ? 0xFFFFU : ((1UL << n) - 1U));
+		uint16_t expect = (n >= 4U) && (n - 4U < 16U) ? (uint16_t)(1UL << (n - 4U)) : 0U;
+
+		MY_HOST_EQUAL(MY_BUTTON_Debounce(&port, sample), expect);
+	}
+
+	MY_HOST_EQUAL(port.State, 0xFFFFU);
+
+	/* Пины вне маски не участвуют */
+	port.Mask = 0x00F0U;
+	port.State = 0;
+
+	for(pin = 0; pin < 4U; pin++)
+	{
+		MY_BUTTON_Debounce(&port, 0xFFFFU);
+	}
+
+	MY_HOST_EQUAL(port.State, 0x00F0U);
+
+	/* Invert: нажатие - низкий уровень */
+	port.Mask = 0x0001U;
+	port.Invert = 0x0001U;
+	port.State = 0;
+	port.Cnt0 = 0;
+	port.Cnt1 = 0;
+
+	for(n = 0; n < 4U; n++)
+	{
+		MY_BUTTON_Debounce(&port, 0x0000U);
+	}
+
+	MY_HOST_EQUAL(port.State, 0x0001U);
+}
+
+
+static void MY_INT_TEST_Events(void)
+{
+	MY_BUTTON_Event_t event;
+	uint32_t n;
+
+	MY_HOST_EQUAL(MY_BUTTON_Init(GPIOA, GPIO_PIN_0, 1U, &MY_INT_TEST_Button0), MY_Result_Ok);
+	MY_HOST_EQUAL(MY_BUTTON_Init(GPIOA, GPIO_PIN_1, 0U, &MY_INT_TEST_Button1), MY_Result_Ok);
+
+	/* PA1 отпущена - высокий уровень */
+	for(n = 0; n < 4U; n++)
+	{
+		MY_INT_TEST_Sample(0x0002U);
+	}
+
+	MY_HOST_EQUAL(MY_INT_TEST_Drain(), 0U);
+
+	/* Нажатие PA0 */
+	for(n = 0; n < 4U; n++)
+	{
+		MY_INT_TEST_Sample(0x0003U);
+	}
+
+	MY_HOST_EQUAL(MY_BUTTON_GetEvent(&event), MY_Result_Ok);
+	MY_HOST_EQUAL(event.Button, MY_INT_TEST_Button0);
+	MY_HOST_EQUAL(event.Event, MY_BUTTON_Event_Press);
+	MY_HOST_EQUAL(MY_BUTTON_GetEvent(&event), MY_Result_Error);
+	MY_HOST_EQUAL(MY_BUTTON_IsPressed(MY_INT_TEST_Button0), 1U);
+	MY_HOST_EQUAL(MY_BUTTON_OnPressed(MY_INT_TEST_Button0), 1U);
+	MY_HOST_EQUAL(MY_BUTTON_OnPressed(MY_INT_TEST_Button0), 0U);
+
+	/* Удержание: долгое нажатие на BUTTON_LONGPRESS_SAMPLES, затем автоповтор */
+	for(n = 1; n < BUTTON_LONGPRESS_SAMPLES; n++)
+	{
+		MY_INT_TEST_Sample(0x0003U);
+	}
+
+	MY_HOST_EQUAL(MY_INT_TEST_Drain(), 0U);
+
+	MY_INT_TEST_Sample(0x0003U);
+
+	MY_HOST_EQUAL(MY_BUTTON_GetEvent(&event), MY_Result_Ok);
+	MY_HOST_EQUAL(event.Event, MY_BUTTON_Event_LongPress);
+
+	for(n = 0; n < (BUTTON_REPEAT_SAMPLES * 3U); n++)
+	{
+		MY_INT_TEST_Sample(0x0003U);
+	}
+
+	for(n = 0; n < 3U; n++)
+	{
+		MY_HOST_EQUAL(MY_BUTTON_GetEvent(&event), MY_Result_Ok);
+		MY_HOST_EQUAL(event.Event, MY_BUTTON_Event_Repeat);
+	}
+
+	MY_HOST_EQUAL(MY_BUTTON_GetEvent(&event), MY_Result_Error);
+
+	/* Отпускание PA0 и нажатие PA1 (низкий уровень) одним отсчётом */
+	for(n = 0; n < 4U; n++)
+	{
+		MY_INT_TEST_Sample(0x0000U);
+	}
+
+	MY_HOST_EQUAL(MY_BUTTON_GetEvent(&event), MY_Result_Ok);
+	MY_HOST_EQUAL(event.Button, MY_INT_TEST_Button0);
+	MY_HOST_EQUAL(event.Event, MY_BUTTON_Event_Release);
+	MY_HOST_EQUAL(MY_BUTTON_GetEvent(&event), MY_Result_Ok);
+	MY_HOST_EQUAL(event.Button, MY_INT_TEST_Button1);
+	MY_HOST_EQUAL(event.Event, MY_BUTTON_Event_Press);
+	MY_HOST_EQUAL(MY_BUTTON_OnReleased(MY_INT_TEST_Button0), 1U);
+
+	for(n = 0; n < 4U; n++)
+	{
+		MY_INT_TEST_Sample(0x0002U);
+	}
+
+	MY_HOST_EQUAL(MY_INT_TEST_Drain(), 1U);
+}
+
+
+/* Очередь на BUTTON_EVENT_QUEUE_SIZE - 1 событий: лишние считаются, порядок сохраняется */
+static void MY_INT_TEST_Overflow(void)
+{
+	MY_BUTTON_Event_t event;
+	uint32_t dropped = MY_BUTTON_GetDroppedEvents();
+	uint32_t n;
+
+	/* Каждое нажатие и отпускание - одно событие, 4 отсчёта на переключение */
+	for(n = 0; n < BUTTON_EVENT_QUEUE_SIZE + 3U; n++)
+	{
+		uint32_t k;
+
+		for(k = 0; k < 4U; k++)
+		{
+			MY_INT_TEST_Sample((n & 1U) ? 0x0002U : 0x0003U);
+		}
+	}
+
+	MY_HOST_EQUAL(MY_BUTTON_GetDroppedEvents() - dropped, 4U);
+
+	for(n = 0; n < BUTTON_EVENT_QUEUE_SIZE - 1U; n++)
+	{
+		MY_HOST_EQUAL(MY_BUTTON_GetEvent(&event), MY_Result_Ok);
+		MY_HOST_EQUAL(event.Event, (n & 1U) ? MY_BUTTON_Event_Release : MY_BUTTON_Event_Press);
+	}
+
+	MY_HOST_EQUAL(MY_BUTTON_GetEvent(&event), MY_Result_Error);
+}
+
+
+/* Тики до ближайшего отсчёта MY_BUTTON_Tick(), возвращает число тиков */
+static uint32_t MY_INT_TEST_TickToSample(void)
+{
+	uint32_t ticks = 0;
+
+	do
+	{
+		MY_SysTick_IncTick();
+		MY_BUTTON_Tick();
+
+		ticks++;
+	}
+	while(MY_BUTTON_GetIdleTicks() != BUTTON_SAMPLE_PERIOD);
+
+	return ticks;
+}
+
+
+/* Отсчёт в MY_BUTTON_Tick() раз в BUTTON_SAMPLE_PERIOD тиков */
+static void MY_INT_TEST_Tick(void)
+{
+	uint32_t n;
+
+	GPIOA->IDR = 0x0002U;
+
+	for(n = 0; n < 4U; n++)
+	{
+		MY_INT_TEST_TickToSample();
+	}
+
+	MY_INT_TEST_Drain();
+	MY_HOST_EQUAL(MY_BUTTON_IsPressed(MY_INT_TEST_Button0), 0U);
+
+	GPIOA->IDR = 0x0003U;
+
+	for(n = 1; n <= 4U; n++)
+	{
+		MY_HOST_EQUAL(MY_INT_TEST_TickToSample(), BUTTON_SAMPLE_PERIOD);
+		MY_HOST_EQUAL(MY_BUTTON_IsPressed(MY_INT_TEST_Button0), (n == 4U) ? 1U : 0U);
+	}
+
+	/* Между отсчётами обработчик только сравнивает время */
+	MY_SysTick_IncTick();
+	MY_BUTTON_Tick();
+
+	MY_HOST_EQUAL(MY_BUTTON_GetIdleTicks(), BUTTON_SAMPLE_PERIOD - 1U);
+
+	MY_INT_TEST_Drain();
+}
+
+
+/* Производитель (отсчёт в прерывании) и потребитель (основной цикл) на каждой границе инструкций */
+static uint32_t MY_INT_TEST_Received;
+static uint8_t MY_INT_TEST_Level;
+
+static void MY_INT_TEST_Consumer(void)
+{
+	MY_BUTTON_Event_t event;
+
+	while(MY_BUTTON_GetEvent(&event) == MY_Result_Ok)
+	{
+		MY_INT_TEST_Received++;
+	}
+}
+
+
+/* 4 отсчёта нового уровня - ровно одно событие */
+static void MY_INT_TEST_Producer(void)
+{
+	uint32_t k;
+
+	MY_INT_TEST_Level ^= 1U;
+
+	for(k = 0; k < 4U; k++)
+	{
+		MY_INT_TEST_Sample(MY_INT_TEST_Level ? 0x0003U : 0x0002U);
+	}
+}
+
+
+static void MY_INT_TEST_Preempt(void)
+{
+	uint32_t steps;
+	uint32_t dropped = MY_BUTTON_GetDroppedEvents();
+	uint32_t at;
+
+	MY_INT_TEST_Level = 0;
+
+	/* Поток, который застаёт в очереди 3 события */
+	MY_INT_TEST_Producer();
+	MY_INT_TEST_Producer();
+	MY_INT_TEST_Producer();
+	MY_INT_TEST_Received = 0;
+
+	steps = MY_HOST_Step_Run(MY_INT_TEST_Consumer, NULL);
+
+	for(at = 0; at <= steps; at++)
+	{
+		MY_INT_TEST_Producer();
+		MY_INT_TEST_Producer();
+		MY_INT_TEST_Producer();
+		MY_INT_TEST_Received = 0;
+
+		MY_HOST_Preempt_Run(MY_INT_TEST_Consumer, MY_INT_TEST_Producer, 15U, at);
+
+		/* Событие прерывания забрано в этом проходе или осталось в очереди */
+		MY_INT_TEST_Received += MY_INT_TEST_Drain();
+
+		MY_HOST_EQUAL(MY_INT_TEST_Received, 4U);
+	}
+
+	MY_HOST_EQUAL(MY_BUTTON_GetDroppedEvents(), dropped);
+}
+
+
+int main(void)
+{
+	MY_HOST_RUN(MY_INT_TEST_Debounce);
+	MY_HOST_RUN(MY_INT_TEST_Events);
+	MY_HOST_RUN(MY_INT_TEST_Overflow);
+	MY_HOST_RUN(MY_INT_TEST_Tick);
+	MY_HOST_RUN(MY_INT_TEST_Preempt);
+
+	return MY_HOST_TEST_Report("button");
+}
@@ -0,0 +1,270 @@
+/**
+ * @author  Андрей Заостровных
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/console
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Тест MY_CONSOLE: кольцевой буфер с переходом через край и переполнением, запись
+ * 			из прерывания и передача в прерывании на каждой границе инструкций писателя
+ */
+
+/* Маленький буфер: переход через край и переполнение с короткими строками */
+#define CONSOLE_BUFFER_SIZE						64U
+
+#include <string.h>
+#include "my_host_test.h"
+#include "../../Drivers/MY/Src/my_stm32f0xx_console.c"
+
+/* Исключение USART1 */
+#define MY_INT_TEST_EXCEPTION					(USART1_IRQn + 16U)
+
+/* Переданные байты */
+static char MY_INT_TEST_Output[4U * CONSOLE_BUFFER_SIZE];
+static uint32_t MY_INT_TEST_OutputSize;
+
+/* Записи потока и прерывания */
+static const char MY_INT_TEST_Thread[] = "thread: 0123456789";
+static const char MY_INT_TEST_Isr[] = "isr!";
+static uint32_t MY_INT_TEST_Written;
+static uint32_t MY_INT_TEST_IsrWritten;
+
+
+/* Состояние буфера - статические переменные драйвера, MY_HOST_Reset() их не сбрасывает */
+static void MY_INT_TEST_Setup(uint32_t Start)
+{
+	MY_INT_CONSOLE_Reserve = Start;
+	MY_INT_CONSOLE_Head = Start;
+	MY_INT_CONSOLE_Tail = Start;
+	MY_INT_CONSOLE_Writers = 0;
+	MY_INT_CONSOLE_Ready = 0;
+
+	memset(&MY_INT_CONSOLE_Stats, 0, sizeof(MY_INT_CONSOLE_Stats));
+	memset(MY_INT_CONSOLE_Buffer, 0, sizeof(MY_INT_CONSOLE_Buffer));
+
+	MY_INT_TEST_OutputSize = 0;
+
+	MY_CONSOLE_Init();
+}
+
+
+/* Один вход в прерывание при свободном TDR: байт из буфера попадает в вывод */
+static void MY_INT_TEST_Transmit(void)
+{
+	uint32_t tail = MY_INT_CONSOLE_Tail;
+
+	USART1->ISR |= USART_ISR_TXE;
+
+	MY_CONSOLE_IRQHandler();
+
+	if((MY_INT_CONSOLE_Tail != tail) && (MY_INT_TEST_OutputSize < sizeof(MY_INT_TEST_Output)))
+	{
+		MY_INT_TEST_Output[MY_INT_TEST_OutputSize++] = (char)USART1->TDR;
+	}
+}
+
+
+/* Передача, пока прерывание разрешено */
+static void MY_INT_TEST_Drain(void)
+{
+	uint32_t i;
+
+	for(i = 0; (i < sizeof(MY_INT_TEST_Output)) && (USART1->CR1 & USART_CR1_TXEIE); i++)
+	{
+		MY_INT_TEST_Transmit();
+	}
+
+	MY_HOST_EQUAL(MY_INT_CONSOLE_Tail, MY_INT_CONSOLE_Head);
+}
+
+
+static uint32_t MY_INT_TEST_Is(const char *Text)
+{
+	return ((strlen(Text) == MY_INT_TEST_OutputSize) && (memcmp(MY_INT_TEST_Output, Text, MY_INT_TEST_OutputSize) == 0)) ? 1U : 0U;
+}
+
+
+static void MY_INT_TEST_WriteThread(void)
+{
+	MY_INT_TEST_Written = MY_CONSOLE_Write(MY_INT_TEST_Thread, sizeof(MY_INT_TEST_Thread) - 1U);
+}
+
+
+static void MY_INT_TEST_WriteIsr(void)
+{
+	MY_INT_TEST_IsrWritten = MY_CONSOLE_Write(MY_INT_TEST_Isr, sizeof(MY_INT_TEST_Isr) - 1U);
+}
+
+
+/* Кольцо: данные через край буфера, переполнение, статистика и вывод до инициализации */
+static void MY_INT_TEST_Ring(void)
+{
+	MY_CONSOLE_Stats_t stats;
+	char line[CONSOLE_BUFFER_SIZE + 8U];
+	uint32_t i;
+
+	for(i = 0; i < sizeof(line); i++)
+	{
+		line[i] = (char)('A' + (i % 26U));
+	}
+
+	/* Счётчики за 6 байт до переполнения 32 бит, это же и 6 байт до края буфера */
+	MY_INT_TEST_Setup(0xFFFFFFFAU);
+
+	MY_HOST_EQUAL(USART1->CR1, USART_CR1_TE | USART_CR1_UE);
+
+	MY_HOST_EQUAL(MY_CONSOLE_Write(line, 20U), 20U);
+	MY_HOST_EQUAL(MY_CONSOLE_GetFree(), CONSOLE_BUFFER_SIZE - 20U);
+	MY_HOST_CHECK(USART1->CR1 & USART_CR1_TXEIE);
+
+	MY_INT_TEST_Drain();
+
+	MY_HOST_EQUAL(MY_INT_TEST_OutputSize, 20U);
+	MY_HOST_EQUAL(memcmp(MY_INT_TEST_Output, line, 20U), 0);
+	MY_HOST_EQUAL(USART1->CR1 & USART_CR1_TXEIE, 0U);
+
+	/* Переполнение: принимается то, что помещается */
+	MY_INT_TEST_OutputSize = 0;
+
+	MY_HOST_EQUAL(MY_CONSOLE_Write(line, 10U), 10U);
+	MY_HOST_EQUAL(MY_CONSOLE_Write(line + 10U, CONSOLE_BUFFER_SIZE), CONSOLE_BUFFER_SIZE - 10U);
+	MY_HOST_EQUAL(MY_CONSOLE_GetFree(), 0U);
+	MY_HOST_EQUAL(MY_CONSOLE_Write(line, 1U), 0U);
+
+	MY_CONSOLE_GetStats(&stats);
+
+	MY_HOST_EQUAL(stats.Written, 20U + CONSOLE_BUFFER_SIZE);
+	MY_HOST_EQUAL(stats.Dropped, 10U + 1U);
+	MY_HOST_EQUAL(stats.Overflows, 2U);
+	MY_HOST_EQUAL(stats.Peak, CONSOLE_BUFFER_SIZE);
+
+	/* Освободившееся место снова принимает данные */
+	MY_INT_TEST_Transmit();
+	MY_INT_TEST_Transmit();
+
+	MY_HOST_EQUAL(MY_CONSOLE_Write(line + 64U, 4U), 2U);
+
+	MY_INT_TEST_Drain();
+
+	MY_HOST_EQUAL(MY_INT_TEST_OutputSize, CONSOLE_BUFFER_SIZE + 2U);
+	MY_HOST_EQUAL(memcmp(MY_INT_TEST_Output, line, CONSOLE_BUFFER_SIZE), 0);
+	MY_HOST_EQUAL(memcmp(MY_INT_TEST_Output + CONSOLE_BUFFER_SIZE, line + 64U, 2U), 0);
+	MY_HOST_EQUAL(MY_CONSOLE_GetFree(), CONSOLE_BUFFER_SIZE);
+
+	/* До инициализации вывод накапливается и передаётся после неё */
+	MY_HOST_Reset();
+	MY_INT_TEST_Setup(0);
+
+	MY_INT_CONSOLE_Ready = 0;
+	USART1->CR1 = 0;
+
+	MY_HOST_EQUAL(MY_CONSOLE_Write("boot", 4U), 4U);
+	MY_HOST_EQUAL(USART1->CR1 & USART_CR1_TXEIE, 0U);
+	MY_HOST_EQUAL(MY_CONSOLE_Flush(0U), MY_Result_Timeout);
+
+	MY_CONSOLE_Init();
+	MY_INT_TEST_Drain();
+
+	MY_HOST_CHECK(MY_INT_TEST_Is("boot"));
+
+	/* Буфер передан, сдвиговый регистр пуст */
+	USART1->ISR |= USART_ISR_TC;
+	MY_HOST_EQUAL(MY_CONSOLE_Flush(0U), MY_Result_Ok);
+	MY_HOST_EQUAL(MY_INT_CONSOLE_PowerConstraint(), MY_PWR_State_Standby);
+}
+
+
+/* Запись из прерывания на каждой границе инструкций потока: обе записи целиком, одна за другой */
+static void MY_INT_TEST_WritePreempt(void)
+{
+	char expected[2][sizeof(MY_INT_TEST_Thread) + sizeof(MY_INT_TEST_Isr)];
+	uint32_t order[2] = { 0, 0 };
+	uint32_t steps;
+	uint32_t at;
+
+	strcpy(expected[0], MY_INT_TEST_Thread);
+	strcat(expected[0], MY_INT_TEST_Isr);
+	strcpy(expected[1], MY_INT_TEST_Isr);
+	strcat(expected[1], MY_INT_TEST_Thread);
+
+	MY_INT_TEST_Setup(CONSOLE_BUFFER_SIZE - 8U);
+	steps = MY_HOST_Step_Run(MY_INT_TEST_WriteThread, NULL);
+
+	for(at = 0; at <= steps; at++)
+	{
+		MY_INT_TEST_Setup(CONSOLE_BUFFER_SIZE - 8U);
+
+		MY_HOST_Preempt_Run(MY_INT_TEST_WriteThread, MY_INT_TEST_WriteIsr, MY_INT_TEST_EXCEPTION, at);
+
+		MY_HOST_EQUAL(MY_INT_TEST_Written, sizeof(MY_INT_TEST_Thread) - 1U);
+		MY_HOST_EQUAL(MY_INT_TEST_IsrWritten, sizeof(MY_INT_TEST_Isr) - 1U);
+		MY_HOST_EQUAL(MY_INT_CONSOLE_Writers, 0U);
+		MY_HOST_EQUAL(MY_INT_CONSOLE_Head, MY_INT_CONSOLE_Reserve);
+		MY_HOST_EQUAL(__get_PRIMASK(), 0U);
+
+		/* Передача запрошена, пока есть что передавать */
+		MY_HOST_CHECK(USART1->CR1 & USART_CR1_TXEIE);
+
+		MY_INT_TEST_Drain();
+
+		if(MY_INT_TEST_Is(expected[0]))
+		{
+			order[0]++;
+		}
+		else
+		{
+			MY_HOST_CHECK(MY_INT_TEST_Is(expected[1]));
+
+			order[1]++;
+		}
+	}
+
+	/* Прерывание приходило и до занятия места потоком, и после */
+	MY_HOST_CHECK(order[0] > 0U);
+	MY_HOST_CHECK(order[1] > 0U);
+}
+
+
+/* Передача в прерывании на каждой границе: не видит нескопированных данных и не теряет запрос передачи */
+static void MY_INT_TEST_ReadPreempt(void)
+{
+	uint32_t prefill;
+	uint32_t steps;
+	uint32_t at;
+
+	for(prefill = 0; prefill < 2U; prefill++)
+	{
+		MY_INT_TEST_Setup(CONSOLE_BUFFER_SIZE - 4U);
+		steps = MY_HOST_Step_Run(MY_INT_TEST_WriteThread, NULL);
+
+		for(at = 0; at <= steps; at++)
+		{
+			MY_INT_TEST_Setup(CONSOLE_BUFFER_SIZE - 4U);
+
+			if(prefill)
+			{
+				MY_CONSOLE_Write("ab", 2U);
+			}
+
+			/* Прерывание разрешено: с пустым буфером обработчик запрещает его */
+			SET_BIT(USART1->CR1, USART_CR1_TXEIE);
+
+			MY_HOST_Preempt_Run(MY_INT_TEST_WriteThread, MY_INT_TEST_Transmit, MY_INT_TEST_EXCEPTION, at);
+
+			MY_HOST_CHECK(USART1->CR1 & USART_CR1_TXEIE);
+
+			MY_INT_TEST_Drain();
+
+			MY_HOST_CHECK(MY_INT_TEST_Is(prefill ? "ab" "thread: 0123456789" : MY_INT_TEST_Thread));
+		}
+	}
+}
+
+
+int main(void)
+{
+	MY_HOST_RUN(MY_INT_TEST_Ring);
+	MY_HOST_RUN(MY_INT_TEST_WritePreempt);
+	MY_HOST_RUN(MY_INT_TEST_ReadPreempt);
+
+	return MY_HOST_TEST_Report("console");
+}
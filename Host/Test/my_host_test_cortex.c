@@ -0,0 +1,788 @@
+/**
+ * @author  Андрей Заостровных
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/cortex
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Тест MY_SysTick: компенсация тиков после tickless-сна на модели счётчика SysTick,
+ * 			64-битный счётчик тиков и сроки в мкс, таблица векторов в SRAM
+ */
+
+/* Таблица векторов в SRAM включена только здесь */
+#define NVIC_VECTORS_IN_RAM						1U
+
+#include "my_host_test.h"
+
+/* Драйвер собирается в этом файле: тест выставляет старшее слово счётчика тиков и видит таблицу в SRAM */
+#include "../../Drivers/MY/Src/my_stm32f0xx_cortex.c"
+
+/*
+ * Модель SysTick в тактах счётчика. Запуск с VAL = 0 загружает LOAD первым тактом, переход 1 -> 0
+ * выставляет COUNTFLAG и PENDSTSET, запись VAL обнуляет счётчик и COUNTFLAG. Чтения регистров модель
+ * не видит, поэтому COUNTFLAG сбрасывается только записью VAL (драйвер делает её перед каждым запуском),
+ * а запись CTRL его не стирает. WFI продвигает время до обнуления счётчика или до пробуждения другим
+ * прерыванием, плюс задержка выхода из сна.
+ */
+static uint32_t MY_INT_TEST_Cpi;			/* Тактов на инструкцию */
+static uint32_t MY_INT_TEST_Wake;			/* Пробуждение другим прерыванием через столько тактов сна */
+static uint32_t MY_INT_TEST_Late;			/* Тактов от пробуждения до первой инструкции */
+static uint32_t MY_INT_TEST_Clock;			/* Тактов всего */
+static uint32_t MY_INT_TEST_Stopped;		/* Тактов с остановленным счётчиком */
+static uint32_t MY_INT_TEST_Val;			/* VAL после модели: отличие означает запись драйвера */
+static uint32_t MY_INT_TEST_Ctrl;
+static uint32_t MY_INT_TEST_CountFlag;
+static uint32_t MY_INT_TEST_Load;			/* LOAD на момент запуска счётчика */
+static uint32_t MY_INT_TEST_Latched;
+static uint32_t MY_INT_TEST_Isr;			/* Выполненных прерываний SysTick */
+static uint32_t MY_INT_TEST_Sleeps;			/* Вызовов WFI */
+static uint32_t MY_INT_TEST_Asleep;			/* Модель сна выполняется пошагово вместе с потоком */
+
+static uint32_t MY_INT_TEST_Idle;
+static uint32_t MY_INT_TEST_Result;
+
+
+/* Значение, которое счётчик загрузит на следующем такте при VAL = 0 */
+static uint32_t MY_INT_TEST_Reload(void)
+{
+	return MY_INT_TEST_Latched ? MY_INT_TEST_Load : SysTick->LOAD;
+}
+
+
+static void MY_INT_TEST_Count(uint32_t Clocks)
+{
+	MY_INT_TEST_Clock += Clocks;
+
+	if(!(SysTick->CTRL & SysTick_CTRL_ENABLE_Msk))
+	{
+		MY_INT_TEST_Stopped += Clocks;
+
+		return;
+	}
+
+	while(Clocks != 0U)
+	{
+		if(SysTick->VAL == 0U)
+		{
+			SysTick->VAL = MY_INT_TEST_Reload();
+			MY_INT_TEST_Latched = 0;
+			Clocks--;
+
+			/* LOAD = 0: счётчик стоит на нуле без прерываний */
+			if(SysTick->VAL == 0U)
+			{
+				break;
+			}
+		}
+		else if(Clocks >= SysTick->VAL)
+		{
+			Clocks -= SysTick->VAL;
+			SysTick->VAL = 0;
+			SysTick->CTRL |= SysTick_CTRL_COUNTFLAG_Msk;
+			MY_INT_TEST_CountFlag = SysTick_CTRL_COUNTFLAG_Msk;
+			SCB->ICSR |= SCB_ICSR_PENDSTSET_Msk;
+		}
+		else
+		{
+			SysTick->VAL -= Clocks;
+			Clocks = 0;
+		}
+	}
+
+	MY_INT_TEST_Val = SysTick->VAL;
+}
+
+
+/* Тактов до ближайшего обнуления счётчика, 0 - не обнулится */
+static uint32_t MY_INT_TEST_ToZero(void)
+{
+	if(!(SysTick->CTRL & SysTick_CTRL_ENABLE_Msk))
+	{
+		return 0U;
+	}
+
+	if(SysTick->VAL != 0U)
+	{
+		return SysTick->VAL;
+	}
+
+	return (MY_INT_TEST_Reload() != 0U) ? (MY_INT_TEST_Reload() + 1U) : 0U;
+}
+
+
+/* Записи драйвера в регистры SysTick и обработчик прерывания при PRIMASK = 0 */
+static void MY_INT_TEST_Hook(void)
+{
+	uint32_t ctrl;
+
+	if(MY_INT_TEST_Asleep)
+	{
+		return;
+	}
+
+	if(SysTick->VAL != MY_INT_TEST_Val)
+	{
+		SysTick->VAL = 0;
+		MY_INT_TEST_Val = 0;
+		MY_INT_TEST_CountFlag = 0;
+	}
+
+	ctrl = SysTick->CTRL;
+
+	/* Запуск после записи VAL = 0: LOAD фиксируется для первой загрузки */
+	if((ctrl & SysTick_CTRL_ENABLE_Msk) && !(MY_INT_TEST_Ctrl & SysTick_CTRL_ENABLE_Msk) && (SysTick->VAL == 0U))
+	{
+		MY_INT_TEST_Load = SysTick->LOAD;
+		MY_INT_TEST_Latched = 1;
+		MY_INT_TEST_CountFlag = 0;
+	}
+
+	SysTick->CTRL = (ctrl & ~SysTick_CTRL_COUNTFLAG_Msk) | MY_INT_TEST_CountFlag;
+	MY_INT_TEST_Ctrl = SysTick->CTRL;
+
+	if((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) && (MY_HOST_PRIMASK == 0U))
+	{
+		SCB->ICSR &= ~SCB_ICSR_PENDSTSET_Msk;
+		MY_INT_TEST_Isr++;
+
+		MY_SysTick_IncTick();
+	}
+
+	MY_INT_TEST_Count(MY_INT_TEST_Cpi);
+}
+
+
+/* Сон до прерывания SysTick (и при PRIMASK = 1) или до пробуждения другим прерыванием */
+static void MY_INT_TEST_Sleep(void)
+{
+	uint32_t clocks = MY_INT_TEST_ToZero();
+
+	MY_INT_TEST_Sleeps++;
+	MY_INT_TEST_Asleep = 1;
+
+	if(!(SCB->ICSR & SCB_ICSR_PENDSTSET_Msk))
+	{
+		if((clocks == 0U) || (MY_INT_TEST_Wake < clocks))
+		{
+			clocks = MY_INT_TEST_Wake;
+		}
+
+		/* Сон без источника пробуждения */
+		MY_HOST_CHECK(clocks != MY_HOST_NEVER);
+
+		if(clocks != MY_HOST_NEVER)
+		{
+			MY_INT_TEST_Count(clocks);
+		}
+	}
+
+	MY_INT_TEST_Count(MY_INT_TEST_Late);
+
+	MY_INT_TEST_Asleep = 0;
+}
+
+
+static void MY_INT_TEST_Thread(void)
+{
+	MY_INT_TEST_Result = MY_SysTick_Tickless_Idle(MY_INT_TEST_Idle);
+}
+
+
+/*
+ * Простой с периодом PerTick тактов, Val тактов до ближайшего тика. Проверяет, что после сна
+ * счётчик тиков и фаза SysTick совпадают с непрерывным отсчётом: uwTick учёл все границы тиков
+ * (возможно, на такт раньше), следующее прерывание приходит на границе, последующие - через период.
+ * Время с остановленным счётчиком сдвигает сетку тиков, поэтому сравнение идёт во времени счётчика.
+ */
+static uint32_t MY_INT_TEST_Run(uint32_t PerTick, uint32_t Val, uint32_t Idle, uint32_t Wake, uint32_t Late, uint32_t Cpi)
+{
+	uint32_t tickstart = MY_SysTick_GetTick();
+	uint32_t next = (Val != 0U) ? Val : PerTick;
+	uint32_t counted;
+	uint32_t passed;
+	uint32_t added;
+	uint32_t clocks;
+
+	SysTick->LOAD = PerTick - 1U;
+	SysTick->VAL = Val;
+	SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+	SCB->ICSR = 0;
+
+	MY_INT_TEST_Cpi = Cpi;
+	MY_INT_TEST_Wake = Wake;
+	MY_INT_TEST_Late = Late;
+	MY_INT_TEST_Clock = 0;
+	MY_INT_TEST_Stopped = 0;
+	MY_INT_TEST_Val = Val;
+	MY_INT_TEST_Ctrl = SysTick->CTRL;
+	MY_INT_TEST_CountFlag = 0;
+	MY_INT_TEST_Latched = 0;
+	MY_INT_TEST_Isr = 0;
+	MY_INT_TEST_Sleeps = 0;
+	MY_INT_TEST_Idle = Idle;
+
+	MY_HOST_WFI = MY_INT_TEST_Sleep;
+	MY_HOST_PRIMASK = 0;
+
+	MY_HOST_Step_Run(MY_INT_TEST_Thread, MY_INT_TEST_Hook);
+
+	/* Ожидающее прерывание выполняется после выхода из функции */
+	MY_INT_TEST_Cpi = 0;
+	MY_INT_TEST_Hook();
+
+	MY_HOST_EQUAL(MY_HOST_PRIMASK, 0U);
+	MY_HOST_CHECK(SysTick->CTRL & SysTick_CTRL_ENABLE_Msk);
+	MY_HOST_EQUAL(SysTick->LOAD, PerTick - 1U);
+
+	added = MY_SysTick_GetTick() - tickstart;
+	MY_HOST_EQUAL(MY_INT_TEST_Result, added - MY_INT_TEST_Isr);
+
+	/* Границы тиков, пройденные счётчиком */
+	counted = MY_INT_TEST_Clock - MY_INT_TEST_Stopped;
+	passed = (counted >= next) ? (1U + ((counted - next) / PerTick)) : 0U;
+
+	MY_HOST_CHECK((added == passed) || ((added == passed + 1U) && (next + (passed * PerTick) - counted == 1U)));
+
+	/* Следующее прерывание - на границе тика, учтённого следующим */
+	clocks = MY_INT_TEST_ToZero();
+	MY_HOST_EQUAL(counted + clocks, next + (added * PerTick));
+
+	/* Затем снова период PerTick */
+	MY_INT_TEST_Count(clocks);
+	MY_HOST_EQUAL(MY_INT_TEST_ToZero(), PerTick);
+
+	MY_HOST_WFI = NULL;
+
+	return MY_INT_TEST_Result;
+}
+
+
+/* Короткий простой: обычный WFI до тика, SysTick не перепрограммируется */
+static void MY_INT_TEST_Short(void)
+{
+	MY_HOST_EQUAL(MY_INT_TEST_Run(10U, 4U, 0U, MY_HOST_NEVER, 0U, 0U), 0U);
+	MY_HOST_EQUAL(MY_INT_TEST_Isr, 1U);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Run(10U, 4U, 1U, MY_HOST_NEVER, 0U, 0U), 0U);
+	MY_HOST_EQUAL(MY_INT_TEST_Isr, 1U);
+}
+
+
+/* Сон на весь интервал: IdleTicks - 1 тиков добавляет функция, последний - прерывание SysTick.
+   Задержка выхода из сна перебирает остаток текущего тика, включая LOAD = 0 */
+static void MY_INT_TEST_Full(void)
+{
+	static const uint32_t val[] = { 0U, 1U, 2U, 5U, 9U };
+	uint32_t idle;
+	uint32_t late;
+	uint32_t i;
+
+	for(i = 0; i < (sizeof(val) / sizeof(val[0])); i++)
+	{
+		for(idle = SYSTICK_TICKLESS_MIN_IDLE; idle <= 6U; idle++)
+		{
+			/* Задержка не дольше интервала: второе обнуление счётчика за время выхода из сна невозможно */
+			for(late = 0; (late <= 25U) && (late <= ((idle - 1U) * 10U)); late++)
+			{
+				MY_INT_TEST_Run(10U, val[i], idle, MY_HOST_NEVER, late, 0U);
+
+				MY_HOST_EQUAL(MY_INT_TEST_Isr, 1U);
+			}
+
+			/* Без задержки: ровно IdleTicks тиков */
+			MY_HOST_EQUAL(MY_INT_TEST_Run(10U, val[i], idle, MY_HOST_NEVER, 0U, 0U), idle - 1U);
+		}
+	}
+}
+
+
+/* Пробуждение другим прерыванием на каждом такте интервала */
+static void MY_INT_TEST_Early(void)
+{
+	static const uint32_t val[] = { 0U, 1U, 3U, 9U };
+	uint32_t wake;
+	uint32_t late;
+	uint32_t i;
+
+	for(i = 0; i < (sizeof(val) / sizeof(val[0])); i++)
+	{
+		for(wake = 0; wake <= 45U; wake++)
+		{
+			for(late = 0; late <= 2U; late++)
+			{
+				MY_INT_TEST_Run(10U, val[i], 5U, wake, late, 0U);
+			}
+		}
+	}
+
+	/* Пробуждение за такт до границы: тик учитывается сразу, следующий период на такт длиннее */
+	MY_HOST_EQUAL(MY_INT_TEST_Run(10U, 5U, 5U, 4U, 0U, 0U), 1U);
+	MY_HOST_EQUAL(MY_INT_TEST_Isr, 0U);
+	MY_HOST_EQUAL(MY_INT_TEST_Load, 10U);
+}
+
+
+/* Интервал ограничен 24-битным счётчиком: 349 тиков при 48 МГц */
+static void MY_INT_TEST_Clamp(void)
+{
+	uint32_t per_tick = 48000U;
+	uint32_t max_ticks = SysTick_LOAD_RELOAD_Msk / per_tick;
+
+	MY_HOST_EQUAL(MY_INT_TEST_Run(per_tick, 12345U, 1000U, MY_HOST_NEVER, 0U, 0U), max_ticks - 1U);
+	MY_HOST_EQUAL(max_ticks, 349U);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Run(per_tick, 1U, max_ticks, 300000U, 17U, 0U), 7U);
+}
+
+
+/* Время выполнения драйвера: тик может наступить на любой инструкции, в том числе до проверки
+   PENDSTSET или с остановленным счётчиком */
+static void MY_INT_TEST_Running(void)
+{
+	uint32_t val;
+	uint32_t wake;
+	uint32_t early = 0;
+
+	for(val = 0; val <= 60U; val++)
+	{
+		MY_INT_TEST_Run(50U, val, 4U, MY_HOST_NEVER, 3U, 1U);
+
+		for(wake = 0; wake <= 200U; wake += 7U)
+		{
+			MY_INT_TEST_Run(50U, val, 4U, wake, 3U, 1U);
+		}
+
+		/* Ранний выход без сна: тик наступил при запрещённых прерываниях до перепрограммирования */
+		early += (MY_INT_TEST_Sleeps == 0U) ? 1U : 0U;
+	}
+
+	MY_HOST_CHECK(early > 0U);
+}
+
+
+/* Период SysTick 1 мс при HCLK = 48 МГц */
+#define MY_INT_TEST_LOAD						47999U
+
+static uint64_t MY_INT_TEST_Read;
+
+
+static void MY_INT_TEST_SetTick(uint64_t Ticks, uint32_t Val)
+{
+	uwTick = (uint32_t)Ticks;
+	MY_INT_SysTick_TickHigh = (uint32_t)(Ticks >> 32);
+
+	SysTick->LOAD = MY_INT_TEST_LOAD;
+	SysTick->VAL = Val;
+	SCB->ICSR = 0;
+}
+
+
+/* Время в мкс при заданных тиках и остатке счётчика */
+static uint64_t MY_INT_TEST_Micros(uint64_t Ticks, uint32_t Val)
+{
+	return (Ticks * 1000U) + ((((uint64_t)(MY_INT_TEST_LOAD - Val)) * 1000U) / (MY_INT_TEST_LOAD + 1U));
+}
+
+
+/* Прерывание SysTick: перезагрузка счётчика и обработчик */
+static void MY_INT_TEST_TickIsr(void)
+{
+	SysTick->VAL = MY_INT_TEST_LOAD;
+	SCB->ICSR &= ~SCB_ICSR_PENDSTSET_Msk;
+
+	MY_SysTick_IncTick();
+}
+
+
+static void MY_INT_TEST_ReadTick64(void)
+{
+	MY_INT_TEST_Read = MY_SysTick_GetTick64();
+}
+
+
+static void MY_INT_TEST_ReadMicros(void)
+{
+	MY_INT_TEST_Read = MY_SysTick_GetMicros();
+}
+
+
+/* Чтение при запрещённых прерываниях: перезагрузку видно только по PENDSTSET */
+static void MY_INT_TEST_ReadMasked(void)
+{
+	__disable_irq();
+	MY_INT_TEST_Read = MY_SysTick_GetMicros();
+	__enable_irq();
+}
+
+
+/* Такты SysTick для профилировщика без TIM2, при запрещённых прерываниях */
+static void MY_INT_TEST_ReadCycles(void)
+{
+	__disable_irq();
+	MY_INT_TEST_Read = MY_SysTick_GetCycles();
+	__enable_irq();
+}
+
+
+/* Переполнение младшего слова: перенос в старшее, в том числе при компенсации нескольких тиков */
+static void MY_INT_TEST_Wrap(void)
+{
+	MY_INT_TEST_SetTick(0xFFFFFFFEULL, 100U);
+
+	MY_SysTick_IncTick();
+	MY_HOST_EQUAL(MY_SysTick_GetTick64(), 0xFFFFFFFFULL);
+
+	MY_SysTick_IncTick();
+	MY_HOST_EQUAL(MY_SysTick_GetTick64(), 0x100000000ULL);
+	MY_HOST_EQUAL(MY_SysTick_GetTick(), 0U);
+	MY_HOST_EQUAL(MY_SysTick_GetMicros(), MY_INT_TEST_Micros(0x100000000ULL, 100U));
+
+	MY_INT_TEST_SetTick(0x1FFFFFFFDULL, 100U);
+
+	MY_INT_SysTick_Advance(5U);
+	MY_HOST_EQUAL(MY_SysTick_GetTick64(), 0x200000002ULL);
+
+	/* Микросекунды не помещаются в 32 бита уже через 72 минуты */
+	MY_INT_TEST_SetTick(4294968ULL, MY_INT_TEST_LOAD);
+	MY_HOST_EQUAL(MY_SysTick_GetMicros(), 4294968000ULL);
+}
+
+
+/* Прерывание SysTick на каждой границе инструкций чтения у переполнения: результат - значение
+   до тика или после, но не смесь слов или остатка счётчика */
+static void MY_INT_TEST_Torn(void)
+{
+	static const MY_HOST_Func_t read[] = { MY_INT_TEST_ReadTick64, MY_INT_TEST_ReadMicros };
+	uint64_t before[2];
+	uint64_t after[2];
+	uint32_t steps;
+	uint32_t at;
+	uint32_t i;
+
+	before[0] = 0xFFFFFFFFULL;
+	after[0] = 0x100000000ULL;
+	before[1] = MY_INT_TEST_Micros(0xFFFFFFFFULL, 1U);
+	after[1] = MY_INT_TEST_Micros(0x100000000ULL, MY_INT_TEST_LOAD);
+
+	for(i = 0; i < 2U; i++)
+	{
+		MY_INT_TEST_SetTick(0xFFFFFFFFULL, 1U);
+		steps = MY_HOST_Step_Run(read[i], NULL);
+
+		for(at = 0; at <= steps; at++)
+		{
+			MY_INT_TEST_SetTick(0xFFFFFFFFULL, 1U);
+
+			MY_HOST_Preempt_Run(read[i], MY_INT_TEST_TickIsr, 15U, at);
+
+			if(MY_HOST_Preempt_Taken() == MY_HOST_NEVER)
+			{
+				MY_HOST_EQUAL(MY_INT_TEST_Read, before[i]);
+			}
+			else if(at == 0U)
+			{
+				MY_HOST_EQUAL(MY_INT_TEST_Read, after[i]);
+			}
+			else
+			{
+				MY_HOST_CHECK((MY_INT_TEST_Read == before[i]) || (MY_INT_TEST_Read == after[i]));
+			}
+
+			MY_HOST_EQUAL(MY_SysTick_GetTick64(), after[0]);
+		}
+	}
+}
+
+
+/* Перезагрузка счётчика на шаге чтения при запрещённых прерываниях */
+static uint32_t MY_INT_TEST_ReloadAt;
+
+static void MY_INT_TEST_ReloadHook(void)
+{
+	if(MY_HOST_Step_Count() == MY_INT_TEST_ReloadAt)
+	{
+		SysTick->VAL = MY_INT_TEST_LOAD;
+		SCB->ICSR |= SCB_ICSR_PENDSTSET_Msk;
+	}
+}
+
+
+/* Перезагрузка перед каждой инструкцией чтения: PENDSTSET учитывает тик, который ещё не обработан */
+static void MY_INT_TEST_Masked(void)
+{
+	static const MY_HOST_Func_t read[] = { MY_INT_TEST_ReadMasked, MY_INT_TEST_ReadCycles };
+	uint64_t before[2];
+	uint64_t after[2];
+	uint32_t steps;
+	uint32_t at;
+	uint32_t i;
+
+	before[0] = MY_INT_TEST_Micros(0xFFFFFFFFULL, 1U);
+	after[0] = MY_INT_TEST_Micros(0x100000000ULL, MY_INT_TEST_LOAD);
+	before[1] = (0xFFFFFFFFULL * (MY_INT_TEST_LOAD + 1U)) + MY_INT_TEST_LOAD - 1U;
+	after[1] = 0x100000000ULL * (MY_INT_TEST_LOAD + 1U);
+
+	for(i = 0; i < 2U; i++)
+	{
+		MY_INT_TEST_SetTick(0xFFFFFFFFULL, 1U);
+		MY_INT_TEST_ReloadAt = MY_HOST_NEVER;
+		steps = MY_HOST_Step_Run(read[i], NULL);
+
+		for(at = 0; at < steps; at++)
+		{
+			MY_INT_TEST_SetTick(0xFFFFFFFFULL, 1U);
+			MY_INT_TEST_ReloadAt = at;
+
+			MY_HOST_Step_Run(read[i], MY_INT_TEST_ReloadHook);
+
+			if(at == 0U)
+			{
+				MY_HOST_EQUAL(MY_INT_TEST_Read, after[i]);
+			}
+			else if(at == (steps - 1U))
+			{
+				MY_HOST_EQUAL(MY_INT_TEST_Read, before[i]);
+			}
+			else
+			{
+				MY_HOST_CHECK((MY_INT_TEST_Read == before[i]) || (MY_INT_TEST_Read == after[i]));
+			}
+
+			/* Ожидающий тик обрабатывается после разрешения прерываний */
+			if(SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+			{
+				SCB->ICSR &= ~SCB_ICSR_PENDSTSET_Msk;
+				MY_SysTick_IncTick();
+			}
+
+			MY_HOST_EQUAL(MY_SysTick_GetMicros(), after[0]);
+		}
+	}
+}
+
+
+/* Сроки через переполнение uwTick и насыщение оставшегося времени */
+static uint64_t MY_INT_TEST_Deadline;
+
+static void MY_INT_TEST_Expire(void)
+{
+	MY_INT_TEST_Read = MY_SysTick_Deadline_Expired(MY_INT_TEST_Deadline);
+}
+
+
+static void MY_INT_TEST_Deadlines(void)
+{
+	uint64_t deadline;
+	uint32_t steps;
+	uint32_t at;
+	uint32_t i;
+
+	MY_INT_TEST_SetTick(0xFFFFFFFEULL, MY_INT_TEST_LOAD);
+
+	deadline = MY_SysTick_Deadline(5000U);
+	MY_HOST_EQUAL(deadline, MY_INT_TEST_Micros(0xFFFFFFFEULL, MY_INT_TEST_LOAD) + 5000U);
+	MY_HOST_EQUAL(MY_SysTick_Deadline_Remaining(deadline), 5000U);
+
+	for(i = 1; i <= 6U; i++)
+	{
+		MY_INT_TEST_TickIsr();
+
+		MY_HOST_EQUAL(MY_SysTick_Deadline_Expired(deadline), (i >= 5U) ? 1U : 0U);
+		MY_HOST_EQUAL(MY_SysTick_Deadline_Remaining(deadline), (i >= 5U) ? 0U : (5000U - (i * 1000U)));
+	}
+
+	/* Дробная часть тика: половина периода - 500 мкс */
+	MY_INT_TEST_SetTick(0x100000000ULL, MY_INT_TEST_LOAD);
+	deadline = MY_SysTick_Deadline(700U);
+	SysTick->VAL = MY_INT_TEST_LOAD - ((MY_INT_TEST_LOAD + 1U) / 2U);
+	MY_HOST_EQUAL(MY_SysTick_Deadline_Remaining(deadline), 200U);
+	MY_HOST_EQUAL(MY_SysTick_Deadline_Expired(deadline), 0U);
+
+	/* Срок дальше 32 бит мкс */
+	MY_HOST_EQUAL(MY_SysTick_Deadline_Remaining(MY_SysTick_GetMicros() + 0x100000005ULL), 0xFFFFFFFFU);
+
+	/* Срок, наступающий ровно с тиком у переполнения: прерывание на каждой границе инструкций */
+	MY_INT_TEST_SetTick(0xFFFFFFFFULL, 1U);
+	MY_INT_TEST_Deadline = MY_INT_TEST_Micros(0x100000000ULL, MY_INT_TEST_LOAD);
+	steps = MY_HOST_Step_Run(MY_INT_TEST_Expire, NULL);
+
+	for(at = 0; at <= steps; at++)
+	{
+		MY_INT_TEST_SetTick(0xFFFFFFFFULL, 1U);
+
+		MY_HOST_Preempt_Run(MY_INT_TEST_Expire, MY_INT_TEST_TickIsr, 15U, at);
+
+		if(MY_HOST_Preempt_Taken() == MY_HOST_NEVER)
+		{
+			MY_HOST_EQUAL(MY_INT_TEST_Read, 0U);
+		}
+		else if(at == 0U)
+		{
+			MY_HOST_EQUAL(MY_INT_TEST_Read, 1U);
+		}
+
+		MY_HOST_EQUAL(MY_SysTick_Deadline_Expired(MY_INT_TEST_Deadline), 1U);
+	}
+}
+
+
+/* Таблица векторов: Flash заполнена различимыми адресами, таблица в SRAM пуста */
+static MY_NVIC_Handler_t MY_INT_TEST_Flash(uint32_t Index)
+{
+	return (MY_NVIC_Handler_t)(uintptr_t)(0x08000101U + (Index * 4U));
+}
+
+
+static void MY_INT_TEST_VectorsSetup(void)
+{
+	uint32_t i;
+
+	for(i = 0; i < MY_NVIC_VECTORS_COUNT; i++)
+	{
+		MY_HOST_Vectors[i] = MY_INT_TEST_Flash(i);
+		MY_INT_NVIC_Vectors[i] = NULL;
+	}
+}
+
+
+static void MY_INT_TEST_Handler(void)
+{
+}
+
+
+/* Перенос таблицы: копия Flash в SRAM, MEM_MODE = 11, GetVector читает действующую таблицу */
+static void MY_INT_TEST_Relocate(void)
+{
+	uint32_t i;
+
+	MY_INT_TEST_VectorsSetup();
+
+	/* До переноса действует таблица во Flash, менять её нельзя */
+	MY_HOST_EQUAL(MY_NVIC_SetVector(SysTick_IRQn, MY_INT_TEST_Handler), MY_Result_Error);
+	MY_HOST_CHECK(MY_NVIC_GetVector(SysTick_IRQn) == MY_INT_TEST_Flash(16U + SysTick_IRQn));
+
+	MY_HOST_EQUAL(MY_NVIC_Vectors_Relocate(), MY_Result_Ok);
+	MY_HOST_EQUAL(SYSCFG->CFGR1 & SYSCFG_CFGR1_MEM_MODE, SYSCFG_CFGR1_MEM_MODE);
+	MY_HOST_EQUAL(MY_HOST_PRIMASK, 0U);
+
+	for(i = 0; i < MY_NVIC_VECTORS_COUNT; i++)
+	{
+		MY_HOST_CHECK(MY_INT_NVIC_Vectors[i] == MY_INT_TEST_Flash(i));
+	}
+
+	/* Повторный перенос не сбрасывает другие биты CFGR1 */
+	SYSCFG->CFGR1 |= SYSCFG_CFGR1_DMA_RMP;
+	MY_HOST_EQUAL(MY_NVIC_Vectors_Relocate(), MY_Result_Ok);
+	MY_HOST_EQUAL(SYSCFG->CFGR1, SYSCFG_CFGR1_MEM_MODE | SYSCFG_CFGR1_DMA_RMP);
+
+	/* Перенос с запрещёнными прерываниями оставляет их запрещёнными */
+	__disable_irq();
+	MY_HOST_EQUAL(MY_NVIC_Vectors_Relocate(), MY_Result_Ok);
+	MY_HOST_EQUAL(MY_HOST_PRIMASK, 1U);
+	__enable_irq();
+}
+
+
+/* Установка обработчика: только в SRAM, только допустимые номера */
+static void MY_INT_TEST_SetVector(void)
+{
+	MY_INT_TEST_VectorsSetup();
+	MY_HOST_EQUAL(MY_NVIC_Vectors_Relocate(), MY_Result_Ok);
+
+	MY_HOST_EQUAL(MY_NVIC_SetVector(SysTick_IRQn, MY_INT_TEST_Handler), MY_Result_Ok);
+	MY_HOST_CHECK(MY_NVIC_GetVector(SysTick_IRQn) == MY_INT_TEST_Handler);
+	MY_HOST_CHECK(MY_HOST_Vectors[16U + SysTick_IRQn] == MY_INT_TEST_Flash(16U + SysTick_IRQn));
+
+	/* Последний IRQ и NMI */
+	MY_HOST_EQUAL(MY_NVIC_SetVector((IRQn_Type)((int32_t)MY_NVIC_VECTORS_COUNT - 17), MY_INT_TEST_Handler), MY_Result_Ok);
+	MY_HOST_CHECK(MY_INT_NVIC_Vectors[MY_NVIC_VECTORS_COUNT - 1U] == MY_INT_TEST_Handler);
+	MY_HOST_EQUAL(MY_NVIC_SetVector(NonMaskableInt_IRQn, MY_INT_TEST_Handler), MY_Result_Ok);
+
+	/* Начальный MSP и вектор сброса, номер за таблицей, NULL */
+	MY_HOST_EQUAL(MY_NVIC_SetVector((IRQn_Type)-16, MY_INT_TEST_Handler), MY_Result_Error);
+	MY_HOST_EQUAL(MY_NVIC_SetVector((IRQn_Type)-15, MY_INT_TEST_Handler), MY_Result_Error);
+	MY_HOST_EQUAL(MY_NVIC_SetVector((IRQn_Type)((int32_t)MY_NVIC_VECTORS_COUNT - 16), MY_INT_TEST_Handler), MY_Result_Error);
+	MY_HOST_EQUAL(MY_NVIC_SetVector(PendSV_IRQn, NULL), MY_Result_Error);
+	MY_HOST_CHECK(MY_INT_NVIC_Vectors[1] == MY_INT_TEST_Flash(1U));
+	MY_HOST_CHECK(MY_INT_NVIC_Vectors[16U + PendSV_IRQn] == MY_INT_TEST_Flash(16U + PendSV_IRQn));
+
+	MY_HOST_CHECK(MY_NVIC_GetVector((IRQn_Type)-16) == NULL);
+	MY_HOST_CHECK(MY_NVIC_GetVector((IRQn_Type)-15) == MY_INT_TEST_Flash(1U));
+	MY_HOST_CHECK(MY_NVIC_GetVector((IRQn_Type)((int32_t)MY_NVIC_VECTORS_COUNT - 16)) == NULL);
+
+	/* Возврат отображения Flash: действует исходная таблица */
+	SYSCFG->CFGR1 &= ~SYSCFG_CFGR1_MEM_MODE;
+	MY_HOST_CHECK(MY_NVIC_GetVector(SysTick_IRQn) == MY_INT_TEST_Flash(16U + SysTick_IRQn));
+	MY_HOST_EQUAL(MY_NVIC_SetVector(SysTick_IRQn, MY_INT_TEST_Handler), MY_Result_Error);
+}
+
+
+/* Прерывание во время переноса: если SRAM уже отображена, таблица в ней полная */
+static uint32_t MY_INT_TEST_Mapped;
+
+static void MY_INT_TEST_VectorsIsr(void)
+{
+	uint32_t i;
+
+	if((SYSCFG->CFGR1 & SYSCFG_CFGR1_MEM_MODE) != SYSCFG_CFGR1_MEM_MODE)
+	{
+		return;
+	}
+
+	MY_INT_TEST_Mapped++;
+
+	for(i = 1; i < MY_NVIC_VECTORS_COUNT; i++)
+	{
+		MY_HOST_CHECK(MY_NVIC_GetVector((IRQn_Type)((int32_t)i - 16)) == MY_INT_TEST_Flash(i));
+	}
+}
+
+
+static void MY_INT_TEST_RelocateThread(void)
+{
+	MY_INT_TEST_Result = MY_NVIC_Vectors_Relocate();
+}
+
+
+static void MY_INT_TEST_VectorsPreempt(void)
+{
+	uint32_t steps;
+	uint32_t at;
+
+	MY_INT_TEST_VectorsSetup();
+	steps = MY_HOST_Step_Run(MY_INT_TEST_RelocateThread, NULL);
+
+	MY_INT_TEST_Mapped = 0;
+
+	for(at = 0; at <= steps; at++)
+	{
+		MY_INT_TEST_VectorsSetup();
+		SYSCFG->CFGR1 = 0;
+
+		MY_HOST_Preempt_Run(MY_INT_TEST_RelocateThread, MY_INT_TEST_VectorsIsr, 16U + TIM2_IRQn, at);
+
+		MY_HOST_EQUAL(MY_INT_TEST_Result, MY_Result_Ok);
+	}
+
+	/* Прерывание приходило и до, и после переноса */
+	MY_HOST_CHECK(MY_INT_TEST_Mapped > 0U);
+	MY_HOST_CHECK(MY_INT_TEST_Mapped <= steps);
+}
+
+
+int main(void)
+{
+	MY_HOST_RUN(MY_INT_TEST_Short);
+	MY_HOST_RUN(MY_INT_TEST_Full);
+	MY_HOST_RUN(MY_INT_TEST_Early);
+	MY_HOST_RUN(MY_INT_TEST_Clamp);
+	MY_HOST_RUN(MY_INT_TEST_Running);
+	MY_HOST_RUN(MY_INT_TEST_Wrap);
+	MY_HOST_RUN(MY_INT_TEST_Torn);
+	MY_HOST_RUN(MY_INT_TEST_Masked);
+	MY_HOST_RUN(MY_INT_TEST_Deadlines);
+	MY_HOST_RUN(MY_INT_TEST_Relocate);
+	MY_HOST_RUN(MY_INT_TEST_SetVector);
+	MY_HOST_RUN(MY_INT_TEST_VectorsPreempt);
+
+	return MY_HOST_TEST_Report("cortex");
+}
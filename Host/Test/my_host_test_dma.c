@@ -0,0 +1,740 @@
+/**
+ * @author  Андрей Заостровных
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/dma
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Тест MY_DMA на модели DMA1: чередование HT/TC в циклическом режиме, общий вектор
+ * 			MY_DMA_IRQ_Dispatch(), ошибка передачи, прерывание передачи и таймаут ожидания, выбор
+ * 			процессора для коротких копий
+ */
+
+#include "my_host_test.h"
+#include "../../Drivers/MY/Src/my_stm32f0xx_dma.c"
+
+/* Флаги канала в DMA_ISR совпадают по положению с битами разрешения прерываний в DMA_CCR */
+#define MY_INT_TEST_IRQ_FLAGS					(DMA_FLAG_TC | DMA_FLAG_HT | DMA_FLAG_TE)
+
+/* Инструкций на элемент данных: обработчик успевает до следующего флага */
+#define MY_INT_TEST_PERIOD						400U
+
+/* Инструкций на тик SysTick для ожидания с таймаутом */
+#define MY_INT_TEST_TICK						50U
+
+/* Предел шагов потока-NVIC */
+#define MY_INT_TEST_STEPS						200000U
+
+/* Журнал callback-функций */
+#define MY_INT_TEST_EVENTS						32U
+
+/* Модель канала: период передачи элемента, длина для перезагрузки, элемент с ошибкой шины */
+static uint32_t MY_INT_TEST_Period[DMA_CHANNELS];
+static uint32_t MY_INT_TEST_Elapsed[DMA_CHANNELS];
+static uint32_t MY_INT_TEST_Length[DMA_CHANNELS];
+static uint32_t MY_INT_TEST_Moved[DMA_CHANNELS];
+static uint32_t MY_INT_TEST_ErrorAt[DMA_CHANNELS];
+static uint32_t MY_INT_TEST_Enabled[DMA_CHANNELS];
+
+/* Журнал: канал и событие ('H', 'C', 'E', 'A'), остаток CNDTR в момент вызова */
+static char MY_INT_TEST_Events[MY_INT_TEST_EVENTS];
+static uint32_t MY_INT_TEST_EventChannel[MY_INT_TEST_EVENTS];
+static uint32_t MY_INT_TEST_EventCounter[MY_INT_TEST_EVENTS];
+static uint32_t MY_INT_TEST_EventCount;
+
+/* Поток-NVIC выполняется, пока callback-функция не снимет флаг */
+static volatile uint32_t MY_INT_TEST_Running;
+static uint32_t MY_INT_TEST_Laps;
+static uint32_t MY_INT_TEST_Entries;
+
+/* Параметры и результаты потоков */
+static MY_DMA_Handle_t *MY_INT_TEST_Handler;
+static MY_DMA_LevelComplete_t MY_INT_TEST_Level;
+static uint32_t MY_INT_TEST_Timeout;
+static MY_Result_t MY_INT_TEST_Result;
+static uint32_t MY_INT_TEST_Ticks;
+static IRQn_Type MY_INT_TEST_IRQn;
+
+
+/* Номер канала 0..4 по структуре */
+static uint32_t MY_INT_TEST_Index(MY_DMA_Handle_t *DMA_Handler)
+{
+	return (uint32_t)(DMA_Handler - DMA1Handlers);
+}
+
+
+/* Запись DMA_IFCR сбрасывает флаги DMA_ISR. CGIFx сбрасывает все флаги канала, GIFx - ИЛИ остальных */
+static void MY_INT_TEST_Flags(void)
+{
+	uint32_t clear = DMA1->IFCR;
+	uint32_t isr = DMA1->ISR;
+	uint32_t bits;
+	uint32_t i;
+
+	if(clear == 0U)
+	{
+		return;
+	}
+
+	for(i = 0; i < DMA_CHANNELS; i++)
+	{
+		bits = (clear >> (i * 4U)) & 0x0FU;
+
+		if(bits & DMA_FLAG_GL)
+		{
+			bits = 0x0FU;
+		}
+
+		isr &= ~(bits << (i * 4U));
+
+		if(((isr >> (i * 4U)) & MY_INT_TEST_IRQ_FLAGS) == 0U)
+		{
+			isr &= ~(DMA_FLAG_GL << (i * 4U));
+		}
+	}
+
+	DMA1->ISR = isr;
+	DMA1->IFCR = 0U;
+}
+
+
+/* Выставление флага канала аппаратурой */
+static void MY_INT_TEST_Raise(uint32_t Index, uint32_t Flag)
+{
+	DMA1->ISR |= (Flag | DMA_FLAG_GL) << (Index * 4U);
+}
+
+
+/* Обработчик шага: флаги, время и передача элементов включёнными каналами */
+static void MY_INT_TEST_Hook(void)
+{
+	DMA_Channel_TypeDef *channel;
+	uint32_t i;
+
+	MY_HOST_RCC_Hook();
+	MY_INT_TEST_Flags();
+
+	for(i = 0; i < DMA_CHANNELS; i++)
+	{
+		channel = DMA1Handlers[i].Instance;
+
+		/* Включение канала: CNDTR запоминается для перезагрузки в циклическом режиме */
+		if((channel->CCR & DMA_CCR_EN) == 0U)
+		{
+			MY_INT_TEST_Enabled[i] = 0;
+
+			continue;
+		}
+
+		if(!MY_INT_TEST_Enabled[i])
+		{
+			MY_INT_TEST_Enabled[i] = 1;
+			MY_INT_TEST_Length[i] = channel->CNDTR;
+			MY_INT_TEST_Elapsed[i] = 0;
+		}
+
+		if((MY_INT_TEST_Period[i] == 0U) || (channel->CNDTR == 0U) || (++MY_INT_TEST_Elapsed[i] < MY_INT_TEST_Period[i]))
+		{
+			continue;
+		}
+
+		MY_INT_TEST_Elapsed[i] = 0;
+
+		/* Ошибка шины: TEIF, канал выключается аппаратно */
+		if((MY_INT_TEST_ErrorAt[i] != 0U) && (MY_INT_TEST_Moved[i] == MY_INT_TEST_ErrorAt[i]))
+		{
+			MY_INT_TEST_Raise(i, DMA_FLAG_TE);
+			channel->CCR &= ~DMA_CCR_EN;
+
+			continue;
+		}
+
+		channel->CNDTR--;
+		MY_INT_TEST_Moved[i]++;
+
+		if(channel->CNDTR == (MY_INT_TEST_Length[i] - MY_INT_TEST_Length[i] / 2U))
+		{
+			MY_INT_TEST_Raise(i, DMA_FLAG_HT);
+		}
+
+		if(channel->CNDTR == 0U)
+		{
+			MY_INT_TEST_Raise(i, DMA_FLAG_TC);
+
+			if(channel->CCR & DMA_CCR_CIRC)
+			{
+				channel->CNDTR = MY_INT_TEST_Length[i];
+			}
+		}
+	}
+}
+
+
+/* Запрос вектора: флаг любого канала вектора с разрешённым прерыванием */
+static uint32_t MY_INT_TEST_Pending(IRQn_Type IRQn)
+{
+	uint32_t i;
+
+	for(i = 0; i < DMA_CHANNELS; i++)
+	{
+		if((DMA1Handlers[i].IRQn == IRQn) &&
+		   ((DMA1->ISR >> (i * 4U)) & DMA1Handlers[i].Instance->CCR & MY_INT_TEST_IRQ_FLAGS))
+		{
+			return 1U;
+		}
+	}
+
+	return 0U;
+}
+
+
+/* Поток-NVIC: вход в обработчик вектора, пока есть запрос */
+static void MY_INT_TEST_Nvic(void)
+{
+	static const IRQn_Type vectors[] = { DMA1_Channel1_IRQn, DMA1_Channel2_3_IRQn, DMA1_Channel4_5_IRQn };
+	uint32_t i;
+
+	while(MY_INT_TEST_Running && (MY_HOST_Step_Count() < MY_INT_TEST_STEPS))
+	{
+		for(i = 0; i < sizeof(vectors) / sizeof(vectors[0]); i++)
+		{
+			if(MY_INT_TEST_Pending(vectors[i]))
+			{
+				MY_INT_TEST_Entries++;
+
+				MY_HOST_IPSR = vectors[i] + 16U;
+				MY_DMA_IRQ_Dispatch(vectors[i]);
+				MY_HOST_IPSR = 0;
+			}
+		}
+	}
+}
+
+
+/* Один вход в обработчик вектора MY_INT_TEST_IRQn */
+static void MY_INT_TEST_Dispatch(void)
+{
+	MY_DMA_IRQ_Dispatch(MY_INT_TEST_IRQn);
+}
+
+
+static void MY_INT_TEST_Poll(void)
+{
+	uint32_t start = MY_SysTick_GetTick();
+
+	MY_INT_TEST_Result = MY_DMA_PollForTransfer(MY_INT_TEST_Handler, MY_INT_TEST_Level, MY_INT_TEST_Timeout);
+	MY_INT_TEST_Ticks = MY_SysTick_GetTick() - start;
+}
+
+
+static void MY_INT_TEST_Log(MY_DMA_Handle_t *DMA_Handler, char Event)
+{
+	if(MY_INT_TEST_EventCount < MY_INT_TEST_EVENTS)
+	{
+		MY_INT_TEST_Events[MY_INT_TEST_EventCount] = Event;
+		MY_INT_TEST_EventChannel[MY_INT_TEST_EventCount] = MY_INT_TEST_Index(DMA_Handler);
+		MY_INT_TEST_EventCounter[MY_INT_TEST_EventCount] = DMA_Handler->Instance->CNDTR;
+	}
+
+	MY_INT_TEST_EventCount++;
+}
+
+
+static void MY_INT_TEST_Half(MY_DMA_Handle_t *DMA_Handler)
+{
+	MY_INT_TEST_Log(DMA_Handler, 'H');
+}
+
+
+/* Завершение: в циклическом режиме останавливает поток после MY_INT_TEST_Laps кругов */
+static void MY_INT_TEST_Complete(MY_DMA_Handle_t *DMA_Handler)
+{
+	MY_INT_TEST_Log(DMA_Handler, 'C');
+
+	if((MY_INT_TEST_Laps == 0U) || (--MY_INT_TEST_Laps == 0U))
+	{
+		MY_INT_TEST_Running = 0;
+	}
+}
+
+
+static void MY_INT_TEST_Error(MY_DMA_Handle_t *DMA_Handler)
+{
+	MY_INT_TEST_Log(DMA_Handler, 'E');
+
+	MY_INT_TEST_Running = 0;
+}
+
+
+static void MY_INT_TEST_Aborted(MY_DMA_Handle_t *DMA_Handler)
+{
+	MY_INT_TEST_Log(DMA_Handler, 'A');
+}
+
+
+/* Структуры каналов - статические переменные драйвера, MY_HOST_Reset() их не сбрасывает */
+static void MY_INT_TEST_Setup(void)
+{
+	uint32_t i;
+
+	for(i = 0; i < DMA_CHANNELS; i++)
+	{
+		DMA1Handlers[i].State = MY_DMA_State_Reset;
+		MY_Lock_Init(&DMA1Handlers[i].Lock);
+
+		MY_INT_TEST_Period[i] = 0;
+		MY_INT_TEST_Elapsed[i] = 0;
+		MY_INT_TEST_Length[i] = 0;
+		MY_INT_TEST_Moved[i] = 0;
+		MY_INT_TEST_ErrorAt[i] = 0;
+		MY_INT_TEST_Enabled[i] = 0;
+	}
+
+	MY_INT_TEST_EventCount = 0;
+	MY_INT_TEST_Laps = 0;
+	MY_INT_TEST_Entries = 0;
+}
+
+
+/* Инициализация канала с callback-функциями журнала */
+static MY_DMA_Handle_t* MY_INT_TEST_Channel(DMA_Channel_TypeDef *Channel, uint32_t Mode)
+{
+	MY_DMA_Init_t init =
+	{
+		.Direction = DMA_PERIPH_TO_MEMORY,
+		.PeriphInc = DMA_PERIPH_INC_DISABLE,
+		.MemInc = DMA_MEMORY_INC_ENABLE,
+		.PeriphDataAlignment = DMA_PERIPH_DATAALIGN_BYTE,
+		.MemDataAlignment = DMA_MEMORY_DATAALIGN_BYTE,
+		.Mode = Mode,
+		.Priority = DMA_PRIORITY_LOW
+	};
+	MY_DMA_Handle_t *handler;
+
+	MY_HOST_EQUAL(MY_DMA_Init(Channel, &init), MY_Result_Ok);
+	MY_INT_TEST_Flags();
+
+	handler = MY_DMA_GetHandler(Channel);
+
+	handler->XferCpltCallback = MY_INT_TEST_Complete;
+	handler->XferErrorCallback = MY_INT_TEST_Error;
+	handler->XferAbortCallback = MY_INT_TEST_Aborted;
+
+	return handler;
+}
+
+
+static void MY_INT_TEST_Start(MY_DMA_Handle_t *DMA_Handler, uint32_t Length, uint32_t Period)
+{
+	uint32_t index = MY_INT_TEST_Index(DMA_Handler);
+
+	MY_INT_TEST_Period[index] = Period;
+	MY_INT_TEST_Moved[index] = 0;
+
+	MY_HOST_EQUAL(MY_DMA_Start_IT(DMA_Handler, 0x20000000U, 0x20001000U, Length), MY_Result_Ok);
+	MY_INT_TEST_Flags();
+}
+
+
+static uint32_t MY_INT_TEST_Run(void)
+{
+	MY_INT_TEST_Running = 1;
+
+	return MY_HOST_Step_Run(MY_INT_TEST_Nvic, MY_INT_TEST_Hook);
+}
+
+
+/* Циклический режим: HT и TC чередуются на каждом круге, канал остаётся включённым, Abort останавливает его */
+static void MY_INT_TEST_Circular(void)
+{
+	MY_DMA_Handle_t *handler;
+	uint32_t i;
+
+	MY_INT_TEST_Setup();
+
+	handler = MY_INT_TEST_Channel(DMA1_Channel1, DMA_MODE_CIRCULAR);
+	handler->XferHalfCpltCallback = MY_INT_TEST_Half;
+
+	MY_INT_TEST_Laps = 4;
+	MY_INT_TEST_Start(handler, 16, MY_INT_TEST_PERIOD);
+
+	MY_HOST_EQUAL(handler->Instance->CCR & MY_INT_TEST_IRQ_FLAGS, DMA_CCR_TCIE | DMA_CCR_HTIE | DMA_CCR_TEIE);
+	MY_HOST_EQUAL(MY_DMA_INT_PowerConstraint(), MY_PWR_State_Sleep);
+
+	MY_HOST_CHECK(MY_INT_TEST_Run() < MY_INT_TEST_STEPS);
+
+	MY_HOST_EQUAL(MY_INT_TEST_EventCount, 8U);
+
+	for(i = 0; i < 8U; i++)
+	{
+		MY_HOST_EQUAL(MY_INT_TEST_Events[i], (i & 1U) ? 'C' : 'H');
+		MY_HOST_EQUAL(MY_INT_TEST_EventChannel[i], 0U);
+
+		/* Callback вызывается вскоре после флага: не позже чем через элемент */
+		MY_HOST_CHECK(MY_INT_TEST_EventCounter[i] + 1U >= ((i & 1U) ? 16U : 8U));
+	}
+
+	/* Прерывание на каждый флаг, без лишних входов */
+	MY_HOST_EQUAL(MY_INT_TEST_Entries, 8U);
+	MY_HOST_CHECK((MY_INT_TEST_Moved[0] >= 4U * 16U) && (MY_INT_TEST_Moved[0] <= 4U * 16U + 1U));
+
+	/* Круги продолжаются: канал включён, прерывания разрешены */
+	MY_HOST_EQUAL(handler->State, MY_DMA_State_Busy);
+	MY_HOST_EQUAL(handler->Instance->CCR & (DMA_CCR_EN | MY_INT_TEST_IRQ_FLAGS), DMA_CCR_EN | DMA_CCR_TCIE | DMA_CCR_HTIE | DMA_CCR_TEIE);
+
+	/* Полная передача в циклическом режиме не завершается */
+	MY_HOST_EQUAL(MY_DMA_PollForTransfer(handler, MY_DMA_Full_Transfer, 1U), MY_Result_Error);
+	MY_HOST_EQUAL(handler->ErrorCode, DMA_ERROR_NOT_SUPPORTED);
+
+	/* Ожидание половины работает на каждом круге */
+	MY_INT_TEST_Handler = handler;
+	MY_INT_TEST_Level = MY_DMA_Half_Transfer;
+	MY_INT_TEST_Timeout = MAX_DELAY;
+
+	for(i = 0; i < 2U; i++)
+	{
+		MY_HOST_Step_Run(MY_INT_TEST_Poll, MY_INT_TEST_Hook);
+
+		MY_HOST_EQUAL(MY_INT_TEST_Result, MY_Result_Ok);
+		MY_HOST_EQUAL(handler->Instance->CNDTR, 8U);
+		MY_HOST_EQUAL(DMA1->ISR & DMA_ISR_HTIF1, 0U);
+	}
+
+	/* Abort выключает канал и прерывания, вызывает XferAbortCallback */
+	MY_HOST_EQUAL(MY_DMA_Abort(handler), MY_Result_Ok);
+	MY_INT_TEST_Flags();
+
+	MY_HOST_EQUAL(handler->State, MY_DMA_State_Ready);
+	MY_HOST_EQUAL(handler->Instance->CCR & (DMA_CCR_EN | MY_INT_TEST_IRQ_FLAGS), 0U);
+	MY_HOST_EQUAL(DMA1->ISR & 0x0FU, 0U);
+	MY_HOST_EQUAL(MY_INT_TEST_EventCount, 9U);
+	MY_HOST_EQUAL(MY_INT_TEST_Events[8], 'A');
+	MY_HOST_EQUAL(MY_DMA_INT_PowerConstraint(), MY_PWR_State_Standby);
+
+	/* После остановки канал не передаёт и прерываний нет */
+	i = MY_INT_TEST_Moved[0];
+	MY_INT_TEST_Run();
+
+	MY_HOST_EQUAL(MY_INT_TEST_EventCount, 9U);
+	MY_HOST_EQUAL(MY_INT_TEST_Moved[0], i);
+
+	/* Повторный Abort: передачи нет */
+	MY_HOST_EQUAL(MY_DMA_Abort(handler), MY_Result_Error);
+	MY_HOST_EQUAL(handler->ErrorCode, DMA_ERROR_NO_XFER);
+	MY_HOST_EQUAL(MY_INT_TEST_EventCount, 9U);
+}
+
+
+/* Нормальный режим: HT один раз, после TC канал готов, прерывания запрещены. Без XferHalfCpltCallback HT не разрешается */
+static void MY_INT_TEST_Normal(void)
+{
+	MY_DMA_Handle_t *handler;
+
+	MY_INT_TEST_Setup();
+
+	handler = MY_INT_TEST_Channel(DMA1_Channel4, DMA_MODE_NORMAL);
+	handler->XferHalfCpltCallback = MY_INT_TEST_Half;
+
+	MY_INT_TEST_Start(handler, 9, MY_INT_TEST_PERIOD);
+	MY_HOST_CHECK(MY_INT_TEST_Run() < MY_INT_TEST_STEPS);
+
+	MY_HOST_EQUAL(MY_INT_TEST_EventCount, 2U);
+	MY_HOST_EQUAL(MY_INT_TEST_Events[0], 'H');
+	MY_HOST_EQUAL(MY_INT_TEST_Events[1], 'C');
+	MY_HOST_EQUAL(MY_INT_TEST_EventChannel[1], 3U);
+	MY_HOST_EQUAL(MY_INT_TEST_EventCounter[1], 0U);
+	MY_HOST_EQUAL(MY_INT_TEST_Entries, 2U);
+
+	MY_HOST_EQUAL(handler->State, MY_DMA_State_Ready);
+	MY_HOST_EQUAL(handler->ErrorCode, DMA_ERROR_NONE);
+	MY_HOST_EQUAL(handler->Instance->CCR & MY_INT_TEST_IRQ_FLAGS, 0U);
+	MY_HOST_EQUAL(DMA1->ISR, 0U);
+	MY_HOST_EQUAL(MY_DMA_GetCounter(handler), 0U);
+
+	/* Без callback-функции половины флаг HT остаётся, но прерывания по нему нет */
+	handler->XferHalfCpltCallback = NULL;
+	MY_INT_TEST_EventCount = 0;
+	MY_INT_TEST_Entries = 0;
+
+	MY_INT_TEST_Start(handler, 9, MY_INT_TEST_PERIOD);
+
+	MY_HOST_EQUAL(handler->Instance->CCR & MY_INT_TEST_IRQ_FLAGS, DMA_CCR_TCIE | DMA_CCR_TEIE);
+
+	MY_HOST_CHECK(MY_INT_TEST_Run() < MY_INT_TEST_STEPS);
+
+	MY_HOST_EQUAL(MY_INT_TEST_EventCount, 1U);
+	MY_HOST_EQUAL(MY_INT_TEST_Events[0], 'C');
+	MY_HOST_EQUAL(MY_INT_TEST_Entries, 1U);
+	MY_HOST_EQUAL(handler->State, MY_DMA_State_Ready);
+}
+
+
+/* Общие векторы: один вход обслуживает все инициализированные каналы вектора и только их */
+static void MY_INT_TEST_Shared(void)
+{
+	MY_DMA_Handle_t *handler[DMA_CHANNELS];
+	uint32_t i;
+
+	MY_INT_TEST_Setup();
+
+	/* Канал 5 не инициализирован: его флаги и биты CCR принадлежат не драйверу */
+	for(i = 0; i < DMA_CHANNELS - 1U; i++)
+	{
+		handler[i] = MY_INT_TEST_Channel(DMA1Handlers[i].Instance, DMA_MODE_NORMAL);
+		handler[i]->XferHalfCpltCallback = MY_INT_TEST_Half;
+
+		MY_INT_TEST_Start(handler[i], 10, 0);
+	}
+
+	MY_HOST_EQUAL(handler[0]->IRQn, DMA1_Channel1_IRQn);
+	MY_HOST_EQUAL(handler[1]->IRQn, DMA1_Channel2_3_IRQn);
+	MY_HOST_EQUAL(handler[2]->IRQn, DMA1_Channel2_3_IRQn);
+	MY_HOST_EQUAL(handler[3]->IRQn, DMA1_Channel4_5_IRQn);
+
+	DMA1_Channel5->CCR = DMA_CCR_TCIE | DMA_CCR_EN;
+
+	for(i = 0; i < DMA_CHANNELS; i++)
+	{
+		MY_INT_TEST_Raise(i, DMA_FLAG_TC);
+	}
+
+	/* Каналы 2 и 3 - за один вход, каналы 1, 4 и 5 не затронуты */
+	MY_INT_TEST_IRQn = DMA1_Channel2_3_IRQn;
+	MY_HOST_Step_Run(MY_INT_TEST_Dispatch, MY_INT_TEST_Hook);
+	MY_INT_TEST_Flags();
+
+	MY_HOST_EQUAL(MY_INT_TEST_EventCount, 2U);
+	MY_HOST_EQUAL(MY_INT_TEST_Events[0], 'C');
+	MY_HOST_EQUAL(MY_INT_TEST_EventChannel[0], 1U);
+	MY_HOST_EQUAL(MY_INT_TEST_Events[1], 'C');
+	MY_HOST_EQUAL(MY_INT_TEST_EventChannel[1], 2U);
+
+	MY_HOST_EQUAL(DMA1->ISR, DMA_ISR_GIF1 | DMA_ISR_TCIF1 | DMA_ISR_GIF4 | DMA_ISR_TCIF4 | DMA_ISR_GIF5 | DMA_ISR_TCIF5);
+	MY_HOST_EQUAL(handler[1]->State, MY_DMA_State_Ready);
+	MY_HOST_EQUAL(handler[2]->State, MY_DMA_State_Ready);
+	MY_HOST_EQUAL(handler[0]->State, MY_DMA_State_Busy);
+	MY_HOST_EQUAL(handler[3]->State, MY_DMA_State_Busy);
+
+	/* Канал 4 обслуживается, флаги неинициализированного канала 5 остаются для его владельца */
+	MY_INT_TEST_IRQn = DMA1_Channel4_5_IRQn;
+	MY_HOST_Step_Run(MY_INT_TEST_Dispatch, MY_INT_TEST_Hook);
+	MY_INT_TEST_Flags();
+
+	MY_HOST_EQUAL(MY_INT_TEST_EventCount, 3U);
+	MY_HOST_EQUAL(MY_INT_TEST_EventChannel[2], 3U);
+	MY_HOST_EQUAL(DMA1->ISR, DMA_ISR_GIF1 | DMA_ISR_TCIF1 | DMA_ISR_GIF5 | DMA_ISR_TCIF5);
+	MY_HOST_EQUAL(DMA1_Channel5->CCR, DMA_CCR_TCIE | DMA_CCR_EN);
+
+	MY_INT_TEST_IRQn = DMA1_Channel1_IRQn;
+	MY_HOST_Step_Run(MY_INT_TEST_Dispatch, MY_INT_TEST_Hook);
+	MY_INT_TEST_Flags();
+
+	MY_HOST_EQUAL(MY_INT_TEST_EventCount, 4U);
+	MY_HOST_EQUAL(MY_INT_TEST_EventChannel[3], 0U);
+	MY_HOST_EQUAL(DMA1->ISR, DMA_ISR_GIF5 | DMA_ISR_TCIF5);
+
+	/* Флаг завершённого канала без разрешённого прерывания и вектор без флагов - без вызовов */
+	MY_INT_TEST_Raise(1, DMA_FLAG_TC);
+
+	MY_INT_TEST_IRQn = DMA1_Channel2_3_IRQn;
+	MY_HOST_Step_Run(MY_INT_TEST_Dispatch, MY_INT_TEST_Hook);
+	MY_INT_TEST_Flags();
+
+	MY_HOST_EQUAL(MY_INT_TEST_EventCount, 4U);
+	MY_HOST_CHECK(DMA1->ISR & DMA_ISR_TCIF2);
+
+	/* HT и TC одновременно: за вход одно событие, вектор остаётся в ожидании до второго входа */
+	DMA1->ISR = 0U;
+
+	MY_INT_TEST_Start(handler[2], 10, 0);
+	MY_INT_TEST_Raise(2, DMA_FLAG_HT | DMA_FLAG_TC);
+
+	MY_HOST_Step_Run(MY_INT_TEST_Dispatch, MY_INT_TEST_Hook);
+	MY_INT_TEST_Flags();
+
+	MY_HOST_EQUAL(MY_INT_TEST_EventCount, 5U);
+	MY_HOST_EQUAL(MY_INT_TEST_Events[4], 'H');
+	MY_HOST_EQUAL(MY_INT_TEST_Pending(DMA1_Channel2_3_IRQn), 1U);
+
+	MY_HOST_Step_Run(MY_INT_TEST_Dispatch, MY_INT_TEST_Hook);
+	MY_INT_TEST_Flags();
+
+	MY_HOST_EQUAL(MY_INT_TEST_EventCount, 6U);
+	MY_HOST_EQUAL(MY_INT_TEST_Events[5], 'C');
+	MY_HOST_EQUAL(MY_INT_TEST_Pending(DMA1_Channel2_3_IRQn), 0U);
+	MY_HOST_EQUAL(DMA1->ISR, 0U);
+}
+
+
+/* Ошибка шины в прерывании и при ожидании: TE, канал готов к новой передаче */
+static void MY_INT_TEST_TransferError(void)
+{
+	MY_DMA_Handle_t *handler;
+
+	MY_INT_TEST_Setup();
+
+	handler = MY_INT_TEST_Channel(DMA1_Channel3, DMA_MODE_NORMAL);
+	handler->XferHalfCpltCallback = MY_INT_TEST_Half;
+
+	MY_INT_TEST_ErrorAt[2] = 3;
+	MY_INT_TEST_Start(handler, 12, MY_INT_TEST_PERIOD);
+
+	MY_HOST_CHECK(MY_INT_TEST_Run() < MY_INT_TEST_STEPS);
+
+	MY_HOST_EQUAL(MY_INT_TEST_EventCount, 1U);
+	MY_HOST_EQUAL(MY_INT_TEST_Events[0], 'E');
+	MY_HOST_EQUAL(MY_INT_TEST_EventCounter[0], 12U - 3U);
+	MY_HOST_EQUAL(handler->ErrorCode, DMA_ERROR_TE);
+	MY_HOST_EQUAL(MY_DMA_GetError(handler), DMA_ERROR_TE);
+	MY_HOST_EQUAL(handler->State, MY_DMA_State_Ready);
+	MY_HOST_EQUAL(handler->Instance->CCR & (DMA_CCR_EN | MY_INT_TEST_IRQ_FLAGS), 0U);
+	MY_HOST_EQUAL(DMA1->ISR, 0U);
+	MY_HOST_EQUAL(MY_DMA_INT_PowerConstraint(), MY_PWR_State_Standby);
+
+	/* Новая передача после ошибки: код ошибки сброшен, передача завершается */
+	MY_INT_TEST_ErrorAt[2] = 0;
+	MY_INT_TEST_EventCount = 0;
+
+	MY_INT_TEST_Start(handler, 12, MY_INT_TEST_PERIOD);
+
+	MY_HOST_EQUAL(handler->ErrorCode, DMA_ERROR_NONE);
+	MY_HOST_CHECK(MY_INT_TEST_Run() < MY_INT_TEST_STEPS);
+
+	MY_HOST_EQUAL(MY_INT_TEST_EventCount, 2U);
+	MY_HOST_EQUAL(MY_INT_TEST_Events[1], 'C');
+	MY_HOST_EQUAL(handler->ErrorCode, DMA_ERROR_NONE);
+
+	/* Ожидание без прерываний видит TEIF */
+	MY_INT_TEST_ErrorAt[2] = 7;
+	MY_INT_TEST_Moved[2] = 0;
+	MY_INT_TEST_Period[2] = MY_INT_TEST_PERIOD;
+
+	MY_HOST_EQUAL(MY_DMA_Start(handler, 0x20000000U, 0x20001000U, 12), MY_Result_Ok);
+	MY_INT_TEST_Flags();
+
+	MY_INT_TEST_Handler = handler;
+	MY_INT_TEST_Level = MY_DMA_Full_Transfer;
+	MY_INT_TEST_Timeout = MAX_DELAY;
+
+	MY_HOST_Step_Run(MY_INT_TEST_Poll, MY_INT_TEST_Hook);
+	MY_INT_TEST_Flags();
+
+	MY_HOST_EQUAL(MY_INT_TEST_Result, MY_Result_Error);
+	MY_HOST_EQUAL(handler->ErrorCode, DMA_ERROR_TE);
+	MY_HOST_EQUAL(handler->State, MY_DMA_State_Ready);
+	MY_HOST_EQUAL(handler->Instance->CNDTR, 12U - 7U);
+	MY_HOST_EQUAL(DMA1->ISR, 0U);
+	MY_HOST_EQUAL(MY_INT_TEST_EventCount, 2U);
+}
+
+
+/* Ожидание: таймаут по тикам, Abort из состояния Timeout, завершение опросом, опрос без передачи */
+static void MY_INT_TEST_PollTimeout(void)
+{
+	MY_DMA_Handle_t *handler;
+
+	MY_INT_TEST_Setup();
+
+	MY_HOST_RCC_Config(&(MY_HOST_RCC_Delays_t){ .Tick = MY_INT_TEST_TICK });
+
+	handler = MY_INT_TEST_Channel(DMA1_Channel2, DMA_MODE_NORMAL);
+
+	MY_INT_TEST_Handler = handler;
+	MY_INT_TEST_Level = MY_DMA_Full_Transfer;
+	MY_INT_TEST_Timeout = 5;
+
+	/* Опрос без передачи */
+	MY_HOST_EQUAL(MY_DMA_PollForTransfer(handler, MY_DMA_Full_Transfer, 5U), MY_Result_Error);
+	MY_HOST_EQUAL(handler->ErrorCode, DMA_ERROR_NO_XFER);
+
+	/* Канал не передаёт: таймаут на первом тике после Timeout */
+	MY_HOST_EQUAL(MY_DMA_Start(handler, 0x20000000U, 0x20001000U, 8), MY_Result_Ok);
+	MY_INT_TEST_Flags();
+
+	MY_HOST_Step_Run(MY_INT_TEST_Poll, MY_INT_TEST_Hook);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Result, MY_Result_Timeout);
+	MY_HOST_EQUAL(handler->ErrorCode, DMA_ERROR_TIMEOUT);
+	MY_HOST_EQUAL(handler->State, MY_DMA_State_Timeout);
+	MY_HOST_CHECK((MY_INT_TEST_Ticks >= 5U + 1U) && (MY_INT_TEST_Ticks <= 5U + 2U));
+
+	/* Канал в таймауте не запускается повторно до Abort, но и не держит Stop */
+	MY_HOST_EQUAL(MY_DMA_INT_PowerConstraint(), MY_PWR_State_Standby);
+
+	MY_HOST_EQUAL(MY_DMA_Abort(handler), MY_Result_Ok);
+	MY_INT_TEST_Flags();
+
+	MY_HOST_EQUAL(handler->State, MY_DMA_State_Ready);
+	MY_HOST_EQUAL(handler->Instance->CCR & DMA_CCR_EN, 0U);
+	MY_HOST_EQUAL(MY_INT_TEST_EventCount, 1U);
+	MY_HOST_EQUAL(MY_INT_TEST_Events[0], 'A');
+
+	/* Передача успевает: канал выключен, флаги сброшены */
+	MY_INT_TEST_Period[1] = MY_INT_TEST_TICK / 2U;
+	MY_INT_TEST_Moved[1] = 0;
+
+	MY_HOST_EQUAL(MY_DMA_Start(handler, 0x20000000U, 0x20001000U, 8), MY_Result_Ok);
+	MY_INT_TEST_Flags();
+
+	MY_INT_TEST_Timeout = 10;
+	MY_HOST_Step_Run(MY_INT_TEST_Poll, MY_INT_TEST_Hook);
+	MY_INT_TEST_Flags();
+
+	MY_HOST_EQUAL(MY_INT_TEST_Result, MY_Result_Ok);
+	MY_HOST_EQUAL(handler->State, MY_DMA_State_Ready);
+	MY_HOST_EQUAL(handler->ErrorCode, DMA_ERROR_NONE);
+	MY_HOST_EQUAL(handler->Instance->CCR & DMA_CCR_EN, 0U);
+	MY_HOST_EQUAL(MY_INT_TEST_Moved[1], 8U);
+	MY_HOST_CHECK(MY_INT_TEST_Ticks <= 5U);
+	MY_HOST_EQUAL(DMA1->ISR, 0U);
+
+	/* Передача длиннее таймаута */
+	MY_HOST_EQUAL(MY_DMA_Start(handler, 0x20000000U, 0x20001000U, 40), MY_Result_Ok);
+	MY_INT_TEST_Flags();
+
+	MY_HOST_Step_Run(MY_INT_TEST_Poll, MY_INT_TEST_Hook);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Result, MY_Result_Timeout);
+	MY_HOST_CHECK((MY_INT_TEST_Ticks >= 10U + 1U) && (MY_INT_TEST_Ticks <= 10U + 2U));
+	MY_HOST_CHECK(handler->Instance->CNDTR > 0U);
+
+	MY_HOST_EQUAL(MY_DMA_Abort(handler), MY_Result_Ok);
+}
+
+
+/* Копии меньше порога не настраивают канал копирования: он остаётся свободным для периферии */
+static void MY_INT_TEST_MemSmall(void)
+{
+	uint32_t src[DMA_MEM_THRESHOLD / 4U];
+	uint32_t dst[DMA_MEM_THRESHOLD / 4U];
+	uint32_t i;
+
+	MY_INT_TEST_Setup();
+
+	for(i = 0; i < DMA_MEM_THRESHOLD / 4U; i++)
+	{
+		src[i] = 0xA5A50000U + i;
+		dst[i] = 0;
+	}
+
+	MY_HOST_EQUAL(MY_DMA_Memcpy(dst, src, DMA_MEM_THRESHOLD - 4U), MY_Result_Ok);
+	MY_HOST_EQUAL(MY_DMA_Memset(src, 0x5A, DMA_MEM_THRESHOLD - 4U), MY_Result_Ok);
+
+	MY_HOST_EQUAL(memcmp(dst, (uint32_t[]){ 0xA5A50000U, 0xA5A50001U }, 8U), 0);
+	MY_HOST_EQUAL(src[0], 0x5A5A5A5AU);
+	MY_HOST_EQUAL(MY_DMA_GetHandler(DMA_MEM_CHANNEL)->State, MY_DMA_State_Reset);
+	MY_HOST_EQUAL(DMA_MEM_CHANNEL->CCR, 0U);
+	MY_HOST_EQUAL(RCC->AHBENR & RCC_AHBENR_DMA1EN, 0U);
+}
+
+
+int main(void)
+{
+	MY_HOST_RUN(MY_INT_TEST_Circular);
+	MY_HOST_RUN(MY_INT_TEST_Normal);
+	MY_HOST_RUN(MY_INT_TEST_Shared);
+	MY_HOST_RUN(MY_INT_TEST_TransferError);
+	MY_HOST_RUN(MY_INT_TEST_PollTimeout);
+	MY_HOST_RUN(MY_INT_TEST_MemSmall);
+
+	return MY_HOST_TEST_Report("dma");
+}
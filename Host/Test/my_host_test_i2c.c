@@ -0,0 +1,761 @@
+/**
+ * @author  Андрей Заостровных
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/i2c
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Тест MY_I2C: пересчёт TIMINGR при смене частот во время передачи,
+ * 			передачи-сопрограммы на модели шины с ведомыми
+ */
+#include <string.h>
+
+#include "my_host_test.h"
+#include "my_stm32f0xx_i2c.h"
+#include "my_stm32f0xx_rcc.h"
+
+#define MY_INT_TEST_SPEED						100000U
+
+static MY_I2C_Init_t *MY_INT_TEST_Handler;
+static uint32_t MY_INT_TEST_Timing8;
+static uint32_t MY_INT_TEST_Timing48;
+static MY_Result_t MY_INT_TEST_Result;
+
+
+/* SYSCLK = HSI 8 МГц, I2C1 тактируется от SYSCLK */
+static void MY_INT_TEST_Clock8(void)
+{
+	RCC->CFGR = 0;
+	RCC->CFGR3 = RCC_CFGR3_I2C1SW;
+
+	MY_RCC_ClockTree_Update();
+}
+
+
+/* SYSCLK = PLL 48 МГц (HSI / 2 * 12) */
+static void MY_INT_TEST_Clock48(void)
+{
+	RCC->CFGR = RCC_CFGR_SW_PLL | RCC_CFGR_SWS_PLL | RCC_CFGR_PLLMUL12;
+	RCC->CFGR3 = RCC_CFGR3_I2C1SW;
+
+	MY_RCC_ClockTree_Update();
+}
+
+
+static void MY_INT_TEST_Setup(void)
+{
+	MY_INT_TEST_Handler = MY_I2C_GetHandler(I2C1);
+	MY_INT_TEST_Handler->ClockSpeed = MY_INT_TEST_SPEED;
+
+	MY_INT_TEST_Timing8 = MY_I2C_Timing_Calc(8000000U, MY_INT_TEST_SPEED);
+	MY_INT_TEST_Timing48 = MY_I2C_Timing_Calc(48000000U, MY_INT_TEST_SPEED);
+
+	MY_INT_TEST_Clock8();
+
+	MY_HOST_EQUAL(MY_I2C_Init(I2C1), MY_Result_Ok);
+	MY_HOST_EQUAL(I2C1->TIMINGR, MY_INT_TEST_Timing8);
+	MY_HOST_CHECK(I2C1->CR1 & I2C_CR1_PE);
+}
+
+
+/* Свободный I2C перенастраивается сразу */
+static void MY_INT_TEST_Idle(void)
+{
+	MY_INT_TEST_Setup();
+
+	MY_HOST_CHECK(MY_INT_TEST_Timing8 != MY_INT_TEST_Timing48);
+
+	MY_INT_TEST_Clock48();
+
+	MY_HOST_EQUAL(I2C1->TIMINGR, MY_INT_TEST_Timing48);
+	MY_HOST_EQUAL(MY_INT_TEST_Handler->TimingPending, 0U);
+	MY_HOST_CHECK(I2C1->CR1 & I2C_CR1_PE);
+	MY_HOST_EQUAL(MY_Lock_IsLocked(&MY_INT_TEST_Handler->Lock), 0U);
+}
+
+
+/* Занятый I2C не выключается: TIMINGR применяется при освобождении */
+static void MY_INT_TEST_Locked(void)
+{
+	MY_INT_TEST_Setup();
+
+	MY_HOST_EQUAL(MY_Lock_Acquire(&MY_INT_TEST_Handler->Lock, 0U), MY_Result_Ok);
+
+	MY_INT_TEST_Clock48();
+
+	MY_HOST_EQUAL(I2C1->TIMINGR, MY_INT_TEST_Timing8);
+	MY_HOST_EQUAL(MY_INT_TEST_Handler->TimingPending, 1U);
+
+	MY_Lock_Release(&MY_INT_TEST_Handler->Lock);
+
+	/* Следующая передача освобождает I2C через драйвер */
+	I2C1->ISR = I2C_ISR_STOPF;
+
+	MY_HOST_EQUAL(MY_I2C_IsDeviceReady(I2C1, 0x78U, 1U, 10U), MY_Result_Ok);
+	MY_HOST_EQUAL(I2C1->TIMINGR, MY_INT_TEST_Timing48);
+	MY_HOST_EQUAL(MY_INT_TEST_Handler->TimingPending, 0U);
+	MY_HOST_CHECK(I2C1->CR1 & I2C_CR1_PE);
+}
+
+
+static void MY_INT_TEST_Transfer(void)
+{
+	MY_INT_TEST_Result = MY_I2C_IsDeviceReady(I2C1, 0x78U, 1U, 10U);
+}
+
+
+/* Смена частоты из прерывания */
+static uint32_t MY_INT_TEST_Busy;
+
+static void MY_INT_TEST_ClockIsr(void)
+{
+	MY_INT_TEST_Busy = MY_Lock_IsLocked(&MY_INT_TEST_Handler->Lock);
+
+	MY_INT_TEST_Clock48();
+
+	/* Во время передачи I2C не выключается и TIMINGR не меняется */
+	if (MY_INT_TEST_Busy)
+	{
+		MY_HOST_EQUAL(I2C1->TIMINGR, MY_INT_TEST_Timing8);
+		MY_HOST_CHECK(I2C1->CR1 & I2C_CR1_PE);
+	}
+}
+
+
+/* Смена частоты на каждой границе инструкций передачи: итог всегда новый TIMINGR */
+static void MY_INT_TEST_Preempt(void)
+{
+	uint32_t steps;
+	uint32_t busy = 0;
+	uint32_t at;
+
+	MY_INT_TEST_Setup();
+
+	I2C1->ISR = I2C_ISR_STOPF;
+
+	steps = MY_HOST_Step_Run(MY_INT_TEST_Transfer, NULL);
+
+	for (at = 0; at <= steps; at++)
+	{
+		MY_INT_TEST_Clock8();
+		I2C1->TIMINGR = MY_INT_TEST_Timing8;
+
+		MY_HOST_Preempt_Run(MY_INT_TEST_Transfer, MY_INT_TEST_ClockIsr, 16U + I2C1_IRQn, at);
+
+		MY_HOST_EQUAL(MY_INT_TEST_Result, MY_Result_Ok);
+		MY_HOST_EQUAL(I2C1->TIMINGR, MY_INT_TEST_Timing48);
+		MY_HOST_EQUAL(MY_INT_TEST_Handler->TimingPending, 0U);
+		MY_HOST_EQUAL(MY_Lock_IsLocked(&MY_INT_TEST_Handler->Lock), 0U);
+
+		busy += MY_INT_TEST_Busy;
+	}
+
+	/* Часть прерываний пришлась на передачу */
+	MY_HOST_CHECK(busy > 0U);
+}
+
+
+/*
+ * Модель шины I2C для передач-сопрограмм. Обработчик шага играет роль аппаратуры и прерывания
+ * I2C: через Latency инструкций после каждого события выставляет следующий флаг. Ведомые - клиенты
+ * с тем же адресом на той же шине: запись сохраняется в журнал клиента, чтение отдаёт байты
+ * MY_INT_TEST_SlaveByte(). Чтение RXDR и запись TXDR модель видит по уменьшению Count контекста
+ * передачи. При TCR модель обнуляет NBYTES, поэтому запись следующей части видна по NBYTES != 0.
+ */
+#define MY_INT_TEST_CLIENTS						6U
+#define MY_INT_TEST_ROUNDS						2U
+#define MY_INT_TEST_SIZE_MAX					300U
+
+/* Проходов суперцикла на тик SysTick */
+#define MY_INT_TEST_LOOPS						4U
+
+typedef struct
+{
+	MY_PT_t				PT;
+	MY_I2C_PT_t			I2C;
+	MY_I2C_Init_t		*Handler;
+	uint16_t			Address;
+	uint16_t			Size;
+	uint32_t			Timeout;
+	uint32_t			Rounds;
+	uint32_t			Round;
+	uint32_t			Done;
+	MY_Result_t			Results[2U * MY_INT_TEST_ROUNDS];
+	uint32_t			ErrorCode;			/* ErrorCode всех передач */
+	uint32_t			RxErrors;
+	uint32_t			Contended;			/* Вызовов в ожидании занятой шины */
+	uint8_t				Tx[MY_INT_TEST_SIZE_MAX];
+	uint8_t				Rx[MY_INT_TEST_SIZE_MAX];
+	uint8_t				Slave[MY_INT_TEST_ROUNDS * MY_INT_TEST_SIZE_MAX];
+	uint32_t			SlaveCount;
+}
+MY_INT_TEST_Client_t;
+
+typedef enum
+{
+	MY_INT_TEST_Bus_Idle,
+	MY_INT_TEST_Bus_Wait,					/* Событие Event через Wait инструкций */
+	MY_INT_TEST_Bus_Data,					/* TXIS/RXNE выставлен, ждём драйвер */
+	MY_INT_TEST_Bus_Reload					/* TCR выставлен, ждём новый NBYTES */
+}
+MY_INT_TEST_BusState_t;
+
+typedef enum
+{
+	MY_INT_TEST_Event_Address,
+	MY_INT_TEST_Event_Data,
+	MY_INT_TEST_Event_Reload,
+	MY_INT_TEST_Event_Stop,
+	MY_INT_TEST_Event_Nack
+}
+MY_INT_TEST_Event_t;
+
+typedef struct
+{
+	I2C_TypeDef				*I2Cx;
+	MY_INT_TEST_Client_t	*Active;
+	MY_INT_TEST_BusState_t	State;
+	MY_INT_TEST_Event_t		Event;
+	uint32_t				Wait;
+	uint32_t				Latency;		/* Инструкций между событиями, MY_HOST_NEVER - ведомый молчит */
+	uint32_t				Nbytes;
+	uint32_t				Reload;
+	uint32_t				Read;
+	uint32_t				Index;
+	uint32_t				Seen;
+	uint32_t				NackAddress;	/* Адрес без подтверждения, MY_HOST_NEVER - нет */
+	uint32_t				NackByte;		/* Номер записываемого байта без подтверждения */
+	uint32_t				Transfers;
+	uint32_t				Overlaps;		/* START во время передачи */
+}
+MY_INT_TEST_Bus_t;
+
+static MY_INT_TEST_Client_t MY_INT_TEST_Clients[MY_INT_TEST_CLIENTS];
+static uint32_t MY_INT_TEST_ClientsCount;
+static MY_INT_TEST_Bus_t MY_INT_TEST_Buses[2];
+
+static MY_INT_TEST_Client_t *MY_INT_TEST_Current;
+static MY_PT_State_t MY_INT_TEST_State;
+
+
+static uint8_t MY_INT_TEST_SlaveByte(uint32_t Address, uint32_t Index)
+{
+	return (uint8_t)((Address * 7U) + (Index * 3U) + (Index >> 8));
+}
+
+
+static void MY_INT_TEST_Schedule(MY_INT_TEST_Bus_t *Bus, MY_INT_TEST_Event_t Event)
+{
+	Bus->State = MY_INT_TEST_Bus_Wait;
+	Bus->Event = Event;
+	Bus->Wait = Bus->Latency;
+}
+
+
+/* Окончание передачи: STOP, при NACK - вместе с NACKF */
+static void MY_INT_TEST_Finish(MY_INT_TEST_Bus_t *Bus, uint32_t Flags)
+{
+	Bus->I2Cx->ISR = (Bus->I2Cx->ISR & ~(I2C_ISR_BUSY | I2C_ISR_TXIS | I2C_ISR_RXNE)) | Flags | I2C_ISR_STOPF;
+	Bus->State = MY_INT_TEST_Bus_Idle;
+	Bus->Active = NULL;
+}
+
+
+/* Следующий байт: RXNE с данными ведомого или TXIS */
+static void MY_INT_TEST_Data(MY_INT_TEST_Bus_t *Bus)
+{
+	if(Bus->Read)
+	{
+		Bus->I2Cx->RXDR = MY_INT_TEST_SlaveByte(Bus->Active->Address, Bus->Index);
+		Bus->I2Cx->ISR |= I2C_ISR_RXNE;
+	}
+	else
+	{
+		Bus->I2Cx->ISR |= I2C_ISR_TXIS;
+	}
+
+	Bus->State = MY_INT_TEST_Bus_Data;
+}
+
+
+static void MY_INT_TEST_Fire(MY_INT_TEST_Bus_t *Bus)
+{
+	I2C_TypeDef *i2c = Bus->I2Cx;
+
+	switch(Bus->Event)
+	{
+		case MY_INT_TEST_Event_Address:
+
+			if(Bus->Active->Address == Bus->NackAddress)
+			{
+				MY_INT_TEST_Finish(Bus, I2C_ISR_NACKF);
+			}
+			else
+			{
+				MY_INT_TEST_Data(Bus);
+			}
+			break;
+
+		case MY_INT_TEST_Event_Data:
+
+			MY_INT_TEST_Data(Bus);
+			break;
+
+		case MY_INT_TEST_Event_Reload:
+
+			i2c->ISR |= I2C_ISR_TCR;
+			i2c->CR2 &= ~I2C_CR2_NBYTES;
+			Bus->State = MY_INT_TEST_Bus_Reload;
+			break;
+
+		case MY_INT_TEST_Event_Stop:
+
+			MY_INT_TEST_Finish(Bus, 0U);
+			break;
+
+		case MY_INT_TEST_Event_Nack:
+
+			MY_INT_TEST_Finish(Bus, I2C_ISR_NACKF);
+			break;
+	}
+}
+
+
+static void MY_INT_TEST_BusStep(MY_INT_TEST_Bus_t *Bus)
+{
+	I2C_TypeDef *i2c = Bus->I2Cx;
+	uint32_t cr2 = i2c->CR2;
+	uint32_t i;
+
+	/* Флаги сбрасываются записью ICR */
+	if(i2c->ICR != 0U)
+	{
+		i2c->ISR &= ~i2c->ICR;
+		i2c->ICR = 0;
+	}
+
+	switch(Bus->State)
+	{
+		case MY_INT_TEST_Bus_Idle:
+
+			if(!(cr2 & I2C_CR2_START))
+			{
+				break;
+			}
+
+			for(i = 0; i < MY_INT_TEST_ClientsCount; i++)
+			{
+				if((MY_INT_TEST_Clients[i].Handler->Instance == i2c) && (MY_INT_TEST_Clients[i].Address == (cr2 & I2C_CR2_SADD)))
+				{
+					Bus->Active = &MY_INT_TEST_Clients[i];
+				}
+			}
+
+			MY_HOST_CHECK(Bus->Active != NULL);
+
+			if(Bus->Active == NULL)
+			{
+				i2c->CR2 = cr2 & ~I2C_CR2_START;
+				break;
+			}
+
+			Bus->Read = cr2 & I2C_CR2_RD_WRN;
+			Bus->Nbytes = (cr2 & I2C_CR2_NBYTES) >> I2C_CR2_NBYTES_Pos;
+			Bus->Reload = cr2 & I2C_CR2_RELOAD;
+			Bus->Index = 0;
+			Bus->Seen = Bus->Active->I2C.Count;
+			Bus->Transfers++;
+
+			i2c->CR2 = cr2 & ~I2C_CR2_START;
+			i2c->ISR |= I2C_ISR_BUSY;
+
+			MY_INT_TEST_Schedule(Bus, MY_INT_TEST_Event_Address);
+			break;
+
+		case MY_INT_TEST_Bus_Wait:
+
+			if((Bus->Wait != MY_HOST_NEVER) && (--Bus->Wait == 0U))
+			{
+				MY_INT_TEST_Fire(Bus);
+			}
+			break;
+
+		case MY_INT_TEST_Bus_Data:
+
+			if(Bus->Active->I2C.Count >= Bus->Seen)
+			{
+				break;
+			}
+
+			Bus->Seen = Bus->Active->I2C.Count;
+
+			if(Bus->Read)
+			{
+				i2c->ISR &= ~I2C_ISR_RXNE;
+			}
+			else
+			{
+				i2c->ISR &= ~I2C_ISR_TXIS;
+				Bus->Active->Slave[Bus->Active->SlaveCount++] = (uint8_t)i2c->TXDR;
+			}
+
+			Bus->Index++;
+			Bus->Nbytes--;
+
+			if(!Bus->Read && ((Bus->Index - 1U) == Bus->NackByte))
+			{
+				MY_INT_TEST_Schedule(Bus, MY_INT_TEST_Event_Nack);
+			}
+			else if(Bus->Nbytes != 0U)
+			{
+				MY_INT_TEST_Schedule(Bus, MY_INT_TEST_Event_Data);
+			}
+			else
+			{
+				MY_INT_TEST_Schedule(Bus, Bus->Reload ? MY_INT_TEST_Event_Reload : MY_INT_TEST_Event_Stop);
+			}
+			break;
+
+		case MY_INT_TEST_Bus_Reload:
+
+			if(cr2 & I2C_CR2_NBYTES)
+			{
+				Bus->Nbytes = (cr2 & I2C_CR2_NBYTES) >> I2C_CR2_NBYTES_Pos;
+				Bus->Reload = cr2 & I2C_CR2_RELOAD;
+				i2c->ISR &= ~I2C_ISR_TCR;
+
+				MY_INT_TEST_Schedule(Bus, MY_INT_TEST_Event_Data);
+			}
+			break;
+	}
+
+	if((Bus->State != MY_INT_TEST_Bus_Idle) && (Bus->Event != MY_INT_TEST_Event_Address) && (i2c->CR2 & I2C_CR2_START))
+	{
+		Bus->Overlaps++;
+	}
+}
+
+
+static void MY_INT_TEST_BusHook(void)
+{
+	MY_INT_TEST_BusStep(&MY_INT_TEST_Buses[0]);
+	MY_INT_TEST_BusStep(&MY_INT_TEST_Buses[1]);
+}
+
+
+static void MY_INT_TEST_BusSetup(uint32_t Latency)
+{
+	uint32_t i;
+
+	/* Передача, оставленная предыдущим случаем, не держит блокировку */
+	MY_Lock_Init(&MY_I2C_GetHandler(I2C1)->Lock);
+	MY_Lock_Init(&MY_I2C_GetHandler(I2C2)->Lock);
+
+	MY_INT_TEST_Setup();
+
+	MY_I2C_GetHandler(I2C2)->ClockSpeed = MY_INT_TEST_SPEED;
+	MY_HOST_EQUAL(MY_I2C_Init(I2C2), MY_Result_Ok);
+
+	memset(MY_INT_TEST_Buses, 0, sizeof(MY_INT_TEST_Buses));
+	memset(MY_INT_TEST_Clients, 0, sizeof(MY_INT_TEST_Clients));
+	MY_INT_TEST_ClientsCount = 0;
+
+	MY_INT_TEST_Buses[0].I2Cx = I2C1;
+	MY_INT_TEST_Buses[1].I2Cx = I2C2;
+
+	for(i = 0; i < 2U; i++)
+	{
+		MY_INT_TEST_Buses[i].Latency = Latency;
+		MY_INT_TEST_Buses[i].NackAddress = MY_HOST_NEVER;
+		MY_INT_TEST_Buses[i].NackByte = MY_HOST_NEVER;
+		MY_INT_TEST_Buses[i].I2Cx->ISR = I2C_ISR_TXE;
+	}
+}
+
+
+static MY_INT_TEST_Client_t* MY_INT_TEST_AddClient(I2C_TypeDef *I2Cx, uint16_t Address, uint16_t Size, uint32_t Rounds)
+{
+	MY_INT_TEST_Client_t *client = &MY_INT_TEST_Clients[MY_INT_TEST_ClientsCount++];
+	uint32_t i;
+
+	client->Handler = MY_I2C_GetHandler(I2Cx);
+	client->Address = Address;
+	client->Size = Size;
+	client->Timeout = 1000U;
+	client->Rounds = Rounds;
+
+	for(i = 0; i < Size; i++)
+	{
+		client->Tx[i] = (uint8_t)(Address + (i * 13U));
+	}
+
+	MY_PT_INIT(&client->PT);
+
+	return client;
+}
+
+
+/* Клиент: запись Size байт и чтение Size байт, Rounds раз */
+static MY_PT_State_t MY_INT_TEST_ClientThread(MY_INT_TEST_Client_t *Client)
+{
+	uint32_t i;
+
+	MY_PT_BEGIN(&Client->PT);
+
+	for(Client->Round = 0; Client->Round < Client->Rounds; Client->Round++)
+	{
+		MY_I2C_PT_AWAIT(&Client->PT, &Client->I2C, MY_I2C_PT_Master_Transmit(&Client->I2C, Client->Handler, Client->Address, Client->Tx, Client->Size, Client->Timeout));
+		Client->Results[Client->Done++] = Client->I2C.Result;
+		Client->ErrorCode |= Client->Handler->ErrorCode;
+
+		memset(Client->Rx, 0, sizeof(Client->Rx));
+
+		MY_I2C_PT_AWAIT(&Client->PT, &Client->I2C, MY_I2C_PT_Master_Receive(&Client->I2C, Client->Handler, Client->Address, Client->Rx, Client->Size, Client->Timeout));
+		Client->Results[Client->Done++] = Client->I2C.Result;
+		Client->ErrorCode |= Client->Handler->ErrorCode;
+
+		for(i = 0; i < Client->Size; i++)
+		{
+			Client->RxErrors += (Client->Rx[i] != MY_INT_TEST_SlaveByte(Client->Address, i)) ? 1U : 0U;
+		}
+
+		MY_PT_YIELD(&Client->PT);
+	}
+
+	MY_PT_END(&Client->PT);
+}
+
+
+static void MY_INT_TEST_Call(void)
+{
+	MY_INT_TEST_State = MY_INT_TEST_ClientThread(MY_INT_TEST_Current);
+}
+
+
+/* Суперцикл: все клиенты по очереди, тик через MY_INT_TEST_LOOPS проходов. Возвращает число тиков до завершения всех */
+static uint32_t MY_INT_TEST_Loop(uint32_t MaxTicks)
+{
+	uint32_t tickstart = MY_SysTick_GetTick();
+	uint32_t running = MY_INT_TEST_ClientsCount;
+	uint32_t ended = 0;
+	uint32_t loops = 0;
+	uint32_t i;
+
+	while((running != 0U) && ((MY_SysTick_GetTick() - tickstart) < MaxTicks))
+	{
+		running = 0;
+
+		for(i = 0; i < MY_INT_TEST_ClientsCount; i++)
+		{
+			if(ended & (1U << i))
+			{
+				continue;
+			}
+
+			MY_INT_TEST_Current = &MY_INT_TEST_Clients[i];
+			MY_HOST_Step_Run(MY_INT_TEST_Call, MY_INT_TEST_BusHook);
+
+			if(MY_INT_TEST_State == MY_PT_State_Ended)
+			{
+				ended |= 1U << i;
+				continue;
+			}
+
+			running++;
+
+			if(MY_INT_TEST_Current->I2C.Result == MY_Result_Busy)
+			{
+				MY_INT_TEST_Current->Contended++;
+			}
+		}
+
+		if(++loops == MY_INT_TEST_LOOPS)
+		{
+			loops = 0;
+			MY_SysTick_IncTick();
+		}
+	}
+
+	MY_HOST_EQUAL(running, 0U);
+
+	return MY_SysTick_GetTick() - tickstart;
+}
+
+
+static void MY_INT_TEST_CheckIdle(I2C_TypeDef *I2Cx)
+{
+	MY_I2C_Init_t *handler = MY_I2C_GetHandler(I2Cx);
+
+	MY_HOST_EQUAL(handler->State, MY_I2C_State_Ready);
+	MY_HOST_EQUAL(MY_Lock_IsLocked(&handler->Lock), 0U);
+	MY_HOST_EQUAL(I2Cx->ISR & (I2C_ISR_BUSY | I2C_ISR_STOPF | I2C_ISR_NACKF), 0U);
+}
+
+
+/* Шесть клиентов на двух шинах: передачи не перемешиваются, части больше 255 байт идут через Reload */
+static void MY_INT_TEST_PTInterleaved(void)
+{
+	static const uint16_t size[MY_INT_TEST_CLIENTS] = { 1U, 5U, 40U, 260U, 17U, 256U };
+	/* При задержке 1 передача укладывается в один вызов, при 8 сопрограмма отдаёт управление на каждом байте */
+	static const uint32_t latency[] = { 1U, 8U };
+	MY_INT_TEST_Client_t *client;
+	uint32_t contended;
+	uint32_t i;
+	uint32_t j;
+	uint32_t k;
+
+	for(k = 0; k < (sizeof(latency) / sizeof(latency[0])); k++)
+	{
+		MY_HOST_Reset();
+		MY_INT_TEST_BusSetup(latency[k]);
+
+		for(i = 0; i < MY_INT_TEST_CLIENTS; i++)
+		{
+			MY_INT_TEST_AddClient((i < 4U) ? I2C1 : I2C2, (uint16_t)(0x20U + (i * 2U)), size[i], MY_INT_TEST_ROUNDS);
+		}
+
+		MY_INT_TEST_Loop(5000U);
+
+		contended = 0;
+
+		for(i = 0; i < MY_INT_TEST_CLIENTS; i++)
+		{
+			client = &MY_INT_TEST_Clients[i];
+
+			MY_HOST_EQUAL(client->Done, 2U * MY_INT_TEST_ROUNDS);
+			MY_HOST_EQUAL(client->RxErrors, 0U);
+			MY_HOST_EQUAL(client->SlaveCount, MY_INT_TEST_ROUNDS * client->Size);
+
+			for(j = 0; j < client->Done; j++)
+			{
+				MY_HOST_EQUAL(client->Results[j], MY_Result_Ok);
+			}
+
+			/* Ведомый получил записи целиком и по порядку */
+			for(j = 0; j < client->SlaveCount; j++)
+			{
+				MY_HOST_EQUAL(client->Slave[j], client->Tx[j % client->Size]);
+			}
+
+			contended += client->Contended;
+		}
+
+		MY_HOST_EQUAL(MY_INT_TEST_Buses[0].Transfers, 4U * 2U * MY_INT_TEST_ROUNDS);
+		MY_HOST_EQUAL(MY_INT_TEST_Buses[1].Transfers, 2U * 2U * MY_INT_TEST_ROUNDS);
+		MY_HOST_EQUAL(MY_INT_TEST_Buses[0].Overlaps + MY_INT_TEST_Buses[1].Overlaps, 0U);
+
+		/* Передача дольше одного вызова: клиенты ждали занятую шину */
+		MY_HOST_CHECK((latency[k] == 1U) || (contended > 0U));
+
+		MY_INT_TEST_CheckIdle(I2C1);
+		MY_INT_TEST_CheckIdle(I2C2);
+	}
+}
+
+
+/* NACK адреса и байта данных, в том числе во второй части Reload: ошибка, шина освобождается */
+static void MY_INT_TEST_PTNack(void)
+{
+	static const uint32_t nack[] = { 0U, 5U, 254U, 255U, 260U };
+	MY_INT_TEST_Client_t *client;
+	uint32_t i;
+
+	for(i = 0; i < (sizeof(nack) / sizeof(nack[0])); i++)
+	{
+		MY_HOST_Reset();
+		MY_INT_TEST_BusSetup(3U);
+
+		client = MY_INT_TEST_AddClient(I2C1, 0x52U, 300U, 1U);
+		MY_INT_TEST_Buses[0].NackByte = nack[i];
+
+		MY_INT_TEST_Loop(1000U);
+
+		MY_HOST_EQUAL(client->Results[0], MY_Result_Error);
+		MY_HOST_EQUAL(client->SlaveCount, nack[i] + 1U);
+		MY_HOST_EQUAL(client->ErrorCode, I2C_ERROR_AF);
+
+		/* Чтение после ошибки проходит */
+		MY_HOST_EQUAL(client->Results[1], MY_Result_Ok);
+		MY_HOST_EQUAL(client->RxErrors, 0U);
+
+		MY_INT_TEST_CheckIdle(I2C1);
+	}
+
+	/* Адрес без подтверждения: ошибка и записи, и чтения */
+	MY_HOST_Reset();
+	MY_INT_TEST_BusSetup(3U);
+
+	client = MY_INT_TEST_AddClient(I2C1, 0x52U, 20U, 2U);
+	MY_INT_TEST_AddClient(I2C1, 0x54U, 20U, 2U);
+	MY_INT_TEST_Buses[0].NackAddress = 0x52U;
+
+	MY_INT_TEST_Loop(1000U);
+
+	for(i = 0; i < 4U; i++)
+	{
+		MY_HOST_EQUAL(client->Results[i], MY_Result_Error);
+		MY_HOST_EQUAL(MY_INT_TEST_Clients[1].Results[i], MY_Result_Ok);
+	}
+
+	MY_HOST_EQUAL(client->SlaveCount, 0U);
+	MY_HOST_EQUAL(client->ErrorCode, I2C_ERROR_AF);
+	MY_HOST_EQUAL(MY_INT_TEST_Clients[1].SlaveCount, 40U);
+
+	MY_INT_TEST_CheckIdle(I2C1);
+}
+
+
+/* Ведомый молчит: таймаут по фиктивному тику, шина освобождается для других клиентов */
+static void MY_INT_TEST_PTTimeout(void)
+{
+	MY_INT_TEST_Client_t *client;
+	MY_INT_TEST_Client_t *other;
+	uint32_t ticks;
+
+	MY_INT_TEST_BusSetup(MY_HOST_NEVER);
+
+	client = MY_INT_TEST_AddClient(I2C1, 0x52U, 10U, 1U);
+	client->Timeout = 50U;
+
+	ticks = MY_INT_TEST_Loop(1000U);
+
+	/* Запись ждёт данных до таймаута, чтение - освобождения шины, оставшейся в BUSY */
+	MY_HOST_EQUAL(client->Results[0], MY_Result_Timeout);
+	MY_HOST_EQUAL(client->Results[1], MY_Result_Timeout);
+	MY_HOST_CHECK(client->ErrorCode & I2C_ERROR_TIMEOUT);
+	MY_HOST_CHECK(ticks >= (client->Timeout + I2C_TIMEOUT_BUSY));
+	MY_HOST_CHECK(ticks <= (client->Timeout + I2C_TIMEOUT_BUSY + 2U));
+	MY_HOST_EQUAL(client->SlaveCount, 0U);
+	MY_HOST_EQUAL(client->Handler->State, MY_I2C_State_Ready);
+	MY_HOST_EQUAL(MY_Lock_IsLocked(&client->Handler->Lock), 0U);
+
+	/* Шина занята другим процессом: ожидание блокировки заканчивается MY_Result_Busy */
+	MY_HOST_Reset();
+	MY_INT_TEST_BusSetup(3U);
+
+	other = MY_INT_TEST_AddClient(I2C1, 0x54U, 10U, 1U);
+	other->Timeout = 30U;
+
+	MY_HOST_EQUAL(MY_Lock_Acquire(&other->Handler->Lock, 0U), MY_Result_Ok);
+
+	ticks = MY_INT_TEST_Loop(1000U);
+
+	MY_HOST_EQUAL(other->Results[0], MY_Result_Busy);
+	MY_HOST_EQUAL(other->Results[1], MY_Result_Busy);
+	MY_HOST_CHECK(ticks >= (2U * other->Timeout));
+	MY_HOST_EQUAL(other->SlaveCount, 0U);
+
+	MY_Lock_Release(&other->Handler->Lock);
+}
+
+
+int main(void)
+{
+	MY_HOST_RUN(MY_INT_TEST_Idle);
+	MY_HOST_RUN(MY_INT_TEST_Locked);
+	MY_HOST_RUN(MY_INT_TEST_Preempt);
+	MY_HOST_RUN(MY_INT_TEST_PTInterleaved);
+	MY_HOST_RUN(MY_INT_TEST_PTNack);
+	MY_HOST_RUN(MY_INT_TEST_PTTimeout);
+
+	return MY_HOST_TEST_Report("i2c");
+}
@@ -0,0 +1,355 @@
+/**
+ * @author  Андрей Заостровных
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/lock
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Тест MY_LOCK: вложенные критические секции, захват и освобождение с прерыванием
+ * 			на каждой границе инструкций, таймаут ожидания
+ */
+
+/* Владелец и счётчики включены только здесь: блокировки собираются в этом файле */
+#define LOCK_OWNERSHIP							1U
+#define LOCK_STATISTICS							1U
+
+#include "my_host_test.h"
+#include "../../Drivers/MY/Src/my_stm32f0xx_lock.c"
+
+/* Номер исключения прерывания, которое конкурирует с потоком */
+#define MY_INT_TEST_EXCEPTION					15U
+
+/* Инструкций на тик SysTick в модели */
+#define MY_INT_TEST_TICK						500U
+
+static MY_Lock_t MY_INT_TEST_Lock;
+
+static volatile uint32_t MY_INT_TEST_Inside;
+static volatile uint32_t MY_INT_TEST_Seen;
+static volatile uint32_t MY_INT_TEST_IsrPrimask;
+static volatile uint32_t MY_INT_TEST_IsrNesting;
+
+static MY_Result_t MY_INT_TEST_Result;
+static MY_Result_t MY_INT_TEST_Release;
+static MY_Result_t MY_INT_TEST_IsrResult;
+static uint32_t MY_INT_TEST_Timeout;
+
+
+/* Захват блокировки обработчиком прерывания, вне MY_HOST_Preempt_Run() */
+static void MY_INT_TEST_IsrAcquire(void)
+{
+	MY_HOST_IPSR = MY_INT_TEST_EXCEPTION;
+
+	MY_HOST_EQUAL(MY_Lock_TryAcquire(&MY_INT_TEST_Lock), MY_Result_Ok);
+
+	MY_HOST_IPSR = 0;
+}
+
+
+/* Вложенные секции: PRIMASK восстанавливается только выходом из внешней и только в значение на входе */
+static void MY_INT_TEST_Nested(void)
+{
+	MY_Critical_Enter();
+	MY_HOST_EQUAL(__get_PRIMASK(), 1U);
+
+	MY_Critical_Enter();
+	MY_Critical_Exit();
+	MY_HOST_EQUAL(__get_PRIMASK(), 1U);
+
+	MY_Critical_Exit();
+	MY_HOST_EQUAL(__get_PRIMASK(), 0U);
+	MY_HOST_EQUAL(MY_INT_LOCK_Nesting, 0U);
+
+	/* Лишний выход ничего не меняет */
+	MY_Critical_Exit();
+	MY_HOST_EQUAL(__get_PRIMASK(), 0U);
+	MY_HOST_EQUAL(MY_INT_LOCK_Nesting, 0U);
+
+	/* Прерывания запрещены до входа: остаются запрещены после выхода */
+	__disable_irq();
+
+	MY_Critical_Enter();
+	MY_Critical_Enter();
+	MY_Critical_Exit();
+	MY_Critical_Exit();
+
+	MY_HOST_EQUAL(__get_PRIMASK(), 1U);
+	MY_HOST_EQUAL(MY_INT_LOCK_Nesting, 0U);
+
+	__enable_irq();
+}
+
+
+static void MY_INT_TEST_NestedThread(void)
+{
+	MY_Critical_Enter();
+	MY_INT_TEST_Inside = 1;
+
+	MY_Critical_Enter();
+	MY_INT_TEST_Inside = 2;
+	MY_Critical_Exit();
+
+	MY_INT_TEST_Inside = 0;
+	MY_Critical_Exit();
+}
+
+
+/* Обработчик со своей вложенной секцией: общий счётчик вложения возвращается к значению на входе */
+static void MY_INT_TEST_NestedIsr(void)
+{
+	MY_INT_TEST_Seen |= MY_INT_TEST_Inside;
+
+	MY_Critical_Enter();
+	MY_Critical_Enter();
+
+	MY_INT_TEST_IsrNesting = MY_INT_LOCK_Nesting;
+
+	MY_Critical_Exit();
+	MY_Critical_Exit();
+
+	MY_INT_TEST_IsrPrimask = __get_PRIMASK();
+}
+
+
+/* Прерывание на каждой границе: не выполняется внутри секции и не ломает вложение потока */
+static void MY_INT_TEST_NestedPreempt(void)
+{
+	uint32_t steps = MY_HOST_Step_Run(MY_INT_TEST_NestedThread, NULL);
+	uint32_t taken = 0;
+	uint32_t at;
+
+	for(at = 0; at <= steps; at++)
+	{
+		MY_INT_TEST_Inside = 0;
+		MY_INT_TEST_Seen = 0;
+		MY_INT_TEST_IsrNesting = 0;
+		MY_INT_TEST_IsrPrimask = 1;
+
+		MY_HOST_Preempt_Run(MY_INT_TEST_NestedThread, MY_INT_TEST_NestedIsr, MY_INT_TEST_EXCEPTION, at);
+
+		MY_HOST_EQUAL(MY_INT_TEST_Seen, 0U);
+		MY_HOST_EQUAL(MY_INT_TEST_IsrNesting, 2U);
+		MY_HOST_EQUAL(MY_INT_TEST_IsrPrimask, 0U);
+		MY_HOST_EQUAL(MY_INT_LOCK_Nesting, 0U);
+		MY_HOST_EQUAL(__get_PRIMASK(), 0U);
+
+		taken += (MY_HOST_Preempt_Taken() != MY_HOST_NEVER) ? 1U : 0U;
+	}
+
+	/* Прерывание выполнялось и до входа в секцию, и после выхода из неё */
+	MY_HOST_CHECK(taken >= 2U);
+}
+
+
+static void MY_INT_TEST_TryThread(void)
+{
+	MY_INT_TEST_Result = MY_Lock_TryAcquire(&MY_INT_TEST_Lock);
+}
+
+
+static void MY_INT_TEST_TryIsr(void)
+{
+	MY_INT_TEST_IsrResult = MY_Lock_TryAcquire(&MY_INT_TEST_Lock);
+}
+
+
+/* Поток и прерывание захватывают одну блокировку: ровно один владелец на любой границе */
+static void MY_INT_TEST_TryPreempt(void)
+{
+	uint32_t steps = MY_HOST_Step_Run(MY_INT_TEST_TryThread, NULL);
+	uint32_t thread = 0;
+	uint32_t at;
+
+	for(at = 0; at <= steps; at++)
+	{
+		MY_Lock_Init(&MY_INT_TEST_Lock);
+
+		MY_HOST_Preempt_Run(MY_INT_TEST_TryThread, MY_INT_TEST_TryIsr, MY_INT_TEST_EXCEPTION, at);
+
+		if(MY_INT_TEST_Result == MY_Result_Ok)
+		{
+			MY_HOST_EQUAL(MY_INT_TEST_IsrResult, MY_Result_Busy);
+			MY_HOST_EQUAL(MY_INT_TEST_Lock.Owner, MY_LOCK_OWNER_MAIN);
+
+			thread++;
+		}
+		else
+		{
+			MY_HOST_EQUAL(MY_INT_TEST_Result, MY_Result_Busy);
+			MY_HOST_EQUAL(MY_INT_TEST_IsrResult, MY_Result_Ok);
+			MY_HOST_EQUAL(MY_INT_TEST_Lock.Owner, MY_INT_TEST_EXCEPTION);
+		}
+
+		MY_HOST_EQUAL(MY_Lock_IsLocked(&MY_INT_TEST_Lock), 1U);
+		MY_HOST_EQUAL(MY_INT_TEST_Lock.Acquired, 1U);
+		MY_HOST_EQUAL(MY_INT_TEST_Lock.Contended, 1U);
+		MY_HOST_EQUAL(__get_PRIMASK(), 0U);
+	}
+
+	/* Встречаются оба исхода */
+	MY_HOST_CHECK(thread > 0U);
+	MY_HOST_CHECK(thread <= steps);
+}
+
+
+static void MY_INT_TEST_HoldThread(void)
+{
+	MY_INT_TEST_Result = MY_Lock_TryAcquire(&MY_INT_TEST_Lock);
+	MY_INT_TEST_Release = MY_Lock_Release(&MY_INT_TEST_Lock);
+}
+
+
+/* Захват и освобождение потоком: прерывание получает блокировку только свободной */
+static void MY_INT_TEST_ReleasePreempt(void)
+{
+	uint32_t steps = MY_HOST_Step_Run(MY_INT_TEST_HoldThread, NULL);
+	uint32_t busy = 0;
+	uint32_t at;
+
+	for(at = 0; at <= steps; at++)
+	{
+		MY_Lock_Init(&MY_INT_TEST_Lock);
+
+		MY_HOST_Preempt_Run(MY_INT_TEST_HoldThread, MY_INT_TEST_TryIsr, MY_INT_TEST_EXCEPTION, at);
+
+		if(MY_INT_TEST_Result == MY_Result_Ok)
+		{
+			/* Поток владел блокировкой: освобождение успешно, прерывание либо застало её занятой, либо захватило после */
+			MY_HOST_EQUAL(MY_INT_TEST_Release, MY_Result_Ok);
+			MY_HOST_EQUAL(MY_Lock_IsLocked(&MY_INT_TEST_Lock), (MY_INT_TEST_IsrResult == MY_Result_Ok) ? 1U : 0U);
+
+			busy += (MY_INT_TEST_IsrResult == MY_Result_Busy) ? 1U : 0U;
+		}
+		else
+		{
+			/* Прерывание захватило первым: поток не освобождает чужую блокировку */
+			MY_HOST_EQUAL(MY_INT_TEST_Result, MY_Result_Busy);
+			MY_HOST_EQUAL(MY_INT_TEST_IsrResult, MY_Result_Ok);
+			MY_HOST_EQUAL(MY_INT_TEST_Release, MY_Result_Error);
+			MY_HOST_EQUAL(MY_Lock_IsLocked(&MY_INT_TEST_Lock), 1U);
+		}
+
+		if(MY_INT_TEST_IsrResult == MY_Result_Ok)
+		{
+			MY_HOST_EQUAL(MY_INT_TEST_Lock.Owner, MY_INT_TEST_EXCEPTION);
+		}
+	}
+
+	/* Прерывание попадало во время владения потоком */
+	MY_HOST_CHECK(busy > 0U);
+}
+
+
+static void MY_INT_TEST_AcquireThread(void)
+{
+	MY_INT_TEST_Result = MY_Lock_Acquire(&MY_INT_TEST_Lock, MY_INT_TEST_Timeout);
+}
+
+
+static void MY_INT_TEST_ReleaseIsr(void)
+{
+	MY_INT_TEST_IsrResult = MY_Lock_Release(&MY_INT_TEST_Lock);
+}
+
+
+/* Ожидание: таймаут по тикам, без ожидания при Timeout = 0 и в обработчике, ошибки владельца */
+static void MY_INT_TEST_Timeouts(void)
+{
+	uint32_t tickstart;
+	uint32_t steps;
+
+	MY_HOST_RCC_Config(&(MY_HOST_RCC_Delays_t){ .Tick = MY_INT_TEST_TICK });
+
+	MY_Lock_Init(&MY_INT_TEST_Lock);
+	MY_INT_TEST_IsrAcquire();
+
+	/* Блокировка не освобождается: MY_Result_Timeout не раньше Timeout тиков */
+	MY_INT_TEST_Timeout = 10U;
+	tickstart = MY_SysTick_GetTick();
+
+	MY_HOST_Step_Run(MY_INT_TEST_AcquireThread, MY_HOST_RCC_Hook);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Result, MY_Result_Timeout);
+	MY_HOST_CHECK(MY_SysTick_GetTick() - tickstart >= MY_INT_TEST_Timeout);
+	MY_HOST_CHECK(MY_SysTick_GetTick() - tickstart <= MY_INT_TEST_Timeout + 1U);
+	MY_HOST_EQUAL(MY_INT_TEST_Lock.Owner, MY_INT_TEST_EXCEPTION);
+	MY_HOST_EQUAL(__get_PRIMASK(), 0U);
+
+	/* Timeout = 0: без ожидания */
+	MY_INT_TEST_Timeout = 0U;
+
+	steps = MY_HOST_Step_Run(MY_INT_TEST_AcquireThread, MY_HOST_RCC_Hook);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Result, MY_Result_Busy);
+	MY_HOST_CHECK(steps < MY_INT_TEST_TICK);
+
+	/* В обработчике прерывания ожидание невозможно: владелец не выполняется */
+	MY_INT_TEST_Timeout = 10U;
+	MY_HOST_IPSR = MY_INT_TEST_EXCEPTION + 1U;
+
+	steps = MY_HOST_Step_Run(MY_INT_TEST_AcquireThread, MY_HOST_RCC_Hook);
+
+	MY_HOST_IPSR = 0;
+
+	MY_HOST_EQUAL(MY_INT_TEST_Result, MY_Result_Busy);
+	MY_HOST_CHECK(steps < MY_INT_TEST_TICK);
+
+	/* Освобождение не владельцем */
+	MY_HOST_EQUAL(MY_Lock_Release(&MY_INT_TEST_Lock), MY_Result_Error);
+	MY_HOST_EQUAL(MY_Lock_IsLocked(&MY_INT_TEST_Lock), 1U);
+
+	/* Повторный захват владельцем не ждёт освобождения */
+	MY_Lock_Init(&MY_INT_TEST_Lock);
+	MY_HOST_EQUAL(MY_Lock_Acquire(&MY_INT_TEST_Lock, 10U), MY_Result_Ok);
+
+	steps = MY_HOST_Step_Run(MY_INT_TEST_AcquireThread, MY_HOST_RCC_Hook);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Result, MY_Result_Error);
+	MY_HOST_CHECK(steps < MY_INT_TEST_TICK);
+
+	MY_HOST_EQUAL(MY_Lock_Release(&MY_INT_TEST_Lock), MY_Result_Ok);
+	MY_HOST_EQUAL(MY_Lock_Release(&MY_INT_TEST_Lock), MY_Result_Error);
+	MY_HOST_EQUAL(MY_INT_TEST_Lock.Acquired, 1U);
+}
+
+
+/* Блокировку держит прерывание и освобождает на границе At: ожидающий поток её получает */
+static void MY_INT_TEST_WaitPreempt(void)
+{
+	uint32_t waited = 0;
+	uint32_t at;
+
+	MY_INT_TEST_Timeout = MAX_DELAY;
+
+	for(at = 0; at <= 200U; at++)
+	{
+		MY_Lock_Init(&MY_INT_TEST_Lock);
+		MY_INT_TEST_IsrAcquire();
+
+		MY_HOST_Preempt_Run(MY_INT_TEST_AcquireThread, MY_INT_TEST_ReleaseIsr, MY_INT_TEST_EXCEPTION, at);
+
+		MY_HOST_EQUAL(MY_INT_TEST_IsrResult, MY_Result_Ok);
+		MY_HOST_EQUAL(MY_INT_TEST_Result, MY_Result_Ok);
+		MY_HOST_EQUAL(MY_INT_TEST_Lock.Owner, MY_LOCK_OWNER_MAIN);
+		MY_HOST_EQUAL(MY_INT_TEST_Lock.Acquired, 2U);
+		MY_HOST_EQUAL(MY_INT_LOCK_Nesting, 0U);
+		MY_HOST_EQUAL(__get_PRIMASK(), 0U);
+
+		waited += (MY_INT_TEST_Lock.Contended != 0U) ? 1U : 0U;
+	}
+
+	/* Поток ждал освобождения, а не застал блокировку свободной */
+	MY_HOST_CHECK(waited > 100U);
+}
+
+
+int main(void)
+{
+	MY_HOST_RUN(MY_INT_TEST_Nested);
+	MY_HOST_RUN(MY_INT_TEST_NestedPreempt);
+	MY_HOST_RUN(MY_INT_TEST_TryPreempt);
+	MY_HOST_RUN(MY_INT_TEST_ReleasePreempt);
+	MY_HOST_RUN(MY_INT_TEST_Timeouts);
+	MY_HOST_RUN(MY_INT_TEST_WaitPreempt);
+
+	return MY_HOST_TEST_Report("lock");
+}
@@ -0,0 +1,301 @@
+/**
+ * @author  Андрей Заостровных
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/log
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Тест MY_LOG: записи через MY_LOG_Process() и MY_CONSOLE, расшифровка Tools/log_decode.py
+ * 			по ELF самого теста и сравнение с printf() ПК. Знаковые значения, h/hh, отброшенные записи,
+ * 			переход буфера через край
+ */
+
+/* Маленький буфер: переход через край и отбрасывание за несколько записей */
+#define LOG_BUFFER_WORDS						32U
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "my_host_test.h"
+#include "../../Drivers/MY/Src/my_stm32f0xx_log.c"
+
+/* Расшифровщик запускается из корня репозитория (make host-test) */
+#define MY_INT_TEST_DECODER						"python3 Tools/log_decode.py"
+
+/* Запись и ожидаемая строка, если запись не отброшена */
+#define MY_INT_TEST_LOG(__FMT__, ...)																\
+	do																								\
+	{																								\
+		uint32_t dropped = MY_INT_LOG_Stats.Dropped;												\
+		MY_LOG(__FMT__, ##__VA_ARGS__);																\
+		if(MY_INT_LOG_Stats.Dropped == dropped)														\
+		{																							\
+			MY_INT_TEST_Expect(1U, __FMT__, ##__VA_ARGS__);										\
+		}																							\
+	}																								\
+	while(0)
+
+/* Вывод консоли и ожидаемый текст расшифровки */
+static char MY_INT_TEST_Console[16384];
+static uint32_t MY_INT_TEST_ConsoleSize;
+static char MY_INT_TEST_Expected[16384];
+static uint32_t MY_INT_TEST_ExpectedSize;
+static char MY_INT_TEST_Decoded[16384];
+
+
+/* Ожидаемая строка: printf() ПК с теми же аргументами, метка времени - как в log_decode.py */
+static void MY_INT_TEST_Expect(uint32_t Timestamp, const char *Format, ...)
+{
+	char *line = MY_INT_TEST_Expected + MY_INT_TEST_ExpectedSize;
+	uint32_t free = sizeof(MY_INT_TEST_Expected) - MY_INT_TEST_ExpectedSize;
+	int length = 0;
+	va_list args;
+
+	if(Timestamp)
+	{
+		length = snprintf(line, free, "[%10d] ", (int)MY_SysTick_GetTick());
+	}
+
+	va_start(args, Format);
+	length += vsnprintf(line + length, free - length, Format, args);
+	va_end(args);
+
+	length += snprintf(line + length, free - length, "\n");
+
+	MY_INT_TEST_ExpectedSize += (uint32_t)length;
+}
+
+
+/* Передача буфера консоли прерыванием USART1 */
+static void MY_INT_TEST_Drain(void)
+{
+	uint32_t free;
+	uint32_t i;
+
+	for(i = 0; (i < CONSOLE_BUFFER_SIZE) && (USART1->CR1 & USART_CR1_TXEIE); i++)
+	{
+		free = MY_CONSOLE_GetFree();
+
+		USART1->ISR |= USART_ISR_TXE;
+		MY_CONSOLE_IRQHandler();
+
+		if((MY_CONSOLE_GetFree() != free) && (MY_INT_TEST_ConsoleSize < sizeof(MY_INT_TEST_Console)))
+		{
+			MY_INT_TEST_Console[MY_INT_TEST_ConsoleSize++] = (char)USART1->TDR;
+		}
+	}
+}
+
+
+/* Вывод всех записей: MY_LOG_Process() останавливается, когда в консоли нет места на строку */
+static void MY_INT_TEST_Process(void)
+{
+	uint32_t i;
+
+	for(i = 0; (i < LOG_BUFFER_WORDS) && (MY_INT_LOG_Tail != MY_INT_LOG_Head); i++)
+	{
+		MY_LOG_Process();
+		MY_INT_TEST_Drain();
+	}
+
+	MY_HOST_EQUAL(MY_INT_LOG_Tail, MY_INT_LOG_Head);
+}
+
+
+/* Строка консоли без записи журнала передаётся без изменений */
+static void MY_INT_TEST_Text(const char *Text)
+{
+	MY_CONSOLE_Write(Text, strlen(Text));
+	MY_INT_TEST_Drain();
+
+	MY_INT_TEST_ExpectedSize += (uint32_t)snprintf(MY_INT_TEST_Expected + MY_INT_TEST_ExpectedSize,
+												   sizeof(MY_INT_TEST_Expected) - MY_INT_TEST_ExpectedSize, "%.*s\n",
+												   (int)strcspn(Text, "\r\n"), Text);
+}
+
+
+/* Расшифровка вывода консоли по ELF этого теста */
+static uint32_t MY_INT_TEST_Decode(void)
+{
+	char path[] = "/tmp/my_host_test_log_XXXXXX";
+	char command[256];
+	uint32_t size = 0;
+	size_t count;
+	FILE *decoder;
+	int file;
+
+	file = mkstemp(path);
+
+	if(file < 0)
+	{
+		return 0;
+	}
+
+	count = (size_t)write(file, MY_INT_TEST_Console, MY_INT_TEST_ConsoleSize);
+	close(file);
+
+	snprintf(command, sizeof(command), MY_INT_TEST_DECODER " /proc/%d/exe %s", (int)getpid(), path);
+
+	decoder = popen(command, "r");
+
+	if(decoder != NULL)
+	{
+		while((count = fread(MY_INT_TEST_Decoded + size, 1, sizeof(MY_INT_TEST_Decoded) - 1U - size, decoder)) > 0U)
+		{
+			size += (uint32_t)count;
+		}
+
+		MY_HOST_EQUAL(pclose(decoder), 0);
+	}
+
+	MY_INT_TEST_Decoded[size] = '\0';
+	unlink(path);
+
+	return size;
+}
+
+
+/* Построчное сравнение: при расхождении печатается первая отличающаяся строка */
+static void MY_INT_TEST_Compare(void)
+{
+	uint32_t size = MY_INT_TEST_Decode();
+	uint32_t line = 0;
+	uint32_t start = 0;
+	uint32_t i;
+
+	MY_INT_TEST_Expected[MY_INT_TEST_ExpectedSize] = '\0';
+
+	MY_HOST_EQUAL(size, MY_INT_TEST_ExpectedSize);
+
+	for(i = 0; (i < size) && (i < MY_INT_TEST_ExpectedSize); i++)
+	{
+		if(MY_INT_TEST_Decoded[i] != MY_INT_TEST_Expected[i])
+		{
+			printf("line %u:\n  decoded  %.*s\n  expected %.*s\n", (unsigned)line,
+				   (int)strcspn(MY_INT_TEST_Decoded + start, "\n"), MY_INT_TEST_Decoded + start,
+				   (int)strcspn(MY_INT_TEST_Expected + start, "\n"), MY_INT_TEST_Expected + start);
+
+			MY_HOST_CHECK(MY_INT_TEST_Decoded[i] == MY_INT_TEST_Expected[i]);
+
+			return;
+		}
+
+		if(MY_INT_TEST_Decoded[i] == '\n')
+		{
+			line++;
+			start = i + 1U;
+		}
+	}
+}
+
+
+static void MY_INT_TEST_Setup(void)
+{
+	MY_INT_LOG_Head = 0;
+	MY_INT_LOG_Tail = 0;
+
+	memset(&MY_INT_LOG_Stats, 0, sizeof(MY_INT_LOG_Stats));
+
+	MY_INT_TEST_ConsoleSize = 0;
+	MY_INT_TEST_ExpectedSize = 0;
+
+	MY_CONSOLE_Init();
+}
+
+
+/* Преобразования и модификаторы: значения приводятся к uint32_t, знак и ширину h/hh восстанавливает расшифровщик */
+static void MY_INT_TEST_Formats(void)
+{
+	int32_t negative = -25;
+	int8_t small = -5;
+	int16_t medium = -300;
+
+	MY_INT_TEST_Setup();
+
+	MY_INT_TEST_Text("boot\r\n");
+
+	MY_INT_TEST_LOG("no arguments");
+	MY_INT_TEST_LOG("adc %u, t %d", 4000U, negative);
+	MY_INT_TEST_LOG("min %d max %d", (int32_t)0x80000000, 0x7FFFFFFF);
+	MY_INT_TEST_Process();
+
+	MY_SysTick_IncTick();
+
+	MY_INT_TEST_LOG("hh %hhd %hhu, h %hd %hu", small, 200, medium, 60000);
+	MY_INT_TEST_LOG("hh of int %hhd %hhu, h of int %hd", 300, 511, 70000);
+	MY_INT_TEST_LOG("x %x X %X o %o c %c", 0xBEEFU, 0xCAFEU, 8, 'A');
+	MY_INT_TEST_LOG("width [%5d] [%-5d] [%05u] [%+d]", -42, 7, 42U, 3);
+	MY_INT_TEST_LOG("[%08X] [%#x]", 0xABCU, 255U);
+	MY_INT_TEST_Process();
+
+	MY_SysTick_IncTick();
+	MY_SysTick_IncTick();
+
+	MY_INT_TEST_LOG("i %i l %lu 100%%", -1, (unsigned long)4000000000U);
+	MY_INT_TEST_LOG("four %d %d %d %d", -1, -2, -3, -4);
+	MY_INT_TEST_Process();
+
+	MY_INT_TEST_Text("plain text\r\n");
+
+	MY_HOST_EQUAL(MY_INT_LOG_Stats.Written, 10U);
+	MY_HOST_EQUAL(MY_INT_LOG_Stats.Dropped, 0U);
+
+	MY_INT_TEST_Compare();
+}
+
+
+/* Переполнение буфера: запись отбрасывается целиком, остальные расшифровываются по порядку.
+   Записи разной длины проходят через край буфера в разных местах */
+static void MY_INT_TEST_Wrap(void)
+{
+	uint32_t round;
+	uint32_t i;
+
+	MY_INT_TEST_Setup();
+
+	for(round = 0; round < 12U; round++)
+	{
+		/* Не больше 32 слов: записи по 2..6 слов, последние не помещаются */
+		for(i = 0; i < 8U; i++)
+		{
+			switch((round + i) % 5U)
+			{
+				case 0:	MY_INT_TEST_LOG("r%u", round);									break;
+				case 1:	MY_INT_TEST_LOG("r%u i%u", round, i);							break;
+				case 2:	MY_INT_TEST_LOG("r%u i%u %d", round, i, -(int)i);				break;
+				case 3:	MY_INT_TEST_LOG("r%u i%u %d %hhd", round, i, -(int)round, -(int)i);	break;
+				default: MY_INT_TEST_LOG("tick");										break;
+			}
+		}
+
+		MY_SysTick_IncTick();
+
+		/* Половину раундов выводим частично: хвост остаётся в буфере до следующего раунда */
+		if(round & 1U)
+		{
+			MY_INT_TEST_Process();
+		}
+	}
+
+	MY_INT_TEST_Process();
+
+	MY_HOST_CHECK(MY_INT_LOG_Stats.Dropped > 0U);
+	MY_HOST_CHECK(MY_INT_LOG_Stats.Written > 0U);
+	MY_HOST_EQUAL(MY_INT_LOG_Stats.Written + MY_INT_LOG_Stats.Dropped, 12U * 8U);
+	MY_HOST_EQUAL(MY_INT_LOG_Stats.Peak, LOG_BUFFER_WORDS);
+
+	/* Счётчики прошли буфер несколько раз */
+	MY_HOST_CHECK(MY_INT_LOG_Head > 4U * LOG_BUFFER_WORDS);
+
+	MY_INT_TEST_Compare();
+}
+
+
+int main(void)
+{
+	MY_HOST_RUN(MY_INT_TEST_Formats);
+	MY_HOST_RUN(MY_INT_TEST_Wrap);
+
+	return MY_HOST_TEST_Report("log");
+}
@@ -0,0 +1,233 @@
+/**
+ * @author  Андрей Заостровных
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/os
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Тест простоя ОС: сон задачи простоя без тиков ограничен ближайшим таймаутом задачи
+ * 			и периодом опроса кнопок (источники сроков MY_PWR)
+ */
+
+/* Ядро собирается для ПК. PendSV_Handler (Thumb-1) не вызывается и не попадает в объектный файл */
+#define USE_RTOS								1U
+#define PendSV_Handler							__attribute__((unused)) static MY_INT_TEST_PendSV
+
+#include "my_host_test.h"
+#include "my_stm32f0xx_button.h"
+#include "../../Drivers/MY/Src/my_stm32f0xx_os.c"
+
+/* Тактов SysTick на тик */
+#define MY_INT_TEST_PER_TICK					48000U
+
+static MY_OS_Task_t MY_INT_TEST_Tasks[3];
+static uint32_t MY_INT_TEST_Stacks[3][OS_STACK_WORDS_MIN] __attribute__((aligned(8)));
+static const uint8_t MY_INT_TEST_Object;
+
+/* Наблюдения модели WFI */
+static uint32_t MY_INT_TEST_Slept;
+static uint32_t MY_INT_TEST_Wfis;
+
+
+static void MY_INT_TEST_Task(void *Arg)
+{
+	UNUSED(Arg);
+}
+
+
+/* WFI: сон до обнуления счётчика SysTick, затем прерывание ожидает */
+static void MY_INT_TEST_Wfi(void)
+{
+	MY_INT_TEST_Wfis++;
+	MY_INT_TEST_Slept = (SysTick->VAL != 0U) ? SysTick->VAL : (SysTick->LOAD + 1U);
+
+	SysTick->VAL = 0U;
+	SysTick->CTRL |= SysTick_CTRL_COUNTFLAG_Msk;
+	SCB->ICSR |= SCB_ICSR_PENDSTSET_Msk;
+}
+
+
+/* SysTick_Handler приложения после восстановления PRIMASK */
+static void MY_INT_TEST_SysTick(void)
+{
+	if(SCB->ICSR & SCB_ICSR_PENDSTSET_Msk)
+	{
+		SCB->ICSR &= ~SCB_ICSR_PENDSTSET_Msk;
+
+		MY_SysTick_IncTick();
+		MY_BUTTON_Tick();
+		MY_OS_Tick();
+	}
+}
+
+
+/* Простой от начала тика со сроком приложения IdleTicks. Проверяет, что сон закончился ровно
+   на границе Expected-го тика, и возвращает число прошедших тиков */
+static uint32_t MY_INT_TEST_Enter(uint32_t IdleTicks, uint32_t Expected)
+{
+	uint32_t tickstart = MY_SysTick_GetTick();
+
+	SysTick->LOAD = MY_INT_TEST_PER_TICK - 1U;
+	SysTick->VAL = MY_INT_TEST_PER_TICK - 1U;
+	SysTick->CTRL = SysTick_CTRL_CLKSOURCE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_ENABLE_Msk;
+	SCB->ICSR = 0;
+
+	MY_INT_TEST_Slept = 0;
+
+	MY_HOST_EQUAL(MY_PWR_Enter(IdleTicks), MY_PWR_State_Sleep);
+
+	MY_INT_TEST_SysTick();
+
+	MY_HOST_EQUAL(MY_INT_TEST_Slept, (MY_INT_TEST_PER_TICK - 1U) + (MY_INT_TEST_PER_TICK * (Expected - 1U)));
+	MY_HOST_EQUAL(SysTick->LOAD, MY_INT_TEST_PER_TICK - 1U);
+	MY_HOST_EQUAL(MY_HOST_PRIMASK, 0U);
+
+	return MY_SysTick_GetTick() - tickstart;
+}
+
+
+/* Один проход задачи простоя: своего срока нет */
+static uint32_t MY_INT_TEST_Idle(uint32_t Expected)
+{
+	return MY_INT_TEST_Enter(MAX_DELAY, Expected);
+}
+
+
+/* Ожидание задачи так, как его выполняет MY_OS_Wait() из задачи: на ПК переключения нет */
+static void MY_INT_TEST_Block(uint32_t Index, const volatile void *Object, uint32_t Timeout)
+{
+	MY_INT_OS_Current = &MY_INT_TEST_Tasks[Index];
+
+	MY_HOST_EQUAL(MY_OS_Wait(Object, Timeout), MY_Result_Timeout);
+	MY_HOST_EQUAL(MY_INT_TEST_Tasks[Index].State, MY_OS_State_Blocked);
+
+	/* Выполняется задача простоя */
+	MY_INT_OS_Current = &MY_INT_OS_IdleTask;
+	SCB->ICSR = 0;
+}
+
+
+static void MY_INT_TEST_Setup(void)
+{
+	uint32_t i;
+
+	MY_HOST_EQUAL(MY_OS_Init(), MY_Result_Ok);
+
+	for(i = 0; i < 3U; i++)
+	{
+		MY_HOST_EQUAL(MY_OS_Task_Create(&MY_INT_TEST_Tasks[i], MY_INT_TEST_Task, NULL, MY_INT_TEST_Stacks[i],
+										OS_STACK_WORDS_MIN, (uint8_t)i, "task"), MY_Result_Ok);
+	}
+
+	/* До запуска сроков нет */
+	MY_HOST_EQUAL(MY_PWR_Deadline_Next(), MAX_DELAY);
+
+	MY_INT_OS_Running = 1;
+	MY_INT_OS_Current = &MY_INT_OS_IdleTask;
+
+	MY_PWR_Init();
+
+	MY_HOST_WFI = MY_INT_TEST_Wfi;
+	MY_HOST_PRIMASK = 0;
+	MY_INT_TEST_Wfis = 0;
+}
+
+
+/* Сон простоя заканчивается на ближайшем таймауте, ожидание без таймаута сон не ограничивает */
+static void MY_INT_TEST_Timeouts(void)
+{
+	MY_INT_TEST_Setup();
+
+	MY_INT_TEST_Block(0, &MY_INT_TEST_Object, MAX_DELAY);
+	MY_INT_TEST_Block(1, NULL, 30U);
+	MY_INT_TEST_Block(2, &MY_INT_TEST_Object, 12U);
+
+	MY_HOST_EQUAL(MY_PWR_Deadline_Next(), 12U);
+
+	/* Один сон на 12 тиков: задача 2 получает таймаут, задача 1 ещё ждёт */
+	MY_HOST_EQUAL(MY_INT_TEST_Idle(12U), 12U);
+	MY_HOST_EQUAL(MY_INT_TEST_Wfis, 1U);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Tasks[2].State, MY_OS_State_Ready);
+	MY_HOST_EQUAL(MY_INT_TEST_Tasks[2].WaitResult, MY_Result_Timeout);
+	MY_HOST_EQUAL(MY_INT_TEST_Tasks[1].State, MY_OS_State_Blocked);
+	MY_HOST_EQUAL(MY_INT_TEST_Tasks[0].State, MY_OS_State_Blocked);
+
+	/* Готовая задача сроком не является: ближайший - оставшиеся 18 тиков задачи 1 */
+	MY_HOST_EQUAL(MY_PWR_Deadline_Next(), 18U);
+	MY_HOST_EQUAL(MY_INT_TEST_Idle(18U), 18U);
+	MY_HOST_EQUAL(MY_INT_TEST_Tasks[1].State, MY_OS_State_Ready);
+
+	/* Наступивший, но ещё не обработанный срок запрещает сон */
+	MY_INT_TEST_Block(1, NULL, 5U);
+	MY_INT_TEST_Tasks[1].WakeTick = MY_SysTick_GetTick();
+	MY_HOST_EQUAL(MY_PWR_Deadline_Next(), 0U);
+	MY_HOST_EQUAL(MY_PWR_Enter(MAX_DELAY), MY_PWR_State_Run);
+	MY_HOST_EQUAL(MY_INT_TEST_Wfis, 2U);
+
+	MY_OS_Tick();
+	MY_HOST_EQUAL(MY_INT_TEST_Tasks[1].State, MY_OS_State_Ready);
+
+	/* Только ожидание без таймаута: сроков нет, разрешён и Stop */
+	MY_HOST_EQUAL(MY_PWR_Deadline_Next(), MAX_DELAY);
+	MY_HOST_EQUAL(MY_PWR_State_Select(MY_PWR_Deadline_Next()), PWR_DEEPEST_STATE);
+
+	MY_OS_Notify(&MY_INT_TEST_Object);
+	MY_HOST_EQUAL(MY_INT_TEST_Tasks[0].State, MY_OS_State_Ready);
+
+	/* Суперцикл: срок приложения ближе сроков модулей - и наоборот */
+	MY_INT_TEST_Block(1, NULL, 30U);
+	MY_HOST_EQUAL(MY_INT_TEST_Enter(7U, 7U), 7U);
+	MY_HOST_EQUAL(MY_INT_TEST_Enter(100U, 23U), 23U);
+	MY_HOST_EQUAL(MY_INT_TEST_Tasks[1].State, MY_OS_State_Ready);
+
+	MY_INT_OS_Running = 0;
+	MY_HOST_EQUAL(MY_PWR_Deadline_Next(), MAX_DELAY);
+}
+
+
+/* Кнопки: сон не длиннее периода опроса, отсчёты не пропускаются, таймаут задачи - на своём тике */
+static void MY_INT_TEST_Buttons(void)
+{
+	uint8_t button;
+	uint32_t tickstart;
+	uint32_t i;
+
+	MY_INT_TEST_Setup();
+
+	MY_HOST_EQUAL(MY_BUTTON_Init(GPIOA, GPIO_PIN_0, 1U, &button), MY_Result_Ok);
+
+	/* Отсчёт на текущем тике: следующий через BUTTON_SAMPLE_PERIOD */
+	MY_BUTTON_Tick();
+	MY_HOST_EQUAL(MY_PWR_Deadline_Next(), BUTTON_SAMPLE_PERIOD);
+
+	tickstart = MY_SysTick_GetTick();
+	MY_INT_TEST_Block(1, NULL, 3U * BUTTON_SAMPLE_PERIOD + 2U);
+
+	for(i = 0; i < 3U; i++)
+	{
+		MY_HOST_EQUAL(MY_INT_TEST_Idle(BUTTON_SAMPLE_PERIOD), BUTTON_SAMPLE_PERIOD);
+		MY_HOST_EQUAL(MY_INT_TEST_Tasks[1].State, MY_OS_State_Blocked);
+	}
+
+	/* Таймаут задачи ближе следующего отсчёта */
+	MY_HOST_EQUAL(MY_PWR_Deadline_Next(), 2U);
+	MY_HOST_EQUAL(MY_INT_TEST_Idle(2U), 2U);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Tasks[1].State, MY_OS_State_Ready);
+	MY_HOST_EQUAL(MY_SysTick_GetTick() - tickstart, 3U * BUTTON_SAMPLE_PERIOD + 2U);
+	MY_HOST_EQUAL(MY_PWR_Deadline_Next(), BUTTON_SAMPLE_PERIOD - 2U);
+
+	MY_PWR_Deadline_Unregister(MY_BUTTON_GetIdleTicks);
+	MY_HOST_EQUAL(MY_PWR_Deadline_Next(), MAX_DELAY);
+
+	MY_INT_OS_Running = 0;
+}
+
+
+int main(void)
+{
+	MY_HOST_RUN(MY_INT_TEST_Timeouts);
+	MY_HOST_RUN(MY_INT_TEST_Buttons);
+
+	return MY_HOST_TEST_Report("os");
+}
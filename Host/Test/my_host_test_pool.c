@@ -0,0 +1,177 @@
+/**
+ * @author  Андрей Заостровных
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/pool
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Тест MY_POOL: выбор пула, переход в более крупный пул, учёт отказов и максимума,
+ * 			проверки освобождения
+ */
+
+#define POOL_CONFIG(POOL)						POOL(16U, 8U) POOL(32U, 4U) POOL(64U, 2U)
+#define POOL_CHECK								1U
+
+#include "my_host_test.h"
+#include "../../Drivers/MY/Src/my_stm32f0xx_pool.c"
+
+/* Все блоки всех пулов */
+#define MY_INT_TEST_BLOCKS						(8U + 4U + 2U)
+
+static void *MY_INT_TEST_Blocks[MY_INT_TEST_BLOCKS];
+
+
+/* Пул, которому принадлежит блок, или POOL_COUNT */
+static uint32_t MY_INT_TEST_Owner(void *Block)
+{
+	uint32_t i;
+
+	for(i = 0; i < POOL_COUNT; i++)
+	{
+		if(((uint8_t *)Block >= (uint8_t *)MY_INT_POOL_Pools[i].Storage) &&
+		   ((uint8_t *)Block < (uint8_t *)MY_INT_POOL_Pools[i].Storage + MY_INT_POOL_Pools[i].Stride * MY_INT_POOL_Pools[i].Count))
+		{
+			return i;
+		}
+	}
+
+	return POOL_COUNT;
+}
+
+
+static MY_POOL_Stats_t MY_INT_TEST_Stats(uint32_t Index)
+{
+	MY_POOL_Stats_t stats;
+
+	MY_HOST_EQUAL(MY_POOL_GetStats(Index, &stats), MY_Result_Ok);
+
+	return stats;
+}
+
+
+/* Наименьший подходящий пул, блоки по возрастанию адреса, размеры округляются до слова */
+static void MY_INT_TEST_Select(void)
+{
+	void *a;
+	void *b;
+
+	MY_POOL_Init();
+
+	a = MY_POOL_Alloc(1U, 0U);
+	b = MY_POOL_Alloc_ISR(16U);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Owner(a), 0U);
+	MY_HOST_EQUAL((uint8_t *)b - (uint8_t *)a, 16U);
+	MY_HOST_EQUAL(MY_INT_TEST_Owner(MY_POOL_Alloc_ISR(17U)), 1U);
+	MY_HOST_EQUAL(MY_INT_TEST_Owner(MY_POOL_Alloc_ISR(33U)), 2U);
+	MY_HOST_EQUAL(MY_INT_TEST_Owner(MY_POOL_Alloc_ISR(64U)), 2U);
+	MY_HOST_EQUAL((uint32_t)(uintptr_t)a & 3U, 0U);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Stats(0).BlockSize, 16U);
+	MY_HOST_EQUAL(MY_INT_TEST_Stats(0).Used, 2U);
+	MY_HOST_EQUAL(MY_INT_TEST_Stats(2).Used, 2U);
+
+	/* Больше самого крупного блока: отказ без учёта в каком-либо пуле */
+	MY_HOST_CHECK(MY_POOL_Alloc_ISR(65U) == NULL);
+	MY_HOST_EQUAL(MY_INT_TEST_Stats(0).Failed + MY_INT_TEST_Stats(1).Failed + MY_INT_TEST_Stats(2).Failed, 0U);
+
+	/* Освобождённый блок выделяется снова первым */
+	MY_HOST_EQUAL(MY_POOL_Free(a), MY_Result_Ok);
+	MY_HOST_CHECK(MY_POOL_Alloc_ISR(8U) == a);
+
+	MY_HOST_EQUAL(MY_POOL_GetStats(POOL_COUNT, &(MY_POOL_Stats_t){ 0 }), MY_Result_Error);
+}
+
+
+/* Переход в более крупный пул - успешное выделение, отказ считается один раз и в пуле запрошенного размера */
+static void MY_INT_TEST_Fallback(void)
+{
+	uint32_t i;
+
+	MY_POOL_Init();
+
+	for(i = 0; i < MY_INT_TEST_BLOCKS; i++)
+	{
+		MY_INT_TEST_Blocks[i] = MY_POOL_Alloc_ISR(4U);
+
+		MY_HOST_CHECK(MY_INT_TEST_Blocks[i] != NULL);
+		MY_HOST_EQUAL(MY_INT_TEST_Owner(MY_INT_TEST_Blocks[i]), (i < 8U) ? 0U : ((i < 12U) ? 1U : 2U));
+	}
+
+	/* Все 14 запросов удовлетворены: отказов нет, хотя 16-байтный пул исчерпан с девятого */
+	for(i = 0; i < POOL_COUNT; i++)
+	{
+		MY_HOST_EQUAL(MY_INT_TEST_Stats(i).Failed, 0U);
+		MY_HOST_EQUAL(MY_INT_TEST_Stats(i).Used, MY_INT_TEST_Stats(i).Count);
+		MY_HOST_EQUAL(MY_INT_TEST_Stats(i).Peak, MY_INT_TEST_Stats(i).Count);
+	}
+
+	/* Отказ: запрос 16 байт - в пуле 16, 20 байт - в пуле 32, 64 байта - в пуле 64 */
+	MY_HOST_CHECK(MY_POOL_Alloc_ISR(16U) == NULL);
+	MY_HOST_CHECK(MY_POOL_Alloc(20U, 0U) == NULL);
+	MY_HOST_CHECK(MY_POOL_Alloc(20U, MAX_DELAY) == NULL);
+	MY_HOST_CHECK(MY_POOL_Alloc_ISR(64U) == NULL);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Stats(0).Failed, 1U);
+	MY_HOST_EQUAL(MY_INT_TEST_Stats(1).Failed, 2U);
+	MY_HOST_EQUAL(MY_INT_TEST_Stats(2).Failed, 1U);
+
+	/* Блок в крупном пуле снова доступен мелкому запросу */
+	MY_HOST_EQUAL(MY_POOL_Free(MY_INT_TEST_Blocks[13]), MY_Result_Ok);
+	MY_HOST_CHECK(MY_POOL_Alloc_ISR(1U) == MY_INT_TEST_Blocks[13]);
+	MY_HOST_EQUAL(MY_INT_TEST_Stats(0).Failed, 1U);
+
+	/* Максимум сохраняется после освобождения, MY_POOL_Init() сбрасывает статистику */
+	for(i = 0; i < MY_INT_TEST_BLOCKS; i++)
+	{
+		MY_HOST_EQUAL(MY_POOL_Free(MY_INT_TEST_Blocks[i]), MY_Result_Ok);
+	}
+
+	MY_HOST_EQUAL(MY_INT_TEST_Stats(1).Used, 0U);
+	MY_HOST_EQUAL(MY_INT_TEST_Stats(1).Peak, 4U);
+
+	MY_POOL_Init();
+
+	MY_HOST_EQUAL(MY_INT_TEST_Stats(1).Peak, 0U);
+	MY_HOST_EQUAL(MY_INT_TEST_Stats(1).Failed, 0U);
+	MY_HOST_EQUAL(__get_PRIMASK(), 0U);
+}
+
+
+/* Освобождение: NULL, чужой адрес, середина блока и повторное освобождение не портят список */
+static void MY_INT_TEST_Free(void)
+{
+	static uint32_t foreign[4];
+	uint8_t *block;
+
+	MY_POOL_Init();
+
+	block = MY_POOL_Alloc_ISR(32U);
+
+	MY_HOST_EQUAL(MY_POOL_Free(NULL), MY_Result_Ok);
+	MY_HOST_EQUAL(MY_POOL_Free(foreign), MY_Result_Error);
+	MY_HOST_EQUAL(MY_POOL_Free(block + 4U), MY_Result_Error);
+	MY_HOST_EQUAL(MY_POOL_Free((uint8_t *)MY_INT_POOL_Pools[0].Storage - 4U), MY_Result_Error);
+	MY_HOST_EQUAL(MY_INT_TEST_Stats(1).Used, 1U);
+
+	MY_HOST_EQUAL(MY_POOL_Free(block), MY_Result_Ok);
+	MY_HOST_EQUAL(MY_POOL_Free(block), MY_Result_Error);
+	MY_HOST_EQUAL(MY_INT_TEST_Stats(1).Used, 0U);
+
+	/* Список цел: четыре разных блока, пятого нет */
+	MY_HOST_CHECK(MY_POOL_Alloc_ISR(32U) == block);
+	MY_HOST_CHECK(MY_POOL_Alloc_ISR(32U) == block + 32U);
+	MY_HOST_CHECK(MY_POOL_Alloc_ISR(32U) == block + 64U);
+	MY_HOST_CHECK(MY_POOL_Alloc_ISR(32U) == block + 96U);
+	MY_HOST_EQUAL(MY_INT_TEST_Owner(MY_POOL_Alloc_ISR(32U)), 2U);
+	MY_HOST_EQUAL(__get_PRIMASK(), 0U);
+}
+
+
+int main(void)
+{
+	MY_HOST_RUN(MY_INT_TEST_Select);
+	MY_HOST_RUN(MY_INT_TEST_Fallback);
+	MY_HOST_RUN(MY_INT_TEST_Free);
+
+	return MY_HOST_TEST_Report("pool");
+}
@@ -0,0 +1,402 @@
+/**
+ * @author  Андрей Заостровных
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/pwr
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Тест MY_PWR: выбор режима по запретам и ограничениям, восстановление частот после Stop
+ * 			на модели RCC
+ */
+
+/* Разрешены все режимы. Ожидание готовности короче, чтобы отказ генератора не шагался долго */
+#define PWR_DEEPEST_STATE						MY_PWR_State_Standby
+#define PWR_RESTORE_SPIN						2000U
+
+#include "my_host_test.h"
+#include "../../Drivers/MY/Src/my_stm32f0xx_pwr.c"
+
+/* Прерывание, которое будит ядро в модели WFI */
+#define MY_INT_TEST_WAKE_IRQ					EXTI0_1_IRQn
+
+/* Ограничения и число их вызовов */
+static MY_PWR_State_t MY_INT_TEST_Allowed[2];
+static uint32_t MY_INT_TEST_Calls;
+
+/* Наблюдения модели WFI */
+static uint32_t MY_INT_TEST_Instant;
+static uint32_t MY_INT_TEST_Wfis;
+static uint32_t MY_INT_TEST_Stops;
+static uint32_t MY_INT_TEST_WfiPrimask;
+static uint32_t MY_INT_TEST_WfiPwr;
+
+static MY_PWR_State_t MY_INT_TEST_State;
+
+
+static MY_PWR_State_t MY_INT_TEST_Constraint0(void)
+{
+	MY_INT_TEST_Calls++;
+
+	return MY_INT_TEST_Allowed[0];
+}
+
+
+static MY_PWR_State_t MY_INT_TEST_Constraint1(void)
+{
+	MY_INT_TEST_Calls++;
+
+	return MY_INT_TEST_Allowed[1];
+}
+
+
+static MY_PWR_State_t MY_INT_TEST_ConstraintRun(void)
+{
+	return MY_PWR_State_Run;
+}
+
+
+static MY_PWR_State_t MY_INT_TEST_ConstraintSleep(void)
+{
+	return MY_PWR_State_Sleep;
+}
+
+
+static MY_PWR_State_t MY_INT_TEST_ConstraintStop(void)
+{
+	return MY_PWR_State_Stop;
+}
+
+
+/* WFI: в Stop аппаратно выключаются HSE и PLL, SYSCLK переходит на HSI. Пробуждает EXTI0_1 */
+static void MY_INT_TEST_Wfi(void)
+{
+	MY_INT_TEST_Wfis++;
+	MY_INT_TEST_WfiPrimask = __get_PRIMASK();
+	MY_INT_TEST_WfiPwr = PWR->CR;
+
+	/* Прерывание уже ожидало: ядро не останавливается */
+	if(!MY_INT_TEST_Instant && (SCB->SCR & SCB_SCR_SLEEPDEEP_Msk) && !(PWR->CR & PWR_CR_PDDS))
+	{
+		RCC->CR &= ~(RCC_CR_HSEON | RCC_CR_HSERDY | RCC_CR_PLLON | RCC_CR_PLLRDY);
+		RCC->CFGR &= ~(RCC_CFGR_SW | RCC_CFGR_SWS);
+
+		MY_INT_TEST_Stops++;
+	}
+
+	NVIC->ISPR[0U] |= 1UL << MY_INT_TEST_WAKE_IRQ;
+}
+
+
+static void MY_INT_TEST_Setup(void)
+{
+	uint32_t i;
+
+	for(i = 0; i < MY_PWR_State_Count; i++)
+	{
+		MY_INT_PWR_Locks[i] = 0;
+	}
+
+	for(i = 0; i < PWR_CONSTRAINTS_MAX; i++)
+	{
+		MY_INT_PWR_Constraints[i] = NULL;
+	}
+
+	MY_INT_TEST_Calls = 0;
+	MY_INT_TEST_Instant = 0;
+	MY_INT_TEST_Wfis = 0;
+	MY_INT_TEST_Stops = 0;
+	MY_INT_TEST_WfiPrimask = 0;
+
+	MY_HOST_WFI = MY_INT_TEST_Wfi;
+	NVIC->ISER[0U] = 1UL << MY_INT_TEST_WAKE_IRQ;
+
+	MY_PWR_Init();
+}
+
+
+/* Запрет режима запрещает и все более глубокие, запреты считаются */
+static void MY_INT_TEST_Locks(void)
+{
+	MY_INT_TEST_Setup();
+
+	MY_HOST_EQUAL(MY_PWR_State_Select(MAX_DELAY), MY_PWR_State_Standby);
+	MY_HOST_EQUAL(MY_PWR_State_Select(0U), MY_PWR_State_Run);
+
+	/* Программный срок: SysTick нужен, поэтому не глубже Sleep */
+	MY_HOST_EQUAL(MY_PWR_State_Select(1U), MY_PWR_State_Sleep);
+	MY_HOST_EQUAL(MY_PWR_State_Select(MAX_DELAY - 1U), MY_PWR_State_Sleep);
+
+	MY_PWR_Lock(MY_PWR_State_Standby);
+	MY_HOST_EQUAL(MY_PWR_State_Select(MAX_DELAY), MY_PWR_State_Stop);
+
+	MY_PWR_Lock(MY_PWR_State_Stop);
+	MY_PWR_Lock(MY_PWR_State_Stop);
+	MY_HOST_EQUAL(MY_PWR_State_Select(MAX_DELAY), MY_PWR_State_Sleep);
+
+	MY_PWR_Lock(MY_PWR_State_Sleep);
+	MY_HOST_EQUAL(MY_PWR_State_Select(MAX_DELAY), MY_PWR_State_Run);
+	MY_HOST_EQUAL(MY_PWR_State_Select(1U), MY_PWR_State_Run);
+
+	MY_PWR_Unlock(MY_PWR_State_Sleep);
+	MY_HOST_EQUAL(MY_PWR_State_Select(MAX_DELAY), MY_PWR_State_Sleep);
+
+	/* Два запрета Stop: первое снятие его не разрешает */
+	MY_PWR_Unlock(MY_PWR_State_Stop);
+	MY_HOST_EQUAL(MY_PWR_State_Select(MAX_DELAY), MY_PWR_State_Sleep);
+
+	MY_PWR_Unlock(MY_PWR_State_Stop);
+	MY_HOST_EQUAL(MY_PWR_State_Select(MAX_DELAY), MY_PWR_State_Stop);
+
+	MY_PWR_Unlock(MY_PWR_State_Standby);
+	MY_HOST_EQUAL(MY_PWR_State_Select(MAX_DELAY), MY_PWR_State_Standby);
+
+	/* Лишнее снятие не уходит в минус, Run и недопустимый режим не запрещаются */
+	MY_PWR_Unlock(MY_PWR_State_Stop);
+	MY_PWR_Lock(MY_PWR_State_Stop);
+	MY_HOST_EQUAL(MY_PWR_State_Select(MAX_DELAY), MY_PWR_State_Sleep);
+	MY_PWR_Unlock(MY_PWR_State_Stop);
+
+	MY_PWR_Lock(MY_PWR_State_Run);
+	MY_PWR_Lock(MY_PWR_State_Count);
+	MY_HOST_EQUAL(MY_PWR_State_Select(MAX_DELAY), MY_PWR_State_Standby);
+	MY_HOST_EQUAL(MY_INT_PWR_Locks[MY_PWR_State_Run], 0U);
+
+	/* Запрет Sleep: MY_PWR_Enter() не останавливает ядро и не считает вход */
+	MY_PWR_Lock(MY_PWR_State_Sleep);
+
+	MY_HOST_EQUAL(MY_PWR_Enter(MAX_DELAY), MY_PWR_State_Run);
+	MY_HOST_EQUAL(MY_INT_TEST_Wfis, 0U);
+	MY_HOST_EQUAL(MY_INT_PWR_Stats.Entries[MY_PWR_State_Sleep], 0U);
+	MY_HOST_EQUAL(__get_PRIMASK(), 0U);
+}
+
+
+/* Ограничения: действует самое строгое, регистрация без дублей и в пределах PWR_CONSTRAINTS_MAX */
+static void MY_INT_TEST_Constraints(void)
+{
+	MY_INT_TEST_Setup();
+
+	MY_INT_TEST_Allowed[0] = MY_PWR_State_Stop;
+	MY_INT_TEST_Allowed[1] = MY_PWR_State_Standby;
+
+	MY_HOST_EQUAL(MY_PWR_Constraint_Register(MY_INT_TEST_Constraint0), MY_Result_Ok);
+	MY_HOST_EQUAL(MY_PWR_State_Select(MAX_DELAY), MY_PWR_State_Stop);
+
+	MY_HOST_EQUAL(MY_PWR_Constraint_Register(MY_INT_TEST_Constraint1), MY_Result_Ok);
+	MY_HOST_EQUAL(MY_PWR_State_Select(MAX_DELAY), MY_PWR_State_Stop);
+
+	MY_INT_TEST_Allowed[1] = MY_PWR_State_Sleep;
+	MY_HOST_EQUAL(MY_PWR_State_Select(MAX_DELAY), MY_PWR_State_Sleep);
+
+	/* Ограничение мягче запрета не ослабляет его */
+	MY_INT_TEST_Allowed[0] = MY_PWR_State_Standby;
+	MY_INT_TEST_Allowed[1] = MY_PWR_State_Standby;
+	MY_PWR_Lock(MY_PWR_State_Stop);
+	MY_HOST_EQUAL(MY_PWR_State_Select(MAX_DELAY), MY_PWR_State_Sleep);
+	MY_PWR_Unlock(MY_PWR_State_Stop);
+
+	/* Повторная регистрация не занимает место */
+	MY_HOST_EQUAL(MY_PWR_Constraint_Register(MY_INT_TEST_Constraint0), MY_Result_Ok);
+	MY_HOST_EQUAL(MY_PWR_Constraint_Register(MY_INT_TEST_ConstraintSleep), MY_Result_Ok);
+	MY_HOST_EQUAL(MY_PWR_Constraint_Register(MY_INT_TEST_ConstraintRun), MY_Result_Ok);
+	MY_HOST_EQUAL(MY_PWR_State_Select(MAX_DELAY), MY_PWR_State_Run);
+
+	/* Места нет, после удаления освобождается */
+	MY_HOST_EQUAL(MY_PWR_Constraint_Register(MY_INT_TEST_ConstraintStop), MY_Result_Error);
+
+	MY_PWR_Constraint_Unregister(MY_INT_TEST_ConstraintRun);
+	MY_HOST_EQUAL(MY_PWR_State_Select(MAX_DELAY), MY_PWR_State_Sleep);
+
+	MY_HOST_EQUAL(MY_PWR_Constraint_Register(MY_INT_TEST_ConstraintStop), MY_Result_Ok);
+	MY_HOST_EQUAL(MY_PWR_State_Select(MAX_DELAY), MY_PWR_State_Sleep);
+
+	MY_PWR_Constraint_Unregister(MY_INT_TEST_ConstraintSleep);
+	MY_HOST_EQUAL(MY_PWR_State_Select(MAX_DELAY), MY_PWR_State_Stop);
+
+	MY_PWR_Constraint_Unregister(MY_INT_TEST_ConstraintStop);
+	MY_HOST_EQUAL(MY_PWR_State_Select(MAX_DELAY), MY_PWR_State_Standby);
+
+	/* Режим уже запрещён до Sleep: ограничения не вызываются */
+	MY_INT_TEST_Calls = 0;
+	MY_PWR_Lock(MY_PWR_State_Sleep);
+
+	MY_HOST_EQUAL(MY_PWR_State_Select(MAX_DELAY), MY_PWR_State_Run);
+	MY_HOST_EQUAL(MY_INT_TEST_Calls, 0U);
+
+	MY_PWR_Unlock(MY_PWR_State_Sleep);
+}
+
+
+/* Частоты до Stop */
+typedef struct
+{
+	uint32_t	Cr;			/* Включённые генераторы, кроме HSI */
+	uint32_t	Cfgr;		/* SW, источник и множитель PLL */
+	uint32_t	Clock;		/* SYSCLK, Гц */
+}
+MY_INT_TEST_Clock_t;
+
+static const MY_INT_TEST_Clock_t MY_INT_TEST_Clocks[] =
+{
+	{ RCC_CR_HSEON | RCC_CR_PLLON,	RCC_CFGR_SW_PLL | RCC_CFGR_PLLSRC_HSE_PREDIV | RCC_CFGR_PLLMUL6,	48000000U },
+	{ RCC_CR_PLLON,					RCC_CFGR_SW_PLL | RCC_CFGR_PLLSRC_HSI_DIV2 | RCC_CFGR_PLLMUL12,	48000000U },
+	{ RCC_CR_HSEON,					RCC_CFGR_SW_HSE,												HSE_VALUE },
+	{ 0U,							RCC_CFGR_SW_HSI,												HSI_VALUE },
+};
+
+
+/* Работающие частоты: генераторы готовы, SWS = SW */
+static void MY_INT_TEST_ClockSet(const MY_INT_TEST_Clock_t *Clock)
+{
+	uint32_t ready = ((Clock->Cr & RCC_CR_HSEON) ? RCC_CR_HSERDY : 0U) | ((Clock->Cr & RCC_CR_PLLON) ? RCC_CR_PLLRDY : 0U);
+
+	RCC->CR = RCC_CR_HSION | RCC_CR_HSIRDY | Clock->Cr | ready;
+	RCC->CFGR = Clock->Cfgr | ((Clock->Cfgr & RCC_CFGR_SW) << RCC_CFGR_SWS_Pos);
+
+	MY_RCC_ClockTree_Update();
+
+	MY_HOST_EQUAL(SystemCoreClock, Clock->Clock);
+}
+
+
+static void MY_INT_TEST_Enter(void)
+{
+	MY_INT_TEST_State = MY_PWR_Enter(MAX_DELAY);
+}
+
+
+/* Stop при запрещённых прерываниях, после пробуждения генераторы и SYSCLK прежние */
+static void MY_INT_TEST_CheckStop(const MY_INT_TEST_Clock_t *Clock)
+{
+	MY_HOST_EQUAL(MY_INT_TEST_State, MY_PWR_State_Stop);
+	MY_HOST_EQUAL(MY_INT_TEST_Wfis, 1U);
+	MY_HOST_EQUAL(MY_INT_TEST_WfiPrimask, 1U);
+	MY_HOST_EQUAL(MY_INT_TEST_WfiPwr & PWR_CR_PDDS, 0U);
+	MY_HOST_EQUAL(MY_INT_TEST_WfiPwr & PWR_CR_LPDS, PWR_CR_LPDS);
+
+	MY_HOST_EQUAL(SCB->SCR & SCB_SCR_SLEEPDEEP_Msk, 0U);
+	MY_HOST_EQUAL(__get_PRIMASK(), 0U);
+
+	MY_HOST_EQUAL(MY_INT_PWR_Stats.Entries[MY_PWR_State_Stop], 1U);
+	MY_HOST_EQUAL(MY_INT_PWR_Stats.LastState, MY_PWR_State_Stop);
+	MY_HOST_EQUAL(MY_INT_PWR_Stats.LastWake, MY_INT_TEST_WAKE_IRQ);
+	MY_HOST_EQUAL(MY_INT_PWR_Stats.Wakeups[MY_INT_TEST_WAKE_IRQ + 1], 1U);
+
+	if(Clock != NULL)
+	{
+		MY_HOST_EQUAL(MY_INT_PWR_Stats.RestoreFailures, 0U);
+		MY_HOST_EQUAL(RCC->CR & (RCC_CR_HSEON | RCC_CR_PLLON), Clock->Cr);
+		MY_HOST_EQUAL((RCC->CFGR & RCC_CFGR_SWS) >> RCC_CFGR_SWS_Pos, Clock->Cfgr & RCC_CFGR_SW);
+		MY_HOST_EQUAL(RCC->CFGR & ~(RCC_CFGR_SWS), Clock->Cfgr);
+		MY_HOST_EQUAL(SystemCoreClock, Clock->Clock);
+	}
+}
+
+
+/* Восстановление каждой конфигурации с задержками готовности и при мгновенном пробуждении */
+static void MY_INT_TEST_StopRestore(void)
+{
+	uint32_t i;
+
+	for(i = 0; i < (sizeof(MY_INT_TEST_Clocks) / sizeof(MY_INT_TEST_Clocks[0])); i++)
+	{
+		MY_HOST_Reset();
+		MY_INT_TEST_Setup();
+		MY_INT_TEST_ClockSet(&MY_INT_TEST_Clocks[i]);
+
+		/* Выше Stop запрещено: без срока выбирается Stop */
+		MY_PWR_Lock(MY_PWR_State_Standby);
+
+		MY_HOST_RCC_Config(&(MY_HOST_RCC_Delays_t){ .HSE = 300U, .PLL = 100U, .Switch = 4U });
+		MY_HOST_Step_Run(MY_INT_TEST_Enter, MY_HOST_RCC_Hook);
+
+		MY_HOST_EQUAL(MY_INT_TEST_Stops, 1U);
+		MY_INT_TEST_CheckStop(&MY_INT_TEST_Clocks[i]);
+
+		/* Прерывание ожидало до входа: генераторы не выключались */
+		MY_HOST_Reset();
+		MY_INT_TEST_Setup();
+		MY_INT_TEST_ClockSet(&MY_INT_TEST_Clocks[i]);
+		MY_PWR_Lock(MY_PWR_State_Standby);
+
+		MY_INT_TEST_Instant = 1;
+		MY_HOST_Step_Run(MY_INT_TEST_Enter, MY_HOST_RCC_Hook);
+
+		MY_HOST_EQUAL(MY_INT_TEST_Stops, 0U);
+		MY_INT_TEST_CheckStop(&MY_INT_TEST_Clocks[i]);
+	}
+}
+
+
+/* HSE или PLL не запускаются после Stop: SYSCLK остаётся на HSI, дерево частот пересчитано */
+static void MY_INT_TEST_StopFail(void)
+{
+	static const MY_HOST_RCC_Delays_t delays[] =
+	{
+		{ .HSE = MY_HOST_NEVER, .PLL = 10U, .Switch = 4U },
+		{ .HSE = 10U, .PLL = MY_HOST_NEVER, .Switch = 4U },
+	};
+	uint32_t i;
+
+	for(i = 0; i < (sizeof(delays) / sizeof(delays[0])); i++)
+	{
+		MY_HOST_Reset();
+		MY_INT_TEST_Setup();
+		MY_INT_TEST_ClockSet(&MY_INT_TEST_Clocks[0]);
+		MY_PWR_Lock(MY_PWR_State_Standby);
+
+		MY_HOST_RCC_Config(&delays[i]);
+		MY_HOST_Step_Run(MY_INT_TEST_Enter, MY_HOST_RCC_Hook);
+
+		MY_INT_TEST_CheckStop(NULL);
+
+		MY_HOST_EQUAL(MY_INT_PWR_Stats.RestoreFailures, 1U);
+		MY_HOST_EQUAL(RCC->CFGR & RCC_CFGR_SWS, RCC_CFGR_SWS_HSI);
+		MY_HOST_EQUAL(SystemCoreClock, HSI_VALUE);
+	}
+}
+
+
+/* Standby не состоялся (прерывание ожидало): PDDS снят, ядро продолжает работу. Флаги Standby при запуске */
+static void MY_INT_TEST_Standby(void)
+{
+	MY_INT_TEST_Setup();
+
+	MY_INT_TEST_State = MY_PWR_Enter(MAX_DELAY);
+
+	MY_HOST_EQUAL(MY_INT_TEST_State, MY_PWR_State_Standby);
+	MY_HOST_EQUAL(MY_INT_TEST_Wfis, 1U);
+	MY_HOST_EQUAL(MY_INT_TEST_WfiPrimask, 1U);
+	MY_HOST_EQUAL(MY_INT_TEST_WfiPwr & PWR_CR_PDDS, PWR_CR_PDDS);
+	MY_HOST_EQUAL(PWR->CR & PWR_CR_PDDS, 0U);
+	MY_HOST_EQUAL(SCB->SCR & SCB_SCR_SLEEPDEEP_Msk, 0U);
+	MY_HOST_EQUAL(MY_INT_PWR_Stats.Entries[MY_PWR_State_Standby], 1U);
+	MY_HOST_EQUAL(MY_INT_PWR_Stats.FromStandby, 0U);
+
+	/* Запуск после Standby по выводу WKUP */
+	MY_HOST_Reset();
+
+	PWR->CSR = PWR_CSR_SBF | PWR_CSR_WUF;
+	MY_INT_TEST_Setup();
+
+	MY_HOST_EQUAL(MY_INT_PWR_Stats.FromStandby, 1U);
+	MY_HOST_EQUAL(MY_INT_PWR_Stats.WakeupPin, 1U);
+	MY_HOST_EQUAL(PWR->CR & (PWR_CR_CSBF | PWR_CR_CWUF), PWR_CR_CSBF | PWR_CR_CWUF);
+
+	/* Новое окно статистики помнит причину запуска */
+	MY_PWR_Stats_Reset();
+
+	MY_HOST_EQUAL(MY_INT_PWR_Stats.FromStandby, 1U);
+	MY_HOST_EQUAL(MY_INT_PWR_Stats.WakeupPin, 1U);
+}
+
+
+int main(void)
+{
+	MY_HOST_RUN(MY_INT_TEST_Locks);
+	MY_HOST_RUN(MY_INT_TEST_Constraints);
+	MY_HOST_RUN(MY_INT_TEST_StopRestore);
+	MY_HOST_RUN(MY_INT_TEST_StopFail);
+	MY_HOST_RUN(MY_INT_TEST_Standby);
+
+	return MY_HOST_TEST_Report("pwr");
+}
@@ -0,0 +1,249 @@
+/**
+ * @author  Андрей Заостровных
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/rcc
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Тест MY_RCC_Profile_Set(): переходы Run - LowPower, задержка Flash, откат при ошибках
+ */
+#include "my_host_test.h"
+#include "my_stm32f0xx_rcc.h"
+#include "my_stm32f0xx_i2c.h"
+
+#define MY_INT_TEST_TICK						100U
+#define MY_INT_TEST_I2C_SPEED					100000U
+#define MY_INT_TEST_LOWPOWER_HCLK				8000000U
+
+static MY_RCC_Profile_t MY_INT_TEST_Target;
+static MY_Result_t MY_INT_TEST_Result;
+
+/* Наблюдения обработчика шага */
+static uint32_t MY_INT_TEST_LatencyErrors;
+static uint32_t MY_INT_TEST_UnmaskedSwitches;
+static uint32_t MY_INT_TEST_Sws;
+
+/* Вызовы подписчика изменения частот */
+static uint32_t MY_INT_TEST_Callbacks;
+static uint32_t MY_INT_TEST_CallbackHCLK;
+static uint32_t MY_INT_TEST_CallbackLoad;
+
+
+static void MY_INT_TEST_Hook(void)
+{
+	MY_HOST_RCC_Hook();
+
+	/* 48 МГц от PLL без задержки Flash */
+	if(((RCC->CFGR & RCC_CFGR_SWS) == RCC_CFGR_SWS_PLL) && !(FLASH->ACR & FLASH_ACR_LATENCY))
+	{
+		MY_INT_TEST_LatencyErrors++;
+	}
+
+	/* SYSCLK меняется только при запрещённых прерываниях */
+	if((RCC->CFGR & RCC_CFGR_SWS) != MY_INT_TEST_Sws)
+	{
+		MY_INT_TEST_Sws = RCC->CFGR & RCC_CFGR_SWS;
+
+		if(__get_PRIMASK() == 0U)
+		{
+			MY_INT_TEST_UnmaskedSwitches++;
+		}
+	}
+}
+
+
+static void MY_INT_TEST_Callback(const MY_RCC_Clocks_t *Clocks)
+{
+	MY_INT_TEST_Callbacks++;
+	MY_INT_TEST_CallbackHCLK = Clocks->HCLK_Freq;
+	MY_INT_TEST_CallbackLoad = SysTick->LOAD;
+}
+
+
+static void MY_INT_TEST_SystemInit(void)
+{
+	MY_INT_TEST_Result = MY_RCC_System_Init();
+}
+
+
+static void MY_INT_TEST_ProfileSet(void)
+{
+	MY_INT_TEST_Result = MY_RCC_Profile_Set(MY_INT_TEST_Target);
+}
+
+
+static MY_Result_t MY_INT_TEST_Set(MY_RCC_Profile_t Profile, uint32_t Hse, uint32_t Pll, uint32_t Switch)
+{
+	MY_HOST_RCC_Config(&(MY_HOST_RCC_Delays_t){ .HSE = Hse, .PLL = Pll, .Switch = Switch, .Tick = MY_INT_TEST_TICK });
+
+	MY_INT_TEST_Target = Profile;
+	MY_INT_TEST_Sws = RCC->CFGR & RCC_CFGR_SWS;
+
+	MY_HOST_Step_Run(MY_INT_TEST_ProfileSet, MY_INT_TEST_Hook);
+
+	return MY_INT_TEST_Result;
+}
+
+
+/* Загрузка в профиль Run, I2C1 тактируется от SYSCLK */
+static void MY_INT_TEST_Boot(void)
+{
+	MY_HOST_RCC_Config(&(MY_HOST_RCC_Delays_t){ .HSE = 50U, .PLL = 20U, .Switch = 4U, .Tick = MY_INT_TEST_TICK });
+
+	MY_INT_TEST_LatencyErrors = 0;
+
+	MY_HOST_Step_Run(MY_INT_TEST_SystemInit, MY_INT_TEST_Hook);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Result, MY_Result_Ok);
+	MY_HOST_EQUAL(SystemCoreClock, RCC_STATIC_SYSCLK);
+
+	MY_RCC_I2C1_CONFIG(RCC_I2C1CLKSOURCE_SYSCLK);
+	MY_RCC_ClockTree_Update();
+
+	MY_I2C_GetHandler(I2C1)->ClockSpeed = MY_INT_TEST_I2C_SPEED;
+
+	MY_HOST_EQUAL(MY_I2C_Init(I2C1), MY_Result_Ok);
+	MY_HOST_EQUAL(MY_RCC_ClockChange_Register(MY_INT_TEST_Callback), MY_Result_Ok);
+
+	/* При загрузке прерывания ещё разрешены, дальше считаются только переключения профилей */
+	MY_INT_TEST_UnmaskedSwitches = 0;
+	MY_INT_TEST_Callbacks = 0;
+}
+
+
+static void MY_INT_TEST_CheckRun(void)
+{
+	MY_HOST_EQUAL(MY_RCC_Profile_Get(), MY_RCC_Profile_Run);
+	MY_HOST_EQUAL(RCC->CFGR & RCC_CFGR_SWS, RCC_CFGR_SWS_PLL);
+	MY_HOST_EQUAL(FLASH->ACR & FLASH_ACR_LATENCY, FLASH_LATENCY);
+	MY_HOST_CHECK(RCC->CR & RCC_CR_HSEON);
+	MY_HOST_EQUAL(SystemCoreClock, RCC_STATIC_SYSCLK);
+	MY_HOST_EQUAL(SysTick->LOAD, (RCC_STATIC_SYSCLK / 1000U) - 1U);
+	MY_HOST_EQUAL(I2C1->TIMINGR, MY_I2C_Timing_Calc(RCC_STATIC_SYSCLK, MY_INT_TEST_I2C_SPEED));
+}
+
+
+static void MY_INT_TEST_CheckLowPower(void)
+{
+	MY_HOST_EQUAL(MY_RCC_Profile_Get(), MY_RCC_Profile_LowPower);
+	MY_HOST_EQUAL(RCC->CFGR & RCC_CFGR_SWS, RCC_CFGR_SWS_HSI);
+	MY_HOST_EQUAL(FLASH->ACR & FLASH_ACR_LATENCY, 0U);
+	MY_HOST_EQUAL(RCC->CR & (RCC_CR_HSEON | RCC_CR_PLLON), 0U);
+	MY_HOST_EQUAL(SystemCoreClock, MY_INT_TEST_LOWPOWER_HCLK);
+	MY_HOST_EQUAL(SysTick->LOAD, (MY_INT_TEST_LOWPOWER_HCLK / 1000U) - 1U);
+	MY_HOST_EQUAL(I2C1->TIMINGR, MY_I2C_Timing_Calc(MY_INT_TEST_LOWPOWER_HCLK, MY_INT_TEST_I2C_SPEED));
+}
+
+
+/* Переходы туда и обратно с разными задержками генераторов, в пределах таймаутов HSE (100 мс) и PLL (2 мс) */
+static void MY_INT_TEST_Transitions(void)
+{
+	static const uint32_t delays[][3] =
+	{
+		{ 0U,    0U,   0U },
+		{ 7U,    7U,   1U },
+		{ 300U,  150U, 9U },
+		{ 5000U, 20U,  15U },
+	};
+	uint32_t i;
+
+	MY_INT_TEST_Boot();
+	MY_INT_TEST_CheckRun();
+
+	for(i = 0; i < (sizeof(delays) / sizeof(delays[0])); i++)
+	{
+		MY_HOST_EQUAL(MY_INT_TEST_Set(MY_RCC_Profile_LowPower, delays[i][0], delays[i][1], delays[i][2]), MY_Result_Ok);
+		MY_INT_TEST_CheckLowPower();
+
+		MY_HOST_EQUAL(MY_INT_TEST_Set(MY_RCC_Profile_Run, delays[i][0], delays[i][1], delays[i][2]), MY_Result_Ok);
+		MY_INT_TEST_CheckRun();
+	}
+
+	/* Повторная установка текущего профиля */
+	MY_HOST_EQUAL(MY_INT_TEST_Set(MY_RCC_Profile_Run, 10U, 10U, 4U), MY_Result_Ok);
+	MY_INT_TEST_CheckRun();
+
+	MY_HOST_EQUAL(MY_INT_TEST_Set(MY_RCC_Profile_Count, 10U, 10U, 4U), MY_Result_Error);
+	MY_INT_TEST_CheckRun();
+
+	MY_HOST_EQUAL(MY_INT_TEST_LatencyErrors, 0U);
+	MY_HOST_EQUAL(MY_INT_TEST_UnmaskedSwitches, 0U);
+
+	MY_RCC_ClockChange_Unregister(MY_INT_TEST_Callback);
+}
+
+
+/* Подписчики вызываются один раз на смену частоты, SysTick к этому моменту уже перенастроен */
+static void MY_INT_TEST_Subscribers(void)
+{
+	MY_INT_TEST_Boot();
+
+	MY_INT_TEST_Set(MY_RCC_Profile_LowPower, 10U, 10U, 4U);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Callbacks, 1U);
+	MY_HOST_EQUAL(MY_INT_TEST_CallbackHCLK, MY_INT_TEST_LOWPOWER_HCLK);
+	MY_HOST_EQUAL(MY_INT_TEST_CallbackLoad, (MY_INT_TEST_LOWPOWER_HCLK / 1000U) - 1U);
+
+	MY_INT_TEST_Set(MY_RCC_Profile_Run, 10U, 10U, 4U);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Callbacks, 2U);
+	MY_HOST_EQUAL(MY_INT_TEST_CallbackHCLK, RCC_STATIC_SYSCLK);
+	MY_HOST_EQUAL(MY_INT_TEST_CallbackLoad, (RCC_STATIC_SYSCLK / 1000U) - 1U);
+
+	/* Без смены частот подписчики не вызываются */
+	MY_INT_TEST_Set(MY_RCC_Profile_Run, 10U, 10U, 4U);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Callbacks, 2U);
+
+	MY_RCC_ClockChange_Unregister(MY_INT_TEST_Callback);
+}
+
+
+/* Ошибка запуска из LowPower: профиль, частоты и генераторы остаются прежними */
+static void MY_INT_TEST_CheckRolledBack(MY_Result_t Result)
+{
+	MY_HOST_EQUAL(Result, MY_Result_Timeout);
+	MY_HOST_EQUAL(RCC->CFGR & RCC_CFGR_SW, RCC_CFGR_SW_HSI);
+	MY_HOST_EQUAL(RCC->CFGR & RCC_CFGR_SWS, RCC_CFGR_SWS_HSI);
+	MY_HOST_EQUAL(RCC->CR & (RCC_CR_HSEON | RCC_CR_PLLON), 0U);
+	MY_HOST_EQUAL(MY_RCC_Profile_Get(), MY_RCC_Profile_LowPower);
+	MY_HOST_EQUAL(SystemCoreClock, MY_INT_TEST_LOWPOWER_HCLK);
+	MY_HOST_EQUAL(MY_INT_TEST_Callbacks, 1U);
+}
+
+
+static void MY_INT_TEST_Rollback(void)
+{
+	MY_INT_TEST_Boot();
+
+	MY_HOST_EQUAL(MY_INT_TEST_Set(MY_RCC_Profile_LowPower, 10U, 10U, 4U), MY_Result_Ok);
+
+	/* HSE не запускается */
+	MY_INT_TEST_CheckRolledBack(MY_INT_TEST_Set(MY_RCC_Profile_Run, MY_HOST_NEVER, 10U, 4U));
+
+	/* PLL не захватывается */
+	MY_INT_TEST_CheckRolledBack(MY_INT_TEST_Set(MY_RCC_Profile_Run, 10U, MY_HOST_NEVER, 4U));
+
+	/* SYSCLK не переключается: запрос SW снимается, задержка Flash может остаться увеличенной */
+	MY_INT_TEST_CheckRolledBack(MY_INT_TEST_Set(MY_RCC_Profile_Run, 10U, 10U, MY_HOST_NEVER));
+
+	MY_HOST_EQUAL(__get_PRIMASK(), 0U);
+	MY_HOST_EQUAL(I2C1->TIMINGR, MY_I2C_Timing_Calc(MY_INT_TEST_LOWPOWER_HCLK, MY_INT_TEST_I2C_SPEED));
+
+	/* После отказов переход выполняется */
+	MY_HOST_EQUAL(MY_INT_TEST_Set(MY_RCC_Profile_Run, 10U, 10U, 4U), MY_Result_Ok);
+	MY_INT_TEST_CheckRun();
+
+	MY_HOST_EQUAL(MY_INT_TEST_LatencyErrors, 0U);
+
+	MY_RCC_ClockChange_Unregister(MY_INT_TEST_Callback);
+}
+
+
+int main(void)
+{
+	MY_HOST_RUN(MY_INT_TEST_Transitions);
+	MY_HOST_RUN(MY_INT_TEST_Subscribers);
+	MY_HOST_RUN(MY_INT_TEST_Rollback);
+
+	return MY_HOST_TEST_Report("rcc");
+}
@@ -0,0 +1,124 @@
+/**
+ * @author  Андрей Заостровных
+ * @email   megalloid@mail.ru
+ * @website http://smarthouseautomatics.ru/stm32/stm32f0xx/
+ * @version v0.1
+ * @ide     STM32CubeIDE
+ * @brief   Тест модели МК: пошаговое выполнение, прерывания и PRIMASK
+ */
+#include "my_host_test.h"
+#include "my_stm32f0xx.h"
+
+static volatile uint32_t MY_INT_TEST_Counter;
+static volatile uint32_t MY_INT_TEST_Seen;
+static volatile uint32_t MY_INT_TEST_Ipsr;
+static uint32_t MY_INT_TEST_Hooks;
+
+
+static void MY_INT_TEST_Thread(void)
+{
+	uint32_t i;
+
+	for(i = 0; i < 16U; i++)
+	{
+		MY_INT_TEST_Counter++;
+	}
+}
+
+
+/* Окно под PRIMASK: обработчик не должен увидеть нечётное значение */
+static void MY_INT_TEST_MaskedThread(void)
+{
+	__disable_irq();
+
+	MY_INT_TEST_Counter++;
+	MY_INT_TEST_Counter++;
+	MY_INT_TEST_Counter++;
+	MY_INT_TEST_Counter++;
+
+	__enable_irq();
+}
+
+
+static void MY_INT_TEST_Isr(void)
+{
+	MY_INT_TEST_Seen = MY_INT_TEST_Counter;
+	MY_INT_TEST_Ipsr = __get_IPSR();
+}
+
+
+static void MY_INT_TEST_Hook(void)
+{
+	MY_INT_TEST_Hooks++;
+}
+
+
+static void MY_INT_TEST_Step(void)
+{
+	uint32_t steps;
+
+	MY_INT_TEST_Counter = 0;
+	MY_INT_TEST_Hooks = 0;
+
+	steps = MY_HOST_Step_Run(MY_INT_TEST_Thread, MY_INT_TEST_Hook);
+
+	MY_HOST_EQUAL(MY_INT_TEST_Counter, 16U);
+	MY_HOST_EQUAL(MY_INT_TEST_Hooks, steps);
+
+	/* Цикл из 16 итераций: не меньше трёх инструкций на итерацию */
+	MY_HOST_CHECK(steps >= 48U);
+}
+
+
+static void MY_INT_TEST_Preempt(void)
+{
+	uint32_t steps = MY_HOST_Step_Run(MY_INT_TEST_Thread, NULL);
+	uint32_t at;
+	uint32_t last = 0;
+
+	for(at = 0; at <= steps; at++)
+	{
+		MY_INT_TEST_Counter = 0;
+		MY_INT_TEST_Seen = 0xFFFFFFFFU;
+
+		MY_HOST_Preempt_Run(MY_INT_TEST_Thread, MY_INT_TEST_Isr, 15U, at);
+
+		MY_HOST_CHECK(MY_INT_TEST_Seen <= 16U);
+		MY_HOST_CHECK(MY_INT_TEST_Seen >= last);
+		MY_HOST_EQUAL(MY_INT_TEST_Ipsr, 15U);
+		MY_HOST_EQUAL(__get_IPSR(), 0U);
+
+		last = MY_INT_TEST_Seen;
+	}
+
+	/* Прерывание после последней инструкции видит результат потока */
+	MY_HOST_EQUAL(last, 16U);
+}
+
+
+static void MY_INT_TEST_Primask(void)
+{
+	uint32_t steps = MY_HOST_Step_Run(MY_INT_TEST_MaskedThread, NULL);
+	uint32_t at;
+
+	for(at = 0; at <= steps; at++)
+	{
+		MY_INT_TEST_Counter = 0;
+		MY_INT_TEST_Seen = 0xFFFFFFFFU;
+
+		MY_HOST_Preempt_Run(MY_INT_TEST_MaskedThread, MY_INT_TEST_Isr, 15U, at);
+
+		MY_HOST_CHECK((MY_INT_TEST_Seen == 0U) || (MY_INT_TEST_Seen == 4U));
+		MY_HOST_EQUAL(__get_PRIMASK(), 0U);
+	}
+}
+
+
+int main(void)
+{
+	MY_HOST_RUN(MY_INT_TEST_Step);
+	MY_HOST_RUN(MY_INT_TEST_Preempt);
+	MY_HOST_RUN(MY_INT_TEST_Primask);
+
+	return MY_HOST_TEST_Report("sim");
+}
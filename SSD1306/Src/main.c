@@ -9,10 +9,18 @@
 #include "my_stm32f0xx.h"
 #include "my_stm32f0xx_disco.h"
 #include "my_stm32f0xx_24c0x.h"
+#include "my_stm32f0xx_console.h"
+#include "my_stm32f0xx_pwr.h"
 
 
 int main(void)
 {
+	/* Вывод printf() через USART1 (PA9) */
+	MY_CONSOLE_Init();
+
+	/* Причина запуска и статистика режимов питания */
+	MY_PWR_Init();
+
 	MY_DISCO_LedInit();
 
 	if(MY_24C0X_Init(I2C1, MY_I2C_PinsPack_1) == MY_Result_Ok)
@@ -32,7 +40,8 @@ int main(void)
 
 	while(1)
 	{
-
+		/* Простой: сон до ближайшего срока модулей или прерывания */
+		MY_PWR_Enter(MAX_DELAY);
 	}
 }
 
@@ -55,6 +55,7 @@
 #include <time.h>
 #include <sys/time.h>
 #include <sys/times.h>
+#include "my_stm32f0xx_console.h"
 
 
 /* Variables */
@@ -105,12 +106,9 @@ return len;
 
 __attribute__((weak)) int _write(int file, char *ptr, int len)
 {
-	int DataIdx;
+	/* Buffered output through MY_CONSOLE: never blocks, bytes that do not fit are dropped and counted */
+	MY_CONSOLE_Write(ptr, (uint32_t)len);
 
-	for (DataIdx = 0; DataIdx < len; DataIdx++)
-	{
-		__io_putchar(*ptr++);
-	}
 	return len;
 }
 
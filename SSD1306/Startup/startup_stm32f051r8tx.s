@@ -45,51 +45,74 @@ Reset_Handler:
   ldr   r0, =_estack
   mov   sp, r0          /* set stack pointer */
 
-/* Copy the data segment initializers from flash to SRAM */
-
-  ldr r0, =_sdata
-  ldr r1, =_edata
-  ldr r2, =_sidata
-  movs r3, #0
-  b LoopCopyDataInit
-
-CopyDataInit:
-
-
-  ldr r4, [r2, r3]
-  str r4, [r0, r3]
-  adds r3, r3, #4
-
-LoopCopyDataInit:
-
-
-  adds r4, r0, r3
-  cmp r4, r1
-
-
-
-  bcc CopyDataInit
-  
-/* Zero fill the bss segment. */
-  ldr r2, =_sbss
-  ldr r4, =_ebss
+/* Start HSE and the boot timer before RAM init: the crystal settles while .data/.bss are set up */
+  bl MY_BOOT_EarlyInit
+
+/* Paint free RAM from the heap start up to the stack with MEM_PAINT_PATTERN for MY_MEM watermarks.
+   Done while the crystal settles; nothing below SP is live yet. Both ends are 8-byte aligned */
+  ldr r1, =_end
+  mov r2, sp
+  subs r2, r2, r1
+  ldr r3, =0xC5C5C5C5
+  bl FillBlock
+
+/* Copy initialised RAM regions from flash: {load address, run address, size} rows of the linker copy table */
+  ldr r7, =__copy_table_start__
+  ldr r0, =__copy_table_end__
+  mov r8, r0
+  b LoopCopyTable
+
+CopyTableEntry:
+  ldmia r7!, {r0, r1, r2}
+  b LoopCopyBlock
+
+/* Four words per iteration, then the remaining 0-3 words */
+CopyBlock:
+  ldmia r0!, {r3, r4, r5, r6}
+  stmia r1!, {r3, r4, r5, r6}
+
+LoopCopyBlock:
+  subs r2, r2, #16
+  bcs CopyBlock
+  adds r2, r2, #16
+  b LoopCopyWord
+
+CopyWord:
+  ldmia r0!, {r3}
+  stmia r1!, {r3}
+
+LoopCopyWord:
+  subs r2, r2, #4
+  bcs CopyWord
+
+LoopCopyTable:
+  cmp r7, r8
+  bcc CopyTableEntry
+
+/* Zero regions of the zero table ({address, size} rows). .noinit and .arena are not listed and keep their contents */
+  ldr r7, =__zero_table_start__
+  ldr r0, =__zero_table_end__
+  mov r8, r0
+  b LoopZeroTable
+
+ZeroTableEntry:
+  ldmia r7!, {r1, r2}
   movs r3, #0
-  b LoopFillZerobss
-
-FillZerobss:
+  bl FillBlock
 
-  str  r3, [r2]
-  adds r2, r2, #4
+LoopZeroTable:
+  cmp r7, r8
+  bcc ZeroTableEntry
 
-LoopFillZerobss:
-
-  cmp r2, r4
-  bcc FillZerobss
+  movs r0, #1           /* MY_BOOT_Phase_MemInit */
+  bl MY_BOOT_Timestamp
 
 /* Call the clock system intitialization function.*/
   bl MY_System_Init
 /* Call static constructors */
   bl __libc_init_array
+  movs r0, #6           /* MY_BOOT_Phase_Main */
+  bl MY_BOOT_Timestamp
 /* Call the application's entry point.*/
   bl main
 
@@ -100,6 +123,40 @@ LoopForever:
 
 .size Reset_Handler, .-Reset_Handler
 
+/**
+ * @brief  Fills memory with a word, four words per STM. Used by Reset_Handler before RAM is initialised
+ * @param  r1: address, word aligned
+ * @param  r2: size in bytes, multiple of 4
+ * @param  r3: fill word
+ * @retval None. Clobbers r1-r6, keeps r7 and r8
+*/
+  .section .text.FillBlock
+  .type FillBlock, %function
+FillBlock:
+  mov r4, r3
+  mov r5, r3
+  mov r6, r3
+  b LoopFillBlock
+
+FillBlock4:
+  stmia r1!, {r3, r4, r5, r6}
+
+LoopFillBlock:
+  subs r2, r2, #16
+  bcs FillBlock4
+  adds r2, r2, #16
+  b LoopFillWord
+
+FillWord:
+  stmia r1!, {r3}
+
+LoopFillWord:
+  subs r2, r2, #4
+  bcs FillWord
+  bx lr
+
+.size FillBlock, .-FillBlock
+
 /**
  * @brief  This is the code that gets called when the processor receives an
  *         unexpected interrupt.  This simply enters an infinite loop, preserving
@@ -19,6 +19,13 @@
 	#include "my_stm32f0xx.h"
 	#include "my_stm32f0xx_rcc.h"
 	#include "my_stm32f0xx_cortex.h"
+	#include "my_stm32f0xx_button.h"
+	#include "my_stm32f0xx_fault.h"
+	#include "my_stm32f0xx_os.h"
+	#include "my_stm32f0xx_isr.h"
+	#include "my_stm32f0xx_dma.h"
+	#include "my_stm32f0xx_mem.h"
+	#include "my_stm32f0xx_console.h"
 
 	/******************************************************************************/
 	/*            Cortex-M0 Processor Exceptions Handlers                         */
@@ -34,10 +41,11 @@
 
 	/**
 	 * @brief  This function handles Hard Fault exception.
+	 * @note   Выбирает стек (MSP/PSP) по EXC_RETURN и передаёт кадр исключения в MY_FAULT_HardFault()
 	 * @param  Нет
 	 * @retval Нет
 	 */
-	void HardFault_Handler(void);
+	void HardFault_Handler(void) __attribute__((naked));
 
 
 	/**
@@ -50,10 +58,13 @@
 
 	/**
 	 * @brief  This function handles PendSVC exception.
+	 * @note   При USE_RTOS = 1 обработчик находится в my_stm32f0xx_os.c
 	 * @param  Нет
 	 * @retval Нет
 	 */
-	void PendSV_Handler(void);
+	#if (USE_RTOS == 0U)
+		void PendSV_Handler(void);
+	#endif
 
 
 	/**
@@ -61,7 +72,7 @@
 	 * @param  Нет
 	 * @retval Нет
 	 */
-	void SysTick_Handler(void);
+	MY_RAMFUNC void SysTick_Handler(void);
 
 
 	/**
@@ -80,10 +91,38 @@
 	/******************************************************************************/
 
 	/**
-	 * @brief  This function handles ...
+	 * @brief  This function handles DMA1 channel 1 interrupt.
+	 * @param  Нет
+	 * @retval Нет
+	 */
+	void DMA1_CH1_IRQHandler(void);
+
+
+	/**
+	 * @brief  This function handles DMA1 channel 2 and 3 interrupt.
+	 * @note   Вектор общий, MY_DMA_IRQ_Dispatch() обслуживает оба канала
+	 * @param  Нет
+	 * @retval Нет
+	 */
+	void DMA1_CH2_3_DMA2_CH1_2_IRQHandler(void);
+
+
+	/**
+	 * @brief  This function handles DMA1 channel 4 and 5 interrupt.
+	 * @note   Вектор общий, MY_DMA_IRQ_Dispatch() обслуживает оба канала
+	 * @param  Нет
+	 * @retval Нет
+	 */
+	void DMA1_CH4_5_6_7_DMA2_CH3_4_5_IRQHandler(void);
+
+
+	/**
+	 * @brief  This function handles USART1 global interrupt.
+	 * @note   Передача буфера MY_CONSOLE
 	 * @param  Нет
 	 * @retval Нет
 	 */
+	void USART1_IRQHandler(void);
 
 
 
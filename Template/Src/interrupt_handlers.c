@@ -18,6 +18,8 @@
 
 void NMI_Handler(void)
 {
+	/* Без MY_ISR_ENTER/EXIT: NMI не маскируется PRIMASK и может прервать обновление статистики */
+
 	/* Check RCC CSS flag */
 	if(MY_RCC_GET_IT(RCC_IT_CSS))
 	{
@@ -32,11 +34,22 @@ void NMI_Handler(void)
 
 void HardFault_Handler(void)
 {
-	/* Go to infinite loop when Hard Fault exception occurs */
-	while (1)
-	{
-
-	}
+	/* Бит 2 EXC_RETURN: 0 - кадр на MSP, 1 - на PSP. Thumb-1: TST только между регистрами */
+	__asm volatile
+	(
+		"movs r0, #4              \n"
+		"mov  r1, lr              \n"
+		"tst  r0, r1              \n"
+		"beq  1f                  \n"
+		"mrs  r0, psp             \n"
+		"b    2f                  \n"
+		"1:                       \n"
+		"mrs  r0, msp             \n"
+		"2:                       \n"
+		"ldr  r2, =MY_FAULT_HardFault \n"
+		"bx   r2                  \n"
+		".ltorg                   \n"
+	);
 }
 
 
@@ -46,14 +59,80 @@ void SVC_Handler(void)
 }
 
 
+#if (USE_RTOS == 0U)
+
 void PendSV_Handler(void)
 {
 
 }
 
+#endif
 
-void SysTick_Handler(void)
+
+MY_RAMFUNC void SysTick_Handler(void)
 {
+	MY_ISR_ENTER(SysTick_IRQn);
+
 	MY_SysTick_IncTick();
+
+	#if (USE_RTOS == 1U)
+		/* Пробуждение задач по таймауту и вытеснение */
+		MY_OS_Tick();
+	#endif
+
+	/* Опрос кнопок с подавлением дребезга */
+	MY_BUTTON_Tick();
+
+	#if (MEM_GUARD_CHECK == 1U)
+		/* Охранная зона основного стека */
+		MY_MEM_Guard_Check();
+	#endif
+
+	MY_ISR_EXIT(SysTick_IRQn);
 }
 
+
+
+/******************************************************************************/
+/*                 STM32F0xx Peripherals Interrupt Handlers                   */
+/******************************************************************************/
+
+
+void DMA1_CH1_IRQHandler(void)
+{
+	MY_ISR_ENTER(DMA1_Channel1_IRQn);
+
+	MY_DMA_IRQ_Dispatch(DMA1_Channel1_IRQn);
+
+	MY_ISR_EXIT(DMA1_Channel1_IRQn);
+}
+
+
+void DMA1_CH2_3_DMA2_CH1_2_IRQHandler(void)
+{
+	MY_ISR_ENTER(DMA1_Channel2_3_IRQn);
+
+	MY_DMA_IRQ_Dispatch(DMA1_Channel2_3_IRQn);
+
+	MY_ISR_EXIT(DMA1_Channel2_3_IRQn);
+}
+
+
+void DMA1_CH4_5_6_7_DMA2_CH3_4_5_IRQHandler(void)
+{
+	MY_ISR_ENTER(DMA1_Channel4_5_IRQn);
+
+	MY_DMA_IRQ_Dispatch(DMA1_Channel4_5_IRQn);
+
+	MY_ISR_EXIT(DMA1_Channel4_5_IRQn);
+}
+
+
+void USART1_IRQHandler(void)
+{
+	MY_ISR_ENTER(USART1_IRQn);
+
+	MY_CONSOLE_IRQHandler();
+
+	MY_ISR_EXIT(USART1_IRQn);
+}
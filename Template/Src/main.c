@@ -9,11 +9,25 @@
 
 #include "my_stm32f0xx.h"
 #include "my_stm32f0xx_gpio.h"
-#include "my_stm32f0xx_delay.h"
+#include "my_stm32f0xx_cortex.h"
+#include "my_stm32f0xx_console.h"
+#include "my_stm32f0xx_pwr.h"
+
+/* Период переключения светодиода, мс */
+#define LED_PERIOD								100U
 
 int main(void)
 {
 	MY_GPIO_Init_t GPIO_Leds;
+	uint32_t tickstart;
+	uint32_t elapsed;
+
+	/* Вывод printf() через USART1 (PA9) */
+	MY_CONSOLE_Init();
+
+	/* Причина запуска и статистика режимов питания */
+	MY_PWR_Init();
+
 	GPIO_Leds.Pin = GPIO_Pin_8 | GPIO_Pin_9;
 	GPIO_Leds.Mode = MY_GPIO_Mode_Out;
 	GPIO_Leds.Pull = MY_GPIO_PuPd_NoPull;
@@ -21,14 +35,22 @@ int main(void)
 
 	MY_GPIO_StructInit(GPIOC, &GPIO_Leds);
 
+	tickstart = MY_SysTick_GetTick();
+
 	while(1)
 	{
-		/* Зажигаем светодиод PC8, гасим PC9 */
-		MY_GPIO_SetPinHigh(GPIOC, GPIO_Pin_9);
-		MY_Delay_ms(100);
+		elapsed = MY_SysTick_GetTick() - tickstart;
+
+		/* Переключаем светодиод PC9 раз в LED_PERIOD */
+		if(elapsed >= LED_PERIOD)
+		{
+			MY_GPIO_TogglePinValue(GPIOC, GPIO_Pin_9);
+
+			tickstart += LED_PERIOD;
+			elapsed -= LED_PERIOD;
+		}
 
-		/* Зажигаем светодиод PC9, гасим PC8 */
-		MY_GPIO_SetPinLow(GPIOC, GPIO_Pin_9);
-		MY_Delay_ms(100);
+		/* Простой до следующего переключения: сон без тиков, если модули не требуют раньше */
+		MY_PWR_Enter((elapsed < LED_PERIOD) ? (LED_PERIOD - elapsed) : 0U);
 	}
 }
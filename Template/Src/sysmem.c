@@ -49,6 +49,7 @@
 /* Includes */
 #include <errno.h>
 #include <stdio.h>
+#include "my_stm32f0xx_mem.h"
 
 /* Variables */
 extern int errno;
@@ -70,13 +71,16 @@ caddr_t _sbrk(int incr)
 		heap_end = &end;
 
 	prev_heap_end = heap_end;
-	if (heap_end + incr > stack_ptr)
+	/* MY_MEM: heap stops below the stack guard zone, peak is tracked for MY_MEM_Dump() */
+	if (heap_end + incr > MY_MEM_Heap_Limit(stack_ptr))
 	{
+		MY_MEM_Heap_Track(NULL);
 		errno = ENOMEM;
 		return (caddr_t) -1;
 	}
 
 	heap_end += incr;
+	MY_MEM_Heap_Track(heap_end);
 
 	return (caddr_t) prev_heap_end;
 }
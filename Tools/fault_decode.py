@@ -0,0 +1,142 @@
+#!/usr/bin/env python3
+"""
+Decode a crash record printed by MY_FAULT_Dump().
+
+Usage:
+    fault_decode.py firmware.elf [log.txt]
+
+The log (file or stdin) is scanned for "FAULT ..." lines. PC, LR and every
+stack word that falls into an executable section of the ELF (flash code and
+MY_RAMFUNC code in .ramfunc, which runs from RAM) are mapped to
+function/file:line with arm-none-eabi-addr2line.
+
+Set ADDR2LINE to use a different addr2line binary.
+"""
+
+import os
+import re
+import struct
+import subprocess
+import sys
+
+FIELD_RE = re.compile(r"(\w+(?:\[\d+\])?)=(0x[0-9A-Fa-f]+|\d+)")
+
+# sh_flags of sections that hold code
+SHF_ALLOC = 0x2
+SHF_EXECINSTR = 0x4
+
+# Bits of EXC_RETURN
+EXC_RETURN_MODES = {
+    0xFFFFFFF1: "handler mode, MSP",
+    0xFFFFFFF9: "thread mode, MSP",
+    0xFFFFFFFD: "thread mode, PSP",
+}
+
+
+def parse(lines):
+    record = {}
+    stack = {}
+
+    for line in lines:
+        if "FAULT" not in line:
+            continue
+
+        if "FAULT none" in line:
+            return None, None
+
+        for key, value in FIELD_RE.findall(line):
+            number = int(value, 0)
+
+            if key.startswith("stack["):
+                stack[int(key[6:-1])] = number
+            else:
+                record[key] = number
+
+    return record, [stack[i] for i in sorted(stack)]
+
+
+def addr2line(elf, addresses):
+    if not addresses:
+        return {}
+
+    tool = os.environ.get("ADDR2LINE", "arm-none-eabi-addr2line")
+
+    # Thumb: bit 0 of return addresses is set
+    query = ["0x%08X" % (address & ~1) for address in addresses]
+
+    # Without -i every address produces exactly two lines: function and file:line
+    output = subprocess.run([tool, "-e", elf, "-f", "-C"] + query,
+                            check=True, capture_output=True, text=True).stdout.splitlines()
+
+    return {address: "%s (%s)" % (output[2 * i], output[2 * i + 1]) for i, address in enumerate(addresses)}
+
+
+def code_ranges(elf):
+    data = open(elf, "rb").read()
+
+    if data[:4] != b"\x7fELF" or data[4] != 1:
+        raise ValueError("%s is not an ELF32 file" % elf)
+
+    shoff, = struct.unpack_from("<I", data, 0x20)
+    shentsize, shnum = struct.unpack_from("<HH", data, 0x2E)
+    ranges = []
+
+    # Run addresses (sh_addr) of allocated executable sections: .text in flash, .ramfunc in RAM
+    for i in range(shnum):
+        _, _, flags, addr, _, size = struct.unpack_from("<IIIIII", data, shoff + i * shentsize)
+
+        if (flags & (SHF_ALLOC | SHF_EXECINSTR)) == (SHF_ALLOC | SHF_EXECINSTR) and size:
+            ranges.append((addr, addr + size))
+
+    return ranges
+
+
+def is_code(ranges, address):
+    return any(start <= (address & ~1) < end for start, end in ranges)
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__.strip())
+        return 2
+
+    elf = sys.argv[1]
+    lines = open(sys.argv[2]).readlines() if len(sys.argv) > 2 else sys.stdin.readlines()
+
+    record, stack = parse(lines)
+
+    if record is None:
+        print("No crash record")
+        return 0
+
+    if "pc" not in record:
+        print("No FAULT lines found")
+        return 1
+
+    ranges = code_ranges(elf)
+    code = [record["pc"], record["lr"]] + stack
+    symbols = addr2line(elf, sorted(set(address for address in code if is_code(ranges, address))))
+
+    print("Crash #%d after %d ms" % (record.get("count", 0), record.get("uptime", 0)))
+    print("  mode : %s" % EXC_RETURN_MODES.get(record.get("exc", 0), "unknown EXC_RETURN 0x%08X" % record.get("exc", 0)))
+    print("  sp   : 0x%08X" % record.get("sp", 0))
+
+    for name in ("pc", "lr"):
+        value = record[name]
+        print("  %-4s : 0x%08X  %s" % (name, value, symbols.get(value, "")))
+
+    print("  xpsr : 0x%08X  (exception %d)" % (record.get("xpsr", 0), record.get("xpsr", 0) & 0x3F))
+    print("  regs : " + " ".join("%s=0x%08X" % (r, record.get(r, 0)) for r in ("r0", "r1", "r2", "r3", "r12")))
+
+    if stack:
+        print("  stack (possible return addresses marked):")
+
+        for index, word in enumerate(stack):
+            mark = symbols.get(word, "") if is_code(ranges, word) else ""
+            print("    [%2d] 0x%08X  %s" % (index, word, mark))
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,141 @@
+#!/usr/bin/env python3
+"""
+Decode the deferred log written by MY_LOG_Process().
+
+Usage:
+    log_decode.py firmware.elf [log.txt]
+
+The console output (file or stdin) is copied to stdout. Every "LOG ..." line
+is replaced with the text of its record: the header word holds the address
+of the format string in the .logstr section of the ELF, the number of
+arguments and a timestamp flag, the following words are the timestamp and
+the raw argument values.
+
+Only integer conversions are formatted (%d %i %u %x %X %o %c %p), %s prints
+the string address.
+"""
+
+import re
+import struct
+import sys
+
+# Header word of a record (my_stm32f0xx_log.h, MY_LOG_Defines)
+HEADER_ID_MASK = 0x00FFFFFF
+HEADER_ARGS_POS = 24
+HEADER_TIMESTAMP = 0x10000000
+
+LOG_RE = re.compile(r"^LOG((?: [0-9A-Fa-f]{8})+)\s*$")
+
+# printf conversion: flags, width, precision, length modifier, conversion
+SPEC_RE = re.compile(r"%([-+ #0]*)(\d*)(?:\.(\d+))?(hh|h|ll|l|z|t|j)?([diuxXocps%])")
+
+
+def read_section(elf, name):
+    data = open(elf, "rb").read()
+
+    if data[:4] != b"\x7fELF":
+        raise ValueError("%s is not an ELF file" % elf)
+
+    # ELF32 (the firmware) or ELF64 (host builds), little-endian
+    if data[4] == 1:
+        shoff, = struct.unpack_from("<I", data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x2E)
+        header = "<IIIIIIIIII"
+    else:
+        shoff, = struct.unpack_from("<Q", data, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from("<HHH", data, 0x3A)
+        header = "<IIQQQQIIQQ"
+
+    sections = [struct.unpack_from(header, data, shoff + i * shentsize) for i in range(shnum)]
+    names = sections[shstrndx]
+
+    for section in sections:
+        start = names[4] + section[0]
+        section_name = data[start:data.index(b"\0", start)].decode()
+
+        if section_name == name:
+            # sh_addr, sh_offset, sh_size
+            return section[3], data[section[4]:section[4] + section[5]]
+
+    raise ValueError("%s has no %s section" % (elf, name))
+
+
+def c_format(fmt, args):
+    values = iter(args)
+
+    def convert(match):
+        flags, width, precision, length, conversion = match.groups()
+
+        if conversion == "%":
+            return "%"
+
+        value = next(values, None)
+
+        if value is None:
+            return "<missing>"
+
+        # Arguments were cast to uint32_t: restore the width of h/hh and the sign of %d
+        if length == "hh":
+            value &= 0xFF
+        elif length == "h":
+            value &= 0xFFFF
+
+        if conversion in "di":
+            bits = 8 if length == "hh" else 16 if length == "h" else 32
+            if value & (1 << (bits - 1)):
+                value -= 1 << bits
+            conversion = "d"
+        elif conversion == "p":
+            return "0x%08x" % value
+        elif conversion == "s":
+            return "<str@0x%08x>" % value
+        elif conversion == "c":
+            value = chr(value & 0xFF)
+
+        spec = "%" + flags + width + ("." + precision if precision else "") + conversion
+
+        return spec % value
+
+    return SPEC_RE.sub(convert, fmt)
+
+
+def decode(strings, base, words):
+    header = words[0]
+    count = (header >> HEADER_ARGS_POS) & 0x0F
+    offset = (header & HEADER_ID_MASK) - (base & HEADER_ID_MASK)
+    body = words[1:]
+    prefix = ""
+
+    if header & HEADER_TIMESTAMP:
+        prefix = "[%10d] " % body[0]
+        body = body[1:]
+
+    if len(body) != count or not 0 <= offset < len(strings):
+        return "LOG <corrupt record %s>" % " ".join("%08X" % word for word in words)
+
+    fmt = strings[offset:strings.index(b"\0", offset)].decode(errors="replace")
+
+    return prefix + c_format(fmt, body)
+
+
+def main():
+    if len(sys.argv) < 2:
+        print(__doc__.strip())
+        return 2
+
+    base, strings = read_section(sys.argv[1], ".logstr")
+    lines = open(sys.argv[2]) if len(sys.argv) > 2 else sys.stdin
+
+    for line in lines:
+        match = LOG_RE.match(line.rstrip("\r\n"))
+
+        if match:
+            print(decode(strings, base, [int(word, 16) for word in match.group(1).split()]))
+        else:
+            sys.stdout.write(line)
+
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())